@@ -255,6 +255,7 @@ LOCAL_SRC_FILES := \
     property_store.cc \
     resolver.cc \
     result_aggregator.cc \
+    router_solicitor.cc \
     routing_table.cc \
     rpc_task.cc \
     scope_logger.cc \
@@ -277,7 +278,8 @@ LOCAL_SRC_FILES := \
     virtual_device.cc \
     vpn/vpn_driver.cc \
     vpn/vpn_provider.cc \
-    vpn/vpn_service.cc
+    vpn/vpn_service.cc \
+    warm_start_state.cc
 ifeq ($(SHILL_USE_BINDER), true)
 LOCAL_AIDL_INCLUDES := \
     system/connectivity/shill/binder \
@@ -507,6 +509,7 @@ LOCAL_SRC_FILES := \
     mock_profile.cc \
     mock_property_store.cc \
     mock_resolver.cc \
+    mock_router_solicitor.cc \
     mock_routing_table.cc \
     mock_service.cc \
     mock_socket_info_reader.cc \
@@ -517,6 +520,7 @@ LOCAL_SRC_FILES := \
     net/byte_string_unittest.cc \
     net/event_history_unittest.cc \
     net/ip_address_unittest.cc \
+    net/io_input_handler_unittest.cc \
     net/netlink_attribute_unittest.cc \
     net/rtnl_handler_unittest.cc \
     net/rtnl_listener_unittest.cc \
@@ -537,9 +541,11 @@ LOCAL_SRC_FILES := \
     property_store_unittest.cc \
     resolver_unittest.cc \
     result_aggregator_unittest.cc \
+    router_solicitor_unittest.cc \
     routing_table_unittest.cc \
     rpc_task_unittest.cc \
     scope_logger_unittest.cc \
+    service_property_change_notifier_unittest.cc \
     service_property_change_test.cc \
     service_under_test.cc \
     service_unittest.cc \
@@ -554,6 +560,7 @@ LOCAL_SRC_FILES := \
     upstart/upstart_unittest.cc \
     virtual_device_unittest.cc \
     vpn/mock_vpn_provider.cc \
+    warm_start_state_unittest.cc \
     json_store_unittest.cc
 ifeq ($(SHILL_USE_BINDER), true)
 LOCAL_SHARED_LIBRARIES += libbinder libbinderwrapper libutils libbrillo-binder
@@ -16,6 +16,8 @@
 
 #include "shill/active_link_monitor.h"
 
+#include <linux/neighbour.h>
+
 #include <string>
 #include <vector>
 
@@ -31,6 +33,9 @@
 #include "shill/logging.h"
 #include "shill/metrics.h"
 #include "shill/net/ip_address.h"
+#include "shill/net/rtnl_handler.h"
+#include "shill/net/rtnl_listener.h"
+#include "shill/net/rtnl_message.h"
 #include "shill/net/shill_time.h"
 
 using base::Bind;
@@ -75,7 +80,9 @@ ActiveLinkMonitor::ActiveLinkMonitor(const ConnectionRefPtr& connection,
       gateway_supports_unicast_arp_(false),
       response_sample_count_(0),
       response_sample_bucket_(0),
-      time_(Time::GetInstance()) {
+      time_(Time::GetInstance()),
+      rtnl_handler_(RTNLHandler::GetInstance()),
+      gateway_reachable_(false) {
 }
 
 ActiveLinkMonitor::~ActiveLinkMonitor() {
@@ -104,6 +111,8 @@ void ActiveLinkMonitor::Stop() {
   gateway_supports_unicast_arp_ = false;
   response_sample_bucket_ = 0;
   response_sample_count_ = 0;
+  neighbor_listener_.reset();
+  gateway_reachable_ = false;
 }
 
 int ActiveLinkMonitor::GetResponseTimeMilliseconds() const {
@@ -145,6 +154,13 @@ bool ActiveLinkMonitor::StartInternal(int probe_period_milliseconds) {
   if (gateway_mac_address_.IsEmpty()) {
     gateway_mac_address_ = ByteString(local_mac_address_.GetLength());
   }
+  if (!neighbor_listener_) {
+    neighbor_listener_.reset(
+        new RTNLListener(RTNLHandler::kRequestNeighbor,
+                         Bind(&ActiveLinkMonitor::OnNeighborMsgReceived,
+                              Unretained(this)),
+                         rtnl_handler_));
+  }
   send_request_callback_.Reset(
       Bind(&ActiveLinkMonitor::SendRequest, Unretained(this)));
   // Post a task to send ARP request instead of calling it synchronously, to
@@ -295,6 +311,7 @@ void ActiveLinkMonitor::ReceiveResponse(int fd) {
       SLOG(connection_.get(), 2) << "Gateway MAC address changed.";
     }
     gateway_mac_address_ = new_mac_address;
+    gateway_reachable_ = false;
   }
 
   is_unicast_ = !is_unicast_;
@@ -313,6 +330,12 @@ void ActiveLinkMonitor::SendRequest() {
     return;
   }
 
+  // Traffic has recently confirmed the gateway; there is nothing to probe.
+  if (gateway_reachable_) {
+    OnGatewayReachabilityConfirmed();
+    return;
+  }
+
   ByteString destination_mac_address(gateway_mac_address_.GetLength());
   if (!IsGatewayFound()) {
     // The remote MAC addess is set by convention to be all-zeroes in the
@@ -343,4 +366,46 @@ void ActiveLinkMonitor::SendRequest() {
                                test_period_milliseconds_);
 }
 
+void ActiveLinkMonitor::OnNeighborMsgReceived(const RTNLMessage& msg) {
+  DCHECK(msg.type() == RTNLMessage::kTypeNeighbor);
+  if (msg.interface_index() != connection_->interface_index() ||
+      !msg.HasAttribute(NDA_DST)) {
+    return;
+  }
+  IPAddress address(msg.family(), msg.GetAttribute(NDA_DST));
+  if (!address.Equals(connection_->gateway())) {
+    return;
+  }
+
+  // Only trust a confirmation for the gateway MAC address we have already
+  // verified by ARP, so that a changed gateway is still detected by probing.
+  bool was_reachable = gateway_reachable_;
+  gateway_reachable_ =
+      msg.mode() == RTNLMessage::kModeAdd &&
+      (msg.neighbor_status().state & NUD_REACHABLE) != 0 &&
+      IsGatewayFound() &&
+      msg.HasAttribute(NDA_LLADDR) &&
+      gateway_mac_address_.Equals(msg.GetAttribute(NDA_LLADDR));
+  SLOG_IF(Link, 3, was_reachable != gateway_reachable_)
+      << "Gateway neighbor entry is "
+      << (gateway_reachable_ ? "now" : "no longer") << " reachable.";
+
+  // Complete a cycle that is waiting on an ARP reply.
+  if (gateway_reachable_ && !was_reachable &&
+      !send_request_callback_.IsCancelled()) {
+    OnGatewayReachabilityConfirmed();
+  }
+}
+
+void ActiveLinkMonitor::OnGatewayReachabilityConfirmed() {
+  SLOG(connection_.get(), 2) << "In " << __func__ << ".";
+  // The kernel has seen the gateway respond, so any probes that went
+  // unanswered did not indicate a link failure.
+  broadcast_failure_count_ = 0;
+  unicast_failure_count_ = 0;
+
+  StopMonitorCycle();
+  success_callback_.Run();
+}
+
 }  // namespace shill
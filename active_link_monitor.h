@@ -35,6 +35,9 @@ class ArpClient;
 class DeviceInfo;
 class EventDispatcher;
 class IOHandler;
+class RTNLHandler;
+class RTNLListener;
+class RTNLMessage;
 class Time;
 
 // ActiveLinkMonitor probes the status of a connection by sending ARP
@@ -46,6 +49,13 @@ class Time;
 // The active link monitor will automatically stop when the link status is
 // determined. It also keeps track of response times which can be an indicator
 // of link quality.
+//
+// While it is running, the monitor also follows the kernel's neighbor table
+// entry for the gateway.  As long as the kernel reports that entry as
+// NUD_REACHABLE (i.e. reachability has recently been confirmed by traffic
+// such as TCP ACKs), the gateway is known to be up and a monitor cycle
+// completes successfully without sending an ARP request.  ARP probes are
+// only sent once the entry goes stale or is otherwise not reachable.
 class ActiveLinkMonitor {
  public:
   // FailureCallback takes monitor failure code, broadcast failure count, and
@@ -143,6 +153,13 @@ class ActiveLinkMonitor {
   void ReceiveResponse(int fd);
   // Send the next ARP request.
   void SendRequest();
+  // Called for every neighbor table update from the kernel.  Tracks whether
+  // the gateway's entry is currently NUD_REACHABLE, and completes a pending
+  // monitor cycle successfully when it becomes so.
+  void OnNeighborMsgReceived(const RTNLMessage& msg);
+  // Completes the current monitor cycle successfully on the strength of a
+  // kernel reachability confirmation rather than an ARP reply.
+  void OnGatewayReachabilityConfirmed();
 
   // The connection on which to perform link monitoring.
   ConnectionRefPtr connection_;
@@ -206,6 +223,13 @@ class ActiveLinkMonitor {
   // Time instance for performing GetTimeMonotonic().
   Time* time_;
 
+  // Listens for neighbor table updates while the monitor is running.
+  RTNLHandler* rtnl_handler_;
+  std::unique_ptr<RTNLListener> neighbor_listener_;
+  // Whether the kernel last reported the gateway's neighbor table entry,
+  // at |gateway_mac_address_|, as NUD_REACHABLE.
+  bool gateway_reachable_;
+
   DISALLOW_COPY_AND_ASSIGN(ActiveLinkMonitor);
 };
 
@@ -16,6 +16,7 @@
 
 #include "shill/active_link_monitor.h"
 
+#include <linux/neighbour.h>
 #include <net/if_arp.h>
 
 #include <string>
@@ -35,8 +36,10 @@
 #include "shill/mock_metrics.h"
 #include "shill/net/byte_string.h"
 #include "shill/net/ip_address.h"
+#include "shill/net/mock_rtnl_handler.h"
 #include "shill/net/mock_sockets.h"
 #include "shill/net/mock_time.h"
+#include "shill/net/rtnl_message.h"
 
 using base::Bind;
 using base::Unretained;
@@ -158,6 +161,7 @@ class ActiveLinkMonitorTest : public Test {
     }
     monitor_.arp_client_.reset(client_);
     monitor_.time_ = &time_;
+    monitor_.rtnl_handler_ = &rtnl_handler_;
     time_val_.tv_sec = 0;
     time_val_.tv_usec = 0;
     EXPECT_CALL(time_, GetTimeMonotonic(_))
@@ -287,6 +291,21 @@ class ActiveLinkMonitorTest : public Test {
     ReceiveResponse(ARPOP_REPLY, gateway_ip_, gateway_mac_,
                     local_ip_, local_mac_);
   }
+  void ReceiveNeighborMessage(uint16_t state, const ByteString& mac) {
+    RTNLMessage msg(RTNLMessage::kTypeNeighbor, RTNLMessage::kModeAdd, 0, 0, 0,
+                    connection_->interface_index(), IPAddress::kFamilyIPv4);
+    msg.set_neighbor_status(RTNLMessage::NeighborStatus(state, 0, NDA_DST));
+    msg.SetAttribute(NDA_DST, gateway_ip_.address());
+    msg.SetAttribute(NDA_LLADDR, mac);
+    monitor_.OnNeighborMsgReceived(msg);
+  }
+  void FindGateway() {
+    StartMonitor();
+    EXPECT_CALL(metrics_, SendToUMA(
+        HasSubstr("LinkMonitorResponseTimeSample"), _, _, _, _));
+    ReceiveReplyAndRestartMonitorCycle();
+    Mock::VerifyAndClearExpectations(&metrics_);
+  }
   void ReceiveReplyAndRestartMonitorCycle() {
     EXPECT_CALL(observer_, OnSuccessCallback()).Times(1);
     ReceiveCorrectResponse();
@@ -367,6 +386,7 @@ class ActiveLinkMonitorTest : public Test {
   ByteString zero_mac_;
   bool link_scope_logging_was_enabled_;
   const string interface_name_;
+  NiceMock<MockRTNLHandler> rtnl_handler_;
   ActiveLinkMonitor monitor_;
 };
 
@@ -462,6 +482,65 @@ TEST_F(ActiveLinkMonitorTest, ReplyReception) {
   Mock::VerifyAndClearExpectations(client_);
 }
 
+TEST_F(ActiveLinkMonitorTest, NeighborReachableCompletesCycle) {
+  FindGateway();
+
+  // A confirmation for some other MAC address does not count.
+  const uint8_t kOtherMACAddress[] = { 1, 1, 1, 1, 1, 1 };
+  ByteString other_mac(kOtherMACAddress, arraysize(kOtherMACAddress));
+  EXPECT_CALL(observer_, OnSuccessCallback()).Times(0);
+  ReceiveNeighborMessage(NUD_REACHABLE, other_mac);
+  EXPECT_FALSE(GetSendRequestCallback().IsCancelled());
+  Mock::VerifyAndClearExpectations(&observer_);
+
+  // Neither does a neighbor entry that is not reachable.
+  EXPECT_CALL(observer_, OnSuccessCallback()).Times(0);
+  ReceiveNeighborMessage(NUD_STALE, gateway_mac_);
+  EXPECT_FALSE(GetSendRequestCallback().IsCancelled());
+  Mock::VerifyAndClearExpectations(&observer_);
+
+  // A reachable gateway completes the pending cycle without an ARP reply.
+  ExpectNoTransmit();
+  EXPECT_CALL(*client_, Stop()).Times(1);
+  EXPECT_CALL(observer_, OnSuccessCallback()).Times(1);
+  ReceiveNeighborMessage(NUD_REACHABLE, gateway_mac_);
+  EXPECT_TRUE(GetSendRequestCallback().IsCancelled());
+  EXPECT_EQ(0, GetBroadcastFailureCount());
+  EXPECT_EQ(0, GetUnicastFailureCount());
+}
+
+TEST_F(ActiveLinkMonitorTest, NeighborReachableSuppressesProbes) {
+  FindGateway();
+  EXPECT_CALL(observer_, OnSuccessCallback()).Times(1);
+  ReceiveNeighborMessage(NUD_REACHABLE, gateway_mac_);
+  Mock::VerifyAndClearExpectations(&observer_);
+
+  // While the gateway stays reachable, new cycles succeed without probing.
+  StartMonitor();
+  ExpectNoTransmit();
+  EXPECT_CALL(observer_, OnSuccessCallback()).Times(1);
+  TriggerRequestTimer();
+  EXPECT_TRUE(GetSendRequestCallback().IsCancelled());
+  Mock::VerifyAndClearExpectations(client_);
+  Mock::VerifyAndClearExpectations(&observer_);
+
+  // Once the entry goes stale, probing resumes.
+  ReceiveNeighborMessage(NUD_STALE, gateway_mac_);
+  StartMonitor();
+  ExpectTransmit(true, GetDefaultTestPeriodMilliseconds());
+  EXPECT_CALL(observer_, OnSuccessCallback()).Times(0);
+  TriggerRequestTimer();
+}
+
+TEST_F(ActiveLinkMonitorTest, NeighborReachableBeforeGatewayFound) {
+  // Until ARP has found the gateway, kernel confirmations are not trusted.
+  StartMonitor();
+  ReceiveNeighborMessage(NUD_REACHABLE, gateway_mac_);
+  ExpectTransmit(false, GetDefaultTestPeriodMilliseconds());
+  EXPECT_CALL(observer_, OnSuccessCallback()).Times(0);
+  TriggerRequestTimer();
+}
+
 TEST_F(ActiveLinkMonitorTest, TimeoutBroadcast) {
   EXPECT_CALL(metrics_, SendToUMA(
       HasSubstr("LinkMonitorResponseTimeSample"),
@@ -141,6 +141,18 @@ Status ManagerBinderAdaptor::GetDevices(vector<sp<IBinder>>* _aidl_return) {
   return Status::ok();
 }
 
+Status ManagerBinderAdaptor::GetServicesWithProperties(
+    const vector<String16>& property_names,
+    bool include_hidden,
+    vector<android::os::PersistableBundle>* properties,
+    vector<sp<IBinder>>* _aidl_return) {
+  // There is no conversion from service properties to PersistableBundle yet,
+  // so fail explicitly rather than return an empty list that looks valid.
+  return Status::fromExceptionCode(
+      Status::EX_UNSUPPORTED_OPERATION,
+      String8("GetServicesWithProperties is not supported over Binder"));
+}
+
 Status ManagerBinderAdaptor::RegisterPropertyChangedSignalHandler(
     const sp<IPropertyChangedCallback>& callback) {
   AddPropertyChangedSignalHandler(callback);
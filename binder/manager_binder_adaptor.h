@@ -90,6 +90,11 @@ class ManagerBinderAdaptor
   android::binder::Status RequestScan(int32_t type);
   android::binder::Status GetDevices(
       ::std::vector<android::sp<android::IBinder>>* _aidl_return);
+  android::binder::Status GetServicesWithProperties(
+      const ::std::vector<android::String16>& property_names,
+      bool include_hidden,
+      ::std::vector<android::os::PersistableBundle>* properties,
+      ::std::vector<android::sp<android::IBinder>>* _aidl_return);
   android::binder::Status RegisterPropertyChangedSignalHandler(
       const android::sp<
           android::system::connectivity::shill::IPropertyChangedCallback>&
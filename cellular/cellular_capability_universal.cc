@@ -27,6 +27,7 @@
 #endif  // __ANDROID__
 #include <ModemManager/ModemManager.h>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -38,6 +39,7 @@
 #include "shill/dbus_properties_proxy_interface.h"
 #include "shill/error.h"
 #include "shill/logging.h"
+#include "shill/net/shill_time.h"
 #include "shill/pending_activation_store.h"
 #include "shill/property_accessor.h"
 
@@ -88,6 +90,9 @@ const char CellularCapabilityUniversal::kAltairLTEMMPlugin[] = "Altair LTE";
 const char CellularCapabilityUniversal::kNovatelLTEMMPlugin[] = "Novatel LTE";
 const int CellularCapabilityUniversal::kSetPowerStateTimeoutMilliseconds =
     20000;
+const int CellularCapabilityUniversal::kMinApnConnectTimeoutMilliseconds =
+    10000;
+const int CellularCapabilityUniversal::kApnConnectTimeoutMultiplier = 3;
 
 namespace {
 
@@ -144,6 +149,11 @@ string AccessTechnologyToTechnologyFamily(uint32_t access_technologies) {
   return "";
 }
 
+string GetApnName(const Stringmap& apn_info) {
+  Stringmap::const_iterator it = apn_info.find(kApnProperty);
+  return it == apn_info.end() ? "" : it->second;
+}
+
 }  // namespace
 
 CellularCapabilityUniversal::CellularCapabilityUniversal(
@@ -154,14 +164,19 @@ CellularCapabilityUniversal::CellularCapabilityUniversal(
       mobile_operator_info_(new MobileOperatorInfo(cellular->dispatcher(),
                                                    "ParseScanResult")),
       weak_ptr_factory_(this),
+      modem_properties_weak_ptr_factory_(this),
+      sim_properties_weak_ptr_factory_(this),
       registration_state_(MM_MODEM_3GPP_REGISTRATION_STATE_UNKNOWN),
       current_capabilities_(MM_MODEM_CAPABILITY_NONE),
       access_technologies_(MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN),
+      connect_start_time_{0, 0},
+      connect_timeout_milliseconds_(kTimeoutConnect),
       resetting_(false),
       subscription_state_(kSubscriptionStateUnknown),
       reset_done_(false),
       registration_dropped_update_timeout_milliseconds_(
-          kRegistrationDroppedUpdateTimeoutMilliseconds) {
+          kRegistrationDroppedUpdateTimeoutMilliseconds),
+      time_(Time::GetInstance()) {
   SLOG(this, 2) << "Cellular capability constructed: Universal";
   mobile_operator_info_->Init();
   HelpRegisterConstDerivedKeyValueStore(
@@ -286,8 +301,8 @@ void CellularCapabilityUniversal::EnableModemCompleted(
     return;
   }
 
-  // After modem is enabled, it should be possible to get properties
-  // TODO(jglasgow): handle errors from GetProperties
+  // After modem is enabled, it should be possible to get properties. They
+  // are fetched asynchronously and applied as the replies arrive.
   GetProperties();
   // We expect the modem to start scanning after it has been enabled.
   // Change this if this behavior is no longer the case in the future.
@@ -429,7 +444,10 @@ void CellularCapabilityUniversal::Connect(const KeyValueStore& properties,
   RpcIdentifierCallback cb = Bind(&CellularCapabilityUniversal::OnConnectReply,
                                   weak_ptr_factory_.GetWeakPtr(),
                                   callback);
-  modem_simple_proxy_->Connect(properties, error, cb, kTimeoutConnect);
+  connect_timeout_milliseconds_ = GetApnConnectTimeout();
+  time_->GetTimeMonotonic(&connect_start_time_);
+  modem_simple_proxy_->Connect(properties, error, cb,
+                               connect_timeout_milliseconds_);
 }
 
 void CellularCapabilityUniversal::Disconnect(Error* error,
@@ -591,6 +609,8 @@ void CellularCapabilityUniversal::ReleaseProxies() {
   modem_proxy_.reset();
   modem_simple_proxy_.reset();
   sim_proxy_.reset();
+  ReleaseModemPropertiesProxy();
+  ReleaseSimPropertiesProxy();
 }
 
 bool CellularCapabilityUniversal::AreProxiesInitialized() const {
@@ -652,23 +672,80 @@ void CellularCapabilityUniversal::OnServiceCreated() {
 //   current network (if any)
 // - the APN, if any, that was set by the user
 // - the list of APNs found in the mobile broadband provider DB for the
-//   home provider associated with the current SIM
+//   home provider associated with the current SIM, ranked by how well
+//   they have worked on the current network before
 // - as a last resort, attempt to connect with no APN
 void CellularCapabilityUniversal::SetupApnTryList() {
   apn_try_list_.clear();
 
-  DCHECK(cellular()->service().get());
-  const Stringmap* apn_info = cellular()->service()->GetLastGoodApn();
+  CellularServiceRefPtr service = cellular()->service();
+  DCHECK(service.get());
+  const Stringmap* apn_info = service->GetLastGoodApn();
   if (apn_info)
     apn_try_list_.push_back(*apn_info);
 
-  apn_info = cellular()->service()->GetUserSpecifiedApn();
+  apn_info = service->GetUserSpecifiedApn();
   if (apn_info)
     apn_try_list_.push_back(*apn_info);
 
-  apn_try_list_.insert(apn_try_list_.end(),
-                       cellular()->apn_list().begin(),
-                       cellular()->apn_list().end());
+  // Rank by success rate, with one success and one failure assumed for
+  // every APN so that untried APNs sit between the ones that have worked
+  // and the ones that have been rejected.  Faster APNs win ties; otherwise
+  // the database order is kept.
+  vector<Stringmap> ranked(cellular()->apn_list());
+  auto success_rate = [](const CellularService::ApnConnectStats* stats) {
+    if (!stats)
+      return 0.5;
+    return (stats->successes + 1.0) / (stats->successes + stats->failures + 2);
+  };
+  std::stable_sort(
+      ranked.begin(), ranked.end(),
+      [&service, &success_rate](const Stringmap& lhs, const Stringmap& rhs) {
+        const CellularService::ApnConnectStats* lhs_stats =
+            service->GetApnConnectStats(GetApnName(lhs));
+        const CellularService::ApnConnectStats* rhs_stats =
+            service->GetApnConnectStats(GetApnName(rhs));
+        double lhs_rate = success_rate(lhs_stats);
+        double rhs_rate = success_rate(rhs_stats);
+        if (lhs_rate != rhs_rate)
+          return lhs_rate > rhs_rate;
+        if (lhs_stats && rhs_stats && lhs_stats->successes > 0 &&
+            rhs_stats->successes > 0) {
+          return lhs_stats->average_connect_ms < rhs_stats->average_connect_ms;
+        }
+        return false;
+      });
+  apn_try_list_.insert(apn_try_list_.end(), ranked.begin(), ranked.end());
+}
+
+int CellularCapabilityUniversal::GetApnConnectTimeout() const {
+  // Never cut short the last attempt, since there is nothing to fall back
+  // to if it is abandoned.
+  CellularServiceRefPtr service = cellular()->service();
+  if (!service || apn_try_list_.size() < 2)
+    return kTimeoutConnect;
+
+  // Allow a multiple of the time this APN usually takes, or of the longest
+  // any APN has taken on this network if this one has never succeeded.
+  const CellularService::ApnConnectStats* stats = service->GetApnConnectStats(
+      GetApnName(apn_try_list_.front()));
+  int64_t expected_milliseconds =
+      (stats && stats->successes > 0) ?
+      stats->average_connect_ms : service->GetLongestAverageApnConnectTime();
+  if (expected_milliseconds <= 0)
+    return kTimeoutConnect;
+  int64_t timeout_milliseconds =
+      expected_milliseconds * kApnConnectTimeoutMultiplier;
+  return static_cast<int>(std::max<int64_t>(
+      kMinApnConnectTimeoutMilliseconds,
+      std::min<int64_t>(timeout_milliseconds, kTimeoutConnect)));
+}
+
+int64_t CellularCapabilityUniversal::GetConnectAttemptDuration() const {
+  struct timeval now, elapsed;
+  time_->GetTimeMonotonic(&now);
+  timersub(&now, &connect_start_time_, &elapsed);
+  return elapsed.tv_sec * 1000 + elapsed.tv_usec / 1000;
 }
 
 void CellularCapabilityUniversal::SetupConnectProperties(
@@ -710,22 +787,52 @@ void CellularCapabilityUniversal::OnConnectReply(const ResultCallback& callback,
     apn_try_list_.clear();
   } else if (error.IsFailure()) {
     service->ClearLastGoodApn();
+    int64_t connect_milliseconds = GetConnectAttemptDuration();
+    // An attempt that outlived a timeout shortened from what was learned
+    // about this network is abandoned in favor of the remaining APNs.
+    bool deadline_expired =
+        connect_timeout_milliseconds_ < kTimeoutConnect &&
+        connect_milliseconds >= connect_timeout_milliseconds_;
+    bool retriable = RetriableConnectError(error);
+    if (!apn_try_list_.empty() && (retriable || deadline_expired)) {
+      service->RecordApnConnectResult(
+          GetApnName(apn_try_list_.front()),
+          false,
+          connect_milliseconds);
+    }
     // The APN that was just tried (and failed) is still at the
     // front of the list, about to be removed. If the list is empty
     // after that, try one last time without an APN. This may succeed
     // with some modems in some cases.
-    if (RetriableConnectError(error) && !apn_try_list_.empty()) {
+    if (deadline_expired && !apn_try_list_.empty() && modem_simple_proxy_) {
+      apn_try_list_.pop_front();
+      SLOG(this, 2) << "Connect timed out after " << connect_milliseconds
+                    << " ms, " << apn_try_list_.size()
+                    << " remaining APNs to try";
+      // ModemManager may still be working on the abandoned attempt, so
+      // tear it down before trying the next APN.
+      Error disconnect_error;
+      Disconnect(&disconnect_error,
+                 Bind(&CellularCapabilityUniversal::OnAbandonedConnectTornDown,
+                      weak_ptr_factory_.GetWeakPtr(),
+                      callback));
+      if (disconnect_error.IsFailure())
+        ConnectToNextApn(callback);
+      return;
+    }
+    if (retriable && !apn_try_list_.empty()) {
       apn_try_list_.pop_front();
       SLOG(this, 2) << "Connect failed with invalid APN, "
                     << apn_try_list_.size() << " remaining APNs to try";
-      KeyValueStore props;
-      FillConnectPropertyMap(&props);
-      Error error;
-      Connect(props, &error, callback);
+      ConnectToNextApn(callback);
       return;
     }
   } else {
     if (!apn_try_list_.empty()) {
+      service->RecordApnConnectResult(
+          GetApnName(apn_try_list_.front()),
+          true,
+          GetConnectAttemptDuration());
       service->SetLastGoodApn(apn_try_list_.front());
       apn_try_list_.clear();
     }
@@ -738,6 +845,21 @@ void CellularCapabilityUniversal::OnConnectReply(const ResultCallback& callback,
   UpdatePendingActivationState();
 }
 
+void CellularCapabilityUniversal::ConnectToNextApn(
+    const ResultCallback& callback) {
+  KeyValueStore props;
+  FillConnectPropertyMap(&props);
+  Error error;
+  Connect(props, &error, callback);
+}
+
+void CellularCapabilityUniversal::OnAbandonedConnectTornDown(
+    const ResultCallback& callback,
+    const Error& error) {
+  SLOG(this, 3) << __func__ << "(" << error << ")";
+  ConnectToNextApn(callback);
+}
+
 bool CellularCapabilityUniversal::AllowRoaming() {
   return cellular()->provider_requires_roaming() || allow_roaming_property();
 }
@@ -745,16 +867,60 @@ bool CellularCapabilityUniversal::AllowRoaming() {
 void CellularCapabilityUniversal::GetProperties() {
   SLOG(this, 3) << __func__;
 
-  std::unique_ptr<DBusPropertiesProxyInterface> properties_proxy(
+  ReleaseModemPropertiesProxy();
+  modem_properties_proxy_.reset(
       control_interface()->CreateDBusPropertiesProxy(
           cellular()->dbus_path(), cellular()->dbus_service()));
+  GetModemPropertiesAsync(MM_DBUS_INTERFACE_MODEM);
+  GetModemPropertiesAsync(MM_DBUS_INTERFACE_MODEM_MODEM3GPP);
+}
+
+void CellularCapabilityUniversal::GetModemPropertiesAsync(
+    const string& interface) {
+  SLOG(this, 3) << __func__ << "(" << interface << ")";
+  CHECK(modem_properties_proxy_);
+  modem_properties_proxy_->GetAllAsync(
+      interface,
+      Bind(&CellularCapabilityUniversal::OnPropertiesFetched,
+           modem_properties_weak_ptr_factory_.GetWeakPtr(),
+           interface));
+}
+
+void CellularCapabilityUniversal::GetSimPropertiesAsync() {
+  SLOG(this, 3) << __func__ << "(" << sim_path_ << ")";
+  // Replacing the proxy drops the reply to any request made for an earlier
+  // SIM, so a slow reply can not overwrite newer SIM state.
+  ReleaseSimPropertiesProxy();
+  sim_properties_proxy_.reset(
+      control_interface()->CreateDBusPropertiesProxy(
+          sim_path_, cellular()->dbus_service()));
+  sim_properties_proxy_->GetAllAsync(
+      MM_DBUS_INTERFACE_SIM,
+      Bind(&CellularCapabilityUniversal::OnPropertiesFetched,
+           sim_properties_weak_ptr_factory_.GetWeakPtr(),
+           string(MM_DBUS_INTERFACE_SIM)));
+}
+
+void CellularCapabilityUniversal::OnPropertiesFetched(
+    const string& interface,
+    const KeyValueStore& properties,
+    const Error& error) {
+  SLOG(this, 3) << __func__ << "(" << interface << ")";
+  if (error.IsFailure()) {
+    LOG(ERROR) << "Failed to get " << interface << " properties: " << error;
+    return;
+  }
+  OnPropertiesChanged(interface, properties, vector<string>());
+}
 
-  KeyValueStore properties(
-      properties_proxy->GetAll(MM_DBUS_INTERFACE_MODEM));
-  OnModemPropertiesChanged(properties, vector<string>());
+void CellularCapabilityUniversal::ReleaseModemPropertiesProxy() {
+  modem_properties_weak_ptr_factory_.InvalidateWeakPtrs();
+  modem_properties_proxy_.reset();
+}
 
-  properties = properties_proxy->GetAll(MM_DBUS_INTERFACE_MODEM_MODEM3GPP);
-  OnModem3GPPPropertiesChanged(properties, vector<string>());
+void CellularCapabilityUniversal::ReleaseSimPropertiesProxy() {
+  sim_properties_weak_ptr_factory_.InvalidateWeakPtrs();
+  sim_properties_proxy_.reset();
 }
 
 void CellularCapabilityUniversal::UpdateServiceOLP() {
@@ -1311,14 +1477,10 @@ void CellularCapabilityUniversal::OnSimPathChanged(
     OnSimIdentifierChanged("");
     OnOperatorIdChanged("");
     cellular()->home_provider_info()->Reset();
+    ReleaseSimPropertiesProxy();
   } else {
     cellular()->set_sim_present(true);
-    std::unique_ptr<DBusPropertiesProxyInterface> properties_proxy(
-        control_interface()->CreateDBusPropertiesProxy(
-            sim_path, cellular()->dbus_service()));
-    // TODO(jglasgow): convert to async interface
-    KeyValueStore properties(properties_proxy->GetAll(MM_DBUS_INTERFACE_SIM));
-    OnSimPropertiesChanged(properties, vector<string>());
+    GetSimPropertiesAsync();
   }
 }
 
@@ -1450,12 +1612,7 @@ void CellularCapabilityUniversal::OnSimLockStatusChanged() {
   if (IsValidSimPath(sim_path_) &&
       (sim_lock_status_.lock_type == MM_MODEM_LOCK_NONE ||
        sim_lock_status_.lock_type == MM_MODEM_LOCK_UNKNOWN)) {
-    std::unique_ptr<DBusPropertiesProxyInterface> properties_proxy(
-        control_interface()->CreateDBusPropertiesProxy(
-            sim_path_, cellular()->dbus_service()));
-    KeyValueStore properties(
-        properties_proxy->GetAll(MM_DBUS_INTERFACE_SIM));
-    OnSimPropertiesChanged(properties, vector<string>());
+    GetSimPropertiesAsync();
   }
 }
 
@@ -17,6 +17,8 @@
 #ifndef SHILL_CELLULAR_CELLULAR_CAPABILITY_UNIVERSAL_H_
 #define SHILL_CELLULAR_CELLULAR_CAPABILITY_UNIVERSAL_H_
 
+#include <sys/time.h>
+
 #include <deque>
 #include <map>
 #include <string>
@@ -36,12 +38,14 @@
 #include "shill/cellular/mm1_modem_simple_proxy_interface.h"
 #include "shill/cellular/mm1_sim_proxy_interface.h"
 #include "shill/cellular/out_of_credits_detector.h"
+#include "shill/dbus_properties_proxy_interface.h"
 
 struct mobile_provider;
 
 namespace shill {
 
 class ModemInfo;
+class Time;
 
 // CellularCapabilityUniversal handles modems using the
 // org.chromium.ModemManager1 DBUS interface.  This class is used for
@@ -135,6 +139,12 @@ class CellularCapabilityUniversal : public CellularCapability {
   // TODO(armansito): Put this method in a 3GPP-only subclass.
   virtual void OnSimPathChanged(const std::string& sim_path);
 
+  // Requests all properties of |interface| on the modem object without
+  // blocking. Requests for different interfaces are in flight concurrently;
+  // each reply is applied through OnPropertiesChanged as it arrives.
+  // GetProperties must have created |modem_properties_proxy_| first.
+  void GetModemPropertiesAsync(const std::string& interface);
+
   // Updates the online payment portal information, if any, for the cellular
   // provider.
   void UpdateServiceOLP() override;
@@ -177,6 +187,8 @@ class CellularCapabilityUniversal : public CellularCapability {
   static const int64_t kEnterPinTimeoutMilliseconds;
   static const int64_t kRegistrationDroppedUpdateTimeoutMilliseconds;
   static const int kSetPowerStateTimeoutMilliseconds;
+  static const int kMinApnConnectTimeoutMilliseconds;
+  static const int kApnConnectTimeoutMultiplier;
 
 
   // Root path. The SIM path is reported by ModemManager to be the root path
@@ -193,11 +205,15 @@ class CellularCapabilityUniversal : public CellularCapability {
               ActivationWaitForRegisterTimeout);
   FRIEND_TEST(CellularCapabilityUniversalMainTest, Connect);
   FRIEND_TEST(CellularCapabilityUniversalMainTest, ConnectApns);
+  FRIEND_TEST(CellularCapabilityUniversalMainTest, ConnectApnDeadlineExpired);
+  FRIEND_TEST(CellularCapabilityUniversalMainTest, ConnectRecordsApnStats);
+  FRIEND_TEST(CellularCapabilityUniversalMainTest, GetApnConnectTimeout);
   FRIEND_TEST(CellularCapabilityUniversalMainTest, DisconnectNoProxy);
   FRIEND_TEST(CellularCapabilityUniversalMainTest,
               DisconnectWithDeferredCallback);
   FRIEND_TEST(CellularCapabilityUniversalMainTest, ExtractPcoValue);
   FRIEND_TEST(CellularCapabilityUniversalMainTest, GetMdnForOLP);
+  FRIEND_TEST(CellularCapabilityUniversalMainTest, GetPropertiesAsync);
   FRIEND_TEST(CellularCapabilityUniversalMainTest,
               GetNetworkTechnologyStringOnE362);
   FRIEND_TEST(CellularCapabilityUniversalMainTest,
@@ -217,9 +233,11 @@ class CellularCapabilityUniversal : public CellularCapability {
   FRIEND_TEST(CellularCapabilityUniversalMainTest, Reset);
   FRIEND_TEST(CellularCapabilityUniversalMainTest, Scan);
   FRIEND_TEST(CellularCapabilityUniversalMainTest, ScanFailure);
+  FRIEND_TEST(CellularCapabilityUniversalMainTest, SetupApnTryListRanking);
   FRIEND_TEST(CellularCapabilityUniversalMainTest, SimLockStatusChanged);
   FRIEND_TEST(CellularCapabilityUniversalMainTest, SimLockStatusToProperty);
   FRIEND_TEST(CellularCapabilityUniversalMainTest, SimPathChanged);
+  FRIEND_TEST(CellularCapabilityUniversalMainTest, SimPropertiesProxyLifetime);
   FRIEND_TEST(CellularCapabilityUniversalMainTest, SimPropertiesChanged);
   FRIEND_TEST(CellularCapabilityUniversalMainTest, StartModem);
   FRIEND_TEST(CellularCapabilityUniversalMainTest, StartModemFailure);
@@ -304,6 +322,19 @@ class CellularCapabilityUniversal : public CellularCapability {
   void SetupApnTryList();
   void FillConnectPropertyMap(KeyValueStore* properties);
 
+  // Returns the timeout for a connect attempt using the APN at the front of
+  // |apn_try_list_|, derived from how long successful connects have taken on
+  // the current network.  Returns kTimeoutConnect when there is nothing to
+  // learn from, or when no other APN is left to fall back to.
+  int GetApnConnectTimeout() const;
+  // Returns the number of milliseconds since the current connect attempt
+  // was issued.
+  int64_t GetConnectAttemptDuration() const;
+  // Tries the APN now at the front of |apn_try_list_|.
+  void ConnectToNextApn(const ResultCallback& callback);
+  void OnAbandonedConnectTornDown(const ResultCallback& callback,
+                                  const Error& error);
+
   void HelpRegisterConstDerivedKeyValueStore(
       const std::string& name,
       KeyValueStore(CellularCapabilityUniversal::*get)(Error* error));
@@ -340,6 +371,21 @@ class CellularCapabilityUniversal : public CellularCapability {
   void OnLockTypeChanged(MMModemLock unlock_required);
   void OnSimLockStatusChanged();
 
+  // Requests the properties of the SIM at |sim_path_| without blocking. Any
+  // earlier SIM request still in flight is dropped.
+  void GetSimPropertiesAsync();
+
+  // Completion handler for asynchronous GetAll requests on |interface|.
+  void OnPropertiesFetched(const std::string& interface,
+                           const KeyValueStore& properties,
+                           const Error& error);
+
+  // Release a properties proxy and drop the replies to any GetAll requests
+  // still in flight on it, so that a late reply can not overwrite state
+  // reported since.
+  void ReleaseModemPropertiesProxy();
+  void ReleaseSimPropertiesProxy();
+
   // Returns false if the MDN is empty or if the MDN consists of all 0s.
   bool IsMdnValid() const;
 
@@ -406,12 +452,21 @@ class CellularCapabilityUniversal : public CellularCapability {
   std::unique_ptr<mm1::ModemProxyInterface> modem_proxy_;
   std::unique_ptr<mm1::ModemSimpleProxyInterface> modem_simple_proxy_;
   std::unique_ptr<mm1::SimProxyInterface> sim_proxy_;
+  // Held for as long as a GetAll request on them may be outstanding.
+  std::unique_ptr<DBusPropertiesProxyInterface> modem_properties_proxy_;
+  std::unique_ptr<DBusPropertiesProxyInterface> sim_properties_proxy_;
   // Used to enrich information about the network operator in |ParseScanResult|.
   // TODO(pprabhu) Instead instantiate a local |MobileOperatorInfo| instance
   // once the context has been separated out. (crbug.com/363874)
   std::unique_ptr<MobileOperatorInfo> mobile_operator_info_;
 
   base::WeakPtrFactory<CellularCapabilityUniversal> weak_ptr_factory_;
+  // Bound to GetAll requests on |modem_properties_proxy_| and
+  // |sim_properties_proxy_| respectively.
+  base::WeakPtrFactory<CellularCapabilityUniversal>
+      modem_properties_weak_ptr_factory_;
+  base::WeakPtrFactory<CellularCapabilityUniversal>
+      sim_properties_weak_ptr_factory_;
 
   MMModem3gppRegistrationState registration_state_;
 
@@ -428,6 +483,9 @@ class CellularCapabilityUniversal : public CellularCapability {
 
   // Properties.
   std::deque<Stringmap> apn_try_list_;
+  // Start time and timeout of the connect attempt in flight.
+  struct timeval connect_start_time_;
+  int connect_timeout_milliseconds_;
   bool resetting_;
   SimLockStatus sim_lock_status_;
   SubscriptionState subscription_state_;
@@ -446,6 +504,8 @@ class CellularCapabilityUniversal : public CellularCapability {
   base::CancelableClosure registration_dropped_update_callback_;
   int64_t registration_dropped_update_timeout_milliseconds_;
 
+  Time* time_;
+
   DISALLOW_COPY_AND_ASSIGN(CellularCapabilityUniversal);
 };
 
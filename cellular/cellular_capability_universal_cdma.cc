@@ -28,7 +28,6 @@
 #include "shill/cellular/cellular_bearer.h"
 #include "shill/cellular/cellular_service.h"
 #include "shill/control_interface.h"
-#include "shill/dbus_properties_proxy_interface.h"
 #include "shill/error.h"
 #include "shill/logging.h"
 #include "shill/pending_activation_store.h"
@@ -258,14 +257,7 @@ void CellularCapabilityUniversalCDMA::UpdateServiceOLP() {
 void CellularCapabilityUniversalCDMA::GetProperties() {
   SLOG(this, 2) << __func__;
   CellularCapabilityUniversal::GetProperties();
-
-  std::unique_ptr<DBusPropertiesProxyInterface> properties_proxy(
-      control_interface()->CreateDBusPropertiesProxy(
-          cellular()->dbus_path(), cellular()->dbus_service()));
-
-  KeyValueStore properties(
-      properties_proxy->GetAll(MM_DBUS_INTERFACE_MODEM_MODEMCDMA));
-  OnModemCDMAPropertiesChanged(properties, vector<string>());
+  GetModemPropertiesAsync(MM_DBUS_INTERFACE_MODEM_MODEMCDMA);
 }
 
 void CellularCapabilityUniversalCDMA::OnActivationStateChangedSignal(
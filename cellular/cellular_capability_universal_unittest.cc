@@ -50,6 +50,7 @@
 #include "shill/mock_pending_activation_store.h"
 #include "shill/mock_profile.h"
 #include "shill/net/mock_rtnl_handler.h"
+#include "shill/net/mock_time.h"
 #include "shill/test_event_dispatcher.h"
 #include "shill/testing.h"
 
@@ -68,6 +69,7 @@ using testing::NiceMock;
 using testing::Return;
 using testing::ReturnRef;
 using testing::SaveArg;
+using testing::SetArgumentPointee;
 using testing::_;
 
 namespace shill {
@@ -159,28 +161,33 @@ class CellularCapabilityUniversalTest : public testing::TestWithParam<string> {
 
   void ExpectModemAndModem3gppProperties() {
     // Set up mock modem properties.
-    KeyValueStore modem_properties;
-    string operator_name = "TestOperator";
-    string operator_code = "001400";
-
-    modem_properties.SetUint(MM_MODEM_PROPERTY_ACCESSTECHNOLOGIES,
-                             kAccessTechnologies);
+    modem_properties_.Clear();
+    modem_properties_.SetUint(MM_MODEM_PROPERTY_ACCESSTECHNOLOGIES,
+                              kAccessTechnologies);
     std::tuple<uint32_t, bool> signal_signal { 90, true };
-    modem_properties.Set(MM_MODEM_PROPERTY_SIGNALQUALITY,
-                         brillo::Any(signal_signal));
+    modem_properties_.Set(MM_MODEM_PROPERTY_SIGNALQUALITY,
+                          brillo::Any(signal_signal));
 
     // Set up mock modem 3gpp properties.
-    KeyValueStore modem3gpp_properties;
-    modem3gpp_properties.SetUint(
+    modem3gpp_properties_.Clear();
+    modem3gpp_properties_.SetUint(
         MM_MODEM_MODEM3GPP_PROPERTY_ENABLEDFACILITYLOCKS, 0);
-    modem3gpp_properties.SetString(MM_MODEM_MODEM3GPP_PROPERTY_IMEI, kImei);
+    modem3gpp_properties_.SetString(MM_MODEM_MODEM3GPP_PROPERTY_IMEI, kImei);
 
     EXPECT_CALL(*properties_proxy_,
-                GetAll(MM_DBUS_INTERFACE_MODEM))
-        .WillOnce(Return(modem_properties));
+                GetAllAsync(MM_DBUS_INTERFACE_MODEM, _))
+        .WillOnce(SaveArg<1>(&modem_properties_callback_));
     EXPECT_CALL(*properties_proxy_,
-                GetAll(MM_DBUS_INTERFACE_MODEM_MODEM3GPP))
-        .WillOnce(Return(modem3gpp_properties));
+                GetAllAsync(MM_DBUS_INTERFACE_MODEM_MODEM3GPP, _))
+        .WillOnce(SaveArg<1>(&modem3gpp_properties_callback_));
+  }
+
+  // Completes the requests set up by ExpectModemAndModem3gppProperties().
+  void ReplyWithModemAndModem3gppProperties() {
+    ASSERT_FALSE(modem_properties_callback_.is_null());
+    ASSERT_FALSE(modem3gpp_properties_callback_.is_null());
+    modem_properties_callback_.Run(modem_properties_, Error());
+    modem3gpp_properties_callback_.Run(modem3gpp_properties_, Error());
   }
 
   void InvokeEnable(bool enable, Error* error,
@@ -346,6 +353,11 @@ class CellularCapabilityUniversalTest : public testing::TestWithParam<string> {
   MockCellularService* service_;  // owned by cellular_
   // saved for testing connect operations.
   RpcIdentifierCallback connect_callback_;
+  // Saved by ExpectModemAndModem3gppProperties().
+  KeyValueStore modem_properties_;
+  KeyValueStore modem3gpp_properties_;
+  KeyValueStoreCallback modem_properties_callback_;
+  KeyValueStoreCallback modem3gpp_properties_callback_;
 
   // Set when required and passed to |cellular_|. Owned by |cellular_|.
   MockMobileOperatorInfo* mock_home_provider_info_;
@@ -400,8 +412,11 @@ TEST_F(CellularCapabilityUniversalMainTest, StartModem) {
   ResultCallback callback =
       Bind(&CellularCapabilityUniversalTest::TestCallback, Unretained(this));
   capability_->StartModem(&error, callback);
-
   EXPECT_TRUE(error.IsOngoing());
+
+  // The properties are applied once ModemManager replies with them.
+  EXPECT_TRUE(cellular_->imei().empty());
+  ReplyWithModemAndModem3gppProperties();
   EXPECT_EQ(kImei, cellular_->imei());
   EXPECT_EQ(kAccessTechnologies, capability_->access_technologies_);
 }
@@ -411,8 +426,10 @@ TEST_F(CellularCapabilityUniversalMainTest, StartModemFailure) {
               Enable(true, _, _, CellularCapability::kTimeoutEnable))
       .WillOnce(Invoke(
            this, &CellularCapabilityUniversalTest::InvokeEnableFail));
-  EXPECT_CALL(*properties_proxy_, GetAll(MM_DBUS_INTERFACE_MODEM)).Times(0);
-  EXPECT_CALL(*properties_proxy_, GetAll(MM_DBUS_INTERFACE_MODEM_MODEM3GPP))
+  EXPECT_CALL(*properties_proxy_, GetAllAsync(MM_DBUS_INTERFACE_MODEM, _))
+      .Times(0);
+  EXPECT_CALL(*properties_proxy_,
+              GetAllAsync(MM_DBUS_INTERFACE_MODEM_MODEM3GPP, _))
       .Times(0);
 
   Error error;
@@ -463,6 +480,7 @@ TEST_F(CellularCapabilityUniversalMainTest, StartModemInWrongState) {
   // Change the state of the modem to disabled and verify that it gets enabled.
   EXPECT_CALL(*this, TestCallback(IsSuccess()));
   capability_->OnModemStateChanged(Cellular::kModemStateDisabled);
+  ReplyWithModemAndModem3gppProperties();
   EXPECT_EQ(kImei, cellular_->imei());
   EXPECT_EQ(kAccessTechnologies, capability_->access_technologies_);
 }
@@ -474,8 +492,10 @@ TEST_F(CellularCapabilityUniversalMainTest,
       .Times(2)
       .WillRepeatedly(Invoke(
            this, &CellularCapabilityUniversalTest::InvokeEnableInWrongState));
-  EXPECT_CALL(*properties_proxy_, GetAll(MM_DBUS_INTERFACE_MODEM)).Times(0);
-  EXPECT_CALL(*properties_proxy_, GetAll(MM_DBUS_INTERFACE_MODEM_MODEM3GPP))
+  EXPECT_CALL(*properties_proxy_, GetAllAsync(MM_DBUS_INTERFACE_MODEM, _))
+      .Times(0);
+  EXPECT_CALL(*properties_proxy_,
+              GetAllAsync(MM_DBUS_INTERFACE_MODEM_MODEM3GPP, _))
       .Times(0);
 
   Error error;
@@ -794,8 +814,9 @@ TEST_F(CellularCapabilityUniversalMainTest, SimLockStatusChanged) {
                            kOperatorIdentifier);
   sim_properties.SetString(MM_SIM_PROPERTY_OPERATORNAME, kOperatorName);
 
-  EXPECT_CALL(*properties_proxy_, GetAll(MM_DBUS_INTERFACE_SIM))
-      .WillOnce(Return(sim_properties));
+  KeyValueStoreCallback sim_callback;
+  EXPECT_CALL(*properties_proxy_, GetAllAsync(MM_DBUS_INTERFACE_SIM, _))
+      .WillOnce(SaveArg<1>(&sim_callback));
   EXPECT_CALL(*modem_info_.mock_pending_activation_store(),
               GetActivationState(PendingActivationStore::kIdentifierICCID, _))
       .Times(1);
@@ -804,6 +825,8 @@ TEST_F(CellularCapabilityUniversalMainTest, SimLockStatusChanged) {
   EXPECT_EQ(nullptr, capability_->sim_proxy_);;
 
   capability_->OnSimPathChanged(kSimPath);
+  ASSERT_FALSE(sim_callback.is_null());
+  sim_callback.Run(sim_properties, Error());
   EXPECT_TRUE(cellular_->sim_present());
   EXPECT_NE(nullptr, capability_->sim_proxy_);;
   EXPECT_EQ(kSimPath, capability_->sim_path_);
@@ -823,14 +846,17 @@ TEST_F(CellularCapabilityUniversalMainTest, SimLockStatusChanged) {
 
   // SIM is unlocked.
   properties_proxy_.reset(new MockDBusPropertiesProxy());
-  EXPECT_CALL(*properties_proxy_, GetAll(MM_DBUS_INTERFACE_SIM))
-      .WillOnce(Return(sim_properties));
+  sim_callback.Reset();
+  EXPECT_CALL(*properties_proxy_, GetAllAsync(MM_DBUS_INTERFACE_SIM, _))
+      .WillOnce(SaveArg<1>(&sim_callback));
   EXPECT_CALL(*modem_info_.mock_pending_activation_store(),
               GetActivationState(PendingActivationStore::kIdentifierICCID, _))
       .Times(1);
 
   capability_->sim_lock_status_.lock_type = MM_MODEM_LOCK_NONE;
   capability_->OnSimLockStatusChanged();
+  ASSERT_FALSE(sim_callback.is_null());
+  sim_callback.Run(sim_properties, Error());
   Mock::VerifyAndClearExpectations(modem_info_.mock_pending_activation_store());
 
   EXPECT_EQ(kImsi, cellular_->imsi());
@@ -881,12 +907,7 @@ TEST_F(CellularCapabilityUniversalMainTest, PropertiesChanged) {
                                0);
   modem3gpp_properties.SetString(MM_MODEM_MODEM3GPP_PROPERTY_IMEI, kImei);
 
-  // Set up mock modem sim properties
-  KeyValueStore sim_properties;
-
-  EXPECT_CALL(*properties_proxy_,
-              GetAll(MM_DBUS_INTERFACE_SIM))
-      .WillOnce(Return(sim_properties));
+  EXPECT_CALL(*properties_proxy_, GetAllAsync(MM_DBUS_INTERFACE_SIM, _));
 
   EXPECT_EQ("", cellular_->imei());
   EXPECT_EQ(MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN,
@@ -950,6 +971,86 @@ TEST_F(CellularCapabilityUniversalMainTest, PropertiesChanged) {
                                    vector<string>());
 }
 
+TEST_F(CellularCapabilityUniversalMainTest, GetPropertiesAsync) {
+  KeyValueStoreCallback modem_callback;
+  KeyValueStoreCallback modem3gpp_callback;
+  EXPECT_CALL(*properties_proxy_, GetAll(_)).Times(0);
+  EXPECT_CALL(*properties_proxy_, GetAllAsync(MM_DBUS_INTERFACE_MODEM, _))
+      .WillOnce(SaveArg<1>(&modem_callback));
+  EXPECT_CALL(*properties_proxy_,
+              GetAllAsync(MM_DBUS_INTERFACE_MODEM_MODEM3GPP, _))
+      .WillOnce(SaveArg<1>(&modem3gpp_callback));
+  capability_->GetProperties();
+
+  // Both requests are outstanding before either reply has arrived.
+  ASSERT_FALSE(modem_callback.is_null());
+  ASSERT_FALSE(modem3gpp_callback.is_null());
+  EXPECT_TRUE(capability_->modem_properties_proxy_);
+
+  // Replies are applied in whatever order they arrive.
+  KeyValueStore modem3gpp_properties;
+  modem3gpp_properties.SetString(MM_MODEM_MODEM3GPP_PROPERTY_IMEI, kImei);
+  modem3gpp_callback.Run(modem3gpp_properties, Error());
+  EXPECT_EQ(kImei, cellular_->imei());
+
+  // A failed request leaves the existing state alone.
+  KeyValueStore modem_properties;
+  modem_properties.SetUint(MM_MODEM_PROPERTY_ACCESSTECHNOLOGIES,
+                           kAccessTechnologies);
+  modem_callback.Run(modem_properties, Error(Error::kOperationFailed));
+  EXPECT_EQ(MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN,
+            capability_->access_technologies_);
+
+  modem_callback.Run(modem_properties, Error());
+  EXPECT_EQ(kAccessTechnologies, capability_->access_technologies_);
+
+  capability_->ReleaseProxies();
+  EXPECT_FALSE(capability_->modem_properties_proxy_);
+}
+
+TEST_F(CellularCapabilityUniversalMainTest, GetPropertiesReplyAfterRelease) {
+  KeyValueStoreCallback modem3gpp_callback;
+  EXPECT_CALL(*properties_proxy_, GetAllAsync(MM_DBUS_INTERFACE_MODEM, _));
+  EXPECT_CALL(*properties_proxy_,
+              GetAllAsync(MM_DBUS_INTERFACE_MODEM_MODEM3GPP, _))
+      .WillOnce(SaveArg<1>(&modem3gpp_callback));
+  capability_->GetProperties();
+  ASSERT_FALSE(modem3gpp_callback.is_null());
+
+  // The proxies are released while the request is outstanding, and a
+  // PropertiesChanged signal reports a newer value in the meantime.
+  capability_->ReleaseProxies();
+  KeyValueStore modem3gpp_properties;
+  modem3gpp_properties.SetString(MM_MODEM_MODEM3GPP_PROPERTY_IMEI, kImei);
+  capability_->OnPropertiesChanged(MM_DBUS_INTERFACE_MODEM_MODEM3GPP,
+                                   modem3gpp_properties,
+                                   vector<string>());
+  EXPECT_EQ(kImei, cellular_->imei());
+
+  // The late reply must not overwrite it.
+  KeyValueStore stale_properties;
+  stale_properties.SetString(MM_MODEM_MODEM3GPP_PROPERTY_IMEI, "000000000000");
+  modem3gpp_callback.Run(stale_properties, Error());
+  EXPECT_EQ(kImei, cellular_->imei());
+}
+
+TEST_F(CellularCapabilityUniversalMainTest, SimPropertiesProxyLifetime) {
+  KeyValueStoreCallback sim_callback;
+  EXPECT_CALL(*properties_proxy_, GetAllAsync(MM_DBUS_INTERFACE_SIM, _))
+      .WillOnce(SaveArg<1>(&sim_callback));
+  capability_->OnSimPathChanged(kSimPath);
+  EXPECT_TRUE(capability_->sim_properties_proxy_);
+  ASSERT_FALSE(sim_callback.is_null());
+
+  // Losing the SIM drops the SIM request that is still in flight.
+  capability_->OnSimPathChanged("");
+  EXPECT_FALSE(capability_->sim_properties_proxy_);
+  KeyValueStore sim_properties;
+  sim_properties.SetString(MM_SIM_PROPERTY_IMSI, "310100000001");
+  sim_callback.Run(sim_properties, Error());
+  EXPECT_EQ("", cellular_->imsi());
+}
+
 TEST_F(CellularCapabilityUniversalMainTest, UpdateRegistrationState) {
   capability_->InitProxies();
 
@@ -1171,8 +1272,9 @@ TEST_F(CellularCapabilityUniversalMainTest, SimPathChanged) {
                            kOperatorIdentifier);
   sim_properties.SetString(MM_SIM_PROPERTY_OPERATORNAME, kOperatorName);
 
-  EXPECT_CALL(*properties_proxy_, GetAll(MM_DBUS_INTERFACE_SIM))
-      .Times(1).WillOnce(Return(sim_properties));
+  KeyValueStoreCallback sim_callback;
+  EXPECT_CALL(*properties_proxy_, GetAllAsync(MM_DBUS_INTERFACE_SIM, _))
+      .WillOnce(SaveArg<1>(&sim_callback));
   EXPECT_CALL(*modem_info_.mock_pending_activation_store(),
               GetActivationState(PendingActivationStore::kIdentifierICCID, _))
       .Times(1);
@@ -1185,6 +1287,8 @@ TEST_F(CellularCapabilityUniversalMainTest, SimPathChanged) {
   EXPECT_EQ("", capability_->spn_);
 
   capability_->OnSimPathChanged(kSimPath);
+  ASSERT_FALSE(sim_callback.is_null());
+  sim_callback.Run(sim_properties, Error());
   EXPECT_TRUE(cellular_->sim_present());
   EXPECT_NE(nullptr, capability_->sim_proxy_);;
   EXPECT_EQ(kSimPath, capability_->sim_path_);
@@ -1211,13 +1315,16 @@ TEST_F(CellularCapabilityUniversalMainTest, SimPathChanged) {
   EXPECT_EQ("", cellular_->sim_identifier());
   EXPECT_EQ("", capability_->spn_);
 
-  EXPECT_CALL(*properties_proxy_, GetAll(MM_DBUS_INTERFACE_SIM))
-      .Times(1).WillOnce(Return(sim_properties));
+  sim_callback.Reset();
+  EXPECT_CALL(*properties_proxy_, GetAllAsync(MM_DBUS_INTERFACE_SIM, _))
+      .WillOnce(SaveArg<1>(&sim_callback));
   EXPECT_CALL(*modem_info_.mock_pending_activation_store(),
               GetActivationState(PendingActivationStore::kIdentifierICCID, _))
       .Times(1);
 
   capability_->OnSimPathChanged(kSimPath);
+  ASSERT_FALSE(sim_callback.is_null());
+  sim_callback.Run(sim_properties, Error());
   EXPECT_TRUE(cellular_->sim_present());
   EXPECT_NE(nullptr, capability_->sim_proxy_);;
   EXPECT_EQ(kSimPath, capability_->sim_path_);
@@ -1244,8 +1351,9 @@ TEST_F(CellularCapabilityUniversalMainTest, SimPropertiesChanged) {
   KeyValueStore sim_properties;
   sim_properties.SetString(MM_SIM_PROPERTY_IMSI, kImsi);
 
-  EXPECT_CALL(*properties_proxy_, GetAll(MM_DBUS_INTERFACE_SIM))
-      .WillOnce(Return(sim_properties));
+  KeyValueStoreCallback sim_callback;
+  EXPECT_CALL(*properties_proxy_, GetAllAsync(MM_DBUS_INTERFACE_SIM, _))
+      .WillOnce(SaveArg<1>(&sim_callback));
   EXPECT_CALL(*modem_info_.mock_pending_activation_store(),
               GetActivationState(PendingActivationStore::kIdentifierICCID, _))
       .Times(0);
@@ -1255,6 +1363,8 @@ TEST_F(CellularCapabilityUniversalMainTest, SimPropertiesChanged) {
                                    modem_properties, vector<string>());
   EXPECT_EQ(kSimPath, capability_->sim_path_);
   EXPECT_TRUE(capability_->sim_proxy_.get());
+  ASSERT_FALSE(sim_callback.is_null());
+  sim_callback.Run(sim_properties, Error());
   EXPECT_EQ(kImsi, cellular_->imsi());
   Mock::VerifyAndClearExpectations(modem_info_.mock_pending_activation_store());
 
@@ -1429,6 +1539,212 @@ TEST_F(CellularCapabilityUniversalMainTest, ConnectApns) {
   connect_callback_.Run(bearer, Error(Error::kSuccess));
 }
 
+// Validates that connect attempts are recorded against the APN they used.
+TEST_F(CellularCapabilityUniversalMainTest, ConnectRecordsApnStats) {
+  mm1::MockModemSimpleProxy* modem_simple_proxy = modem_simple_proxy_.get();
+  SetSimpleProxy();
+  MockTime time;
+  Time* old_time = capability_->time_;
+  capability_->time_ = &time;
+  struct timeval start_time = { 100, 0 };
+  struct timeval reply_time = { 102, 500000 };
+  Error error;
+  KeyValueStore properties;
+  ResultCallback callback =
+      Bind(&CellularCapabilityUniversalTest::TestCallback, Unretained(this));
+  string bearer("/bearer0");
+
+  Stringmap apn1;
+  apn1[kApnProperty] = "foo";
+  Stringmap apn2;
+  apn2[kApnProperty] = "bar";
+  capability_->apn_try_list_.clear();
+  capability_->apn_try_list_.push_back(apn1);
+  capability_->apn_try_list_.push_back(apn2);
+  EXPECT_CALL(*modem_simple_proxy, Connect(_, _, _, _))
+      .WillRepeatedly(SaveArg<2>(&connect_callback_));
+  EXPECT_CALL(time, GetTimeMonotonic(_))
+      .WillRepeatedly(DoAll(SetArgumentPointee<0>(start_time), Return(0)));
+  capability_->FillConnectPropertyMap(&properties);
+  capability_->Connect(properties, &error, callback);
+
+  // A rejected APN counts as a failure for that APN.
+  EXPECT_CALL(*service_, ClearLastGoodApn());
+  connect_callback_.Run(bearer, Error(Error::kInvalidApn));
+  const CellularService::ApnConnectStats* stats =
+      service_->GetApnConnectStats("foo");
+  ASSERT_NE(nullptr, stats);
+  EXPECT_EQ(0, stats->successes);
+  EXPECT_EQ(1, stats->failures);
+
+  // A success records how long the attempt took.
+  EXPECT_CALL(time, GetTimeMonotonic(_))
+      .WillRepeatedly(DoAll(SetArgumentPointee<0>(reply_time), Return(0)));
+  EXPECT_CALL(*service_, SetLastGoodApn(apn2));
+  EXPECT_CALL(*this, TestCallback(IsSuccess()));
+  connect_callback_.Run(bearer, Error(Error::kSuccess));
+  stats = service_->GetApnConnectStats("bar");
+  ASSERT_NE(nullptr, stats);
+  EXPECT_EQ(1, stats->successes);
+  EXPECT_EQ(0, stats->failures);
+  EXPECT_EQ(2500, stats->average_connect_ms);
+  Mock::VerifyAndClearExpectations(service_);
+  Mock::VerifyAndClearExpectations(this);
+
+  // Failures that aren't caused by the APN are not held against it.
+  capability_->apn_try_list_.push_back(apn2);
+  capability_->Connect(properties, &error, callback);
+  EXPECT_CALL(*this, TestCallback(IsFailure()));
+  connect_callback_.Run(bearer, Error(Error::kWrongState));
+  EXPECT_EQ(0, service_->GetApnConnectStats("bar")->failures);
+
+  capability_->time_ = old_time;
+}
+
+// Validates that an APN whose attempt outlives its learned timeout is
+// abandoned in favor of the next one.
+TEST_F(CellularCapabilityUniversalMainTest, ConnectApnDeadlineExpired) {
+  mm1::MockModemSimpleProxy* modem_simple_proxy = modem_simple_proxy_.get();
+  SetSimpleProxy();
+  MockTime time;
+  Time* old_time = capability_->time_;
+  capability_->time_ = &time;
+  struct timeval start_time = { 100, 0 };
+  struct timeval reply_time = { 100 +
+      CellularCapabilityUniversal::kMinApnConnectTimeoutMilliseconds / 1000,
+      0 };
+  Error error;
+  KeyValueStore properties;
+  ResultCallback callback =
+      Bind(&CellularCapabilityUniversalTest::TestCallback, Unretained(this));
+  string bearer("/bearer0");
+
+  service_->RecordApnConnectResult("foo", true, 1000);
+  Stringmap apn1;
+  apn1[kApnProperty] = "foo";
+  Stringmap apn2;
+  apn2[kApnProperty] = "bar";
+  capability_->apn_try_list_.clear();
+  capability_->apn_try_list_.push_back(apn1);
+  capability_->apn_try_list_.push_back(apn2);
+  EXPECT_CALL(time, GetTimeMonotonic(_))
+      .WillRepeatedly(DoAll(SetArgumentPointee<0>(start_time), Return(0)));
+  EXPECT_CALL(*modem_simple_proxy,
+              Connect(HasApn("foo"), _, _,
+                      CellularCapabilityUniversal::
+                          kMinApnConnectTimeoutMilliseconds))
+      .WillOnce(SaveArg<2>(&connect_callback_));
+  capability_->FillConnectPropertyMap(&properties);
+  capability_->Connect(properties, &error, callback);
+  Mock::VerifyAndClearExpectations(modem_simple_proxy);
+
+  // The abandoned attempt is torn down before the next APN is tried.
+  ResultCallback disconnect_callback;
+  EXPECT_CALL(time, GetTimeMonotonic(_))
+      .WillRepeatedly(DoAll(SetArgumentPointee<0>(reply_time), Return(0)));
+  EXPECT_CALL(*service_, ClearLastGoodApn()).Times(2);
+  EXPECT_CALL(*modem_simple_proxy,
+              Disconnect(CellularCapabilityUniversal::kRootPath, _, _,
+                         CellularCapability::kTimeoutDisconnect))
+      .WillOnce(SaveArg<2>(&disconnect_callback));
+  EXPECT_CALL(*modem_simple_proxy, Connect(_, _, _, _)).Times(0);
+  EXPECT_CALL(*this, TestCallback(_)).Times(0);
+  connect_callback_.Run(bearer, Error(Error::kOperationFailed));
+  EXPECT_EQ(1, service_->GetApnConnectStats("foo")->failures);
+  Mock::VerifyAndClearExpectations(modem_simple_proxy);
+  Mock::VerifyAndClearExpectations(this);
+
+  // The last APN gets the full timeout.
+  EXPECT_CALL(*modem_simple_proxy,
+              Connect(HasApn("bar"), _, _,
+                      CellularCapability::kTimeoutConnect))
+      .WillOnce(SaveArg<2>(&connect_callback_));
+  disconnect_callback.Run(Error());
+  Mock::VerifyAndClearExpectations(modem_simple_proxy);
+
+  // Running out the full timeout is reported as a plain failure.
+  struct timeval final_time = { reply_time.tv_sec +
+      CellularCapability::kTimeoutConnect / 1000, 0 };
+  EXPECT_CALL(time, GetTimeMonotonic(_))
+      .WillRepeatedly(DoAll(SetArgumentPointee<0>(final_time), Return(0)));
+  EXPECT_CALL(*modem_simple_proxy, Disconnect(_, _, _, _)).Times(0);
+  EXPECT_CALL(*this, TestCallback(IsFailure()));
+  connect_callback_.Run(bearer, Error(Error::kOperationFailed));
+
+  capability_->time_ = old_time;
+}
+
+// Validates that APN connect timeouts follow observed connect times.
+TEST_F(CellularCapabilityUniversalMainTest, GetApnConnectTimeout) {
+  Stringmap apn1;
+  apn1[kApnProperty] = "foo";
+  Stringmap apn2;
+  apn2[kApnProperty] = "bar";
+  capability_->apn_try_list_.clear();
+  EXPECT_EQ(CellularCapability::kTimeoutConnect,
+            capability_->GetApnConnectTimeout());
+  capability_->apn_try_list_.push_back(apn1);
+  EXPECT_EQ(CellularCapability::kTimeoutConnect,
+            capability_->GetApnConnectTimeout());
+
+  // Nothing has been learned yet.
+  capability_->apn_try_list_.push_back(apn2);
+  EXPECT_EQ(CellularCapability::kTimeoutConnect,
+            capability_->GetApnConnectTimeout());
+
+  // Another APN's connect time applies to one that never succeeded.
+  service_->RecordApnConnectResult("bar", true, 6000);
+  EXPECT_EQ(6000 * CellularCapabilityUniversal::kApnConnectTimeoutMultiplier,
+            capability_->GetApnConnectTimeout());
+
+  // An APN's own connect time takes precedence, within limits.
+  service_->RecordApnConnectResult("foo", true, 5000);
+  EXPECT_EQ(5000 * CellularCapabilityUniversal::kApnConnectTimeoutMultiplier,
+            capability_->GetApnConnectTimeout());
+  service_->apn_connect_stats_.clear();
+  service_->RecordApnConnectResult("foo", true, 100);
+  EXPECT_EQ(CellularCapabilityUniversal::kMinApnConnectTimeoutMilliseconds,
+            capability_->GetApnConnectTimeout());
+  service_->apn_connect_stats_.clear();
+  service_->RecordApnConnectResult("foo", true, 40000);
+  EXPECT_EQ(CellularCapability::kTimeoutConnect,
+            capability_->GetApnConnectTimeout());
+
+  // Without a service there is nothing to learn from.
+  cellular_->service_ = nullptr;
+  EXPECT_EQ(CellularCapability::kTimeoutConnect,
+            capability_->GetApnConnectTimeout());
+}
+
+// Validates that database APNs are ranked by past results.
+TEST_F(CellularCapabilityUniversalMainTest, SetupApnTryListRanking) {
+  Stringmaps apn_list;
+  for (const char* name : { "rejected", "untried", "slow", "fast" }) {
+    Stringmap apn;
+    apn[kApnProperty] = name;
+    apn_list.push_back(apn);
+  }
+  cellular_->set_apn_list(apn_list);
+
+  // Without any history the database order is kept.
+  capability_->SetupApnTryList();
+  ASSERT_EQ(4, capability_->apn_try_list_.size());
+  EXPECT_EQ("rejected", capability_->apn_try_list_[0][kApnProperty]);
+  EXPECT_EQ("untried", capability_->apn_try_list_[1][kApnProperty]);
+  EXPECT_EQ("slow", capability_->apn_try_list_[2][kApnProperty]);
+  EXPECT_EQ("fast", capability_->apn_try_list_[3][kApnProperty]);
+
+  service_->RecordApnConnectResult("rejected", false, 45000);
+  service_->RecordApnConnectResult("slow", true, 20000);
+  service_->RecordApnConnectResult("fast", true, 2000);
+  capability_->SetupApnTryList();
+  ASSERT_EQ(4, capability_->apn_try_list_.size());
+  EXPECT_EQ("fast", capability_->apn_try_list_[0][kApnProperty]);
+  EXPECT_EQ("slow", capability_->apn_try_list_[1][kApnProperty]);
+  EXPECT_EQ("untried", capability_->apn_try_list_[2][kApnProperty]);
+  EXPECT_EQ("rejected", capability_->apn_try_list_[3][kApnProperty]);
+}
+
 // Validates GetTypeString and AccessTechnologyToTechnologyFamily
 TEST_F(CellularCapabilityUniversalMainTest, GetTypeString) {
   const int gsm_technologies[] = {
@@ -16,8 +16,13 @@
 
 #include "shill/cellular/cellular_service.h"
 
+#include <inttypes.h>
+
+#include <algorithm>
 #include <string>
+#include <vector>
 
+#include <base/strings/string_number_conversions.h>
 #include <base/strings/stringprintf.h>
 #if defined(__ANDROID__)
 #include <dbus/service_constants.h>
@@ -31,6 +36,7 @@
 #include "shill/store_interface.h"
 
 using std::string;
+using std::vector;
 
 namespace shill {
 
@@ -49,6 +55,9 @@ const char CellularService::kAutoConnOutOfCreditsDetectionInProgress[] =
     "device detecting out-of-credits";
 const char CellularService::kStoragePPPUsername[] = "Cellular.PPP.Username";
 const char CellularService::kStoragePPPPassword[] = "Cellular.PPP.Password";
+const char CellularService::kStorageApnConnectStats[] =
+    "Cellular.APNConnectStats";
+const size_t CellularService::kMaxApnConnectStats = 32;
 
 // TODO(petkov): Add these to system_api/dbus/service_constants.h
 namespace {
@@ -59,6 +68,9 @@ const char kCellularPPPPasswordProperty[] = "Cellular.PPP.Password";
 namespace {
 const char kStorageAPN[] = "Cellular.APN";
 const char kStorageLastGoodAPN[] = "Cellular.LastGoodAPN";
+// Once an APN has this many recorded attempts, its counts are halved so
+// that recent results outweigh old ones.
+const int kApnConnectStatsMaxAttempts = 16;
 }  // namespace
 
 static bool GetNonEmptyField(const Stringmap& stringmap,
@@ -229,6 +241,69 @@ void CellularService::ClearLastGoodApn() {
                                   last_good_apn_info_);
 }
 
+void CellularService::RecordApnConnectResult(const string& apn,
+                                             bool success,
+                                             int64_t connect_ms) {
+  const string key = GetApnConnectStatsKey(apn);
+  if (!ContainsKey(apn_connect_stats_, key) &&
+      apn_connect_stats_.size() >= kMaxApnConnectStats) {
+    // Make room by forgetting the APN we know the least about.
+    auto least_known = apn_connect_stats_.begin();
+    for (auto it = apn_connect_stats_.begin(); it != apn_connect_stats_.end();
+         ++it) {
+      if (it->second.successes + it->second.failures <
+          least_known->second.successes + least_known->second.failures) {
+        least_known = it;
+      }
+    }
+    apn_connect_stats_.erase(least_known);
+  }
+
+  ApnConnectStats& stats = apn_connect_stats_[key];
+  if (stats.successes + stats.failures >= kApnConnectStatsMaxAttempts) {
+    stats.successes = (stats.successes + 1) / 2;
+    stats.failures = (stats.failures + 1) / 2;
+  }
+  if (success) {
+    ++stats.successes;
+    stats.average_connect_ms +=
+        (connect_ms - stats.average_connect_ms) / stats.successes;
+  } else {
+    ++stats.failures;
+  }
+  SLOG(this, 2) << __func__ << ": APN " << apn << ": "
+                << stats.successes << " successes, "
+                << stats.failures << " failures, "
+                << stats.average_connect_ms << " ms average connect time";
+}
+
+const CellularService::ApnConnectStats* CellularService::GetApnConnectStats(
+    const string& apn) const {
+  auto it = apn_connect_stats_.find(GetApnConnectStatsKey(apn));
+  if (it == apn_connect_stats_.end())
+    return nullptr;
+  return &it->second;
+}
+
+int64_t CellularService::GetLongestAverageApnConnectTime() const {
+  const string prefix = GetApnConnectStatsKey("");
+  int64_t longest = 0;
+  for (const auto& entry : apn_connect_stats_) {
+    if (entry.first.compare(0, prefix.size(), prefix) != 0 ||
+        entry.second.successes == 0) {
+      continue;
+    }
+    longest = std::max(longest, entry.second.average_connect_ms);
+  }
+  return longest;
+}
+
+string CellularService::GetApnConnectStatsKey(const string& apn) const {
+  string operator_code;
+  GetNonEmptyField(serving_operator_, kOperatorCodeKey, &operator_code);
+  return operator_code + "/" + apn;
+}
+
 void CellularService::OnAfterResume() {
   Service::OnAfterResume();
   resume_start_time_ = base::Time::Now();
@@ -252,6 +327,7 @@ bool CellularService::Load(StoreInterface* storage) {
   const string id = GetStorageIdentifier();
   LoadApn(storage, id, kStorageAPN, &apn_info_);
   LoadApn(storage, id, kStorageLastGoodAPN, &last_good_apn_info_);
+  LoadApnConnectStats(storage, id);
 
   const string old_username = ppp_username_;
   const string old_password = ppp_password_;
@@ -288,6 +364,62 @@ bool CellularService::LoadApnField(StoreInterface* storage,
   return false;
 }
 
+// Each entry is stored as "<operator code>/<apn>:<successes>:<failures>:
+// <average connect ms>".
+void CellularService::LoadApnConnectStats(StoreInterface* storage,
+                                          const string& storage_group) {
+  apn_connect_stats_.clear();
+  vector<string> entries;
+  if (!storage->GetStringList(storage_group, kStorageApnConnectStats,
+                              &entries)) {
+    return;
+  }
+  for (const auto& entry : entries) {
+    if (apn_connect_stats_.size() >= kMaxApnConnectStats)
+      break;
+    // Fields are split off from the end, since the key is free-form.
+    size_t average_pos = entry.rfind(':');
+    if (average_pos == string::npos || average_pos == 0)
+      continue;
+    size_t failures_pos = entry.rfind(':', average_pos - 1);
+    if (failures_pos == string::npos || failures_pos == 0)
+      continue;
+    size_t successes_pos = entry.rfind(':', failures_pos - 1);
+    if (successes_pos == string::npos)
+      continue;
+    ApnConnectStats stats;
+    if (!base::StringToInt(
+            entry.substr(successes_pos + 1, failures_pos - successes_pos - 1),
+            &stats.successes) ||
+        !base::StringToInt(
+            entry.substr(failures_pos + 1, average_pos - failures_pos - 1),
+            &stats.failures) ||
+        !base::StringToInt64(entry.substr(average_pos + 1),
+                             &stats.average_connect_ms) ||
+        stats.successes < 0 || stats.failures < 0 ||
+        stats.average_connect_ms < 0) {
+      LOG(WARNING) << "Ignoring malformed APN connect stats: " << entry;
+      continue;
+    }
+    apn_connect_stats_[entry.substr(0, successes_pos)] = stats;
+  }
+}
+
+void CellularService::SaveApnConnectStats(StoreInterface* storage,
+                                          const string& storage_group) const {
+  if (apn_connect_stats_.empty()) {
+    storage->DeleteKey(storage_group, kStorageApnConnectStats);
+    return;
+  }
+  vector<string> entries;
+  for (const auto& entry : apn_connect_stats_) {
+    entries.push_back(base::StringPrintf(
+        "%s:%d:%d:%" PRId64, entry.first.c_str(), entry.second.successes,
+        entry.second.failures, entry.second.average_connect_ms));
+  }
+  storage->SetStringList(storage_group, kStorageApnConnectStats, entries);
+}
+
 bool CellularService::Save(StoreInterface* storage) {
   // Save properties common to all Services.
   if (!Service::Save(storage))
@@ -296,6 +428,7 @@ bool CellularService::Save(StoreInterface* storage) {
   const string id = GetStorageIdentifier();
   SaveApn(storage, id, GetUserSpecifiedApn(), kStorageAPN);
   SaveApn(storage, id, GetLastGoodApn(), kStorageLastGoodAPN);
+  SaveApnConnectStats(storage, id);
   SaveString(storage, id, kStoragePPPUsername, ppp_username_, false, true);
   SaveString(storage, id, kStoragePPPPassword, ppp_password_, false, true);
   return true;
@@ -120,6 +120,29 @@ class CellularService : public Service {
   virtual void SetLastGoodApn(const Stringmap& apn_info);
   virtual void ClearLastGoodApn();
 
+  // Outcome of previous connect attempts using a given APN, learned while
+  // this service's SIM was registered on a given serving operator.
+  struct ApnConnectStats {
+    ApnConnectStats() : successes(0), failures(0), average_connect_ms(0) {}
+
+    int successes;
+    int failures;
+    // Mean duration of the successful attempts.
+    int64_t average_connect_ms;
+  };
+
+  // Records the result of a connect attempt using |apn| on the current
+  // serving operator, which took |connect_ms| milliseconds.
+  void RecordApnConnectResult(const std::string& apn,
+                              bool success,
+                              int64_t connect_ms);
+  // Returns the statistics recorded for |apn| on the current serving
+  // operator, or nullptr if no attempt with it has been recorded.
+  const ApnConnectStats* GetApnConnectStats(const std::string& apn) const;
+  // Returns the longest average connect time of the APNs that have
+  // succeeded on the current serving operator, or 0 if none has.
+  int64_t GetLongestAverageApnConnectTime() const;
+
   void OnAfterResume() override;
 
   // Initialize out-of-credits detection.
@@ -157,6 +180,8 @@ class CellularService : public Service {
   FRIEND_TEST(CellularServiceTest, OutOfCreditsNotDetectedIntermittentNetwork);
   FRIEND_TEST(CellularServiceTest, OutOfCreditsNotEnforced);
   FRIEND_TEST(CellularServiceTest, CustomSetterNoopChange);
+  FRIEND_TEST(CellularServiceTest, ApnConnectStats);
+  FRIEND_TEST(CellularServiceTest, LoadSaveApnConnectStats);
 
   static const char kAutoConnActivating[];
   static const char kAutoConnBadPPPCredentials[];
@@ -165,6 +190,8 @@ class CellularService : public Service {
   static const char kAutoConnOutOfCreditsDetectionInProgress[];
   static const char kStoragePPPUsername[];
   static const char kStoragePPPPassword[];
+  static const char kStorageApnConnectStats[];
+  static const size_t kMaxApnConnectStats;
 
   void HelpRegisterDerivedString(
       const std::string& name,
@@ -203,6 +230,13 @@ class CellularService : public Service {
                            const std::string& keytag,
                            const std::string& apntag,
                            Stringmap* apn_info);
+  // Returns the key under which statistics for |apn| on the current
+  // serving operator are kept in |apn_connect_stats_|.
+  std::string GetApnConnectStatsKey(const std::string& apn) const;
+  void LoadApnConnectStats(StoreInterface* storage,
+                           const std::string& storage_group);
+  void SaveApnConnectStats(StoreInterface* storage,
+                           const std::string& storage_group) const;
   bool IsOutOfCredits(Error* /*error*/);
 
   // For unit test.
@@ -220,6 +254,8 @@ class CellularService : public Service {
   std::string usage_url_;
   Stringmap apn_info_;
   Stringmap last_good_apn_info_;
+  // Keyed by GetApnConnectStatsKey().
+  std::map<std::string, ApnConnectStats> apn_connect_stats_;
   std::string ppp_username_;
   std::string ppp_password_;
 
@@ -16,6 +16,10 @@
 
 #include "shill/cellular/cellular_service.h"
 
+#include <string>
+#include <vector>
+
+#include <base/strings/stringprintf.h>
 #if defined(__ANDROID__)
 #include <dbus/service_constants.h>
 #else
@@ -38,11 +42,13 @@
 #include "shill/service_property_change_test.h"
 
 using std::string;
+using std::vector;
 using testing::_;
 using testing::InSequence;
 using testing::Mock;
 using testing::NiceMock;
 using testing::Return;
+using testing::SaveArg;
 using testing::SetArgumentPointee;
 
 namespace shill {
@@ -334,6 +340,97 @@ TEST_F(CellularServiceTest, LastGoodApn) {
   EXPECT_EQ(nullptr, service_->GetLastGoodApn());;
 }
 
+TEST_F(CellularServiceTest, ApnConnectStats) {
+  static const char kApn[] = "TheAPN";
+  EXPECT_EQ(nullptr, service_->GetApnConnectStats(kApn));
+  EXPECT_EQ(0, service_->GetLongestAverageApnConnectTime());
+
+  service_->RecordApnConnectResult(kApn, false, 45000);
+  const CellularService::ApnConnectStats* stats =
+      service_->GetApnConnectStats(kApn);
+  ASSERT_NE(nullptr, stats);
+  EXPECT_EQ(0, stats->successes);
+  EXPECT_EQ(1, stats->failures);
+  EXPECT_EQ(0, stats->average_connect_ms);
+  EXPECT_EQ(0, service_->GetLongestAverageApnConnectTime());
+
+  service_->RecordApnConnectResult(kApn, true, 2000);
+  service_->RecordApnConnectResult(kApn, true, 4000);
+  stats = service_->GetApnConnectStats(kApn);
+  ASSERT_NE(nullptr, stats);
+  EXPECT_EQ(2, stats->successes);
+  EXPECT_EQ(1, stats->failures);
+  EXPECT_EQ(3000, stats->average_connect_ms);
+  EXPECT_EQ(3000, service_->GetLongestAverageApnConnectTime());
+
+  // Statistics are kept separately for each serving operator.
+  Stringmap serving_operator;
+  serving_operator[kOperatorCodeKey] = "310260";
+  service_->set_serving_operator(serving_operator);
+  EXPECT_EQ(nullptr, service_->GetApnConnectStats(kApn));
+  EXPECT_EQ(0, service_->GetLongestAverageApnConnectTime());
+  service_->set_serving_operator(Stringmap());
+  EXPECT_NE(nullptr, service_->GetApnConnectStats(kApn));
+
+  // Old results decay once enough attempts have been recorded.
+  for (int i = 0; i < 13; ++i)
+    service_->RecordApnConnectResult(kApn, false, 45000);
+  stats = service_->GetApnConnectStats(kApn);
+  EXPECT_EQ(2, stats->successes);
+  EXPECT_EQ(14, stats->failures);
+  service_->RecordApnConnectResult(kApn, false, 45000);
+  EXPECT_EQ(1, stats->successes);
+  EXPECT_EQ(8, stats->failures);
+
+  // The number of APNs remembered is bounded.
+  for (size_t i = 0; i < CellularService::kMaxApnConnectStats; ++i) {
+    service_->RecordApnConnectResult(base::StringPrintf("apn%zu", i), true,
+                                     1000);
+  }
+  EXPECT_EQ(CellularService::kMaxApnConnectStats,
+            service_->apn_connect_stats_.size());
+  EXPECT_NE(nullptr, service_->GetApnConnectStats(kApn));
+}
+
+TEST_F(CellularServiceTest, LoadSaveApnConnectStats) {
+  NiceMock<MockStore> storage;
+  const string id = service_->GetStorageIdentifier();
+  EXPECT_CALL(storage, ContainsGroup(_)).WillRepeatedly(Return(true));
+  vector<string> entries;
+  entries.push_back("/TheAPN:3:1:2500");
+  entries.push_back("310260/other.apn:0:2:0");
+  entries.push_back("malformed");
+  entries.push_back("/bad:one:1:100");
+  EXPECT_CALL(storage, GetStringList(id,
+                                     CellularService::kStorageApnConnectStats,
+                                     _))
+      .WillOnce(DoAll(SetArgumentPointee<2>(entries), Return(true)));
+  EXPECT_TRUE(service_->Load(&storage));
+  EXPECT_EQ(2, service_->apn_connect_stats_.size());
+  const CellularService::ApnConnectStats* stats =
+      service_->GetApnConnectStats("TheAPN");
+  ASSERT_NE(nullptr, stats);
+  EXPECT_EQ(3, stats->successes);
+  EXPECT_EQ(1, stats->failures);
+  EXPECT_EQ(2500, stats->average_connect_ms);
+
+  vector<string> saved;
+  EXPECT_CALL(storage, SetStringList(id,
+                                     CellularService::kStorageApnConnectStats,
+                                     _))
+      .WillOnce(DoAll(SaveArg<2>(&saved), Return(true)));
+  EXPECT_TRUE(service_->Save(&storage));
+  ASSERT_EQ(2, saved.size());
+  EXPECT_EQ("/TheAPN:3:1:2500", saved[0]);
+  EXPECT_EQ("310260/other.apn:0:2:0", saved[1]);
+  Mock::VerifyAndClearExpectations(&storage);
+
+  service_->apn_connect_stats_.clear();
+  EXPECT_CALL(storage, DeleteKey(id, CellularService::kStorageApnConnectStats));
+  EXPECT_CALL(storage, SetStringList(_, _, _)).Times(0);
+  EXPECT_TRUE(service_->Save(&storage));
+}
+
 TEST_F(CellularServiceTest, IsAutoConnectable) {
   const char* reason = nullptr;
 
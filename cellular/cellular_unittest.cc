@@ -401,8 +401,8 @@ class CellularTest : public testing::Test {
   }
 
   void SetCommonOnAfterResumeExpectations() {
-    EXPECT_CALL(*dbus_properties_proxy_, GetAll(_))
-        .WillRepeatedly(Return(KeyValueStore()));
+    EXPECT_CALL(*dbus_properties_proxy_, GetAllAsync(_, _))
+        .Times(AnyNumber());
     EXPECT_CALL(*mm1_proxy_, set_state_changed_callback(_)).Times(AnyNumber());
     EXPECT_CALL(*modem_info_.mock_metrics(), NotifyDeviceScanStarted(_))
         .Times(AnyNumber());
@@ -1842,7 +1842,6 @@ TEST_F(CellularTest, OnAfterResumeDisableQueuedWantEnabled) {
   PopulateProxies();
   SetCommonOnAfterResumeExpectations();
   mm1_proxy = mm1_proxy_.get();
-  auto dbus_properties_proxy = dbus_properties_proxy_.get();
 
   // Resume, with disable still in progress.
   EXPECT_CALL(*mm1_proxy, Enable(true, _, _, _))
@@ -1853,18 +1852,11 @@ TEST_F(CellularTest, OnAfterResumeDisableQueuedWantEnabled) {
   EXPECT_TRUE(device_->enabled_persistent());  // no change
   EXPECT_EQ(Cellular::kStateDisabled, device_->state_);  // by OnAfterResume
 
-  // Set up state that we need.
-  KeyValueStore modem_properties;
-  modem_properties.SetInt(MM_MODEM_PROPERTY_STATE,
-                          Cellular::kModemStateDisabled);
-
   // Let the disable complete.
   EXPECT_CALL(*mm1_proxy, Enable(false, _, _, _))
       .WillOnce(Invoke(this, &CellularTest::InvokeEnable));
   EXPECT_CALL(*mm1_proxy, SetPowerState(_, _, _, _))
       .WillOnce(Invoke(this, &CellularTest::InvokeSetPowerState));
-  EXPECT_CALL(*dbus_properties_proxy, GetAll(_))
-      .WillRepeatedly(Return(modem_properties));
   dispatcher_.DispatchPendingEvents();
   EXPECT_TRUE(device_->running());  // last changed by OnAfterResume
   EXPECT_TRUE(device_->enabled_persistent());  // last changed by OnAfterResume
@@ -1960,10 +1952,14 @@ TEST_F(CellularTest, OnAfterResumePowerDownInProgressWantEnabled) {
 
   // Let the enable complete.
   ASSERT_TRUE(error.IsSuccess());
-  EXPECT_CALL(*dbus_properties_proxy, GetAll(_))
-      .WillRepeatedly(Return(modem_properties));
+  KeyValueStoreCallback modem_properties_callback;
+  EXPECT_CALL(*dbus_properties_proxy,
+              GetAllAsync(MM_DBUS_INTERFACE_MODEM, _))
+      .WillOnce(SaveArg<1>(&modem_properties_callback));
   ASSERT_TRUE(!modem_proxy_enable_callback.is_null());
   modem_proxy_enable_callback.Run(error);
+  ASSERT_FALSE(modem_properties_callback.is_null());
+  modem_properties_callback.Run(modem_properties, Error());
   EXPECT_TRUE(device_->running());
   EXPECT_TRUE(device_->enabled_persistent());
   EXPECT_EQ(Cellular::kStateEnabled, device_->state_);
@@ -47,7 +47,7 @@ ModemInfo::~ModemInfo() {
 }
 
 void ModemInfo::Start() {
-  pending_activation_store_.reset(new PendingActivationStore());
+  pending_activation_store_.reset(new PendingActivationStore(dispatcher_));
   pending_activation_store_->InitStorage(manager_->storage_path());
 
   RegisterModemManager(new ModemManagerClassic(control_interface_,
@@ -25,9 +25,12 @@
 
 #include "shill/control_interface.h"
 #include "shill/device_info.h"
+#include "shill/error.h"
 #include "shill/firewall_proxy_interface.h"
 #include "shill/logging.h"
+#include "shill/metrics.h"
 #include "shill/net/rtnl_handler.h"
+#include "shill/net/shill_time.h"
 #include "shill/routing_table.h"
 
 #if !defined(__ANDROID__)
@@ -68,8 +71,6 @@ const char* kGoogleDNSServers[] = {
 // static
 const uint32_t Connection::kDefaultMetric = 1;
 // static
-const uint32_t Connection::kNonDefaultMetricBase = 10;
-// static
 const uint32_t Connection::kMarkForUserTraffic = 0x1;
 // static
 const uint8_t Connection::kSecondaryTableId = 0x1;
@@ -112,7 +113,8 @@ Connection::Connection(int interface_index,
                        const std::string& interface_name,
                        Technology::Identifier technology,
                        const DeviceInfo* device_info,
-                       ControlInterface* control_interface)
+                       ControlInterface* control_interface,
+                       Metrics* metrics)
     : weak_ptr_factory_(this),
       is_default_(false),
       has_broadcast_domain_(false),
@@ -122,8 +124,13 @@ Connection::Connection(int interface_index,
       technology_(technology),
       user_traffic_only_(false),
       table_id_(RT_TABLE_MAIN),
+      default_route_table_id_(RT_TABLE_UNSPEC),
       local_(IPAddress::kFamilyUnknown),
       gateway_(IPAddress::kFamilyUnknown),
+      has_applied_config_(false),
+      applied_broadcast_(IPAddress::kFamilyUnknown),
+      applied_peer_(IPAddress::kFamilyUnknown),
+      applied_table_id_(RT_TABLE_MAIN),
       lower_binder_(
           interface_name_,
           // Connection owns a single instance of |lower_binder_| so it's safe
@@ -137,7 +144,9 @@ Connection::Connection(int interface_index,
 #endif  // __ANDROID__
       routing_table_(RoutingTable::GetInstance()),
       rtnl_handler_(RTNLHandler::GetInstance()),
-      control_interface_(control_interface) {
+      control_interface_(control_interface),
+      metrics_(metrics),
+      time_(Time::GetInstance()) {
   SLOG(this, 2) << __func__ << "(" << interface_index << ", "
                 << interface_name << ", "
                 << Technology::NameFromIdentifier(technology) << ")";
@@ -151,6 +160,9 @@ Connection::~Connection() {
   DCHECK(!routing_request_count_);
   routing_table_->FlushRoutes(interface_index_);
   routing_table_->FlushRoutesWithTag(interface_index_);
+  if (default_route_table_id_ != RT_TABLE_UNSPEC) {
+    routing_table_->FreeInterfaceTable(default_route_table_id_);
+  }
   device_info_->FlushAddresses(interface_index_);
   TearDownIptableEntries();
 }
@@ -235,38 +247,63 @@ void Connection::UpdateFromIPConfig(const IPConfigRefPtr& config) {
     LOG(INFO) << __func__ << ": Flushing old addresses and routes.";
     routing_table_->FlushRoutes(interface_index_);
     device_info_->FlushAddresses(interface_index_);
+    has_applied_config_ = false;
   }
 
-  LOG(INFO) << __func__ << ": Installing with parameters:"
-            << " local=" << local.ToString()
-            << " broadcast=" << broadcast.ToString()
-            << " peer=" << peer.ToString()
-            << " gateway=" << gateway.ToString();
-  rtnl_handler_->AddInterfaceAddress(interface_index_, local, broadcast, peer);
+  // Only the pieces of kernel state whose inputs differ from what was last
+  // installed are pushed down, so that an unchanged lease renewal does not
+  // generate any RTNL traffic.
+  const IPConfig::Properties& applied = applied_properties_;
+  bool same_family = has_applied_config_ &&
+      applied.address_family == properties.address_family;
+  bool same_table = same_family && applied_table_id_ == table_id_;
 
-  if (gateway.IsValid() && properties.default_route) {
+  if (same_family && local.Equals(local_) &&
+      broadcast.Equals(applied_broadcast_) && peer.Equals(applied_peer_)) {
+    SLOG(this, 2) << __func__ << ": Address unchanged; not reinstalling.";
+  } else {
+    LOG(INFO) << __func__ << ": Installing with parameters:"
+              << " local=" << local.ToString()
+              << " broadcast=" << broadcast.ToString()
+              << " peer=" << peer.ToString()
+              << " gateway=" << gateway.ToString();
+    rtnl_handler_->AddInterfaceAddress(interface_index_, local, broadcast,
+                                       peer);
+  }
+
+  if (gateway.IsValid() && properties.default_route &&
+      !(same_table && applied.default_route && gateway.Equals(gateway_))) {
     routing_table_->SetDefaultRoute(interface_index_, gateway,
-                                    GetMetric(is_default_),
-                                    table_id_);
+                                    kDefaultMetric,
+                                    GetDefaultRouteTableId());
   }
 
-  if (user_traffic_only_) {
+  if (user_traffic_only_ &&
+      !(has_applied_config_ && applied.user_traffic_only)) {
     SetupIptableEntries();
   }
 
   // Install any explicitly configured routes at the default metric.
-  routing_table_->ConfigureRoutes(interface_index_, config, kDefaultMetric,
-                                  table_id_);
+  if (!(same_table && applied.routes == properties.routes)) {
+    routing_table_->ConfigureRoutes(interface_index_, config, kDefaultMetric,
+                                    table_id_);
+  }
 
-  SetMTU(properties.mtu);
+  if (!(same_family && applied.mtu == properties.mtu)) {
+    SetMTU(properties.mtu);
+  }
 
-  if (properties.blackhole_ipv6) {
+  if (properties.blackhole_ipv6 && !(same_table && applied.blackhole_ipv6)) {
     routing_table_->CreateBlackholeRoute(interface_index_,
                                          IPAddress::kFamilyIPv6,
                                          kDefaultMetric,
                                          table_id_);
   }
 
+  vector<string> old_dns_servers = dns_servers_;
+  vector<string> old_dns_domain_search = dns_domain_search_;
+  string old_dns_domain_name = dns_domain_name_;
+
   // Save a copy of the last non-null DNS config.
   if (!config->properties().dns_servers.empty()) {
     dns_servers_ = config->properties().dns_servers;
@@ -292,14 +329,24 @@ void Connection::UpdateFromIPConfig(const IPConfigRefPtr& config) {
 
   ipconfig_rpc_identifier_ = config->GetRpcIdentifier();
 
-  PushDNSConfig();
+  if (!has_applied_config_ || dns_servers_ != old_dns_servers ||
+      dns_domain_search_ != old_dns_domain_search ||
+      dns_domain_name_ != old_dns_domain_name) {
+    PushDNSConfig();
+  }
 
   local_ = local;
   gateway_ = gateway;
   has_broadcast_domain_ = !peer.IsValid();
+
+  has_applied_config_ = true;
+  applied_properties_ = properties;
+  applied_broadcast_ = broadcast;
+  applied_peer_ = peer;
+  applied_table_id_ = table_id_;
 }
 
-bool Connection::SetupIptableEntries() {
+void Connection::SetupIptableEntries() {
   if (!firewall_proxy_) {
     firewall_proxy_.reset(control_interface_->CreateFirewallProxy());
   }
@@ -308,12 +355,29 @@ bool Connection::SetupIptableEntries() {
   user_names.push_back("chronos");
   user_names.push_back("debugd");
 
-  if (!firewall_proxy_->RequestVpnSetup(user_names, interface_name_)) {
-    LOG(ERROR) << "VPN iptables setup request failed.";
-    return false;
-  }
+  // The rest of the connection setup does not depend on the firewall rules,
+  // so carry on while the firewall installs them.
+  struct timeval now;
+  time_->GetTimeMonotonic(&now);
+  firewall_proxy_->RequestVpnSetupAsync(
+      user_names,
+      interface_name_,
+      Bind(&Connection::OnIptableEntriesSetUp,
+           weak_ptr_factory_.GetWeakPtr(),
+           now));
+}
 
-  return true;
+void Connection::OnIptableEntriesSetUp(const struct timeval& start_time,
+                                       const Error& error) {
+  struct timeval now = { 0, 0 };
+  struct timeval elapsed_time;
+  time_->GetTimeMonotonic(&now);
+  timersub(&now, &start_time, &elapsed_time);
+  metrics_->NotifyVpnFirewallSetupCompleted(
+      elapsed_time.tv_sec * 1000 + elapsed_time.tv_usec / 1000);
+  if (error.IsFailure()) {
+    LOG(ERROR) << "VPN iptables setup request failed: " << error;
+  }
 }
 
 bool Connection::TearDownIptableEntries() {
@@ -328,10 +392,17 @@ void Connection::SetIsDefault(bool is_default) {
     return;
   }
 
-  routing_table_->SetDefaultMetric(interface_index_, GetMetric(is_default));
-
   is_default_ = is_default;
 
+  // Becoming the default only repoints the default-network policy rule at
+  // our table; routes are left alone, and the kernel invalidates cached
+  // routes on rule changes so no flush is needed.  The rule is left pointing
+  // at our table when we stop being the default, until the next default
+  // connection claims it.
+  if (is_default && default_route_table_id_ != RT_TABLE_UNSPEC) {
+    routing_table_->SetDefaultTable(default_route_table_id_);
+  }
+
   PushDNSConfig();
   if (is_default) {
     DeviceRefPtr device = device_info_->GetDevice(interface_index_);
@@ -339,7 +410,6 @@ void Connection::SetIsDefault(bool is_default) {
       device->RequestPortalDetection();
     }
   }
-  routing_table_->FlushCache();
 }
 
 void Connection::UpdateDNSServers(const vector<string>& dns_servers) {
@@ -555,11 +625,25 @@ bool Connection::FixGatewayReachability(const IPAddress& local,
   return true;
 }
 
-uint32_t Connection::GetMetric(bool is_default) {
-  // If this is not the default route, assign a metric based on the interface
-  // index.  This way all non-default routes (even to the same gateway IP) end
-  // up with unique metrics so they do not collide.
-  return is_default ? kDefaultMetric : kNonDefaultMetricBase + interface_index_;
+uint8_t Connection::GetDefaultRouteTableId() {
+  // User-only traffic is steered to its table by a firewall mark, so its
+  // default route stays there.
+  if (user_traffic_only_) {
+    return table_id_;
+  }
+  if (default_route_table_id_ == RT_TABLE_UNSPEC) {
+    default_route_table_id_ =
+        routing_table_->AllocInterfaceTable(interface_name_);
+    if (default_route_table_id_ == RT_TABLE_UNSPEC) {
+      LOG(ERROR) << "Installing default route for " << interface_name_
+                 << " in table " << static_cast<int>(table_id_);
+      return table_id_;
+    }
+    if (is_default_) {
+      routing_table_->SetDefaultTable(default_route_table_id_);
+    }
+  }
+  return default_route_table_id_;
 }
 
 bool Connection::PinHostRoute(const IPAddress& trusted_ip,
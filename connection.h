@@ -17,6 +17,8 @@
 #ifndef SHILL_CONNECTION_H_
 #define SHILL_CONNECTION_H_
 
+#include <sys/time.h>
+
 #include <deque>
 #include <string>
 #include <vector>
@@ -34,7 +36,9 @@ namespace shill {
 
 class ControlInterface;
 class DeviceInfo;
+class Error;
 class FirewallProxyInterface;
+class Metrics;
 class RTNLHandler;
 #if !defined(__ANDROID__)
 class Resolver;
@@ -43,6 +47,7 @@ class DNSServerProxy;
 class DNSServerProxyFactory;
 #endif  // __ANDROID__
 class RoutingTable;
+class Time;
 struct RoutingTableEntry;
 
 // The Conneciton maintains the implemented state of an IPConfig, e.g,
@@ -85,7 +90,8 @@ class Connection : public base::RefCounted<Connection> {
              const std::string& interface_name,
              Technology::Identifier technology_,
              const DeviceInfo* device_info,
-             ControlInterface* control_interface);
+             ControlInterface* control_interface,
+             Metrics* metrics);
 
   // Add the contents of an IPConfig reference to the list of managed state.
   // This will replace all previous state for this address family.
@@ -115,7 +121,9 @@ class Connection : public base::RefCounted<Connection> {
     return ipconfig_rpc_identifier_;
   }
 
-  virtual bool SetupIptableEntries();
+  // Asks the firewall to install the rules for user-only traffic on this
+  // connection. The request completes asynchronously.
+  virtual void SetupIptableEntries();
   virtual bool TearDownIptableEntries();
 
   // Request to accept traffic routed to this connection even if it is not
@@ -167,11 +175,12 @@ class Connection : public base::RefCounted<Connection> {
   FRIEND_TEST(ConnectionTest, OnRouteQueryResponse);
   FRIEND_TEST(ConnectionTest, RequestHostRoute);
   FRIEND_TEST(ConnectionTest, SetMTU);
+  FRIEND_TEST(ConnectionTest, SetupIptableEntriesAsync);
   FRIEND_TEST(ConnectionTest, UpdateDNSServers);
+  FRIEND_TEST(ConnectionTest, UpdateFromIPConfigUnchanged);
   FRIEND_TEST(VPNServiceTest, OnConnectionDisconnected);
 
   static const uint32_t kDefaultMetric;
-  static const uint32_t kNonDefaultMetricBase;
   static const uint32_t kMarkForUserTraffic;
   static const uint8_t kSecondaryTableId;
 
@@ -181,7 +190,9 @@ class Connection : public base::RefCounted<Connection> {
                               IPAddress* peer,
                               IPAddress* gateway,
                               const IPAddress& trusted_ip);
-  uint32_t GetMetric(bool is_default);
+  // Returns the routing table that holds this connection's default route,
+  // allocating it on first use.
+  uint8_t GetDefaultRouteTableId();
   bool PinHostRoute(const IPAddress& trusted_ip, const IPAddress& gateway);
   void SetMTU(int32_t mtu);
 
@@ -194,6 +205,11 @@ class Connection : public base::RefCounted<Connection> {
 
   void OnLowerDisconnect();
 
+  // Called when the firewall replies to a SetupIptableEntries request made
+  // at |start_time|.
+  void OnIptableEntriesSetUp(const struct timeval& start_time,
+                             const Error& error);
+
   // Send our DNS configuration to the resolver.
   void PushDNSConfig();
 
@@ -212,9 +228,20 @@ class Connection : public base::RefCounted<Connection> {
   std::string ipconfig_rpc_identifier_;
   bool user_traffic_only_;
   uint8_t table_id_;
+  // Table holding the default route of a connection that is not limited to
+  // user traffic, or RT_TABLE_UNSPEC until that route is first installed.
+  uint8_t default_route_table_id_;
   IPAddress local_;
   IPAddress gateway_;
 
+  // State installed by the last call to UpdateFromIPConfig(), used to skip
+  // kernel and resolver updates that would not change anything.
+  bool has_applied_config_;
+  IPConfig::Properties applied_properties_;
+  IPAddress applied_broadcast_;
+  IPAddress applied_peer_;
+  uint8_t applied_table_id_;
+
   // Track the tethering status of the Service associated with this connection.
   // This property is set by a service as it takes ownership of a connection,
   // and is read by services that are bound through this connection.
@@ -239,6 +266,8 @@ class Connection : public base::RefCounted<Connection> {
   RTNLHandler* rtnl_handler_;
 
   ControlInterface* control_interface_;
+  Metrics* metrics_;
+  Time* time_;
   std::unique_ptr<FirewallProxyInterface> firewall_proxy_;
 
   DISALLOW_COPY_AND_ASSIGN(Connection);
@@ -16,6 +16,8 @@
 
 #include "shill/connection_diagnostics.h"
 
+#include <utility>
+
 #include <base/bind.h>
 #include <base/strings/stringprintf.h>
 
@@ -26,7 +28,6 @@
 #include "shill/device_info.h"
 #include "shill/dns_client.h"
 #include "shill/dns_client_factory.h"
-#include "shill/error.h"
 #include "shill/event_dispatcher.h"
 #include "shill/http_url.h"
 #include "shill/icmp_session.h"
@@ -167,6 +168,12 @@ ConnectionDiagnostics::ConnectionDiagnostics(
       arp_client_(new ArpClient(connection_->interface_index())),
       icmp_session_(new IcmpSession(dispatcher_)),
       icmp_session_factory_(IcmpSessionFactory::GetInstance()),
+      dns_server_pings_awaited_(false),
+      dns_server_pings_done_(false),
+      dns_resolution_probe_pending_(false),
+      dns_resolution_awaited_(false),
+      dns_resolution_done_(false),
+      dns_resolution_address_(IPAddress::kFamilyUnknown),
       num_dns_attempts_(0),
       running_(false),
       result_callback_(result_callback) {}
@@ -197,6 +204,7 @@ bool ConnectionDiagnostics::Start(const string& url_string) {
 
   running_ = true;
   AddEvent(kTypePortalDetection, kPhaseStart, kResultSuccess);
+  StartProbes();
   return true;
 }
 
@@ -217,6 +225,7 @@ bool ConnectionDiagnostics::StartAfterPortalDetection(
   }
 
   running_ = true;
+  StartProbes();
   dispatcher_->PostTask(
       Bind(&ConnectionDiagnostics::StartAfterPortalDetectionInternal,
            weak_ptr_factory_.GetWeakPtr(), result));
@@ -236,6 +245,13 @@ void ConnectionDiagnostics::Stop() {
   receive_response_handler_.reset();
   neighbor_msg_listener_.reset();
   id_to_pending_dns_server_icmp_session_.clear();
+  dns_server_pings_awaited_ = false;
+  dns_server_pings_done_ = false;
+  ping_probes_.clear();
+  dns_resolution_probe_pending_ = false;
+  dns_resolution_awaited_ = false;
+  dns_resolution_done_ = false;
+  dns_resolution_error_.Reset();
   target_url_.reset();
   route_query_callback_.Cancel();
   route_query_timeout_callback_.Cancel();
@@ -342,10 +358,83 @@ void ConnectionDiagnostics::StartAfterPortalDetectionInternal(
   }
 }
 
+void ConnectionDiagnostics::StartProbes() {
+  SLOG(this, 3) << __func__;
+
+  const IPAddress& gateway = connection_->gateway();
+  if (gateway.IsValid() && !gateway.IsDefault()) {
+    StartPingProbe(gateway);
+  }
+
+  if (connection_->dns_servers().empty()) {
+    // PingDNSServers and ResolveTargetServerIPAddress report this when the
+    // decision tree reaches them.
+    return;
+  }
+
+  pingable_dns_servers_.clear();
+  size_t num_invalid_dns_server_addr = 0;
+  size_t num_failed_icmp_session_start = 0;
+  StartDNSServerPings(&num_invalid_dns_server_addr,
+                      &num_failed_icmp_session_start);
+
+  Error e;
+  dns_client_.reset(dns_client_factory_->CreateDNSClient(
+      connection_->IsIPv6() ? IPAddress::kFamilyIPv6 : IPAddress::kFamilyIPv4,
+      connection_->interface_name(), connection_->dns_servers(),
+      kDNSTimeoutSeconds * 1000, dispatcher_,
+      Bind(&ConnectionDiagnostics::OnDNSResolutionProbeComplete,
+           weak_ptr_factory_.GetWeakPtr())));
+  if (!dns_client_->Start(target_url_->host(), &e)) {
+    SLOG(this, 3) << __func__ << ": could not start DNS -- " << e.message();
+    dns_client_.reset();
+    return;
+  }
+  dns_resolution_probe_pending_ = true;
+}
+
+void ConnectionDiagnostics::StartPingProbe(const IPAddress& address) {
+  const string key = address.ToString();
+  if (ping_probes_.find(key) != ping_probes_.end()) {
+    return;
+  }
+
+  std::unique_ptr<PingProbe> probe(new PingProbe());
+  probe->session.reset(icmp_session_factory_->CreateIcmpSession(dispatcher_));
+  if (!probe->session->Start(
+          address, Bind(&ConnectionDiagnostics::OnPingProbeComplete,
+                        weak_ptr_factory_.GetWeakPtr(), address))) {
+    SLOG(this, 3) << __func__ << ": could not start ping to " << key;
+    return;
+  }
+  SLOG(this, 3) << __func__ << ": pinging " << key;
+  ping_probes_[key] = std::move(probe);
+}
+
 void ConnectionDiagnostics::ResolveTargetServerIPAddress(
     const vector<string>& dns_servers) {
   SLOG(this, 3) << __func__;
 
+  if (num_dns_attempts_ == 0 &&
+      (dns_resolution_probe_pending_ || dns_resolution_done_) &&
+      dns_servers == connection_->dns_servers()) {
+    // The first attempt was already started by StartProbes.
+    AddEventWithMessage(kTypeResolveTargetServerIP, kPhaseStart,
+                        kResultSuccess,
+                        StringPrintf("Attempt #%d", num_dns_attempts_));
+    ++num_dns_attempts_;
+    if (dns_resolution_done_) {
+      dispatcher_->PostTask(
+          Bind(&ConnectionDiagnostics::ReportDNSResolutionProbeResult,
+               weak_ptr_factory_.GetWeakPtr()));
+    } else {
+      dns_resolution_awaited_ = true;
+    }
+    return;
+  }
+
+  dns_resolution_probe_pending_ = false;
+  dns_resolution_done_ = false;
   Error e;
   dns_client_.reset(dns_client_factory_->CreateDNSClient(
       connection_->IsIPv6() ? IPAddress::kFamilyIPv6 : IPAddress::kFamilyIPv4,
@@ -378,10 +467,47 @@ void ConnectionDiagnostics::PingDNSServers() {
     return;
   }
 
-  id_to_pending_dns_server_icmp_session_.clear();
+  if (!id_to_pending_dns_server_icmp_session_.empty() ||
+      dns_server_pings_done_) {
+    // The DNS servers are already being pinged by StartProbes.
+    AddEvent(kTypePingDNSServers, kPhaseStart, kResultSuccess);
+    if (dns_server_pings_done_) {
+      dns_server_pings_done_ = false;
+      dispatcher_->PostTask(
+          Bind(&ConnectionDiagnostics::OnDNSServerPingsComplete,
+               weak_ptr_factory_.GetWeakPtr()));
+    } else {
+      dns_server_pings_awaited_ = true;
+    }
+    return;
+  }
+
   pingable_dns_servers_.clear();
   size_t num_invalid_dns_server_addr = 0;
   size_t num_failed_icmp_session_start = 0;
+  StartDNSServerPings(&num_invalid_dns_server_addr,
+                      &num_failed_icmp_session_start);
+
+  if (id_to_pending_dns_server_icmp_session_.empty()) {
+    AddEventWithMessage(
+        kTypePingDNSServers, kPhaseStart, kResultFailure,
+        "Could not start ping for any of the given DNS servers");
+    if (num_invalid_dns_server_addr == connection_->dns_servers().size()) {
+      ReportResultAndStop(kIssueDNSServersInvalid);
+    } else if (num_failed_icmp_session_start ==
+               connection_->dns_servers().size()) {
+      ReportResultAndStop(kIssueInternalError);
+    }
+  } else {
+    dns_server_pings_awaited_ = true;
+    AddEvent(kTypePingDNSServers, kPhaseStart, kResultSuccess);
+  }
+}
+
+void ConnectionDiagnostics::StartDNSServerPings(
+    size_t* num_invalid_dns_server_addr,
+    size_t* num_failed_icmp_session_start) {
+  id_to_pending_dns_server_icmp_session_.clear();
   for (size_t i = 0; i < connection_->dns_servers().size(); ++i) {
     // If we encounter any errors starting ping for any DNS server, carry on
     // attempting to ping the other DNS servers rather than failing. We only
@@ -391,7 +517,7 @@ void ConnectionDiagnostics::PingDNSServers() {
     if (dns_server_ip_addr.family() == IPAddress::kFamilyUnknown) {
       LOG(ERROR) << __func__
                  << ": could not parse DNS server IP address from string";
-      ++num_invalid_dns_server_addr;
+      ++*num_invalid_dns_server_addr;
       continue;
     }
 
@@ -410,26 +536,12 @@ void ConnectionDiagnostics::PingDNSServers() {
     } else {
       LOG(ERROR) << "Failed to initiate ping for DNS server at "
                  << dns_server_ip_addr.ToString();
-      ++num_failed_icmp_session_start;
+      ++*num_failed_icmp_session_start;
       if (emplace_success) {
         id_to_pending_dns_server_icmp_session_.erase(i);
       }
     }
   }
-
-  if (id_to_pending_dns_server_icmp_session_.empty()) {
-    AddEventWithMessage(
-        kTypePingDNSServers, kPhaseStart, kResultFailure,
-        "Could not start ping for any of the given DNS servers");
-    if (num_invalid_dns_server_addr == connection_->dns_servers().size()) {
-      ReportResultAndStop(kIssueDNSServersInvalid);
-    } else if (num_failed_icmp_session_start ==
-               connection_->dns_servers().size()) {
-      ReportResultAndStop(kIssueInternalError);
-    }
-  } else {
-    AddEvent(kTypePingDNSServers, kPhaseStart, kResultSuccess);
-  }
 }
 
 void ConnectionDiagnostics::FindRouteToHost(const IPAddress& address) {
@@ -580,6 +692,24 @@ void ConnectionDiagnostics::PingHost(const IPAddress& address) {
   Type event_type = address.Equals(connection_->gateway())
                         ? kTypePingGateway
                         : kTypePingTargetServer;
+  auto probe_it = ping_probes_.find(address.ToString());
+  if (probe_it != ping_probes_.end()) {
+    // This host is already being pinged by StartPingProbe.
+    AddEventWithMessage(event_type, kPhaseStart, kResultSuccess,
+                        StringPrintf("Pinging %s", address.ToString().c_str()));
+    if (probe_it->second->done) {
+      vector<base::TimeDelta> result = probe_it->second->result;
+      ping_probes_.erase(probe_it);
+      dispatcher_->PostTask(Bind(&ConnectionDiagnostics::OnPingHostComplete,
+                                 weak_ptr_factory_.GetWeakPtr(), event_type,
+                                 address, result));
+    } else {
+      probe_it->second->awaited = true;
+      probe_it->second->awaited_type = event_type;
+    }
+    return;
+  }
+
   if (!icmp_session_->Start(
           address, Bind(&ConnectionDiagnostics::OnPingHostComplete,
                         weak_ptr_factory_.GetWeakPtr(), event_type, address))) {
@@ -622,6 +752,19 @@ void ConnectionDiagnostics::OnPingDNSServerComplete(
     return;
   }
 
+  if (!dns_server_pings_awaited_) {
+    // These pings were started by StartProbes; keep the results until
+    // PingDNSServers needs them.
+    dns_server_pings_done_ = true;
+    return;
+  }
+  OnDNSServerPingsComplete();
+}
+
+void ConnectionDiagnostics::OnDNSServerPingsComplete() {
+  SLOG(this, 3) << __func__;
+
+  dns_server_pings_awaited_ = false;
   if (pingable_dns_servers_.empty()) {
     // Use the first DNS server on the list and diagnose its connectivity.
     IPAddress first_dns_server_ip_addr(connection_->dns_servers()[0]);
@@ -688,6 +831,58 @@ void ConnectionDiagnostics::OnDNSResolutionComplete(const Error& error,
   }
 }
 
+void ConnectionDiagnostics::OnDNSResolutionProbeComplete(
+    const Error& error, const IPAddress& address) {
+  SLOG(this, 3) << __func__;
+
+  dns_resolution_probe_pending_ = false;
+  if (error.IsSuccess()) {
+    // Pinging the target web server is the next step after a successful
+    // resolution, so start it right away.
+    StartPingProbe(address);
+  }
+  if (dns_resolution_awaited_) {
+    dns_resolution_awaited_ = false;
+    OnDNSResolutionComplete(error, address);
+    return;
+  }
+  dns_resolution_done_ = true;
+  dns_resolution_error_.CopyFrom(error);
+  dns_resolution_address_ = address;
+}
+
+void ConnectionDiagnostics::ReportDNSResolutionProbeResult() {
+  SLOG(this, 3) << __func__;
+
+  Error error;
+  error.CopyFrom(dns_resolution_error_);
+  IPAddress address(dns_resolution_address_);
+  dns_resolution_done_ = false;
+  OnDNSResolutionComplete(error, address);
+}
+
+void ConnectionDiagnostics::OnPingProbeComplete(
+    const IPAddress& address, const vector<base::TimeDelta>& result) {
+  SLOG(this, 3) << __func__ << "(" << address.ToString() << ")";
+
+  auto probe_it = ping_probes_.find(address.ToString());
+  if (probe_it == ping_probes_.end()) {
+    return;
+  }
+  if (!probe_it->second->awaited) {
+    probe_it->second->done = true;
+    probe_it->second->result = result;
+    return;
+  }
+
+  // Erasing the probe destroys the IcmpSession that owns |address|, so copy
+  // what we need first.
+  Type event_type = probe_it->second->awaited_type;
+  IPAddress address_pinged(address);
+  ping_probes_.erase(probe_it);
+  OnPingHostComplete(event_type, address_pinged, result);
+}
+
 void ConnectionDiagnostics::OnPingHostComplete(
     Type ping_event_type, const IPAddress& address_pinged,
     const vector<base::TimeDelta>& result) {
@@ -26,6 +26,8 @@
 #include <base/cancelable_callback.h>
 #include <base/memory/weak_ptr.h>
 
+#include "shill/error.h"
+#include "shill/net/ip_address.h"
 #include "shill/portal_detector.h"
 #include "shill/refptr_types.h"
 
@@ -36,7 +38,6 @@ class ByteString;
 class DeviceInfo;
 class DNSClient;
 class DNSClientFactory;
-class Error;
 class EventDispatcher;
 class HTTPURL;
 class IcmpSession;
@@ -117,6 +118,13 @@ class RTNLMessage;
 //                             does not actually exist on the local network, or
 //                             there is a link layer issue. END.
 //
+// The probes in steps D, H, K and S do not depend on each other, so they are
+// started in parallel with portal detection in step A (the target web server
+// is pinged as soon as its address resolves). Each step then consumes the
+// result already collected for it, or waits for the outstanding probe, so the
+// events and conclusion reported are the same as if the steps had run one
+// after the other.
+//
 // TODO(samueltan): Step F: if retry succeeds, remove the unresponsive DNS
 // servers so Chrome does not try to use them.
 // TODO(samueltan): Step X: find ways to disambiguate the cause (e.g. can we see
@@ -230,6 +238,18 @@ class ConnectionDiagnostics {
   static const int kNeighborTableRequestTimeoutSeconds;
   static const int kDNSTimeoutSeconds;
 
+  // A ping started by ConnectionDiagnostics::StartProbes before the decision
+  // tree reaches the step that uses its result.
+  struct PingProbe {
+    PingProbe()
+        : done(false), awaited(false), awaited_type(kTypePingGateway) {}
+    std::unique_ptr<IcmpSession> session;
+    bool done;
+    bool awaited;
+    Type awaited_type;
+    std::vector<base::TimeDelta> result;
+  };
+
   // Create a new Event with |type|, |phase|, |result|, and an empty message,
   // and add it to the end of |diagnostic_events_|.
   void AddEvent(Type type, Phase phase, Result result);
@@ -246,6 +266,21 @@ class ConnectionDiagnostics {
 
   void StartAfterPortalDetectionInternal(const PortalDetector::Result& result);
 
+  // Starts the probes that do not depend on earlier diagnostic results: pings
+  // to the gateway and to all DNS servers, and resolution of |target_url_|.
+  // Probes that fail to start are simply run on demand later.
+  void StartProbes();
+
+  // Starts a ping to |address| whose result is kept for
+  // ConnectionDiagnostics::PingHost.
+  void StartPingProbe(const IPAddress& address);
+
+  // Starts an IcmpSession for each DNS server of |connection_|, counting the
+  // servers that could not be pinged in |num_invalid_dns_server_addr| and
+  // |num_failed_icmp_session_start|.
+  void StartDNSServerPings(size_t* num_invalid_dns_server_addr,
+                           size_t* num_failed_icmp_session_start);
+
   // Attempts to resolve the IP address of |target_url_| using |dns_servers|.
   void ResolveTargetServerIPAddress(
       const std::vector<std::string>& dns_servers);
@@ -282,6 +317,25 @@ class ConnectionDiagnostics {
   void OnPingDNSServerComplete(int dns_server_index,
                                const std::vector<base::TimeDelta>& result);
 
+  // Called once all DNS server pings have finished and the decision tree has
+  // reached ConnectionDiagnostics::PingDNSServers.
+  void OnDNSServerPingsComplete();
+
+  // Called when the resolution started in ConnectionDiagnostics::StartProbes
+  // completes.
+  void OnDNSResolutionProbeComplete(const Error& error,
+                                    const IPAddress& address);
+
+  // Hands the stored result of the resolution started in
+  // ConnectionDiagnostics::StartProbes to
+  // ConnectionDiagnostics::OnDNSResolutionComplete.
+  void ReportDNSResolutionProbeResult();
+
+  // Called when the ping started in ConnectionDiagnostics::StartPingProbe on
+  // |address| finishes or times out.
+  void OnPingProbeComplete(const IPAddress& address,
+                           const std::vector<base::TimeDelta>& result);
+
   // Called after the DNS IP address resolution on started in
   // ConnectionDiagnostics::ResolveTargetServerIPAddress completes.
   void OnDNSResolutionComplete(const Error& error, const IPAddress& address);
@@ -358,6 +412,24 @@ class ConnectionDiagnostics {
   std::map<int, std::unique_ptr<IcmpSession>>
       id_to_pending_dns_server_icmp_session_;
   std::vector<std::string> pingable_dns_servers_;
+  // True once ConnectionDiagnostics::PingDNSServers is waiting for the pings
+  // in |id_to_pending_dns_server_icmp_session_| to complete.
+  bool dns_server_pings_awaited_;
+  // True if all DNS server pings completed before the decision tree needed
+  // them.
+  bool dns_server_pings_done_;
+
+  // Pings started ahead of time by ConnectionDiagnostics::StartProbes, keyed
+  // by the string form of the address pinged.
+  std::map<std::string, std::unique_ptr<PingProbe>> ping_probes_;
+
+  // State of the target resolution started by
+  // ConnectionDiagnostics::StartProbes.
+  bool dns_resolution_probe_pending_;
+  bool dns_resolution_awaited_;
+  bool dns_resolution_done_;
+  Error dns_resolution_error_;
+  IPAddress dns_resolution_address_;
 
   int num_dns_attempts_;
   bool running_;
@@ -263,6 +263,9 @@ class ConnectionDiagnosticsTest : public Test {
     EXPECT_FALSE(connection_diagnostics_.neighbor_msg_listener_.get());
     EXPECT_TRUE(
         connection_diagnostics_.id_to_pending_dns_server_icmp_session_.empty());
+    EXPECT_TRUE(connection_diagnostics_.ping_probes_.empty());
+    EXPECT_FALSE(connection_diagnostics_.dns_server_pings_done_);
+    EXPECT_FALSE(connection_diagnostics_.dns_resolution_done_);
     EXPECT_FALSE(connection_diagnostics_.target_url_.get());
     EXPECT_TRUE(connection_diagnostics_.route_query_callback_.IsCancelled());
     EXPECT_TRUE(
@@ -278,6 +281,41 @@ class ConnectionDiagnosticsTest : public Test {
   }
 
   void ExpectPortalDetectionStartSuccess(const string& url_string) {
+    // None of the probes started alongside portal detection succeed, so each
+    // diagnostic step runs on demand.
+    ExpectPortalDetectionStartSuccessWithProbes(url_string, false, false,
+                                                false);
+  }
+
+  void ExpectPortalDetectionStartSuccessWithProbes(
+      const string& url_string, bool gateway_ping_started,
+      bool dns_pings_started, bool dns_resolution_started) {
+    gateway_icmp_session_ = new NiceMock<MockIcmpSession>(&dispatcher_);
+    dns_server_icmp_session_0_ = new NiceMock<MockIcmpSession>(&dispatcher_);
+    dns_server_icmp_session_1_ = new NiceMock<MockIcmpSession>(&dispatcher_);
+    EXPECT_CALL(*MockIcmpSessionFactory::GetInstance(),
+                CreateIcmpSession(&dispatcher_))
+        .WillOnce(Return(gateway_icmp_session_))
+        .WillOnce(Return(dns_server_icmp_session_0_))
+        .WillOnce(Return(dns_server_icmp_session_1_));
+    EXPECT_CALL(*gateway_icmp_session_, Start(_, _))
+        .WillOnce(Return(gateway_ping_started));
+    EXPECT_CALL(*dns_server_icmp_session_0_,
+                Start(IsSameIPAddress(IPAddress(kDNSServer0)), _))
+        .WillOnce(Return(dns_pings_started));
+    EXPECT_CALL(*dns_server_icmp_session_1_,
+                Start(IsSameIPAddress(IPAddress(kDNSServer1)), _))
+        .WillOnce(Return(dns_pings_started));
+    dns_client_ = new NiceMock<MockDNSClient>();
+    EXPECT_CALL(
+        *MockDNSClientFactory::GetInstance(),
+        CreateDNSClient(_, kInterfaceName, dns_servers_,
+                        ConnectionDiagnostics::kDNSTimeoutSeconds * 1000,
+                        &dispatcher_, _))
+        .WillOnce(Return(dns_client_));  // Passes ownership
+    EXPECT_CALL(*dns_client_, Start(_, _))
+        .WillOnce(Return(dns_resolution_started));
+
     AddExpectedEvent(ConnectionDiagnostics::kTypePortalDetection,
                      ConnectionDiagnostics::kPhaseStart,
                      ConnectionDiagnostics::kResultSuccess);
@@ -590,6 +628,113 @@ class ConnectionDiagnosticsTest : public Test {
     connection_diagnostics_.OnArpReplyReceived(1);
   }
 
+  void ExpectPingDNSServersStartProbed() {
+    AddExpectedEvent(ConnectionDiagnostics::kTypePingDNSServers,
+                     ConnectionDiagnostics::kPhaseStart,
+                     ConnectionDiagnostics::kResultSuccess);
+    bool pings_done = connection_diagnostics_.dns_server_pings_done_;
+    if (pings_done) {
+      EXPECT_CALL(dispatcher_, PostTask(_));
+    }
+    connection_diagnostics_.PingDNSServers();
+    EXPECT_EQ(!pings_done, connection_diagnostics_.dns_server_pings_awaited_);
+  }
+
+  void CompleteDNSServerPingProbes() {
+    connection_diagnostics_.OnPingDNSServerComplete(0, kNonEmptyResult);
+    connection_diagnostics_.OnPingDNSServerComplete(1, kNonEmptyResult);
+    EXPECT_TRUE(connection_diagnostics_.dns_server_pings_done_);
+  }
+
+  void ExpectResolveTargetServerIPAddressStartProbed() {
+    AddExpectedEvent(ConnectionDiagnostics::kTypeResolveTargetServerIP,
+                     ConnectionDiagnostics::kPhaseStart,
+                     ConnectionDiagnostics::kResultSuccess);
+    bool resolution_done = connection_diagnostics_.dns_resolution_done_;
+    if (resolution_done) {
+      EXPECT_CALL(dispatcher_, PostTask(_));
+    }
+    connection_diagnostics_.ResolveTargetServerIPAddress(dns_servers_);
+    EXPECT_EQ(!resolution_done,
+              connection_diagnostics_.dns_resolution_awaited_);
+  }
+
+  void ExpectResolveTargetServerIPAddressEndProbed(
+      const IPAddress& resolved_address) {
+    bool awaited = connection_diagnostics_.dns_resolution_awaited_;
+    if (awaited) {
+      AddExpectedEvent(ConnectionDiagnostics::kTypeResolveTargetServerIP,
+                       ConnectionDiagnostics::kPhaseEnd,
+                       ConnectionDiagnostics::kResultSuccess);
+      // Next action is to ping the resolved address.
+      EXPECT_CALL(dispatcher_, PostTask(_));
+    }
+    // The resolved address is pinged as soon as it is known.
+    target_icmp_session_ = new NiceMock<MockIcmpSession>(&dispatcher_);
+    EXPECT_CALL(*MockIcmpSessionFactory::GetInstance(),
+                CreateIcmpSession(&dispatcher_))
+        .WillOnce(Return(target_icmp_session_));
+    EXPECT_CALL(*target_icmp_session_,
+                Start(IsSameIPAddress(resolved_address), _))
+        .WillOnce(Return(true));
+    connection_diagnostics_.OnDNSResolutionProbeComplete(Error(),
+                                                         resolved_address);
+    EXPECT_EQ(1, connection_diagnostics_.ping_probes_.count(
+                     resolved_address.ToString()));
+    EXPECT_EQ(!awaited, connection_diagnostics_.dns_resolution_done_);
+  }
+
+  void ExpectReportDNSResolutionProbeResultSuccess() {
+    AddExpectedEvent(ConnectionDiagnostics::kTypeResolveTargetServerIP,
+                     ConnectionDiagnostics::kPhaseEnd,
+                     ConnectionDiagnostics::kResultSuccess);
+    EXPECT_CALL(dispatcher_, PostTask(_));
+    connection_diagnostics_.ReportDNSResolutionProbeResult();
+  }
+
+  void ExpectPingHostStartProbed(ConnectionDiagnostics::Type ping_event_type,
+                                 const IPAddress& address) {
+    AddExpectedEvent(ping_event_type, ConnectionDiagnostics::kPhaseStart,
+                     ConnectionDiagnostics::kResultSuccess);
+    bool probe_done =
+        connection_diagnostics_.ping_probes_[address.ToString()]->done;
+    if (probe_done) {
+      EXPECT_CALL(dispatcher_, PostTask(_));
+    }
+    EXPECT_CALL(*icmp_session_, Start(_, _)).Times(0);
+    connection_diagnostics_.PingHost(address);
+    EXPECT_EQ(probe_done ? 0 : 1,
+              connection_diagnostics_.ping_probes_.count(address.ToString()));
+  }
+
+  void CompletePingProbe(const IPAddress& address, bool success) {
+    connection_diagnostics_.OnPingProbeComplete(
+        address, success ? kNonEmptyResult : kEmptyResult);
+    EXPECT_TRUE(connection_diagnostics_.ping_probes_[address.ToString()]->done);
+  }
+
+  void ExpectPingProbeEndFailure(ConnectionDiagnostics::Type ping_event_type,
+                                 const IPAddress& address) {
+    AddExpectedEvent(ping_event_type, ConnectionDiagnostics::kPhaseEnd,
+                     ConnectionDiagnostics::kResultFailure);
+    EXPECT_CALL(dispatcher_, PostTask(_));
+    connection_diagnostics_.OnPingProbeComplete(address, kEmptyResult);
+  }
+
+  void ExpectPingProbeEndSuccess(ConnectionDiagnostics::Type ping_event_type,
+                                 const IPAddress& address) {
+    AddExpectedEvent(ping_event_type, ConnectionDiagnostics::kPhaseEnd,
+                     ConnectionDiagnostics::kResultSuccess);
+    const string& issue =
+        ping_event_type == ConnectionDiagnostics::kTypePingGateway
+            ? ConnectionDiagnostics::kIssueGatewayUpstream
+            : ConnectionDiagnostics::kIssueHTTPBrokenPortal;
+    EXPECT_CALL(metrics_, NotifyConnectionDiagnosticsIssue(issue));
+    EXPECT_CALL(callback_target(),
+                ResultCallback(issue, IsEventList(expected_events_)));
+    connection_diagnostics_.OnPingProbeComplete(address, kNonEmptyResult);
+  }
+
   void ExpectCheckIPCollisionEndFailureGatewayArpFailed() {
     ExpectCheckIPCollisionEndFailure(
         ConnectionDiagnostics::kIssueGatewayArpFailed);
@@ -835,6 +980,8 @@ class ConnectionDiagnosticsTest : public Test {
   NiceMock<MockArpClient>* arp_client_;
   NiceMock<MockDNSClient>* dns_client_;
   NiceMock<MockIcmpSession>* icmp_session_;
+  NiceMock<MockIcmpSession>* gateway_icmp_session_;
+  NiceMock<MockIcmpSession>* target_icmp_session_;
   NiceMock<MockIcmpSession>* dns_server_icmp_session_0_;
   NiceMock<MockIcmpSession>* dns_server_icmp_session_1_;
   NiceMock<MockPortalDetector>* portal_detector_;
@@ -1454,4 +1601,53 @@ TEST_F(ConnectionDiagnosticsTest, EndWith_kTypeNeighborTableLookupFailure_2) {
   VerifyStopped();
 }
 
+TEST_F(ConnectionDiagnosticsTest, EndWith_ProbesCompleteBeforeNeeded) {
+  // The gateway ping, DNS server pings and target resolution all start with
+  // portal detection and complete before portal detection ends in HTTP phase.
+  // Each step then uses the stored results, and we report the same events as
+  // EndWith_PingGatewaySuccess_1_IPv4.
+  ExpectPortalDetectionStartSuccessWithProbes(kURL, true, true, true);
+  CompleteDNSServerPingProbes();
+  ExpectResolveTargetServerIPAddressEndProbed(kIPv4ServerAddress);
+  CompletePingProbe(kIPv4ServerAddress, false);
+  CompletePingProbe(kIPv4GatewayAddress, true);
+  ExpectPortalDetectionEndHTTPPhaseFailure();
+  ExpectResolveTargetServerIPAddressStartProbed();
+  ExpectReportDNSResolutionProbeResultSuccess();
+  ExpectPingHostStartProbed(ConnectionDiagnostics::kTypePingTargetServer,
+                            kIPv4ServerAddress);
+  ExpectPingHostEndFailure(ConnectionDiagnostics::kTypePingTargetServer,
+                           kIPv4ServerAddress);
+  ExpectFindRouteToHostStartSuccess(kIPv4ServerAddress);
+  ExpectFindRouteToHostEndSuccess(kIPv4ServerAddress, false);
+  ExpectPingHostStartProbed(ConnectionDiagnostics::kTypePingGateway,
+                            kIPv4GatewayAddress);
+  ExpectPingHostEndSuccess(ConnectionDiagnostics::kTypePingGateway,
+                           kIPv4GatewayAddress);
+  VerifyStopped();
+}
+
+TEST_F(ConnectionDiagnosticsTest, EndWith_ProbesAwaited) {
+  // Portal detection ends with a DNS timeout while all probes are still
+  // outstanding. Each step waits for its probe, and we report the same events
+  // as EndWith_PingGatewaySuccess_2.
+  ExpectPortalDetectionStartSuccessWithProbes(kURL, true, true, true);
+  ExpectPortalDetectionEndDNSPhaseTimeout();
+  ExpectPingDNSServersStartProbed();
+  ExpectPingDNSServersEndSuccessRetriesLeft();
+  ExpectResolveTargetServerIPAddressStartProbed();
+  ExpectResolveTargetServerIPAddressEndProbed(kIPv4ServerAddress);
+  ExpectPingHostStartProbed(ConnectionDiagnostics::kTypePingTargetServer,
+                            kIPv4ServerAddress);
+  ExpectPingProbeEndFailure(ConnectionDiagnostics::kTypePingTargetServer,
+                            kIPv4ServerAddress);
+  ExpectFindRouteToHostStartSuccess(kIPv4ServerAddress);
+  ExpectFindRouteToHostEndSuccess(kIPv4ServerAddress, false);
+  ExpectPingHostStartProbed(ConnectionDiagnostics::kTypePingGateway,
+                            kIPv4GatewayAddress);
+  ExpectPingProbeEndSuccess(ConnectionDiagnostics::kTypePingGateway,
+                            kIPv4GatewayAddress);
+  VerifyStopped();
+}
+
 }  // namespace shill
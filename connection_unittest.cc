@@ -26,12 +26,14 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include "shill/error.h"
 #include "shill/ipconfig.h"
 #include "shill/mock_connection.h"
 #include "shill/mock_control.h"
 #include "shill/mock_device.h"
 #include "shill/mock_device_info.h"
 #include "shill/mock_firewall_proxy.h"
+#include "shill/mock_metrics.h"
 #if !defined(__ANDROID__)
 #include "shill/mock_resolver.h"
 #else
@@ -45,10 +47,12 @@
 using std::string;
 using std::vector;
 using testing::_;
+using testing::AtMost;
 using testing::Mock;
 using testing::NiceMock;
 using testing::Return;
 using testing::ReturnRef;
+using testing::SaveArg;
 using testing::StrictMock;
 using testing::Test;
 
@@ -59,6 +63,7 @@ const char kTestDeviceName0[] = "netdev0";
 const int kTestDeviceInterfaceIndex0 = 123;
 const char kTestDeviceName1[] = "netdev1";
 const int kTestDeviceInterfaceIndex1 = 321;
+const uint8_t kTestDefaultRouteTableId = 2;
 const char kIPAddress0[] = "192.168.1.1";
 const char kGatewayAddress0[] = "192.168.1.254";
 const char kBroadcastAddress0[] = "192.168.1.255";
@@ -81,12 +86,14 @@ class ConnectionTest : public Test {
             nullptr,
             nullptr,
             nullptr)),
+        metrics_(nullptr),
         connection_(new Connection(
             kTestDeviceInterfaceIndex0,
             kTestDeviceName0,
             Technology::kUnknown,
             device_info_.get(),
-            &control_)),
+            &control_,
+            &metrics_)),
         ipconfig_(new IPConfig(&control_, kTestDeviceName0)),
         ip6config_(new IPConfig(&control_, kTestDeviceName0)),
         local_address_(IPAddress::kFamilyIPv4),
@@ -163,10 +170,6 @@ class ConnectionTest : public Test {
       return Connection::kDefaultMetric;
   }
 
-  uint32_t GetNonDefaultMetricBase() {
-      return Connection::kNonDefaultMetricBase;
-  }
-
   void SetLocal(const IPAddress& local) {
     connection_->local_ = local;
   }
@@ -202,9 +205,16 @@ class ConnectionTest : public Test {
     base::Closure callback_;
   };
 
+  void ExpectDefaultRouteTableAllocation() {
+    EXPECT_CALL(routing_table_, AllocInterfaceTable(kTestDeviceName0))
+        .WillOnce(Return(kTestDefaultRouteTableId));
+  }
+
   void AddDestructorExpectations() {
     EXPECT_CALL(routing_table_, FlushRoutes(kTestDeviceInterfaceIndex0));
     EXPECT_CALL(routing_table_, FlushRoutesWithTag(kTestDeviceInterfaceIndex0));
+    EXPECT_CALL(routing_table_, FreeInterfaceTable(kTestDefaultRouteTableId))
+        .Times(AtMost(1));
     EXPECT_CALL(*device_info_.get(),
                 FlushAddresses(kTestDeviceInterfaceIndex0));
   }
@@ -216,12 +226,14 @@ class ConnectionTest : public Test {
                                                kTestDeviceName0,
                                                Technology::kUnknown,
                                                device_info_.get(),
-                                               &control_));
+                                               &control_,
+                                               &metrics_));
     ReplaceSingletons(connection);
     return connection;
   }
 
   std::unique_ptr<StrictMock<MockDeviceInfo>> device_info_;
+  MockMetrics metrics_;
   ConnectionRefPtr connection_;
   MockControl control_;
   IPConfigRefPtr ipconfig_;
@@ -290,12 +302,12 @@ TEST_F(ConnectionTest, AddConfig) {
                                   IsIPAddress(local_address_, kPrefix0),
                                   IsIPAddress(broadcast_address_, 0),
                                   IsIPAddress(default_address_, 0)));
+  ExpectDefaultRouteTableAllocation();
   EXPECT_CALL(routing_table_,
               SetDefaultRoute(kTestDeviceInterfaceIndex0,
                               IsIPAddress(gateway_address_, 0),
-                              GetNonDefaultMetricBase() +
-                              kTestDeviceInterfaceIndex0,
-                              RT_TABLE_MAIN));
+                              GetDefaultMetric(),
+                              kTestDefaultRouteTableId));
   EXPECT_CALL(routing_table_,
               ConfigureRoutes(kTestDeviceInterfaceIndex0,
                               ipconfig_,
@@ -323,8 +335,8 @@ TEST_F(ConnectionTest, AddConfig) {
   connection_->has_broadcast_domain_ = false;
   EXPECT_FALSE(connection_->CreateGatewayRoute());
 
-  EXPECT_CALL(routing_table_, SetDefaultMetric(kTestDeviceInterfaceIndex0,
-                                               GetDefaultMetric()));
+  EXPECT_CALL(routing_table_, SetDefaultTable(kTestDefaultRouteTableId))
+      .WillOnce(Return(true));
 #if !defined(__ANDROID__)
   EXPECT_CALL(resolver_, SetDNSFromLists(
       ipconfig_->properties().dns_servers,
@@ -344,18 +356,12 @@ TEST_F(ConnectionTest, AddConfig) {
       .WillOnce(Return(device));
   EXPECT_CALL(*device.get(), RequestPortalDetection())
       .WillOnce(Return(true));
-  EXPECT_CALL(routing_table_, FlushCache())
-      .WillOnce(Return(true));
   connection_->SetIsDefault(true);
   Mock::VerifyAndClearExpectations(&routing_table_);
   EXPECT_TRUE(connection_->is_default());
 
-  EXPECT_CALL(routing_table_,
-              SetDefaultMetric(kTestDeviceInterfaceIndex0,
-                               GetNonDefaultMetricBase() +
-                               kTestDeviceInterfaceIndex0));
-  EXPECT_CALL(routing_table_, FlushCache())
-      .WillOnce(Return(true));
+  // Giving up the default leaves the routes and the policy rule alone until
+  // another connection takes over.
   connection_->SetIsDefault(false);
   EXPECT_FALSE(connection_->is_default());
 }
@@ -390,7 +396,7 @@ TEST_F(ConnectionTest, AddConfigUserTrafficOnly) {
 
   MockFirewallProxy* firewall_proxy = new MockFirewallProxy();
   connection->firewall_proxy_.reset(firewall_proxy);
-  EXPECT_CALL(*firewall_proxy, RequestVpnSetup(_, _));
+  EXPECT_CALL(*firewall_proxy, RequestVpnSetupAsync(_, kTestDeviceName0, _));
   properties_.user_traffic_only = true;
   properties_.default_route = false;
   properties_.exclusion_list.push_back(kExcludeAddress1);
@@ -442,8 +448,6 @@ TEST_F(ConnectionTest, AddConfigUserTrafficOnly) {
   connection->has_broadcast_domain_ = false;
   EXPECT_FALSE(connection->CreateGatewayRoute());
 
-  EXPECT_CALL(routing_table_,
-              SetDefaultMetric(kTestDeviceInterfaceIndex0, GetDefaultMetric()));
 #if !defined(__ANDROID__)
   EXPECT_CALL(resolver_,
               SetDNSFromLists(ipconfig_->properties().dns_servers,
@@ -457,21 +461,66 @@ TEST_F(ConnectionTest, AddConfigUserTrafficOnly) {
   EXPECT_CALL(*device_info_, GetDevice(kTestDeviceInterfaceIndex0))
       .WillOnce(Return(device));
   EXPECT_CALL(*device.get(), RequestPortalDetection()).WillOnce(Return(true));
-  EXPECT_CALL(routing_table_, FlushCache()).WillOnce(Return(true));
+  EXPECT_CALL(routing_table_, SetDefaultTable(_)).Times(0);
   connection->SetIsDefault(true);
   Mock::VerifyAndClearExpectations(&routing_table_);
   EXPECT_TRUE(connection->is_default());
 
-  EXPECT_CALL(routing_table_, SetDefaultMetric(kTestDeviceInterfaceIndex0,
-                                               GetNonDefaultMetricBase() +
-                                                   kTestDeviceInterfaceIndex0));
-  EXPECT_CALL(routing_table_, FlushCache()).WillOnce(Return(true));
   connection->SetIsDefault(false);
   EXPECT_FALSE(connection->is_default());
   AddDestructorExpectations();
   EXPECT_CALL(*firewall_proxy, RemoveVpnSetup());
 }
 
+TEST_F(ConnectionTest, SetupIptableEntriesAsync) {
+  MockFirewallProxy* firewall_proxy = new MockFirewallProxy();
+  connection_->firewall_proxy_.reset(firewall_proxy);
+  ResultCallback callback;
+  EXPECT_CALL(*firewall_proxy, RequestVpnSetupAsync(_, kTestDeviceName0, _))
+      .WillOnce(SaveArg<2>(&callback));
+  EXPECT_CALL(metrics_, NotifyVpnFirewallSetupCompleted(_)).Times(0);
+  connection_->SetupIptableEntries();
+  Mock::VerifyAndClearExpectations(&metrics_);
+
+  // The firewall's reply arrives later, and its latency is recorded.
+  ASSERT_FALSE(callback.is_null());
+  EXPECT_CALL(metrics_, NotifyVpnFirewallSetupCompleted(_));
+  callback.Run(Error());
+}
+
+TEST_F(ConnectionTest, SetupIptableEntriesAsyncFailure) {
+  MockFirewallProxy* firewall_proxy = new MockFirewallProxy();
+  connection_->firewall_proxy_.reset(firewall_proxy);
+  ResultCallback callback;
+  EXPECT_CALL(*firewall_proxy, RequestVpnSetupAsync(_, kTestDeviceName0, _))
+      .WillOnce(SaveArg<2>(&callback));
+  connection_->SetupIptableEntries();
+
+  // A failed setup is only logged; its latency is recorded all the same.
+  ASSERT_FALSE(callback.is_null());
+  EXPECT_CALL(metrics_, NotifyVpnFirewallSetupCompleted(_));
+  callback.Run(Error(Error::kOperationFailed));
+}
+
+TEST_F(ConnectionTest, SetupIptableEntriesReplyAfterDestruction) {
+  ConnectionRefPtr connection = GetNewConnection();
+  MockFirewallProxy* firewall_proxy = new MockFirewallProxy();
+  connection->firewall_proxy_.reset(firewall_proxy);
+  ResultCallback callback;
+  EXPECT_CALL(*firewall_proxy, RequestVpnSetupAsync(_, kTestDeviceName0, _))
+      .WillOnce(SaveArg<2>(&callback));
+  connection->SetupIptableEntries();
+  ASSERT_FALSE(callback.is_null());
+
+  AddDestructorExpectations();
+  EXPECT_CALL(*firewall_proxy, RemoveVpnSetup());
+  connection = nullptr;
+
+  // A reply for a connection that no longer exists is dropped.
+  EXPECT_CALL(metrics_, NotifyVpnFirewallSetupCompleted(_)).Times(0);
+  callback.Run(Error());
+}
+
 TEST_F(ConnectionTest, AddConfigIPv6) {
   EXPECT_CALL(*device_info_,
               HasOtherAddress(kTestDeviceInterfaceIndex0,
@@ -544,12 +593,12 @@ TEST_F(ConnectionTest, AddConfigWithBrokenNetmask) {
                                   IsIPAddress(local_address_, kPrefix1),
                                   IsIPAddress(broadcast_address_, 0),
                                   IsIPAddress(default_address_, 0)));
+  ExpectDefaultRouteTableAllocation();
   EXPECT_CALL(routing_table_,
               SetDefaultRoute(kTestDeviceInterfaceIndex0,
                               IsIPAddress(gateway_address_, 0),
-                              GetNonDefaultMetricBase() +
-                              kTestDeviceInterfaceIndex0,
-                              RT_TABLE_MAIN));
+                              GetDefaultMetric(),
+                              kTestDefaultRouteTableId));
   EXPECT_CALL(routing_table_,
               ConfigureRoutes(kTestDeviceInterfaceIndex0,
                               ipconfig_,
@@ -561,8 +610,8 @@ TEST_F(ConnectionTest, AddConfigWithBrokenNetmask) {
 }
 
 TEST_F(ConnectionTest, AddConfigReverse) {
-  EXPECT_CALL(routing_table_, SetDefaultMetric(kTestDeviceInterfaceIndex0,
-                                               GetDefaultMetric()));
+  // Without a default route yet, there is no table to select.
+  EXPECT_CALL(routing_table_, SetDefaultTable(_)).Times(0);
   vector<string> empty_list;
 #if !defined(__ANDROID__)
   EXPECT_CALL(resolver_, SetDNSFromLists(empty_list, empty_list));
@@ -581,8 +630,6 @@ TEST_F(ConnectionTest, AddConfigReverse) {
       .WillOnce(Return(device));
   EXPECT_CALL(*device.get(), RequestPortalDetection())
       .WillOnce(Return(true));
-  EXPECT_CALL(routing_table_, FlushCache())
-      .WillOnce(Return(true));
   connection_->SetIsDefault(true);
   Mock::VerifyAndClearExpectations(&routing_table_);
 
@@ -595,10 +642,14 @@ TEST_F(ConnectionTest, AddConfigReverse) {
                                   IsIPAddress(local_address_, kPrefix0),
                                   IsIPAddress(broadcast_address_, 0),
                                   IsIPAddress(default_address_, 0)));
+  // The table is selected as soon as it is allocated.
+  ExpectDefaultRouteTableAllocation();
+  EXPECT_CALL(routing_table_, SetDefaultTable(kTestDefaultRouteTableId))
+      .WillOnce(Return(true));
   EXPECT_CALL(routing_table_, SetDefaultRoute(kTestDeviceInterfaceIndex0,
                                               IsIPAddress(gateway_address_, 0),
                                               GetDefaultMetric(),
-                                              RT_TABLE_MAIN));
+                                              kTestDefaultRouteTableId));
   EXPECT_CALL(routing_table_,
               ConfigureRoutes(kTestDeviceInterfaceIndex0,
                               ipconfig_,
@@ -624,12 +675,14 @@ TEST_F(ConnectionTest, AddConfigWithDNSDomain) {
   EXPECT_CALL(*device_info_, HasOtherAddress(_, _))
       .WillOnce(Return(false));
   EXPECT_CALL(rtnl_handler_, AddInterfaceAddress(_, _, _, _));
+  ExpectDefaultRouteTableAllocation();
   EXPECT_CALL(routing_table_, SetDefaultRoute(_, _, _, _));
   EXPECT_CALL(routing_table_, ConfigureRoutes(_, _, _, _));
   EXPECT_CALL(rtnl_handler_, SetInterfaceMTU(_, _));
   connection_->UpdateFromIPConfig(ipconfig_);
 
-  EXPECT_CALL(routing_table_, SetDefaultMetric(_, _));
+  EXPECT_CALL(routing_table_, SetDefaultTable(kTestDefaultRouteTableId))
+      .WillOnce(Return(true));
   vector<string> domain_search_list;
   domain_search_list.push_back(kDomainName + ".");
 #if !defined(__ANDROID__)
@@ -639,7 +692,6 @@ TEST_F(ConnectionTest, AddConfigWithDNSDomain) {
 #endif  // __ANDROID__
   DeviceRefPtr device;
   EXPECT_CALL(*device_info_, GetDevice(_)).WillOnce(Return(device));
-  EXPECT_CALL(routing_table_, FlushCache()).WillOnce(Return(true));
   connection_->SetIsDefault(true);
 }
 
@@ -655,12 +707,12 @@ TEST_F(ConnectionTest, HasOtherAddress) {
                                   IsIPAddress(local_address_, kPrefix0),
                                   IsIPAddress(broadcast_address_, 0),
                                   IsIPAddress(default_address_, 0)));
+  ExpectDefaultRouteTableAllocation();
   EXPECT_CALL(routing_table_,
               SetDefaultRoute(kTestDeviceInterfaceIndex0,
                               IsIPAddress(gateway_address_, 0),
-                              GetNonDefaultMetricBase() +
-                              kTestDeviceInterfaceIndex0,
-                              RT_TABLE_MAIN));
+                              GetDefaultMetric(),
+                              kTestDefaultRouteTableId));
   EXPECT_CALL(routing_table_,
               ConfigureRoutes(kTestDeviceInterfaceIndex0,
                               ipconfig_,
@@ -737,7 +789,8 @@ TEST_F(ConnectionTest, Destructor) {
                                              kTestDeviceName1,
                                              Technology::kUnknown,
                                              device_info_.get(),
-                                             &control_));
+                                             &control_,
+                                             &metrics_));
 #if !defined(__ANDROID__)
   connection->resolver_ = &resolver_;
 #else
@@ -776,6 +829,7 @@ TEST_F(ConnectionTest, BlackholeIPv6) {
   EXPECT_CALL(*device_info_, HasOtherAddress(_, _))
       .WillOnce(Return(false));
   EXPECT_CALL(rtnl_handler_, AddInterfaceAddress(_, _, _, _));
+  ExpectDefaultRouteTableAllocation();
   EXPECT_CALL(routing_table_, SetDefaultRoute(_, _, _, _));
   EXPECT_CALL(routing_table_, ConfigureRoutes(_, _, _, _));
   EXPECT_CALL(routing_table_,
@@ -789,6 +843,61 @@ TEST_F(ConnectionTest, BlackholeIPv6) {
   connection_->UpdateFromIPConfig(ipconfig_);
 }
 
+TEST_F(ConnectionTest, UpdateFromIPConfigUnchanged) {
+  connection_->is_default_ = true;
+  EXPECT_CALL(*device_info_, HasOtherAddress(_, _))
+      .WillRepeatedly(Return(false));
+  EXPECT_CALL(rtnl_handler_, AddInterfaceAddress(_, _, _, _));
+  ExpectDefaultRouteTableAllocation();
+  EXPECT_CALL(routing_table_, SetDefaultTable(kTestDefaultRouteTableId))
+      .WillOnce(Return(true));
+  EXPECT_CALL(routing_table_, SetDefaultRoute(_, _, _, _));
+  EXPECT_CALL(routing_table_, ConfigureRoutes(_, _, _, _));
+  EXPECT_CALL(rtnl_handler_, SetInterfaceMTU(_, _));
+#if !defined(__ANDROID__)
+  EXPECT_CALL(resolver_, SetDNSFromLists(_, _));
+#else
+  ExpectDNSServerProxyCreation(ipconfig_->properties().dns_servers, true);
+#endif  // __ANDROID__
+  connection_->UpdateFromIPConfig(ipconfig_);
+  Mock::VerifyAndClearExpectations(&rtnl_handler_);
+  Mock::VerifyAndClearExpectations(&routing_table_);
+#if !defined(__ANDROID__)
+  Mock::VerifyAndClearExpectations(&resolver_);
+#else
+  Mock::VerifyAndClearExpectations(&dns_server_proxy_factory_);
+#endif  // __ANDROID__
+
+  // An identical renewal should not touch the kernel or the resolver.
+  connection_->UpdateFromIPConfig(ipconfig_);
+  Mock::VerifyAndClearExpectations(&rtnl_handler_);
+  Mock::VerifyAndClearExpectations(&routing_table_);
+
+  // Only the MTU and DNS servers change, so only they are reapplied.
+  const int kNewMTU = 1400;
+  properties_.mtu = kNewMTU;
+  properties_.dns_servers.pop_back();
+  UpdateProperties();
+  EXPECT_CALL(rtnl_handler_, SetInterfaceMTU(kTestDeviceInterfaceIndex0,
+                                             kNewMTU));
+#if !defined(__ANDROID__)
+  EXPECT_CALL(resolver_, SetDNSFromLists(properties_.dns_servers, _));
+#else
+  ExpectDNSServerProxyCreation(properties_.dns_servers, true);
+#endif  // __ANDROID__
+  connection_->UpdateFromIPConfig(ipconfig_);
+  Mock::VerifyAndClearExpectations(&rtnl_handler_);
+  Mock::VerifyAndClearExpectations(&routing_table_);
+
+  // A new gateway is installed without readding the address.
+  properties_.gateway = "192.168.1.253";
+  UpdateProperties();
+  EXPECT_CALL(routing_table_, SetDefaultRoute(kTestDeviceInterfaceIndex0, _,
+                                              GetDefaultMetric(),
+                                              kTestDefaultRouteTableId));
+  connection_->UpdateFromIPConfig(ipconfig_);
+}
+
 TEST_F(ConnectionTest, PinHostRoute) {
   ConnectionRefPtr connection = GetNewConnection();
 
@@ -17,6 +17,7 @@
 #include "shill/daemon_task.h"
 
 #include <base/bind.h>
+#include <base/files/file_path.h>
 
 #if !defined(ENABLE_JSON_STORE)
 #include <glib-object.h>
@@ -55,6 +56,16 @@ static auto kModuleLogScope = ScopeLogger::kDaemon;
 static string ObjectID(DaemonTask* d) { return "(chromeos_daemon)"; }
 }
 
+#if !defined(DISABLE_WIFI)
+namespace {
+
+// Netlink packets kept because of the netlink_capture_packets setting are
+// written to this file in the run directory when the daemon stops.
+const char kNetlinkCaptureFileName[] = "netlink_capture";
+
+}  // namespace
+#endif  // DISABLE_WIFI
+
 DaemonTask::DaemonTask(const Settings& settings, Config* config)
     : settings_(settings), config_(config) {}
 
@@ -79,6 +90,11 @@ void DaemonTask::ApplySettings() {
   }
   manager_->SetAcceptHostnameFrom(settings_.accept_hostname_from);
   manager_->SetDHCPv6EnabledDevices(settings_.dhcpv6_enabled_devices);
+#if !defined(DISABLE_WIFI)
+  if (netlink_manager_ && settings_.netlink_capture_packets) {
+    netlink_manager_->SetPacketCaptureSize(settings_.netlink_capture_packets);
+  }
+#endif  // DISABLE_WIFI
 }
 
 bool DaemonTask::Quit(const base::Closure& completion_callback) {
@@ -166,7 +182,7 @@ void DaemonTask::Start() {
   metrics_->Start();
   rtnl_handler_->Start(RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV4_ROUTE |
                        RTMGRP_IPV6_IFADDR | RTMGRP_IPV6_ROUTE |
-                       RTMGRP_ND_USEROPT);
+                       RTMGRP_ND_USEROPT | RTMGRP_NEIGH);
   routing_table_->Start();
   dhcp_provider_->Init(control_.get(), dispatcher_.get(), metrics_.get());
   process_manager_->Init(dispatcher_.get());
@@ -198,6 +214,11 @@ void DaemonTask::Stop() {
   manager_ = nullptr;  // Release manager resources, including DBus adaptor.
 #if !defined(DISABLE_WIFI)
   callback80211_metrics_ = nullptr;
+  if (netlink_manager_ && settings_.netlink_capture_packets) {
+    netlink_manager_->DumpCapturedPackets(
+        base::FilePath(config_->GetRunDirectory())
+            .Append(kNetlinkCaptureFileName));
+  }
 #endif  // DISABLE_WIFI
   metrics_->Stop();
   process_manager_->Stop();
@@ -57,6 +57,7 @@ class DaemonTask {
     Settings()
         : ignore_unknown_ethernet(false),
           minimum_mtu(0),
+          netlink_capture_packets(0),
           passive_mode(false),
           use_portal_list(false) {}
     std::string accept_hostname_from;
@@ -66,6 +67,7 @@ class DaemonTask {
     std::vector<std::string> dhcpv6_enabled_devices;
     bool ignore_unknown_ethernet;
     int minimum_mtu;
+    int netlink_capture_packets;
     bool passive_mode;
     std::string portal_list;
     std::string prepend_dns_servers;
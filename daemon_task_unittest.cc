@@ -20,6 +20,7 @@
 #include <vector>
 
 #include <base/bind.h>
+#include <base/files/file_path.h>
 #include <base/memory/ref_counted.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -153,7 +154,8 @@ TEST_F(DaemonTaskTest, StartStop) {
   EXPECT_CALL(*metrics_, Start());
   EXPECT_CALL(rtnl_handler_, Start(RTMGRP_LINK | RTMGRP_IPV4_IFADDR |
                                    RTMGRP_IPV4_ROUTE | RTMGRP_IPV6_IFADDR |
-                                   RTMGRP_IPV6_ROUTE | RTMGRP_ND_USEROPT));
+                                   RTMGRP_IPV6_ROUTE | RTMGRP_ND_USEROPT |
+                                   RTMGRP_NEIGH));
   Expectation routing_table_started = EXPECT_CALL(routing_table_, Start());
   EXPECT_CALL(dhcp_provider_, Init(_, _, _));
   EXPECT_CALL(process_manager_, Init(_));
@@ -173,8 +175,30 @@ TEST_F(DaemonTaskTest, StartStop) {
   EXPECT_CALL(*manager_, Stop());
   EXPECT_CALL(*metrics_, Stop());
   EXPECT_CALL(process_manager_, Stop());
+#if !defined(DISABLE_WIFI)
+  // Netlink packets are not captured by default.
+  EXPECT_CALL(netlink_manager_, DumpCapturedPackets(_)).Times(0);
+#endif  // DISABLE_WIFI
+  StopDaemon();
+}
+
+#if !defined(DISABLE_WIFI)
+TEST_F(DaemonTaskTest, StopDumpsNetlinkCapture) {
+  DaemonTask::Settings settings;
+  settings.netlink_capture_packets = 64;
+  EXPECT_CALL(netlink_manager_, SetPacketCaptureSize(64));
+  ApplySettings(settings);
+
+  EXPECT_CALL(*manager_, Stop());
+  EXPECT_CALL(*metrics_, Stop());
+  EXPECT_CALL(process_manager_, Stop());
+  EXPECT_CALL(netlink_manager_,
+              DumpCapturedPackets(base::FilePath(config_.GetRunDirectory())
+                                      .Append("netlink_capture")))
+      .WillOnce(Return(true));
   StopDaemon();
 }
+#endif  // DISABLE_WIFI
 
 ACTION_P2(CompleteAction, manager, name) {
   manager->TerminationActionComplete(name);
@@ -217,6 +241,9 @@ TEST_F(DaemonTaskTest, ApplySettings) {
   EXPECT_CALL(*manager_, SetPrependDNSServers(""));
   EXPECT_CALL(*manager_, SetMinimumMTU(_)).Times(0);
   EXPECT_CALL(*manager_, SetAcceptHostnameFrom(""));
+#if !defined(DISABLE_WIFI)
+  EXPECT_CALL(netlink_manager_, SetPacketCaptureSize(_)).Times(0);
+#endif  // DISABLE_WIFI
   ApplySettings(settings);
   Mock::VerifyAndClearExpectations(manager_);
 
@@ -17,6 +17,7 @@
 #include "shill/dbus/chromeos_dbus_adaptor.h"
 
 #include <string>
+#include <vector>
 
 #include <base/bind.h>
 #include <base/callback.h>
@@ -29,6 +30,7 @@ using base::Passed;
 using brillo::dbus_utils::DBusObject;
 using brillo::dbus_utils::ExportedObjectManager;
 using std::string;
+using std::vector;
 
 namespace shill {
 
@@ -47,12 +49,39 @@ const char ChromeosDBusAdaptor::kNullPath[] = "/";
 ChromeosDBusAdaptor::ChromeosDBusAdaptor(const scoped_refptr<dbus::Bus>& bus,
                                          const std::string& object_path)
     : dbus_path_(object_path),
-      dbus_object_(new DBusObject(nullptr, bus, dbus_path_)) {
+      dbus_object_(new DBusObject(nullptr, bus, dbus_path_)),
+      registration_started_(false) {
   SLOG(this, 2) << "DBusAdaptor: " << object_path;
 }
 
 ChromeosDBusAdaptor::~ChromeosDBusAdaptor() {}
 
+void ChromeosDBusAdaptor::RegisterDBusObjectAsync(
+    const base::Callback<void(bool)>& completion_callback) {
+  SLOG(this, 2) << __func__;
+  registration_started_ = true;
+  dbus_object_->RegisterAsync(completion_callback);
+  vector<base::Closure> signals;
+  signals.swap(pending_signals_);
+  for (const auto& signal : signals) {
+    signal.Run();
+  }
+}
+
+void ChromeosDBusAdaptor::SendSignalWhenExported(const base::Closure& signal) {
+  if (registration_started_) {
+    signal.Run();
+    return;
+  }
+  pending_signals_.push_back(signal);
+}
+
+void ChromeosDBusAdaptor::UnregisterDBusObjectAsync() {
+  if (registration_started_) {
+    dbus_object_->UnregisterAsync();
+  }
+}
+
 // static
 bool ChromeosDBusAdaptor::SetProperty(PropertyStore* store,
                                       const std::string& name,
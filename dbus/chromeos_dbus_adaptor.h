@@ -18,6 +18,7 @@
 #define SHILL_DBUS_CHROMEOS_DBUS_ADAPTOR_H_
 
 #include <string>
+#include <vector>
 
 #include <base/callback.h>
 #include <base/macros.h>
@@ -48,6 +49,13 @@ class ChromeosDBusAdaptor : public base::SupportsWeakPtr<ChromeosDBusAdaptor> {
 
   const dbus::ObjectPath& dbus_path() const { return dbus_path_; }
 
+  // Exports the D-Bus object without blocking, and runs
+  // |completion_callback| with the result once all of its methods have
+  // been exported.  Signals held back by SendSignalWhenExported() are
+  // sent once the export has started.
+  void RegisterDBusObjectAsync(
+      const base::Callback<void(bool)>& completion_callback);
+
  protected:
   FRIEND_TEST(ChromeosDBusAdaptorTest, SanitizePathElement);
 
@@ -93,6 +101,16 @@ class ChromeosDBusAdaptor : public base::SupportsWeakPtr<ChromeosDBusAdaptor> {
     return dbus_object_.get();
   }
 
+  // Runs |signal|, which sends a D-Bus signal from this object, once the
+  // object's export has started.  DBusObject drops signals sent before
+  // then, and objects often announce properties in the same iteration of
+  // the event loop that creates them.
+  void SendSignalWhenExported(const base::Closure& signal);
+
+  // Unexports the D-Bus object, if RegisterDBusObjectAsync() was ever
+  // called.  An adaptor may be destroyed before its export has started.
+  void UnregisterDBusObjectAsync();
+
   // Set the property with |name| through |store|. Returns true if and
   // only if the property was changed. Updates |error| if a) an error
   // was encountered, and b) |error| is non-NULL. Otherwise, |error| is
@@ -135,6 +153,8 @@ class ChromeosDBusAdaptor : public base::SupportsWeakPtr<ChromeosDBusAdaptor> {
 
   dbus::ObjectPath dbus_path_;
   std::unique_ptr<brillo::dbus_utils::DBusObject> dbus_object_;
+  bool registration_started_;
+  std::vector<base::Closure> pending_signals_;
 
   DISALLOW_COPY_AND_ASSIGN(ChromeosDBusAdaptor);
 };
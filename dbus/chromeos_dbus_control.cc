@@ -16,6 +16,8 @@
 
 #include "shill/dbus/chromeos_dbus_control.h"
 
+#include <limits>
+
 #include <brillo/dbus/async_event_sequencer.h>
 
 #if defined(__ANDROID__)
@@ -78,10 +80,13 @@
 #include "shill/dbus/chromeos_wimax_network_proxy.h"
 #endif  // DISABLE_WIMAX
 
+#include "shill/event_dispatcher.h"
+#include "shill/logging.h"
 #include "shill/manager.h"
 
 using brillo::dbus_utils::AsyncEventSequencer;
 using std::string;
+using std::vector;
 
 namespace shill {
 
@@ -90,7 +95,8 @@ const char ChromeosDBusControl::kNullPath[] = "/";
 
 ChromeosDBusControl::ChromeosDBusControl(EventDispatcher* dispatcher)
     : dispatcher_(dispatcher),
-      null_identifier_(kNullPath) {
+      null_identifier_(kNullPath),
+      next_registration_batch_(0) {
   dbus::Bus::Options options;
   options.bus_type = dbus::Bus::SYSTEM;
 
@@ -130,7 +136,84 @@ void ChromeosDBusControl::RegisterManagerObject(
 
 template <typename Object, typename AdaptorInterface, typename Adaptor>
 AdaptorInterface* ChromeosDBusControl::CreateAdaptor(Object* object) {
-  return new Adaptor(adaptor_bus_, object);
+  Adaptor* adaptor = new Adaptor(adaptor_bus_, object);
+  QueueAdaptorRegistration(adaptor);
+  return adaptor;
+}
+
+void ChromeosDBusControl::QueueAdaptorRegistration(
+    ChromeosDBusAdaptor* adaptor) {
+  pending_adaptors_.push_back(adaptor->AsWeakPtr());
+  if (pending_adaptors_.size() == 1) {
+    dispatcher_->PostTask(
+        base::Bind(&ChromeosDBusControl::RegisterPendingAdaptors,
+                   base::Unretained(this)));
+  }
+}
+
+void ChromeosDBusControl::RegisterPendingAdaptors() {
+  vector<base::WeakPtr<ChromeosDBusAdaptor>> adaptors;
+  adaptors.swap(pending_adaptors_);
+  int batch = next_registration_batch_++;
+  registration_batches_in_flight_.insert(batch);
+  scoped_refptr<AsyncEventSequencer> sequencer(new AsyncEventSequencer());
+  for (const auto& adaptor : adaptors) {
+    // Adaptors destroyed before this task ran never need exporting.
+    if (!adaptor) {
+      continue;
+    }
+    adaptor->RegisterDBusObjectAsync(
+        sequencer->GetHandler("Adaptor RegisterAsync() failed.", false));
+  }
+  sequencer->OnAllTasksCompletedCall({
+      base::Bind(&ChromeosDBusControl::OnPendingAdaptorsRegistered,
+                 base::Unretained(this), batch)
+  });
+}
+
+void ChromeosDBusControl::OnPendingAdaptorsRegistered(int batch,
+                                                      bool success) {
+  LOG_IF(ERROR, !success) << "Failed to export one or more D-Bus objects.";
+  registration_batches_in_flight_.erase(batch);
+  RunFinishedRegistrationWaiters();
+}
+
+void ChromeosDBusControl::RunFinishedRegistrationWaiters() {
+  // Batches are numbered in the order they are queued, so every batch below
+  // the oldest unfinished one has finished.
+  int oldest_unfinished_batch = std::numeric_limits<int>::max();
+  if (!registration_batches_in_flight_.empty()) {
+    oldest_unfinished_batch = *registration_batches_in_flight_.begin();
+  } else if (!pending_adaptors_.empty()) {
+    oldest_unfinished_batch = next_registration_batch_;
+  }
+  vector<base::Closure> finished;
+  auto it = registration_waiters_.begin();
+  while (it != registration_waiters_.end()) {
+    if (it->first < oldest_unfinished_batch) {
+      finished.push_back(it->second);
+      it = registration_waiters_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  for (const auto& waiter : finished) {
+    waiter.Run();
+  }
+}
+
+void ChromeosDBusControl::RunAfterPendingRegistrations(
+    const base::Closure& callback) {
+  int last_batch;
+  if (!pending_adaptors_.empty()) {
+    last_batch = next_registration_batch_;
+  } else if (!registration_batches_in_flight_.empty()) {
+    last_batch = *registration_batches_in_flight_.rbegin();
+  } else {
+    callback.Run();
+    return;
+  }
+  registration_waiters_.push_back(std::make_pair(last_batch, callback));
 }
 
 void ChromeosDBusControl::OnDBusServiceRegistered(
@@ -169,7 +252,8 @@ IPConfigAdaptorInterface* ChromeosDBusControl::CreateIPConfigAdaptor(
 
 ManagerAdaptorInterface* ChromeosDBusControl::CreateManagerAdaptor(
     Manager* manager) {
-  return new ChromeosManagerDBusAdaptor(adaptor_bus_, proxy_bus_, manager);
+  return new ChromeosManagerDBusAdaptor(adaptor_bus_, proxy_bus_, manager,
+                                        this);
 }
 
 ProfileAdaptorInterface* ChromeosDBusControl::CreateProfileAdaptor(
@@ -18,14 +18,19 @@
 #define SHILL_DBUS_CHROMEOS_DBUS_CONTROL_H_
 
 #include <memory>
+#include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include <base/memory/weak_ptr.h>
 #include <brillo/dbus/exported_object_manager.h>
 
 #include "shill/control_interface.h"
 
 namespace shill {
 
+class ChromeosDBusAdaptor;
 class EventDispatcher;
 class Manager;
 
@@ -50,6 +55,11 @@ class ChromeosDBusControl : public ControlInterface {
 
   const std::string& NullRPCIdentifier() override;
 
+  // Runs |callback| once every adaptor created so far has finished exporting
+  // its D-Bus object.  Adaptors created afterwards do not delay |callback|.
+  // Runs |callback| immediately if nothing is outstanding.
+  void RunAfterPendingRegistrations(const base::Closure& callback);
+
   // The caller retains ownership of 'delegate'.  It must not be deleted before
   // the proxy.
   PowerManagerProxyInterface* CreatePowerManagerProxy(
@@ -163,6 +173,15 @@ class ChromeosDBusControl : public ControlInterface {
   template <typename Object, typename AdaptorInterface, typename Adaptor>
   AdaptorInterface* CreateAdaptor(Object* object);
 
+  // Adaptors are not exported from their constructors.  Instead they are
+  // queued here and exported together, without blocking, from a task posted
+  // on the event loop.  Each such batch is numbered, so that a registration
+  // waiter only waits for the batches that were queued before it.
+  void QueueAdaptorRegistration(ChromeosDBusAdaptor* adaptor);
+  void RegisterPendingAdaptors();
+  void OnPendingAdaptorsRegistered(int batch, bool success);
+  void RunFinishedRegistrationWaiters();
+
   void OnDBusServiceRegistered(
       const base::Callback<void(bool)>& completion_action, bool success);
   void TakeServiceOwnership(bool success);
@@ -177,6 +196,12 @@ class ChromeosDBusControl : public ControlInterface {
   EventDispatcher* dispatcher_;
   std::string null_identifier_;
   base::Closure registration_done_callback_;
+  // Adaptors to be exported in batch |next_registration_batch_|.
+  std::vector<base::WeakPtr<ChromeosDBusAdaptor>> pending_adaptors_;
+  int next_registration_batch_;
+  std::set<int> registration_batches_in_flight_;
+  // Each callback runs once its batch and all earlier ones have finished.
+  std::vector<std::pair<int, base::Closure>> registration_waiters_;
 };
 
 }  // namespace shill
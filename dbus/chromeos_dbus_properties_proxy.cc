@@ -16,6 +16,7 @@
 
 #include "shill/dbus/chromeos_dbus_properties_proxy.h"
 
+#include "shill/error.h"
 #include "shill/logging.h"
 
 namespace shill {
@@ -80,6 +81,75 @@ brillo::Any ChromeosDBusPropertiesProxy::Get(const string& interface_name,
   return value;
 }
 
+void ChromeosDBusPropertiesProxy::GetAllAsync(
+    const string& interface_name, const KeyValueStoreCallback& callback) {
+  SLOG(&proxy_->GetObjectPath(), 2) << __func__ << "(" << interface_name << ")";
+  proxy_->GetAllAsync(
+      interface_name,
+      base::Bind(&ChromeosDBusPropertiesProxy::OnGetAllSuccess,
+                 weak_factory_.GetWeakPtr(),
+                 callback,
+                 interface_name),
+      base::Bind(&ChromeosDBusPropertiesProxy::OnGetAllFailure,
+                 weak_factory_.GetWeakPtr(),
+                 callback,
+                 interface_name));
+}
+
+void ChromeosDBusPropertiesProxy::GetAsync(const string& interface_name,
+                                           const string& property,
+                                           const GetCallback& callback) {
+  SLOG(&proxy_->GetObjectPath(), 2) << __func__ << "(" << interface_name
+      << ", " << property << ")";
+  proxy_->GetAsync(
+      interface_name,
+      property,
+      base::Bind(&ChromeosDBusPropertiesProxy::OnGetSuccess,
+                 weak_factory_.GetWeakPtr(),
+                 callback,
+                 property),
+      base::Bind(&ChromeosDBusPropertiesProxy::OnGetFailure,
+                 weak_factory_.GetWeakPtr(),
+                 callback,
+                 property));
+}
+
+void ChromeosDBusPropertiesProxy::OnGetAllSuccess(
+    const KeyValueStoreCallback& callback,
+    const string& interface_name,
+    const brillo::VariantDictionary& properties) {
+  SLOG(&proxy_->GetObjectPath(), 2) << __func__ << "(" << interface_name << ")";
+  KeyValueStore properties_store;
+  KeyValueStore::ConvertFromVariantDictionary(properties, &properties_store);
+  callback.Run(properties_store, Error());
+}
+
+void ChromeosDBusPropertiesProxy::OnGetAllFailure(
+    const KeyValueStoreCallback& callback,
+    const string& interface_name,
+    brillo::Error* dbus_error) {
+  LOG(ERROR) << "GetAll failed on " << interface_name << ": "
+             << dbus_error->GetCode() << " " << dbus_error->GetMessage();
+  callback.Run(KeyValueStore(),
+               Error(Error::kOperationFailed, dbus_error->GetMessage()));
+}
+
+void ChromeosDBusPropertiesProxy::OnGetSuccess(const GetCallback& callback,
+                                               const string& property,
+                                               const brillo::Any& value) {
+  SLOG(&proxy_->GetObjectPath(), 2) << __func__ << "(" << property << ")";
+  callback.Run(value, Error());
+}
+
+void ChromeosDBusPropertiesProxy::OnGetFailure(const GetCallback& callback,
+                                               const string& property,
+                                               brillo::Error* dbus_error) {
+  LOG(ERROR) << "Get failed for " << property << ": "
+             << dbus_error->GetCode() << " " << dbus_error->GetMessage();
+  callback.Run(brillo::Any(),
+               Error(Error::kOperationFailed, dbus_error->GetMessage()));
+}
+
 void ChromeosDBusPropertiesProxy::MmPropertiesChanged(
     const string& interface,
     const brillo::VariantDictionary& properties) {
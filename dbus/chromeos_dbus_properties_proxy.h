@@ -40,6 +40,11 @@ class ChromeosDBusPropertiesProxy : public DBusPropertiesProxyInterface {
   KeyValueStore GetAll(const std::string& interface_name) override;
   brillo::Any Get(const std::string& interface_name,
                   const std::string& property) override;
+  void GetAllAsync(const std::string& interface_name,
+                   const KeyValueStoreCallback& callback) override;
+  void GetAsync(const std::string& interface_name,
+                const std::string& property,
+                const GetCallback& callback) override;
 
   void set_properties_changed_callback(
       const PropertiesChangedCallback& callback) override {
@@ -61,6 +66,20 @@ class ChromeosDBusPropertiesProxy : public DBusPropertiesProxyInterface {
       const brillo::VariantDictionary& changed_properties,
       const std::vector<std::string>& invalidated_properties);
 
+  // Completion handlers for the asynchronous calls.
+  void OnGetAllSuccess(const KeyValueStoreCallback& callback,
+                       const std::string& interface_name,
+                       const brillo::VariantDictionary& properties);
+  void OnGetAllFailure(const KeyValueStoreCallback& callback,
+                       const std::string& interface_name,
+                       brillo::Error* dbus_error);
+  void OnGetSuccess(const GetCallback& callback,
+                    const std::string& property,
+                    const brillo::Any& value);
+  void OnGetFailure(const GetCallback& callback,
+                    const std::string& property,
+                    brillo::Error* dbus_error);
+
   // Called when signal is connected to the ObjectProxy.
   void OnSignalConnected(const std::string& interface_name,
                          const std::string& signal_name,
@@ -16,10 +16,13 @@
 
 #include "shill/dbus/chromeos_device_dbus_adaptor.h"
 
+#include <base/bind.h>
+
 #include "shill/device.h"
 #include "shill/error.h"
 #include "shill/logging.h"
 
+using base::Bind;
 using brillo::dbus_utils::AsyncEventSequencer;
 using brillo::dbus_utils::DBusObject;
 using brillo::dbus_utils::ExportedObjectManager;
@@ -47,11 +50,10 @@ ChromeosDeviceDBusAdaptor::ChromeosDeviceDBusAdaptor(
       device_(device) {
   // Register DBus object.
   RegisterWithDBusObject(dbus_object());
-  dbus_object()->RegisterAndBlock();
 }
 
 ChromeosDeviceDBusAdaptor::~ChromeosDeviceDBusAdaptor() {
-  dbus_object()->UnregisterAsync();
+  UnregisterDBusObjectAsync();
   device_ = nullptr;
 }
 
@@ -62,48 +64,48 @@ const string& ChromeosDeviceDBusAdaptor::GetRpcIdentifier() {
 void ChromeosDeviceDBusAdaptor::EmitBoolChanged(const string& name,
                                                 bool value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(value));
+  SendPropertyChanged(name, brillo::Any(value));
 }
 
 void ChromeosDeviceDBusAdaptor::EmitUintChanged(const string& name,
                                                 uint32_t value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(value));
+  SendPropertyChanged(name, brillo::Any(value));
 }
 
 void ChromeosDeviceDBusAdaptor::EmitUint16Changed(const string& name,
                                                   uint16_t value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(value));
+  SendPropertyChanged(name, brillo::Any(value));
 }
 
 void ChromeosDeviceDBusAdaptor::EmitIntChanged(const string& name, int value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(value));
+  SendPropertyChanged(name, brillo::Any(value));
 }
 
 void ChromeosDeviceDBusAdaptor::EmitStringChanged(const string& name,
                                                   const string& value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(value));
+  SendPropertyChanged(name, brillo::Any(value));
 }
 
 void ChromeosDeviceDBusAdaptor::EmitStringmapChanged(const string& name,
                                                      const Stringmap& value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(value));
+  SendPropertyChanged(name, brillo::Any(value));
 }
 
 void ChromeosDeviceDBusAdaptor::EmitStringmapsChanged(const string& name,
                                                       const Stringmaps& value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(value));
+  SendPropertyChanged(name, brillo::Any(value));
 }
 
 void ChromeosDeviceDBusAdaptor::EmitStringsChanged(const string& name,
                                                    const Strings& value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(value));
+  SendPropertyChanged(name, brillo::Any(value));
 }
 
 void ChromeosDeviceDBusAdaptor::EmitKeyValueStoreChanged(
@@ -111,13 +113,13 @@ void ChromeosDeviceDBusAdaptor::EmitKeyValueStoreChanged(
   SLOG(this, 2) << __func__ << ": " << name;
   brillo::VariantDictionary dict;
   KeyValueStore::ConvertToVariantDictionary(value, &dict);
-  SendPropertyChangedSignal(name, brillo::Any(dict));
+  SendPropertyChanged(name, brillo::Any(dict));
 }
 
 void ChromeosDeviceDBusAdaptor::EmitRpcIdentifierChanged(
     const std::string& name, const std::string& value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(dbus::ObjectPath(value)));
+  SendPropertyChanged(name, brillo::Any(dbus::ObjectPath(value)));
 }
 
 void ChromeosDeviceDBusAdaptor::EmitRpcIdentifierArrayChanged(
@@ -129,7 +131,7 @@ void ChromeosDeviceDBusAdaptor::EmitRpcIdentifierArrayChanged(
     paths.push_back(dbus::ObjectPath(element));
   }
 
-  SendPropertyChangedSignal(name, brillo::Any(paths));
+  SendPropertyChanged(name, brillo::Any(paths));
 }
 
 bool ChromeosDeviceDBusAdaptor::GetProperties(
@@ -314,4 +316,11 @@ bool ChromeosDeviceDBusAdaptor::RemoveAllWakeOnPacketConnections(
   return !e.ToChromeosError(error);
 }
 
+void ChromeosDeviceDBusAdaptor::SendPropertyChanged(
+    const string& name, const brillo::Any& value) {
+  SendSignalWhenExported(
+      Bind(&ChromeosDeviceDBusAdaptor::SendPropertyChangedSignal,
+           base::Unretained(this), name, value));
+}
+
 }  // namespace shill
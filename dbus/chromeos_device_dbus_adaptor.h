@@ -113,6 +113,9 @@ class ChromeosDeviceDBusAdaptor
   Device* device() const { return device_; }
 
  private:
+  // Sends PropertyChanged once the D-Bus object's export has started.
+  void SendPropertyChanged(const std::string& name, const brillo::Any& value);
+
   Device* device_;
 
   DISALLOW_COPY_AND_ASSIGN(ChromeosDeviceDBusAdaptor);
@@ -19,6 +19,9 @@
 #include <string>
 #include <vector>
 
+#include <base/bind.h>
+
+#include "shill/error.h"
 #include "shill/logging.h"
 
 namespace shill {
@@ -50,6 +53,28 @@ bool ChromeosFirewalldProxy::RequestVpnSetup(
   return success;
 }
 
+void ChromeosFirewalldProxy::RequestVpnSetupAsync(
+    const std::vector<std::string>& user_names,
+    const std::string& interface,
+    const ResultCallback& callback) {
+  // VPN already setup.
+  if (!user_names_.empty() || !interface_name_.empty()) {
+    LOG(ERROR) << "Already setup?";
+    callback.Run(Error(Error::kAlreadyExists));
+    return;
+  }
+
+  proxy_->RequestVpnSetupAsync(
+      user_names,
+      interface,
+      base::Bind(&ChromeosFirewalldProxy::OnRequestVpnSetupSuccess,
+                 weak_factory_.GetWeakPtr(),
+                 callback),
+      base::Bind(&ChromeosFirewalldProxy::OnRequestVpnSetupFailure,
+                 weak_factory_.GetWeakPtr(),
+                 callback));
+}
+
 bool ChromeosFirewalldProxy::RemoveVpnSetup() {
   // No VPN setup.
   if (user_names_.empty() && interface_name_.empty()) {
@@ -67,4 +92,16 @@ bool ChromeosFirewalldProxy::RemoveVpnSetup() {
   return success;
 }
 
+void ChromeosFirewalldProxy::OnRequestVpnSetupSuccess(
+    const ResultCallback& callback, bool success) {
+  callback.Run(success ? Error() : Error(Error::kOperationFailed));
+}
+
+void ChromeosFirewalldProxy::OnRequestVpnSetupFailure(
+    const ResultCallback& callback, brillo::Error* dbus_error) {
+  LOG(ERROR) << "Failed to request VPN setup: " << dbus_error->GetCode()
+             << " " << dbus_error->GetMessage();
+  callback.Run(Error(Error::kOperationFailed, dbus_error->GetMessage()));
+}
+
 }  // namespace shill
@@ -21,6 +21,7 @@
 #include <vector>
 
 #include <base/macros.h>
+#include <base/memory/weak_ptr.h>
 #include <firewalld/dbus-proxies.h>
 
 #include "shill/firewall_proxy_interface.h"
@@ -34,14 +35,23 @@ class ChromeosFirewalldProxy : public FirewallProxyInterface {
 
   bool RequestVpnSetup(const std::vector<std::string>& user_names,
                        const std::string& interface) override;
+  void RequestVpnSetupAsync(const std::vector<std::string>& user_names,
+                            const std::string& interface,
+                            const ResultCallback& callback) override;
 
   bool RemoveVpnSetup() override;
 
  private:
+  // Completion handlers for RequestVpnSetupAsync.
+  void OnRequestVpnSetupSuccess(const ResultCallback& callback, bool success);
+  void OnRequestVpnSetupFailure(const ResultCallback& callback,
+                                brillo::Error* dbus_error);
+
   std::unique_ptr<org::chromium::FirewalldProxy> proxy_;
   std::vector<std::string> user_names_;
   std::string interface_name_;
 
+  base::WeakPtrFactory<ChromeosFirewalldProxy> weak_factory_{this};
   DISALLOW_COPY_AND_ASSIGN(ChromeosFirewalldProxy);
 };
 
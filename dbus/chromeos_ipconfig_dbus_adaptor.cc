@@ -19,12 +19,14 @@
 #include <string>
 #include <vector>
 
+#include <base/bind.h>
 #include <base/strings/stringprintf.h>
 
 #include "shill/error.h"
 #include "shill/ipconfig.h"
 #include "shill/logging.h"
 
+using base::Bind;
 using base::StringPrintf;
 using brillo::dbus_utils::AsyncEventSequencer;
 using brillo::dbus_utils::ExportedObjectManager;
@@ -57,42 +59,41 @@ ChromeosIPConfigDBusAdaptor::ChromeosIPConfigDBusAdaptor(
       ipconfig_(config) {
   // Register DBus object.
   RegisterWithDBusObject(dbus_object());
-  dbus_object()->RegisterAndBlock();
 }
 
 ChromeosIPConfigDBusAdaptor::~ChromeosIPConfigDBusAdaptor() {
-  dbus_object()->UnregisterAsync();
+  UnregisterDBusObjectAsync();
   ipconfig_ = nullptr;
 }
 
 void ChromeosIPConfigDBusAdaptor::EmitBoolChanged(const string& name,
                                                   bool value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(value));
+  SendPropertyChanged(name, brillo::Any(value));
 }
 
 void ChromeosIPConfigDBusAdaptor::EmitUintChanged(const string& name,
                                                   uint32_t value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(value));
+  SendPropertyChanged(name, brillo::Any(value));
 }
 
 void ChromeosIPConfigDBusAdaptor::EmitIntChanged(const string& name,
                                                  int value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(value));
+  SendPropertyChanged(name, brillo::Any(value));
 }
 
 void ChromeosIPConfigDBusAdaptor::EmitStringChanged(const string& name,
                                                     const string& value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(value));
+  SendPropertyChanged(name, brillo::Any(value));
 }
 
 void ChromeosIPConfigDBusAdaptor::EmitStringsChanged(
     const string& name, const vector<string>& value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(value));
+  SendPropertyChanged(name, brillo::Any(value));
 }
 
 bool ChromeosIPConfigDBusAdaptor::GetProperties(
@@ -132,4 +133,11 @@ bool ChromeosIPConfigDBusAdaptor::Refresh(brillo::ErrorPtr* error) {
   return !e.ToChromeosError(error);
 }
 
+void ChromeosIPConfigDBusAdaptor::SendPropertyChanged(
+    const string& name, const brillo::Any& value) {
+  SendSignalWhenExported(
+      Bind(&ChromeosIPConfigDBusAdaptor::SendPropertyChangedSignal,
+           base::Unretained(this), name, value));
+}
+
 }  // namespace shill
@@ -70,6 +70,9 @@ class ChromeosIPConfigDBusAdaptor
   bool Refresh(brillo::ErrorPtr* error) override;
 
  private:
+  // Sends PropertyChanged once the D-Bus object's export has started.
+  void SendPropertyChanged(const std::string& name, const brillo::Any& value);
+
   IPConfig* ipconfig_;
   DISALLOW_COPY_AND_ASSIGN(ChromeosIPConfigDBusAdaptor);
 };
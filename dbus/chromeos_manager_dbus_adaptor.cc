@@ -17,10 +17,12 @@
 #include "shill/dbus/chromeos_manager_dbus_adaptor.h"
 
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "shill/callbacks.h"
+#include "shill/dbus/chromeos_dbus_control.h"
 #include "shill/dbus/dbus_service_watcher_factory.h"
 #include "shill/device.h"
 #include "shill/error.h"
@@ -29,6 +31,7 @@
 #include "shill/logging.h"
 #include "shill/manager.h"
 #include "shill/property_store.h"
+#include "shill/service.h"
 
 using base::Unretained;
 using std::map;
@@ -50,10 +53,12 @@ const char ChromeosManagerDBusAdaptor::kPath[] = "/";
 ChromeosManagerDBusAdaptor::ChromeosManagerDBusAdaptor(
     const scoped_refptr<dbus::Bus>& adaptor_bus,
     const scoped_refptr<dbus::Bus> proxy_bus,
-    Manager* manager)
+    Manager* manager,
+    ChromeosDBusControl* control)
     : org::chromium::flimflam::ManagerAdaptor(this),
       ChromeosDBusAdaptor(adaptor_bus, kPath),
       manager_(manager),
+      control_(control),
       proxy_bus_(proxy_bus),
       dbus_service_watcher_factory_(DBusServiceWatcherFactory::GetInstance()) {}
 
@@ -100,7 +105,8 @@ void ChromeosManagerDBusAdaptor::EmitRpcIdentifierChanged(
     const string& name,
     const string& value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(dbus::ObjectPath(value)));
+  SendObjectPathPropertyChangedSignal(name,
+                                      brillo::Any(dbus::ObjectPath(value)));
 }
 
 void ChromeosManagerDBusAdaptor::EmitRpcIdentifierArrayChanged(
@@ -112,7 +118,24 @@ void ChromeosManagerDBusAdaptor::EmitRpcIdentifierArrayChanged(
     paths.push_back(dbus::ObjectPath(element));
   }
 
-  SendPropertyChangedSignal(name, brillo::Any(paths));
+  SendObjectPathPropertyChangedSignal(name, brillo::Any(paths));
+}
+
+void ChromeosManagerDBusAdaptor::SendObjectPathPropertyChangedSignal(
+    const string& name, const brillo::Any& value) {
+  if (!control_) {
+    SendPropertyChangedSignal(name, value);
+    return;
+  }
+  control_->RunAfterPendingRegistrations(
+      base::Bind(
+          &ChromeosManagerDBusAdaptor::SendDeferredPropertyChangedSignal,
+          weak_factory_.GetWeakPtr(), name, value));
+}
+
+void ChromeosManagerDBusAdaptor::SendDeferredPropertyChangedSignal(
+    const string& name, const brillo::Any& value) {
+  SendPropertyChangedSignal(name, value);
 }
 
 bool ChromeosManagerDBusAdaptor::GetProperties(
@@ -305,6 +328,35 @@ bool ChromeosManagerDBusAdaptor::ConfigureService(
   return true;
 }
 
+bool ChromeosManagerDBusAdaptor::ConfigureServices(
+    brillo::ErrorPtr* error,
+    const vector<brillo::VariantDictionary>& configurations,
+    vector<dbus::ObjectPath>* services,
+    vector<string>* errors) {
+  SLOG(this, 2) << __func__ << ": " << configurations.size() << " services";
+  vector<KeyValueStore> args(configurations.size());
+  for (size_t i = 0; i < configurations.size(); ++i) {
+    KeyValueStore::ConvertFromVariantDictionary(configurations[i], &args[i]);
+  }
+  vector<ServiceRefPtr> configured_services;
+  vector<std::unique_ptr<Error>> configure_errors;
+  manager_->ConfigureServices(args, &configured_services, &configure_errors);
+  // Per-entry failures are reported in |errors|, indexed like
+  // |configurations|, rather than failing the whole call.
+  for (size_t i = 0; i < configured_services.size(); ++i) {
+    const Error& e = *configure_errors[i];
+    if (e.IsFailure() || !configured_services[i]) {
+      services->push_back(dbus::ObjectPath(kNullPath));
+      errors->push_back(Error::GetDBusResult(e.type()));
+    } else {
+      services->push_back(
+          dbus::ObjectPath(configured_services[i]->GetRpcIdentifier()));
+      errors->push_back(string());
+    }
+  }
+  return true;
+}
+
 bool ChromeosManagerDBusAdaptor::ConfigureServiceForProfile(
     brillo::ErrorPtr* error,
     const dbus::ObjectPath& profile_rpcid,
@@ -414,6 +466,28 @@ bool ChromeosManagerDBusAdaptor::GetNetworksForGeolocation(
   return true;
 }
 
+bool ChromeosManagerDBusAdaptor::GetServicesWithProperties(
+    brillo::ErrorPtr* error,
+    const vector<string>& property_names,
+    bool include_hidden,
+    vector<dbus::ObjectPath>* services,
+    vector<brillo::VariantDictionary>* properties) {
+  SLOG(this, 2) << __func__;
+  for (const auto& service : manager_->GetOrderedServices(include_hidden)) {
+    brillo::VariantDictionary service_properties;
+    Error e;
+    service->store().GetSelectedProperties(property_names,
+                                           &service_properties,
+                                           &e);
+    if (e.ToChromeosError(error)) {
+      return false;
+    }
+    services->push_back(dbus::ObjectPath(service->GetRpcIdentifier()));
+    properties->push_back(service_properties);
+  }
+  return true;
+}
+
 void ChromeosManagerDBusAdaptor::VerifyDestination(
     DBusMethodResponsePtr<bool> response,
     const string& certificate,
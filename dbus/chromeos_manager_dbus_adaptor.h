@@ -22,6 +22,7 @@
 #include <vector>
 
 #include <base/macros.h>
+#include <base/memory/weak_ptr.h>
 #include <gtest/gtest_prod.h>  // for FRIEND_TEST
 
 #include "dbus_bindings/org.chromium.flimflam.Manager.h"
@@ -31,6 +32,7 @@
 
 namespace shill {
 
+class ChromeosDBusControl;
 class DBusServiceWatcherFactory;
 class Manager;
 
@@ -49,7 +51,8 @@ class ChromeosManagerDBusAdaptor
 
   ChromeosManagerDBusAdaptor(const scoped_refptr<dbus::Bus>& adaptor_bus,
                              const scoped_refptr<dbus::Bus> proxy_bus,
-                             Manager* manager);
+                             Manager* manager,
+                             ChromeosDBusControl* control);
   ~ChromeosManagerDBusAdaptor() override;
 
   // Implementation of ManagerAdaptorInterface.
@@ -109,6 +112,11 @@ class ChromeosManagerDBusAdaptor
   bool ConfigureService(brillo::ErrorPtr* error,
                         const brillo::VariantDictionary& args,
                         dbus::ObjectPath* service_path) override;
+  bool ConfigureServices(
+      brillo::ErrorPtr* error,
+      const std::vector<brillo::VariantDictionary>& configurations,
+      std::vector<dbus::ObjectPath>* services,
+      std::vector<std::string>* errors) override;
   bool ConfigureServiceForProfile(brillo::ErrorPtr* error,
                                   const dbus::ObjectPath& profile_rpcid,
                                   const brillo::VariantDictionary& args,
@@ -129,6 +137,12 @@ class ChromeosManagerDBusAdaptor
   bool GetNetworksForGeolocation(
       brillo::ErrorPtr* error,
       brillo::VariantDictionary* networks) override;
+  bool GetServicesWithProperties(
+      brillo::ErrorPtr* error,
+      const std::vector<std::string>& property_names,
+      bool include_hidden,
+      std::vector<dbus::ObjectPath>* services,
+      std::vector<brillo::VariantDictionary>* properties) override;
   void VerifyDestination(DBusMethodResponsePtr<bool> response,
                          const std::string& certificate,
                          const std::string& public_key,
@@ -186,13 +200,25 @@ class ChromeosManagerDBusAdaptor
   void OnApModeSetterVanished();
   void OnDeviceClaimerVanished();
 
+  // Sends a property change that carries object paths once the objects
+  // behind them have been exported, so that clients are never handed a
+  // path they cannot yet call.
+  void SendObjectPathPropertyChangedSignal(const std::string& name,
+                                           const brillo::Any& value);
+  void SendDeferredPropertyChangedSignal(const std::string& name,
+                                         const brillo::Any& value);
+
   Manager* manager_;
+  // Used to hold back object path signals while adaptor exports are
+  // outstanding.  May be null, in which case signals are sent immediately.
+  ChromeosDBusControl* control_;
   // We store a pointer to |proxy_bus_| in order to create a
   // ChromeosDBusServiceWatcher objects.
   scoped_refptr<dbus::Bus> proxy_bus_;
   DBusServiceWatcherFactory* dbus_service_watcher_factory_;
   std::unique_ptr<ChromeosDBusServiceWatcher> watcher_for_device_claimer_;
   std::unique_ptr<ChromeosDBusServiceWatcher> watcher_for_ap_mode_setter_;
+  base::WeakPtrFactory<ChromeosManagerDBusAdaptor> weak_factory_{this};
 
   DISALLOW_COPY_AND_ASSIGN(ChromeosManagerDBusAdaptor);
 };
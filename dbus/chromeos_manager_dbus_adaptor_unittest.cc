@@ -32,13 +32,16 @@
 #include "shill/mock_event_dispatcher.h"
 #include "shill/mock_manager.h"
 #include "shill/mock_metrics.h"
+#include "shill/mock_service.h"
 
 using dbus::MockBus;
 using dbus::Response;
 using std::string;
+using std::vector;
 using testing::_;
 using testing::DoAll;
 using testing::Invoke;
+using testing::NiceMock;
 using testing::Return;
 using testing::SetArgPointee;
 using testing::Test;
@@ -53,7 +56,7 @@ class ChromeosManagerDBusAdaptorTest : public Test {
         proxy_bus_(new MockBus(dbus::Bus::Options())),
         metrics_(&dispatcher_),
         manager_(&control_interface_, &dispatcher_, &metrics_),
-        manager_adaptor_(adaptor_bus_, proxy_bus_, &manager_) {}
+        manager_adaptor_(adaptor_bus_, proxy_bus_, &manager_, nullptr) {}
 
   virtual ~ChromeosManagerDBusAdaptorTest() {}
 
@@ -227,4 +230,70 @@ TEST_F(ChromeosManagerDBusAdaptorTest, OnDeviceClaimerVanished) {
   EXPECT_EQ(nullptr, manager_adaptor_.watcher_for_device_claimer_.get());
 }
 
+TEST_F(ChromeosManagerDBusAdaptorTest, GetServicesWithProperties) {
+  scoped_refptr<MockService> service0(new NiceMock<MockService>(
+      &control_interface_, &dispatcher_, &metrics_, &manager_));
+  scoped_refptr<MockService> service1(new NiceMock<MockService>(
+      &control_interface_, &dispatcher_, &metrics_, &manager_));
+  service0->set_friendly_name("service0");
+  service1->set_friendly_name("service1");
+  EXPECT_CALL(manager_, GetOrderedServices(true))
+      .WillOnce(Return(vector<ServiceRefPtr>{service1, service0}));
+
+  brillo::ErrorPtr error;
+  vector<dbus::ObjectPath> services;
+  vector<brillo::VariantDictionary> properties;
+  EXPECT_TRUE(manager_adaptor_.GetServicesWithProperties(
+      &error, vector<string>{kNameProperty, "NotAProperty"}, true, &services,
+      &properties));
+
+  // Services come back in manager order, each with only the properties
+  // that were asked for and exist.
+  ASSERT_EQ(2U, services.size());
+  ASSERT_EQ(2U, properties.size());
+  EXPECT_EQ(service1->GetRpcIdentifier(), services[0].value());
+  EXPECT_EQ(service0->GetRpcIdentifier(), services[1].value());
+  ASSERT_EQ(1U, properties[0].size());
+  EXPECT_EQ("service1", properties[0][kNameProperty].Get<string>());
+  ASSERT_EQ(1U, properties[1].size());
+  EXPECT_EQ("service0", properties[1][kNameProperty].Get<string>());
+}
+
+TEST_F(ChromeosManagerDBusAdaptorTest, ConfigureServices) {
+  scoped_refptr<MockService> service(new NiceMock<MockService>(
+      &control_interface_, &dispatcher_, &metrics_, &manager_));
+  const string kGUID = "guid";
+  vector<KeyValueStore> configured_args;
+  EXPECT_CALL(manager_, ConfigureServices(_, _, _))
+      .WillOnce(Invoke([&](const vector<KeyValueStore>& args,
+                           vector<ServiceRefPtr>* services,
+                           vector<std::unique_ptr<Error>>* errors) {
+        configured_args = args;
+        services->push_back(service);
+        errors->emplace_back(new Error());
+        services->push_back(nullptr);
+        errors->emplace_back(new Error(Error::kInvalidArguments));
+      }));
+
+  vector<brillo::VariantDictionary> configurations(2);
+  configurations[0][kGUIDProperty] = brillo::Any(kGUID);
+  brillo::ErrorPtr error;
+  vector<dbus::ObjectPath> services;
+  vector<string> errors;
+  EXPECT_TRUE(manager_adaptor_.ConfigureServices(
+      &error, configurations, &services, &errors));
+
+  ASSERT_EQ(2U, configured_args.size());
+  EXPECT_EQ(kGUID, configured_args[0].GetString(kGUIDProperty));
+  EXPECT_TRUE(configured_args[1].IsEmpty());
+
+  // A failed entry does not fail the call, but is reported at its index.
+  ASSERT_EQ(2U, services.size());
+  ASSERT_EQ(2U, errors.size());
+  EXPECT_EQ(service->GetRpcIdentifier(), services[0].value());
+  EXPECT_EQ("", errors[0]);
+  EXPECT_EQ(ChromeosDBusAdaptor::kNullPath, services[1].value());
+  EXPECT_EQ(Error::GetDBusResult(Error::kInvalidArguments), errors[1]);
+}
+
 }  // namespace shill
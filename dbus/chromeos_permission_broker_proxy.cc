@@ -19,6 +19,9 @@
 #include <string>
 #include <vector>
 
+#include <base/bind.h>
+
+#include "shill/error.h"
 #include "shill/logging.h"
 
 namespace shill {
@@ -68,6 +71,40 @@ bool ChromeosPermissionBrokerProxy::RequestVpnSetup(
   return success;
 }
 
+void ChromeosPermissionBrokerProxy::RequestVpnSetupAsync(
+    const std::vector<std::string>& user_names,
+    const std::string& interface,
+    const ResultCallback& callback) {
+  if (lifeline_read_fd_ != kInvalidHandle ||
+      lifeline_write_fd_ != kInvalidHandle) {
+    LOG(ERROR) << "Already setup?";
+    callback.Run(Error(Error::kAlreadyExists));
+    return;
+  }
+
+  int fds[2];
+  if (pipe(fds) != 0) {
+    LOG(ERROR) << "Failed to create lifeline pipe";
+    callback.Run(Error(Error::kOperationFailed));
+    return;
+  }
+  lifeline_read_fd_ = fds[0];
+  lifeline_write_fd_ = fds[1];
+
+  dbus::FileDescriptor dbus_fd(lifeline_read_fd_);
+  dbus_fd.CheckValidity();
+  proxy_->RequestVpnSetupAsync(
+      user_names,
+      interface,
+      dbus_fd,
+      base::Bind(&ChromeosPermissionBrokerProxy::OnRequestVpnSetupSuccess,
+                 weak_factory_.GetWeakPtr(),
+                 callback),
+      base::Bind(&ChromeosPermissionBrokerProxy::OnRequestVpnSetupFailure,
+                 weak_factory_.GetWeakPtr(),
+                 callback));
+}
+
 bool ChromeosPermissionBrokerProxy::RemoveVpnSetup() {
   if (lifeline_read_fd_ == kInvalidHandle &&
       lifeline_write_fd_ == kInvalidHandle) {
@@ -87,4 +124,16 @@ bool ChromeosPermissionBrokerProxy::RemoveVpnSetup() {
   return success;
 }
 
+void ChromeosPermissionBrokerProxy::OnRequestVpnSetupSuccess(
+    const ResultCallback& callback, bool success) {
+  callback.Run(success ? Error() : Error(Error::kOperationFailed));
+}
+
+void ChromeosPermissionBrokerProxy::OnRequestVpnSetupFailure(
+    const ResultCallback& callback, brillo::Error* dbus_error) {
+  LOG(ERROR) << "Failed to request VPN setup: " << dbus_error->GetCode()
+             << " " << dbus_error->GetMessage();
+  callback.Run(Error(Error::kOperationFailed, dbus_error->GetMessage()));
+}
+
 }  // namespace shill
@@ -21,6 +21,7 @@
 #include <vector>
 
 #include <base/macros.h>
+#include <base/memory/weak_ptr.h>
 #include <permission_broker/dbus-proxies.h>
 
 #include "shill/firewall_proxy_interface.h"
@@ -34,16 +35,25 @@ class ChromeosPermissionBrokerProxy : public FirewallProxyInterface {
 
   bool RequestVpnSetup(const std::vector<std::string>& user_names,
                        const std::string& interface) override;
+  void RequestVpnSetupAsync(const std::vector<std::string>& user_names,
+                            const std::string& interface,
+                            const ResultCallback& callback) override;
 
   bool RemoveVpnSetup() override;
 
  private:
+  // Completion handlers for RequestVpnSetupAsync.
+  void OnRequestVpnSetupSuccess(const ResultCallback& callback, bool success);
+  void OnRequestVpnSetupFailure(const ResultCallback& callback,
+                                brillo::Error* dbus_error);
+
   static const int kInvalidHandle;
 
   std::unique_ptr<org::chromium::PermissionBrokerProxy> proxy_;
   int lifeline_read_fd_;
   int lifeline_write_fd_;
 
+  base::WeakPtrFactory<ChromeosPermissionBrokerProxy> weak_factory_{this};
   DISALLOW_COPY_AND_ASSIGN(ChromeosPermissionBrokerProxy);
 };
 
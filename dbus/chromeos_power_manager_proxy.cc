@@ -20,6 +20,7 @@
 #include <google/protobuf/message_lite.h>
 
 #include "power_manager/proto_bindings/suspend.pb.h"
+#include "shill/error.h"
 #include "shill/event_dispatcher.h"
 #include "shill/logging.h"
 
@@ -176,6 +177,50 @@ bool ChromeosPowerManagerProxy::RecordDarkResumeWakeReason(
   return true;
 }
 
+void ChromeosPowerManagerProxy::RegisterSuspendDelayAsync(
+    base::TimeDelta timeout,
+    const string& description,
+    const RegisterSuspendDelayCallback& callback) {
+  if (!service_available_) {
+    LOG(ERROR) << "PowerManager service not available";
+    callback.Run(Error(Error::kOperationFailed), 0);
+    return;
+  }
+  RegisterSuspendDelayAsyncInternal(false, timeout, description, callback);
+}
+
+void ChromeosPowerManagerProxy::ReportSuspendReadinessAsync(
+    int delay_id, int suspend_id, const ResultCallback& callback) {
+  if (!service_available_) {
+    LOG(ERROR) << "PowerManager service not available";
+    callback.Run(Error(Error::kOperationFailed));
+    return;
+  }
+  ReportSuspendReadinessAsyncInternal(false, delay_id, suspend_id, callback);
+}
+
+void ChromeosPowerManagerProxy::RegisterDarkSuspendDelayAsync(
+    base::TimeDelta timeout,
+    const string& description,
+    const RegisterSuspendDelayCallback& callback) {
+  if (!service_available_) {
+    LOG(ERROR) << "PowerManager service not available";
+    callback.Run(Error(Error::kOperationFailed), 0);
+    return;
+  }
+  RegisterSuspendDelayAsyncInternal(true, timeout, description, callback);
+}
+
+void ChromeosPowerManagerProxy::ReportDarkSuspendReadinessAsync(
+    int delay_id, int suspend_id, const ResultCallback& callback) {
+  if (!service_available_) {
+    LOG(ERROR) << "PowerManager service not available";
+    callback.Run(Error(Error::kOperationFailed));
+    return;
+  }
+  ReportSuspendReadinessAsyncInternal(true, delay_id, suspend_id, callback);
+}
+
 bool ChromeosPowerManagerProxy::RegisterSuspendDelayInternal(
     bool is_dark,
     base::TimeDelta timeout,
@@ -269,6 +314,112 @@ bool ChromeosPowerManagerProxy::ReportSuspendReadinessInternal(
   return true;
 }
 
+void ChromeosPowerManagerProxy::RegisterSuspendDelayAsyncInternal(
+    bool is_dark,
+    base::TimeDelta timeout,
+    const string& description,
+    const RegisterSuspendDelayCallback& callback) {
+  const string is_dark_arg = (is_dark ? "dark=true" : "dark=false");
+  LOG(INFO) << __func__ << "(" << timeout.InMilliseconds()
+            << ", " << is_dark_arg <<")";
+
+  power_manager::RegisterSuspendDelayRequest request_proto;
+  request_proto.set_timeout(timeout.ToInternalValue());
+  request_proto.set_description(description);
+  vector<uint8_t> serialized_request;
+  CHECK(SerializeProtocolBuffer(request_proto, &serialized_request));
+
+  auto success_callback =
+      base::Bind(&ChromeosPowerManagerProxy::OnRegisterSuspendDelaySuccess,
+                 weak_factory_.GetWeakPtr(), is_dark, callback);
+  auto failure_callback =
+      base::Bind(&ChromeosPowerManagerProxy::OnRegisterSuspendDelayFailure,
+                 weak_factory_.GetWeakPtr(), is_dark, callback);
+  if (is_dark) {
+    proxy_->RegisterDarkSuspendDelayAsync(serialized_request,
+                                          success_callback,
+                                          failure_callback);
+  } else {
+    proxy_->RegisterSuspendDelayAsync(serialized_request,
+                                      success_callback,
+                                      failure_callback);
+  }
+}
+
+void ChromeosPowerManagerProxy::ReportSuspendReadinessAsyncInternal(
+    bool is_dark,
+    int delay_id,
+    int suspend_id,
+    const ResultCallback& callback) {
+  const string is_dark_arg = (is_dark ? "dark=true" : "dark=false");
+  LOG(INFO) << __func__
+            << "(" << delay_id
+            << ", " << suspend_id
+            << ", " << is_dark_arg << ")";
+
+  power_manager::SuspendReadinessInfo proto;
+  proto.set_delay_id(delay_id);
+  proto.set_suspend_id(suspend_id);
+  vector<uint8_t> serialized_proto;
+  CHECK(SerializeProtocolBuffer(proto, &serialized_proto));
+
+  auto success_callback =
+      base::Bind(&ChromeosPowerManagerProxy::OnReportSuspendReadinessSuccess,
+                 weak_factory_.GetWeakPtr(), callback);
+  auto failure_callback =
+      base::Bind(&ChromeosPowerManagerProxy::OnReportSuspendReadinessFailure,
+                 weak_factory_.GetWeakPtr(), is_dark, callback);
+  if (is_dark) {
+    proxy_->HandleDarkSuspendReadinessAsync(serialized_proto,
+                                            success_callback,
+                                            failure_callback);
+  } else {
+    proxy_->HandleSuspendReadinessAsync(serialized_proto,
+                                        success_callback,
+                                        failure_callback);
+  }
+}
+
+void ChromeosPowerManagerProxy::OnRegisterSuspendDelaySuccess(
+    bool is_dark,
+    const RegisterSuspendDelayCallback& callback,
+    const vector<uint8_t>& serialized_reply) {
+  power_manager::RegisterSuspendDelayReply reply_proto;
+  if (!DeserializeProtocolBuffer(serialized_reply, &reply_proto)) {
+    LOG(ERROR) << "Failed to register "
+               << (is_dark ? "dark " : "")
+               << "suspend delay.  Couldn't parse response.";
+    callback.Run(Error(Error::kOperationFailed), 0);
+    return;
+  }
+  callback.Run(Error(), reply_proto.delay_id());
+}
+
+void ChromeosPowerManagerProxy::OnRegisterSuspendDelayFailure(
+    bool is_dark,
+    const RegisterSuspendDelayCallback& callback,
+    brillo::Error* dbus_error) {
+  LOG(ERROR) << "Failed to register "
+             << (is_dark ? "dark " : "") << "suspend delay: "
+             << dbus_error->GetCode() << " " << dbus_error->GetMessage();
+  callback.Run(Error(Error::kOperationFailed, dbus_error->GetMessage()), 0);
+}
+
+void ChromeosPowerManagerProxy::OnReportSuspendReadinessSuccess(
+    const ResultCallback& callback) {
+  callback.Run(Error());
+}
+
+void ChromeosPowerManagerProxy::OnReportSuspendReadinessFailure(
+    bool is_dark,
+    const ResultCallback& callback,
+    brillo::Error* dbus_error) {
+  LOG(ERROR) << "Failed to report "
+             << (is_dark ? "dark " : "") << "suspend readiness: "
+             << dbus_error->GetCode() << " " << dbus_error->GetMessage();
+  callback.Run(Error(Error::kOperationFailed, dbus_error->GetMessage()));
+}
+
 void ChromeosPowerManagerProxy::SuspendImminent(
     const vector<uint8_t>& serialized_proto) {
   LOG(INFO) << __func__;
@@ -59,6 +59,20 @@ class ChromeosPowerManagerProxy : public PowerManagerProxyInterface {
   bool UnregisterDarkSuspendDelay(int delay_id) override;
   bool ReportDarkSuspendReadiness(int delay_id, int suspend_id) override;
   bool RecordDarkResumeWakeReason(const std::string& wake_reason) override;
+  void RegisterSuspendDelayAsync(
+      base::TimeDelta timeout,
+      const std::string& description,
+      const RegisterSuspendDelayCallback& callback) override;
+  void ReportSuspendReadinessAsync(int delay_id,
+                                   int suspend_id,
+                                   const ResultCallback& callback) override;
+  void RegisterDarkSuspendDelayAsync(
+      base::TimeDelta timeout,
+      const std::string& description,
+      const RegisterSuspendDelayCallback& callback) override;
+  void ReportDarkSuspendReadinessAsync(int delay_id,
+                                       int suspend_id,
+                                       const ResultCallback& callback) override;
 
  private:
   // Signal handlers.
@@ -76,6 +90,30 @@ class ChromeosPowerManagerProxy : public PowerManagerProxyInterface {
                                       int delay_id,
                                       int suspend_id);
 
+  void RegisterSuspendDelayAsyncInternal(
+      bool is_dark,
+      base::TimeDelta timeout,
+      const std::string& description,
+      const RegisterSuspendDelayCallback& callback);
+  void ReportSuspendReadinessAsyncInternal(bool is_dark,
+                                           int delay_id,
+                                           int suspend_id,
+                                           const ResultCallback& callback);
+
+  // Completion handlers for the asynchronous calls.
+  void OnRegisterSuspendDelaySuccess(
+      bool is_dark,
+      const RegisterSuspendDelayCallback& callback,
+      const std::vector<uint8_t>& serialized_reply);
+  void OnRegisterSuspendDelayFailure(
+      bool is_dark,
+      const RegisterSuspendDelayCallback& callback,
+      brillo::Error* dbus_error);
+  void OnReportSuspendReadinessSuccess(const ResultCallback& callback);
+  void OnReportSuspendReadinessFailure(bool is_dark,
+                                       const ResultCallback& callback,
+                                       brillo::Error* dbus_error);
+
   // Called when service appeared or vanished.
   void OnServiceAvailable(bool available);
 
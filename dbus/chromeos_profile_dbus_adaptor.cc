@@ -19,11 +19,14 @@
 #include <string>
 #include <vector>
 
+#include <base/bind.h>
+
 #include "shill/error.h"
 #include "shill/logging.h"
 #include "shill/profile.h"
 #include "shill/service.h"
 
+using base::Bind;
 using brillo::dbus_utils::AsyncEventSequencer;
 using brillo::dbus_utils::ExportedObjectManager;
 using std::string;
@@ -50,35 +53,34 @@ ChromeosProfileDBusAdaptor::ChromeosProfileDBusAdaptor(
       profile_(profile) {
   // Register DBus object.
   RegisterWithDBusObject(dbus_object());
-  dbus_object()->RegisterAndBlock();
 }
 
 ChromeosProfileDBusAdaptor::~ChromeosProfileDBusAdaptor() {
-  dbus_object()->UnregisterAsync();
+  UnregisterDBusObjectAsync();
   profile_ = nullptr;
 }
 
 void ChromeosProfileDBusAdaptor::EmitBoolChanged(const string& name,
                                                  bool value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(value));
+  SendPropertyChanged(name, brillo::Any(value));
 }
 
 void ChromeosProfileDBusAdaptor::EmitUintChanged(const string& name,
                                                  uint32_t value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(value));
+  SendPropertyChanged(name, brillo::Any(value));
 }
 
 void ChromeosProfileDBusAdaptor::EmitIntChanged(const string& name, int value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(value));
+  SendPropertyChanged(name, brillo::Any(value));
 }
 
 void ChromeosProfileDBusAdaptor::EmitStringChanged(const string& name,
                                                    const string& value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(value));
+  SendPropertyChanged(name, brillo::Any(value));
 }
 
 bool ChromeosProfileDBusAdaptor::GetProperties(
@@ -121,4 +123,11 @@ bool ChromeosProfileDBusAdaptor::DeleteEntry(brillo::ErrorPtr* error,
   return !e.ToChromeosError(error);
 }
 
+void ChromeosProfileDBusAdaptor::SendPropertyChanged(
+    const string& name, const brillo::Any& value) {
+  SendSignalWhenExported(
+      Bind(&ChromeosProfileDBusAdaptor::SendPropertyChangedSignal,
+           base::Unretained(this), name, value));
+}
+
 }  // namespace shill
@@ -74,6 +74,9 @@ class ChromeosProfileDBusAdaptor
   bool DeleteEntry(brillo::ErrorPtr* error, const std::string& name) override;
 
  private:
+  // Sends PropertyChanged once the D-Bus object's export has started.
+  void SendPropertyChanged(const std::string& name, const brillo::Any& value);
+
   Profile* profile_;
 
   DISALLOW_COPY_AND_ASSIGN(ChromeosProfileDBusAdaptor);
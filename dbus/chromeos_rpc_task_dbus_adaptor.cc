@@ -48,11 +48,10 @@ ChromeosRPCTaskDBusAdaptor::ChromeosRPCTaskDBusAdaptor(
       connection_name_(bus->GetConnectionName()) {
   // Register DBus object.
   RegisterWithDBusObject(dbus_object());
-  dbus_object()->RegisterAndBlock();
 }
 
 ChromeosRPCTaskDBusAdaptor::~ChromeosRPCTaskDBusAdaptor() {
-  dbus_object()->UnregisterAsync();
+  UnregisterDBusObjectAsync();
   task_ = nullptr;
 }
 
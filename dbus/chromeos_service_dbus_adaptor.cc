@@ -19,10 +19,13 @@
 #include <map>
 #include <string>
 
+#include <base/bind.h>
+
 #include "shill/error.h"
 #include "shill/logging.h"
 #include "shill/service.h"
 
+using base::Bind;
 using brillo::dbus_utils::AsyncEventSequencer;
 using brillo::dbus_utils::ExportedObjectManager;
 using std::map;
@@ -49,65 +52,64 @@ ChromeosServiceDBusAdaptor::ChromeosServiceDBusAdaptor(
       service_(service) {
   // Register DBus object.
   RegisterWithDBusObject(dbus_object());
-  dbus_object()->RegisterAndBlock();
 }
 
 ChromeosServiceDBusAdaptor::~ChromeosServiceDBusAdaptor() {
-  dbus_object()->UnregisterAsync();
+  UnregisterDBusObjectAsync();
   service_ = nullptr;
 }
 
 void ChromeosServiceDBusAdaptor::EmitBoolChanged(const string& name,
                                                  bool value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(value));
+  SendPropertyChanged(name, brillo::Any(value));
 }
 
 void ChromeosServiceDBusAdaptor::EmitUint8Changed(const string& name,
                                                   uint8_t value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(value));
+  SendPropertyChanged(name, brillo::Any(value));
 }
 
 void ChromeosServiceDBusAdaptor::EmitUint16Changed(const string& name,
                                                    uint16_t value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(value));
+  SendPropertyChanged(name, brillo::Any(value));
 }
 
 void ChromeosServiceDBusAdaptor::EmitUint16sChanged(const string& name,
                                                     const Uint16s& value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(value));
+  SendPropertyChanged(name, brillo::Any(value));
 }
 
 void ChromeosServiceDBusAdaptor::EmitUintChanged(const string& name,
                                                  uint32_t value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(value));
+  SendPropertyChanged(name, brillo::Any(value));
 }
 
 void ChromeosServiceDBusAdaptor::EmitIntChanged(const string& name, int value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(value));
+  SendPropertyChanged(name, brillo::Any(value));
 }
 
 void ChromeosServiceDBusAdaptor::EmitRpcIdentifierChanged(const string& name,
                                                           const string& value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(dbus::ObjectPath(value)));
+  SendPropertyChanged(name, brillo::Any(dbus::ObjectPath(value)));
 }
 
 void ChromeosServiceDBusAdaptor::EmitStringChanged(const string& name,
                                                    const string& value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(value));
+  SendPropertyChanged(name, brillo::Any(value));
 }
 
 void ChromeosServiceDBusAdaptor::EmitStringmapChanged(const string& name,
                                                       const Stringmap& value) {
   SLOG(this, 2) << __func__ << ": " << name;
-  SendPropertyChangedSignal(name, brillo::Any(value));
+  SendPropertyChanged(name, brillo::Any(value));
 }
 
 bool ChromeosServiceDBusAdaptor::GetProperties(
@@ -210,4 +212,11 @@ bool ChromeosServiceDBusAdaptor::GetLoadableProfileEntries(
   return true;
 }
 
+void ChromeosServiceDBusAdaptor::SendPropertyChanged(
+    const string& name, const brillo::Any& value) {
+  SendSignalWhenExported(
+      Bind(&ChromeosServiceDBusAdaptor::SendPropertyChangedSignal,
+           base::Unretained(this), name, value));
+}
+
 }  // namespace shill
@@ -90,6 +90,9 @@ class ChromeosServiceDBusAdaptor
   Service* service() const { return service_; }
 
  private:
+  // Sends PropertyChanged once the D-Bus object's export has started.
+  void SendPropertyChanged(const std::string& name, const brillo::Any& value);
+
   Service* service_;
 
   DISALLOW_COPY_AND_ASSIGN(ChromeosServiceDBusAdaptor);
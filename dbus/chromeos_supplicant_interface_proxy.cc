@@ -20,6 +20,7 @@
 
 #include <base/bind.h>
 
+#include "shill/error.h"
 #include "shill/logging.h"
 #include "shill/supplicant/supplicant_event_delegate_interface.h"
 #include "shill/supplicant/wpa_supplicant.h"
@@ -455,6 +456,104 @@ bool ChromeosSupplicantInterfaceProxy::SetScan(bool enable) {
   return true;
 }
 
+void ChromeosSupplicantInterfaceProxy::AddNetworkAsync(
+    const KeyValueStore& args, const RpcIdentifierCallback& callback) {
+  SLOG(&interface_proxy_->GetObjectPath(), 2) << __func__;
+  brillo::VariantDictionary dict;
+  KeyValueStore::ConvertToVariantDictionary(args, &dict);
+  interface_proxy_->AddNetworkAsync(
+      dict,
+      base::Bind(&ChromeosSupplicantInterfaceProxy::OnAddNetworkSuccess,
+                 weak_factory_.GetWeakPtr(),
+                 callback),
+      base::Bind(&ChromeosSupplicantInterfaceProxy::OnAddNetworkFailure,
+                 weak_factory_.GetWeakPtr(),
+                 callback));
+}
+
+void ChromeosSupplicantInterfaceProxy::FlushBSSAsync(
+    uint32_t age, const ResultCallback& callback) {
+  SLOG(&interface_proxy_->GetObjectPath(), 2) << __func__ << ": " << age;
+  interface_proxy_->FlushBSSAsync(
+      age,
+      base::Bind(&ChromeosSupplicantInterfaceProxy::OnOperationSuccess,
+                 weak_factory_.GetWeakPtr(),
+                 callback,
+                 __func__),
+      base::Bind(&ChromeosSupplicantInterfaceProxy::OnOperationFailure,
+                 weak_factory_.GetWeakPtr(),
+                 callback,
+                 __func__));
+}
+
+void ChromeosSupplicantInterfaceProxy::ScanAsync(
+    const KeyValueStore& args, const ResultCallback& callback) {
+  SLOG(&interface_proxy_->GetObjectPath(), 2) << __func__;
+  brillo::VariantDictionary dict;
+  KeyValueStore::ConvertToVariantDictionary(args, &dict);
+  interface_proxy_->ScanAsync(
+      dict,
+      base::Bind(&ChromeosSupplicantInterfaceProxy::OnOperationSuccess,
+                 weak_factory_.GetWeakPtr(),
+                 callback,
+                 __func__),
+      base::Bind(&ChromeosSupplicantInterfaceProxy::OnOperationFailure,
+                 weak_factory_.GetWeakPtr(),
+                 callback,
+                 __func__));
+}
+
+void ChromeosSupplicantInterfaceProxy::SelectNetworkAsync(
+    const string& network, const ResultCallback& callback) {
+  SLOG(&interface_proxy_->GetObjectPath(), 2) << __func__ << ": " << network;
+  interface_proxy_->SelectNetworkAsync(
+      dbus::ObjectPath(network),
+      base::Bind(&ChromeosSupplicantInterfaceProxy::OnOperationSuccess,
+                 weak_factory_.GetWeakPtr(),
+                 callback,
+                 __func__),
+      base::Bind(&ChromeosSupplicantInterfaceProxy::OnOperationFailure,
+                 weak_factory_.GetWeakPtr(),
+                 callback,
+                 __func__));
+}
+
+void ChromeosSupplicantInterfaceProxy::SetHT40EnableAsync(
+    const string& network, bool enable, const ResultCallback& callback) {
+  SLOG(&interface_proxy_->GetObjectPath(), 2) << __func__
+      << " network: " << network << " enable: " << enable;
+#if defined(__ANDROID__)
+  interface_proxy_->SetHT40EnableAsync(
+      dbus::ObjectPath(network),
+      enable,
+      base::Bind(&ChromeosSupplicantInterfaceProxy::OnOperationSuccess,
+                 weak_factory_.GetWeakPtr(),
+                 callback,
+                 __func__),
+      base::Bind(&ChromeosSupplicantInterfaceProxy::OnOperationFailure,
+                 weak_factory_.GetWeakPtr(),
+                 callback,
+                 __func__));
+#else
+  callback.Run(Error());
+#endif  // __ANDROID__
+}
+
+void ChromeosSupplicantInterfaceProxy::SetRoamThresholdAsync(
+    uint16_t threshold, const ResultCallback& callback) {
+  SLOG(&interface_proxy_->GetObjectPath(), 2) << __func__ << ": " << threshold;
+#if !defined(__ANDROID__)
+  properties_->roam_threshold.Set(
+      threshold,
+      base::Bind(&ChromeosSupplicantInterfaceProxy::OnPropertySet,
+                 weak_factory_.GetWeakPtr(),
+                 callback,
+                 kPropertyRoamThreshold));
+#else
+  callback.Run(Error());
+#endif  // __ANDROID__
+}
+
 void ChromeosSupplicantInterfaceProxy::BlobAdded(const string& /*blobname*/) {
   SLOG(&interface_proxy_->GetObjectPath(), 2) << __func__;
   // XXX
@@ -551,4 +650,48 @@ void ChromeosSupplicantInterfaceProxy::OnSignalConnected(
   }
 }
 
+void ChromeosSupplicantInterfaceProxy::OnAddNetworkSuccess(
+    const RpcIdentifierCallback& callback, const dbus::ObjectPath& network) {
+  SLOG(&interface_proxy_->GetObjectPath(), 2) << __func__ << ": "
+      << network.value();
+  callback.Run(network.value(), Error());
+}
+
+void ChromeosSupplicantInterfaceProxy::OnAddNetworkFailure(
+    const RpcIdentifierCallback& callback, brillo::Error* dbus_error) {
+  LOG(ERROR) << "Failed to add network: "
+             << dbus_error->GetCode() << " " << dbus_error->GetMessage();
+  callback.Run("", Error(Error::kOperationFailed, dbus_error->GetMessage()));
+}
+
+void ChromeosSupplicantInterfaceProxy::OnOperationSuccess(
+    const ResultCallback& callback, const string& operation) {
+  SLOG(&interface_proxy_->GetObjectPath(), 2) << __func__ << ": "
+      << operation;
+  callback.Run(Error());
+}
+
+void ChromeosSupplicantInterfaceProxy::OnOperationFailure(
+    const ResultCallback& callback,
+    const string& operation,
+    brillo::Error* dbus_error) {
+  LOG(ERROR) << operation << " failed: "
+             << dbus_error->GetCode() << " " << dbus_error->GetMessage();
+  callback.Run(Error(Error::kOperationFailed, dbus_error->GetMessage()));
+}
+
+void ChromeosSupplicantInterfaceProxy::OnPropertySet(
+    const ResultCallback& callback,
+    const string& property_name,
+    bool success) {
+  SLOG(&interface_proxy_->GetObjectPath(), 2) << __func__ << ": "
+      << property_name << " success: " << success;
+  if (!success) {
+    LOG(ERROR) << "Failed to set property " << property_name;
+    callback.Run(Error(Error::kOperationFailed));
+    return;
+  }
+  callback.Run(Error());
+}
+
 }  // namespace shill
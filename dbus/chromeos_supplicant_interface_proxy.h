@@ -74,6 +74,18 @@ class ChromeosSupplicantInterfaceProxy
   bool SetDisableHighBitrates(bool disable_high_bitrates) override;
   bool SetSchedScan(bool enable) override;
   bool SetScan(bool enable) override;
+  void AddNetworkAsync(const KeyValueStore& args,
+                       const RpcIdentifierCallback& callback) override;
+  void FlushBSSAsync(uint32_t age, const ResultCallback& callback) override;
+  void ScanAsync(const KeyValueStore& args,
+                 const ResultCallback& callback) override;
+  void SelectNetworkAsync(const std::string& network,
+                          const ResultCallback& callback) override;
+  void SetHT40EnableAsync(const std::string& network,
+                          bool enable,
+                          const ResultCallback& callback) override;
+  void SetRoamThresholdAsync(uint16_t threshold,
+                             const ResultCallback& callback) override;
 
  private:
   class PropertySet : public dbus::PropertySet {
@@ -120,6 +132,20 @@ class ChromeosSupplicantInterfaceProxy
   // Callback invoked when the value of property |property_name| is changed.
   void OnPropertyChanged(const std::string& property_name);
 
+  // Completion handlers for asynchronous method calls.
+  void OnAddNetworkSuccess(const RpcIdentifierCallback& callback,
+                           const dbus::ObjectPath& network);
+  void OnAddNetworkFailure(const RpcIdentifierCallback& callback,
+                           brillo::Error* dbus_error);
+  void OnOperationSuccess(const ResultCallback& callback,
+                          const std::string& operation);
+  void OnOperationFailure(const ResultCallback& callback,
+                          const std::string& operation,
+                          brillo::Error* dbus_error);
+  void OnPropertySet(const ResultCallback& callback,
+                     const std::string& property_name,
+                     bool success);
+
   // Called when signal is connected to the ObjectProxy.
   void OnSignalConnected(const std::string& interface_name,
                          const std::string& signal_name,
@@ -22,6 +22,7 @@
 
 #include <base/callback.h>
 
+#include "shill/callbacks.h"
 #include "shill/key_value_store.h"
 
 namespace shill {
@@ -46,12 +47,24 @@ class DBusPropertiesProxyInterface {
       const KeyValueStore& properties)>
     ModemManagerPropertiesChangedCallback;
 
+  // Callback invoked when an asynchronous Get completes.
+  typedef base::Callback<void(const brillo::Any& value, const Error& error)>
+    GetCallback;
+
   virtual ~DBusPropertiesProxyInterface() {}
 
   virtual KeyValueStore GetAll(const std::string& interface_name) = 0;
   virtual brillo::Any Get(const std::string& interface_name,
                           const std::string& property) = 0;
 
+  // Asynchronous versions of GetAll and Get. |callback| is run once the reply
+  // arrives; it is not run if the proxy is destroyed before then.
+  virtual void GetAllAsync(const std::string& interface_name,
+                           const KeyValueStoreCallback& callback) = 0;
+  virtual void GetAsync(const std::string& interface_name,
+                        const std::string& property,
+                        const GetCallback& callback) = 0;
+
   virtual void set_properties_changed_callback(
       const PropertiesChangedCallback& callback) = 0;
   virtual void set_modem_manager_properties_changed_callback(
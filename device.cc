@@ -65,6 +65,7 @@
 #include "shill/net/rtnl_handler.h"
 #include "shill/property_accessor.h"
 #include "shill/refptr_types.h"
+#include "shill/router_solicitor.h"
 #include "shill/service.h"
 #include "shill/socket_info_reader.h"
 #include "shill/store_interface.h"
@@ -118,6 +119,14 @@ const char Device::kIPFlagArpIgnoreDefault[] = "0";
 // static
 const char Device::kIPFlagArpIgnoreLocalOnly[] = "1";
 // static
+const char Device::kIPFlagOptimisticDAD[] = "optimistic_dad";
+// static
+const char Device::kIPFlagOptimisticDADEnabled[] = "1";
+// static
+const char Device::kIPFlagUseOptimistic[] = "use_optimistic";
+// static
+const char Device::kIPFlagUseOptimisticEnabled[] = "1";
+// static
 const char Device::kStoragePowered[] = "Powered";
 // static
 const char Device::kStorageReceiveByteCount[] = "ReceiveByteCount";
@@ -173,6 +182,10 @@ Device::Device(ControlInterface* control_interface,
                                        weak_ptr_factory_.GetWeakPtr())),
       is_loose_routing_(false),
       is_multi_homed_(false),
+      router_solicitor_(new RouterSolicitor(dispatcher, interface_index)),
+      ipv6_enabled_time_{0, 0},
+      ipv6_address_pending_(false),
+      ipv6_dns_pending_(false),
       connection_diagnostics_callback_(
           Bind(&Device::ConnectionDiagnosticsCallback,
                weak_ptr_factory_.GetWeakPtr())) {
@@ -324,6 +337,9 @@ bool Device::IsIPv6Allowed() const {
 
 void Device::DisableIPv6() {
   SLOG(this, 2) << __func__;
+  router_solicitor_->Stop();
+  ipv6_address_pending_ = false;
+  ipv6_dns_pending_ = false;
   SetIPFlag(IPAddress::kFamilyIPv6, kIPFlagDisableIPv6, "1");
 }
 
@@ -334,7 +350,30 @@ void Device::EnableIPv6() {
               << " as it is not allowed.";
     return;
   }
-  SetIPFlag(IPAddress::kFamilyIPv6, kIPFlagDisableIPv6, "0");
+  // Optimistic DAD (RFC 4429) lets autoconfigured addresses be used while
+  // duplicate address detection is still in progress.  The kernel only
+  // applies it to SLAAC addresses, so static addresses remain protected.
+  if (HasIPFlag(IPAddress::kFamilyIPv6, kIPFlagOptimisticDAD)) {
+    SetIPFlag(IPAddress::kFamilyIPv6, kIPFlagOptimisticDAD,
+              kIPFlagOptimisticDADEnabled);
+    SetIPFlag(IPAddress::kFamilyIPv6, kIPFlagUseOptimistic,
+              kIPFlagUseOptimisticEnabled);
+  }
+  if (!SetIPFlag(IPAddress::kFamilyIPv6, kIPFlagDisableIPv6, "0")) {
+    return;
+  }
+  time_->GetTimeMonotonic(&ipv6_enabled_time_);
+  ipv6_address_pending_ = true;
+  ipv6_dns_pending_ = true;
+  router_solicitor_->Start();
+}
+
+int Device::GetMillisecondsSinceIPv6Enabled() {
+  struct timeval now = { 0, 0 };
+  struct timeval elapsed_time;
+  time_->GetTimeMonotonic(&now);
+  timersub(&now, &ipv6_enabled_time_, &elapsed_time);
+  return elapsed_time.tv_sec * 1000 + elapsed_time.tv_usec / 1000;
 }
 
 void Device::EnableIPv6Privacy() {
@@ -586,6 +625,13 @@ void Device::OnIPv6AddressChanged() {
   PrependDNSServers(IPAddress::kFamilyIPv6, &properties.dns_servers);
   ip6config_->set_properties(properties);
   UpdateIPConfigsProperty();
+  if (ipv6_address_pending_) {
+    ipv6_address_pending_ = false;
+    metrics_->NotifyIPv6AddressReady(technology_,
+                                     GetMillisecondsSinceIPv6Enabled());
+  }
+  // A router has answered, so there is no need to keep soliciting.
+  router_solicitor_->Stop();
   OnIPv6ConfigUpdated();
 }
 
@@ -636,6 +682,11 @@ void Device::OnIPv6DnsServerAddressesChanged() {
 
   ip6config_->UpdateDNSServers(addresses_str);
   UpdateIPConfigsProperty();
+  if (ipv6_dns_pending_) {
+    ipv6_dns_pending_ = false;
+    metrics_->NotifyIPv6DNSReady(technology_,
+                                 GetMillisecondsSinceIPv6Enabled());
+  }
   OnIPv6ConfigUpdated();
 }
 
@@ -1136,7 +1187,8 @@ void Device::CreateConnection() {
                                  link_name_,
                                  technology_,
                                  manager_->device_info(),
-                                 control_interface_);
+                                 control_interface_,
+                                 metrics());
   }
 }
 
@@ -1202,8 +1254,8 @@ void Device::SetServiceFailureSilent(Service::ConnectFailure failure_state) {
   }
 }
 
-bool Device::SetIPFlag(IPAddress::Family family, const string& flag,
-                       const string& value) {
+string Device::GetIPFlagPath(IPAddress::Family family,
+                             const string& flag) const {
   string ip_version;
   if (family == IPAddress::kFamilyIPv4) {
     ip_version = kIPFlagVersion4;
@@ -1212,8 +1264,17 @@ bool Device::SetIPFlag(IPAddress::Family family, const string& flag,
   } else {
     NOTIMPLEMENTED();
   }
-  FilePath flag_file(StringPrintf(kIPFlagTemplate, ip_version.c_str(),
-                                  link_name_.c_str(), flag.c_str()));
+  return StringPrintf(kIPFlagTemplate, ip_version.c_str(), link_name_.c_str(),
+                      flag.c_str());
+}
+
+bool Device::HasIPFlag(IPAddress::Family family, const string& flag) const {
+  return base::PathExists(FilePath(GetIPFlagPath(family, flag)));
+}
+
+bool Device::SetIPFlag(IPAddress::Family family, const string& flag,
+                       const string& value) {
+  FilePath flag_file(GetIPFlagPath(family, flag));
   SLOG(this, 2) << "Writing " << value << " to flag file "
                 << flag_file.value();
   if (base::WriteFile(flag_file, value.c_str(), value.length()) != 1) {
@@ -1329,6 +1390,13 @@ bool Device::StartPortalDetection() {
 
   SLOG(this, 2) << "Device " << FriendlyName()
                 << ": Portal detection has started.";
+
+  // If this service was online before the daemon restarted, report it online
+  // now rather than after the first trial completes.  The running detector
+  // moves it to portal state if that turns out to be wrong.
+  if (manager_->ConsumeWarmStartOnlineHint(selected_service_)) {
+    SetServiceState(Service::kStateOnline);
+  }
   return true;
 }
 
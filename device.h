@@ -56,6 +56,7 @@ class LinkMonitor;
 class Manager;
 class Metrics;
 class RTNLHandler;
+class RouterSolicitor;
 class TrafficMonitor;
 
 // Device superclass.  Individual network interfaces types will inherit from
@@ -694,6 +695,10 @@ class Device : public base::RefCounted<Device> {
   static const char kIPFlagArpIgnore[];
   static const char kIPFlagArpIgnoreDefault[];
   static const char kIPFlagArpIgnoreLocalOnly[];
+  static const char kIPFlagOptimisticDAD[];
+  static const char kIPFlagOptimisticDADEnabled[];
+  static const char kIPFlagUseOptimistic[];
+  static const char kIPFlagUseOptimisticEnabled[];
   static const char kStoragePowered[];
   static const char kStorageReceiveByteCount[];
   static const char kStorageTransmitByteCount[];
@@ -724,6 +729,18 @@ class Device : public base::RefCounted<Device> {
                          const std::string& flag,
                          const std::string& value);
 
+  // Returns true if |flag| exists for this interface in |family|, i.e. the
+  // running kernel supports it.  Overridden by unit tests.
+  virtual bool HasIPFlag(IPAddress::Family family,
+                         const std::string& flag) const;
+
+  // Returns the procfs path of IP configuration |flag| for this interface.
+  std::string GetIPFlagPath(IPAddress::Family family,
+                            const std::string& flag) const;
+
+  // Returns the time elapsed since IPv6 was last enabled on this device.
+  int GetMillisecondsSinceIPv6Enabled();
+
   // Request the removal of reverse-path filtering for this interface.
   // This will allow packets destined for this interface to be accepted,
   // even if this is not the default route for such a packet to arrive.
@@ -895,6 +912,14 @@ class Device : public base::RefCounted<Device> {
   // Remember which flag files were previously successfully written.
   std::set<std::string> written_flags_;
 
+  // Sends IPv6 Router Solicitations as soon as IPv6 is enabled.
+  std::unique_ptr<RouterSolicitor> router_solicitor_;
+  // Time when IPv6 was last enabled, and whether the first address and DNS
+  // configuration since then are still awaited, for readiness metrics.
+  struct timeval ipv6_enabled_time_;
+  bool ipv6_address_pending_;
+  bool ipv6_dns_pending_;
+
   std::unique_ptr<ConnectionDiagnostics> connection_diagnostics_;
   base::Callback<void(const std::string&,
                       const std::vector<ConnectionDiagnostics::Event>&)>
@@ -177,6 +177,11 @@ void DeviceInfo::Stop() {
   request_link_statistics_callback_.Cancel();
   delayed_devices_callback_.Cancel();
   delayed_devices_.clear();
+  if (!ignored_interfaces_.empty() || !link_only_interfaces_.empty()) {
+    ignored_interfaces_.clear();
+    link_only_interfaces_.clear();
+    UpdateInterfaceFilter();
+  }
 }
 
 vector<string> DeviceInfo::GetUninitializedTechnologies() const {
@@ -563,6 +568,7 @@ DeviceRefPtr DeviceInfo::CreateDevice(const string& link_name,
       // We will not manage this device in shill.  Do not create a device
       // object or do anything to change its state.  We create a stub object
       // which is useful for testing.
+      IgnoreInterface(interface_index, technology);
       return new DeviceStub(control_interface_, dispatcher_, metrics_,
                             manager_, link_name, address, interface_index,
                             technology);
@@ -873,6 +879,15 @@ bool DeviceInfo::GetPrimaryIPv6Address(int interface_index,
       continue;
     }
 
+    // Addresses still undergoing duplicate address detection cannot be used
+    // as a source address unless they are optimistic (RFC 4429).  The
+    // kernel notifies us again once DAD completes.
+    if ((local_address.flags & IFA_F_DADFAILED) ||
+        ((local_address.flags & IFA_F_TENTATIVE) &&
+         !(local_address.flags & IFA_F_OPTIMISTIC))) {
+      continue;
+    }
+
     // Prefer non-deprecated addresses to deprecated addresses to match the
     // kernel's preference.
     bool is_current_address =
@@ -1034,12 +1049,37 @@ void DeviceInfo::RemoveInfo(int interface_index) {
     indices_.erase(iter->second.name);
     infos_.erase(iter);
     delayed_devices_.erase(interface_index);
+    if (ignored_interfaces_.erase(interface_index) ||
+        link_only_interfaces_.erase(interface_index)) {
+      UpdateInterfaceFilter();
+    }
   } else {
     SLOG(this, 2) << __func__ << ": Unknown device index: "
                   << interface_index;
   }
 }
 
+void DeviceInfo::IgnoreInterface(int interface_index,
+                                 Technology::Identifier technology) {
+  if (technology == Technology::kBlacklisted) {
+    // Link notifications are still needed to notice the interface being
+    // renamed off the blacklist (see IsRenamedBlacklistedDevice()).
+    link_only_interfaces_.insert(interface_index);
+  } else if (technology == Technology::kUnknown) {
+    ignored_interfaces_.insert(interface_index);
+  } else {
+    return;
+  }
+  SLOG(this, 2) << "Filtering RTNL messages for interface index "
+                << interface_index;
+  UpdateInterfaceFilter();
+}
+
+void DeviceInfo::UpdateInterfaceFilter() {
+  rtnl_handler_->SetIgnoredInterfaces(ignored_interfaces_,
+                                      link_only_interfaces_);
+}
+
 void DeviceInfo::LinkMsgHandler(const RTNLMessage& msg) {
   DCHECK(msg.type() == RTNLMessage::kTypeLink);
   if (msg.mode() == RTNLMessage::kModeAdd) {
@@ -285,6 +285,10 @@ class DeviceInfo : public base::SupportsWeakPtr<DeviceInfo> {
 
   const Info* GetInfo(int interface_index) const;
   void RemoveInfo(int interface_index);
+  // Asks |rtnl_handler_| to drop RTNL notifications for an interface of
+  // |technology| that shill will not manage.
+  void IgnoreInterface(int interface_index, Technology::Identifier technology);
+  void UpdateInterfaceFilter();
   void DelayDeviceCreation(int interface_index);
   void DelayedDeviceCreationTask();
   void RetrieveLinkStatistics(int interface_index, const RTNLMessage& msg);
@@ -319,6 +323,11 @@ class DeviceInfo : public base::SupportsWeakPtr<DeviceInfo> {
   base::CancelableClosure delayed_devices_callback_;
   std::set<int> delayed_devices_;
 
+  // Interfaces whose RTNL notifications are filtered out in the kernel.
+  // Link notifications are still delivered for |link_only_interfaces_|.
+  std::set<int> ignored_interfaces_;
+  std::set<int> link_only_interfaces_;
+
   // Maintain a callback for the periodic link statistics poll task.
   base::CancelableClosure request_link_statistics_callback_;
 
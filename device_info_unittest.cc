@@ -113,6 +113,7 @@ class DeviceInfoTest : public Test {
     manager_.set_mock_device_info(&device_info_);
     EXPECT_CALL(manager_, FilterPrependDNSServersByFamily(_))
       .WillRepeatedly(Return(vector<string>()));
+    EXPECT_CALL(rtnl_handler_, SetIgnoredInterfaces(_, _)).Times(AnyNumber());
   }
 
   IPAddress CreateInterfaceAddress() {
@@ -766,6 +767,37 @@ TEST_F(DeviceInfoTest, RenamedNonBlacklistedDevice) {
   EXPECT_TRUE(initial_device->technology() == Technology::kUnknown);
 }
 
+TEST_F(DeviceInfoTest, IgnoredInterfacesFiltered) {
+  const int kUnknownDeviceIndex = kTestDeviceIndex + 1;
+
+  // Blacklisted interfaces keep delivering link notifications so that a
+  // rename can still be noticed.
+  EXPECT_CALL(rtnl_handler_,
+              SetIgnoredInterfaces(set<int>(), set<int>{kTestDeviceIndex}));
+  device_info_.AddDeviceToBlackList(kTestDeviceName);
+  unique_ptr<RTNLMessage> message(BuildLinkMessage(RTNLMessage::kModeAdd));
+  SendMessageToDeviceInfo(*message);
+  Mock::VerifyAndClearExpectations(&rtnl_handler_);
+
+  EXPECT_CALL(rtnl_handler_,
+              SetIgnoredInterfaces(set<int>{kUnknownDeviceIndex},
+                                   set<int>{kTestDeviceIndex}));
+  EXPECT_TRUE(CreateDevice(
+      "unknown-device", "address", kUnknownDeviceIndex, Technology::kUnknown));
+  Mock::VerifyAndClearExpectations(&rtnl_handler_);
+
+  // Interfaces stop being filtered once they are removed.
+  EXPECT_CALL(manager_, DeregisterDevice(_));
+  EXPECT_CALL(rtnl_handler_,
+              SetIgnoredInterfaces(set<int>{kUnknownDeviceIndex}, set<int>()));
+  message.reset(BuildLinkMessage(RTNLMessage::kModeDelete));
+  SendMessageToDeviceInfo(*message);
+  Mock::VerifyAndClearExpectations(&rtnl_handler_);
+
+  EXPECT_CALL(rtnl_handler_, SetIgnoredInterfaces(set<int>(), set<int>()));
+  device_info_.Stop();
+}
+
 TEST_F(DeviceInfoTest, DeviceAddressList) {
   unique_ptr<RTNLMessage> message(BuildLinkMessage(RTNLMessage::kModeAdd));
   SendMessageToDeviceInfo(*message);
@@ -1324,6 +1356,52 @@ TEST_F(DeviceInfoTest, IPv6AddressChanged) {
   EXPECT_TRUE(address3.Equals(ipv6_address7));
 }
 
+TEST_F(DeviceInfoTest, IPv6TentativeAddress) {
+  scoped_refptr<MockDevice> device(new MockDevice(
+      &control_interface_, &dispatcher_, &metrics_, &manager_,
+      "null0", "addr0", kTestDeviceIndex));
+  device_info_.infos_[kTestDeviceIndex].device = device;
+  EXPECT_CALL(*device, OnIPv6AddressChanged()).Times(AnyNumber());
+
+  // An address still undergoing DAD is not usable.
+  IPAddress ipv6_address1(IPAddress::kFamilyIPv6);
+  EXPECT_TRUE(ipv6_address1.SetAddressFromString(kTestIPAddress1));
+  unique_ptr<RTNLMessage> message(BuildAddressMessage(
+      RTNLMessage::kModeAdd, ipv6_address1, IFA_F_TENTATIVE,
+      RT_SCOPE_UNIVERSE));
+  SendMessageToDeviceInfo(*message);
+  EXPECT_FALSE(device_info_.GetPrimaryIPv6Address(kTestDeviceIndex, nullptr));
+
+  // Neither is an address that failed DAD.
+  IPAddress ipv6_address2(IPAddress::kFamilyIPv6);
+  EXPECT_TRUE(ipv6_address2.SetAddressFromString(kTestIPAddress2));
+  message.reset(BuildAddressMessage(
+      RTNLMessage::kModeAdd, ipv6_address2, IFA_F_DADFAILED,
+      RT_SCOPE_UNIVERSE));
+  SendMessageToDeviceInfo(*message);
+  EXPECT_FALSE(device_info_.GetPrimaryIPv6Address(kTestDeviceIndex, nullptr));
+
+  // An optimistic address may be used while DAD is in progress.
+  IPAddress ipv6_address3(IPAddress::kFamilyIPv6);
+  EXPECT_TRUE(ipv6_address3.SetAddressFromString(kTestIPAddress3));
+  message.reset(BuildAddressMessage(
+      RTNLMessage::kModeAdd, ipv6_address3, IFA_F_TENTATIVE | IFA_F_OPTIMISTIC,
+      RT_SCOPE_UNIVERSE));
+  SendMessageToDeviceInfo(*message);
+  IPAddress address0(IPAddress::kFamilyUnknown);
+  EXPECT_TRUE(device_info_.GetPrimaryIPv6Address(kTestDeviceIndex, &address0));
+  EXPECT_TRUE(address0.Equals(ipv6_address3));
+
+  // Once DAD completes for the first address it becomes usable.
+  message.reset(BuildAddressMessage(
+      RTNLMessage::kModeAdd, ipv6_address1, IFA_F_TEMPORARY,
+      RT_SCOPE_UNIVERSE));
+  SendMessageToDeviceInfo(*message);
+  IPAddress address1(IPAddress::kFamilyUnknown);
+  EXPECT_TRUE(device_info_.GetPrimaryIPv6Address(kTestDeviceIndex, &address1));
+  EXPECT_TRUE(address1.Equals(ipv6_address1));
+}
+
 
 TEST_F(DeviceInfoTest, IPv6DnsServerAddressesChanged) {
   scoped_refptr<MockDevice> device(new MockDevice(
@@ -57,6 +57,7 @@
 #include "shill/mock_manager.h"
 #include "shill/mock_metrics.h"
 #include "shill/mock_portal_detector.h"
+#include "shill/mock_router_solicitor.h"
 #include "shill/mock_service.h"
 #include "shill/mock_store.h"
 #include "shill/mock_traffic_monitor.h"
@@ -112,6 +113,8 @@ class TestDevice : public Device {
         .WillByDefault(Invoke(this, &TestDevice::DeviceIsIPv6Allowed));
     ON_CALL(*this, SetIPFlag(_, _, _))
         .WillByDefault(Invoke(this, &TestDevice::DeviceSetIPFlag));
+    ON_CALL(*this, HasIPFlag(_, _))
+        .WillByDefault(Invoke(this, &TestDevice::DeviceHasIPFlag));
     ON_CALL(*this, IsTrafficMonitorEnabled())
         .WillByDefault(Invoke(this,
                               &TestDevice::DeviceIsTrafficMonitorEnabled));
@@ -139,6 +142,8 @@ class TestDevice : public Device {
   MOCK_METHOD3(SetIPFlag, bool(IPAddress::Family family,
                                const std::string& flag,
                                const std::string& value));
+  MOCK_CONST_METHOD2(HasIPFlag, bool(IPAddress::Family family,
+                                     const std::string& flag));
 
   MOCK_METHOD3(StartDNSTest, bool(
       const std::vector<std::string>& dns_servers,
@@ -162,6 +167,11 @@ class TestDevice : public Device {
     return Device::SetIPFlag(family, flag, value);
   }
 
+  virtual bool DeviceHasIPFlag(IPAddress::Family family,
+                               const std::string& flag) const {
+    return Device::HasIPFlag(family, flag);
+  }
+
   virtual bool DeviceStartDNSTest(
       const std::vector<std::string>& dns_servers,
       const bool retry_until_success,
@@ -182,10 +192,12 @@ class DeviceTest : public PropertyStoreTest {
                                kDeviceInterfaceIndex,
                                Technology::kUnknown)),
         device_info_(control_interface(), nullptr, nullptr, nullptr),
-        metrics_(dispatcher()) {
+        metrics_(dispatcher()),
+        router_solicitor_(new MockRouterSolicitor()) {
     DHCPProvider::GetInstance()->control_interface_ = control_interface();
     DHCPProvider::GetInstance()->dispatcher_ = dispatcher();
     device_->time_ = &time_;
+    device_->router_solicitor_.reset(router_solicitor_);  // Passes ownership.
   }
   virtual ~DeviceTest() {}
 
@@ -296,6 +308,7 @@ class DeviceTest : public PropertyStoreTest {
   MockMetrics metrics_;
   MockTime time_;
   StrictMock<MockRTNLHandler> rtnl_handler_;
+  MockRouterSolicitor* router_solicitor_;  // Owned by |device_|.
 };
 
 const char DeviceTest::kDeviceName[] = "testdevice";
@@ -509,19 +522,137 @@ TEST_F(DeviceTest, ConfigWithMinimumMTU) {
 }
 
 TEST_F(DeviceTest, EnableIPv6) {
+  EXPECT_CALL(*device_, HasIPFlag(IPAddress::kFamilyIPv6,
+                                  StrEq(Device::kIPFlagOptimisticDAD)))
+      .WillOnce(Return(false));
   EXPECT_CALL(*device_, SetIPFlag(IPAddress::kFamilyIPv6,
                                   StrEq(Device::kIPFlagDisableIPv6),
                                   StrEq("0")))
       .WillOnce(Return(true));
+  EXPECT_CALL(time_, GetTimeMonotonic(_)).WillOnce(Return(0));
+  EXPECT_CALL(*router_solicitor_, Start());
+  device_->EnableIPv6();
+}
+
+TEST_F(DeviceTest, EnableIPv6OptimisticDAD) {
+  EXPECT_CALL(*device_, HasIPFlag(IPAddress::kFamilyIPv6,
+                                  StrEq(Device::kIPFlagOptimisticDAD)))
+      .WillOnce(Return(true));
+  EXPECT_CALL(*device_, SetIPFlag(IPAddress::kFamilyIPv6,
+                                  StrEq(Device::kIPFlagOptimisticDAD),
+                                  StrEq("1")))
+      .WillOnce(Return(true));
+  EXPECT_CALL(*device_, SetIPFlag(IPAddress::kFamilyIPv6,
+                                  StrEq(Device::kIPFlagUseOptimistic),
+                                  StrEq("1")))
+      .WillOnce(Return(true));
+  EXPECT_CALL(*device_, SetIPFlag(IPAddress::kFamilyIPv6,
+                                  StrEq(Device::kIPFlagDisableIPv6),
+                                  StrEq("0")))
+      .WillOnce(Return(true));
+  EXPECT_CALL(*router_solicitor_, Start());
+  device_->EnableIPv6();
+}
+
+TEST_F(DeviceTest, EnableIPv6FlagWriteFailed) {
+  EXPECT_CALL(*device_, HasIPFlag(_, _)).WillOnce(Return(false));
+  EXPECT_CALL(*device_, SetIPFlag(IPAddress::kFamilyIPv6,
+                                  StrEq(Device::kIPFlagDisableIPv6),
+                                  StrEq("0")))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*router_solicitor_, Start()).Times(0);
   device_->EnableIPv6();
 }
 
 TEST_F(DeviceTest, EnableIPv6NotAllowed) {
   EXPECT_CALL(*device_, IsIPv6Allowed()).WillOnce(Return(false));
   EXPECT_CALL(*device_, SetIPFlag(_, _, _)).Times(0);
+  EXPECT_CALL(*router_solicitor_, Start()).Times(0);
   device_->EnableIPv6();
 }
 
+TEST_F(DeviceTest, DisableIPv6) {
+  EXPECT_CALL(*router_solicitor_, Stop());
+  EXPECT_CALL(*device_, SetIPFlag(IPAddress::kFamilyIPv6,
+                                  StrEq(Device::kIPFlagDisableIPv6),
+                                  StrEq("1")))
+      .WillOnce(Return(true));
+  device_->DisableIPv6();
+}
+
+TEST_F(DeviceTest, IPv6ReadinessMetrics) {
+  StrictMock<MockManager> manager(control_interface(),
+                                  dispatcher(),
+                                  metrics());
+  manager.set_mock_device_info(&device_info_);
+  EXPECT_CALL(manager, FilterPrependDNSServersByFamily(_))
+      .WillRepeatedly(Return(vector<string>()));
+  SetManager(&manager);
+
+  // Keep an IPv4 connection so that completing the IPv6 configuration does
+  // not set up a new connection.
+  scoped_refptr<MockConnection> connection(
+      new StrictMock<MockConnection>(&device_info_));
+  SetConnection(connection.get());
+  EXPECT_CALL(*connection, IsIPv6()).WillRepeatedly(Return(false));
+
+  EXPECT_CALL(*device_, HasIPFlag(_, _)).WillOnce(Return(false));
+  EXPECT_CALL(*device_, SetIPFlag(IPAddress::kFamilyIPv6,
+                                  StrEq(Device::kIPFlagDisableIPv6),
+                                  StrEq("0")))
+      .WillOnce(Return(true));
+  struct timeval enabled_time = { 100, 0 };
+  EXPECT_CALL(time_, GetTimeMonotonic(_))
+      .WillOnce(DoAll(SetArgPointee<0>(enabled_time), Return(0)));
+  EXPECT_CALL(*router_solicitor_, Start());
+  device_->EnableIPv6();
+  Mock::VerifyAndClearExpectations(&time_);
+
+  // The first address reports the time since IPv6 was enabled, and ends
+  // solicitation.
+  IPAddress address(IPAddress::kFamilyIPv6);
+  ASSERT_TRUE(address.SetAddressFromString("2001:db8::1"));
+  EXPECT_CALL(device_info_, GetPrimaryIPv6Address(kDeviceInterfaceIndex, _))
+      .WillOnce(DoAll(SetArgPointee<1>(address), Return(true)));
+  struct timeval address_time = { 101, 250000 };
+  EXPECT_CALL(time_, GetTimeMonotonic(_))
+      .WillOnce(DoAll(SetArgPointee<0>(address_time), Return(0)));
+  EXPECT_CALL(metrics_, NotifyIPv6AddressReady(Technology::kUnknown, 1250));
+  EXPECT_CALL(*router_solicitor_, Stop());
+  device_->OnIPv6AddressChanged();
+  Mock::VerifyAndClearExpectations(&time_);
+  Mock::VerifyAndClearExpectations(&metrics_);
+  Mock::VerifyAndClearExpectations(router_solicitor_);
+
+  // A subsequent address change is not reported.
+  IPAddress address1(IPAddress::kFamilyIPv6);
+  ASSERT_TRUE(address1.SetAddressFromString("2001:db8::2"));
+  EXPECT_CALL(device_info_, GetPrimaryIPv6Address(kDeviceInterfaceIndex, _))
+      .WillOnce(DoAll(SetArgPointee<1>(address1), Return(true)));
+  EXPECT_CALL(time_, GetTimeMonotonic(_)).Times(0);
+  EXPECT_CALL(metrics_, NotifyIPv6AddressReady(_, _)).Times(0);
+  device_->OnIPv6AddressChanged();
+  Mock::VerifyAndClearExpectations(&time_);
+  Mock::VerifyAndClearExpectations(&metrics_);
+
+  // The first DNS server list is reported once.
+  IPAddress dns_server(IPAddress::kFamilyIPv6);
+  ASSERT_TRUE(dns_server.SetAddressFromString("2001:db8::53"));
+  vector<IPAddress> dns_server_addresses{ dns_server };
+  const uint32_t kInfiniteLifetime = 0xffffffff;
+  EXPECT_CALL(device_info_,
+              GetIPv6DnsServerAddresses(kDeviceInterfaceIndex, _, _))
+      .WillOnce(DoAll(SetArgPointee<1>(dns_server_addresses),
+                      SetArgPointee<2>(kInfiniteLifetime),
+                      Return(true)));
+  struct timeval dns_time = { 102, 0 };
+  EXPECT_CALL(time_, GetTimeMonotonic(_))
+      .WillOnce(DoAll(SetArgPointee<0>(dns_time), Return(0)));
+  EXPECT_CALL(metrics_, NotifyIPv6DNSReady(Technology::kUnknown, 2000));
+  device_->OnIPv6DnsServerAddressesChanged();
+  Mock::VerifyAndClearExpectations(&metrics_);
+}
+
 TEST_F(DeviceTest, MultiHomed) {
   // Device should have multi-homing disabled by default.
   EXPECT_CALL(*device_, SetIPFlag(_, _, _)).Times(0);
@@ -1918,6 +2049,9 @@ class DevicePortalDetectionTest : public DeviceTest {
     SetConnection(connection_.get());
     device_->portal_detector_.reset(portal_detector_);  // Passes ownership.
     SetManager(&manager_);
+    // No warm start hints unless a test provides one.
+    EXPECT_CALL(manager_, ConsumeWarmStartOnlineHint(_))
+        .WillRepeatedly(Return(false));
   }
 
  protected:
@@ -2047,6 +2181,42 @@ TEST_F(DevicePortalDetectionTest, PortalDetectionStart) {
   StopPortalDetection();
 }
 
+TEST_F(DevicePortalDetectionTest, PortalDetectionStartWarmStartOnline) {
+  EXPECT_CALL(*service_.get(), IsPortalDetectionDisabled())
+      .WillOnce(Return(false));
+  EXPECT_CALL(*service_.get(), IsConnected())
+      .WillRepeatedly(Return(true));
+  EXPECT_CALL(*service_.get(), HasProxyConfig())
+      .WillOnce(Return(false));
+  EXPECT_CALL(*service_.get(), IsPortalDetectionAuto())
+      .WillOnce(Return(true));
+  EXPECT_CALL(manager_, IsPortalDetectionEnabled(device_->technology()))
+      .WillOnce(Return(true));
+  const string portal_url(ConnectivityTrial::kDefaultURL);
+  EXPECT_CALL(manager_, GetPortalCheckURL())
+      .WillRepeatedly(ReturnRef(portal_url));
+  const string kInterfaceName("int0");
+  EXPECT_CALL(*connection_.get(), interface_name())
+      .WillRepeatedly(ReturnRef(kInterfaceName));
+  EXPECT_CALL(*connection_.get(), IsIPv6())
+      .WillRepeatedly(Return(false));
+  const vector<string> kDNSServers;
+  EXPECT_CALL(*connection_.get(), dns_servers())
+      .WillRepeatedly(ReturnRef(kDNSServers));
+
+  // The service is reported online straight away, while the detector that
+  // was started keeps running to confirm it.
+  EXPECT_CALL(manager_, ConsumeWarmStartOnlineHint(_))
+      .WillOnce(Return(true));
+  EXPECT_CALL(*service_.get(), SetState(Service::kStateOnline));
+  EXPECT_TRUE(StartPortalDetection());
+  ExpectPortalDetectorSet();
+
+  // Drop all references to device_info before it falls out of scope.
+  SetConnection(nullptr);
+  StopPortalDetection();
+}
+
 TEST_F(DevicePortalDetectionTest, PortalDetectionStartIPv6) {
   EXPECT_CALL(*service_.get(), IsPortalDetectionDisabled())
       .WillOnce(Return(false));
@@ -82,6 +82,7 @@ DHCPConfig::DHCPConfig(ControlInterface* control_interface,
       lease_file_suffix_(lease_file_suffix),
       pid_(0),
       is_lease_active_(false),
+      start_deferred_(false),
       lease_acquisition_timeout_seconds_(kAcquisitionTimeoutSeconds),
       minimum_mtu_(kMinIPv4MTU),
       root_("/"),
@@ -97,8 +98,14 @@ DHCPConfig::DHCPConfig(ControlInterface* control_interface,
 DHCPConfig::~DHCPConfig() {
   SLOG(this, 2) << __func__ << ": " << device_name();
 
-  // Don't leave behind dhcpcd running.
-  Stop(__func__);
+  // Don't leave behind dhcpcd running.  Nothing will be around to finish an
+  // asynchronous stop, so wait for the client to exit.
+  LOG_IF(INFO, pid_) << "Stopping " << pid_ << " (" << __func__ << ")";
+  start_deferred_ = false;
+  if (pid_) {
+    process_manager_->StopProcessAndBlock(pid_);
+  }
+  CleanupClientState();
 }
 
 bool DHCPConfig::RequestIP() {
@@ -131,6 +138,8 @@ bool DHCPConfig::RenewIP() {
 bool DHCPConfig::ReleaseIP(ReleaseReason reason) {
   SLOG(this, 2) << __func__ << ": " << device_name();
   if (!pid_) {
+    // Don't start a client that was waiting for a previous one to exit.
+    start_deferred_ = false;
     return true;
   }
 
@@ -187,6 +196,18 @@ bool DHCPConfig::IsEphemeralLease() const {
 bool DHCPConfig::Start() {
   SLOG(this, 2) << __func__ << ": " << device_name();
 
+  if (start_deferred_) {
+    return true;
+  }
+  if (provider_->DeferStartUntilStopped(
+          GetClientKey(),
+          Bind(&DHCPConfig::StartDeferred, weak_ptr_factory_.GetWeakPtr()))) {
+    LOG(INFO) << "Waiting for previous DHCP client on " << device_name()
+              << " to exit.";
+    start_deferred_ = true;
+    return true;
+  }
+
   // Setup program arguments.
   vector<string> args = GetFlags();
   string interface_arg(device_name());
@@ -219,11 +240,27 @@ bool DHCPConfig::Start() {
   return true;
 }
 
+void DHCPConfig::StartDeferred() {
+  if (!start_deferred_) {
+    return;
+  }
+  start_deferred_ = false;
+  if (!Start()) {
+    NotifyFailure();
+  }
+}
+
+string DHCPConfig::GetClientKey() const {
+  return type() + ":" + device_name();
+}
+
 void DHCPConfig::Stop(const char* reason) {
   LOG_IF(INFO, pid_) << "Stopping " << pid_ << " (" << reason << ")";
+  start_deferred_ = false;
   KillClient();
-  // KillClient waits for the client to terminate so it's safe to cleanup the
-  // state.
+  // The client may still be exiting, but it has been unbound from us and
+  // any new client for this interface waits for it to go away, so it's safe
+  // to cleanup the state.
   CleanupClientState();
 }
 
@@ -234,9 +271,16 @@ void DHCPConfig::KillClient() {
 
   // Pass the termination responsibility to ProcessManager.
   // ProcessManager will try to terminate the process using SIGTERM, then
-  // SIGKill signals.  It will log an error message if it is not able to
-  // terminate the process in a timely manner.
-  process_manager_->StopProcessAndBlock(pid_);
+  // SIGKill signals on dispatcher timers.  It will log an error message if it
+  // is not able to terminate the process in a timely manner.
+  const string client_key = GetClientKey();
+  provider_->ClientStopping(client_key);
+  if (!process_manager_->StopProcessAsync(
+          pid_,
+          base::Bind(&DHCPProvider::ClientStopped,
+                     base::Unretained(provider_), client_key))) {
+    provider_->ClientStopped(client_key);
+  }
 }
 
 bool DHCPConfig::Restart() {
@@ -129,6 +129,7 @@ class DHCPConfig : public IPConfig {
   FRIEND_TEST(DHCPConfigTest, RequestIP);
   FRIEND_TEST(DHCPConfigTest, Restart);
   FRIEND_TEST(DHCPConfigTest, RestartNoClient);
+  FRIEND_TEST(DHCPConfigTest, StartDeferredUntilClientStopped);
   FRIEND_TEST(DHCPConfigTest, StartFail);
   FRIEND_TEST(DHCPConfigTest, StartWithoutLeaseSuffix);
   FRIEND_TEST(DHCPConfigTest, Stop);
@@ -143,10 +144,19 @@ class DHCPConfig : public IPConfig {
   static const char kDHCPCDUser[];
   static const char kDHCPCDGroup[];
 
-  // Starts dhcpcd, returns true on success and false otherwise.
+  // Starts dhcpcd, returns true on success and false otherwise.  If a
+  // previous dhcpcd for this interface is still exiting, the start is
+  // deferred until it has, and true is returned.
   bool Start();
 
-  // Stops dhcpcd if running.
+  // Runs a start deferred by Start(), unless it was cancelled since.
+  void StartDeferred();
+
+  // Identifies the dhcpcd instance for this interface and address family to
+  // DHCPProvider.
+  std::string GetClientKey() const;
+
+  // Stops dhcpcd if running, without waiting for it to exit.
   void Stop(const char* reason);
 
   // Stops dhcpcd if already running and then starts it. Returns true on success
@@ -176,7 +186,8 @@ class DHCPConfig : public IPConfig {
   // Informs upper layers of the expiration and restarts the DHCP client.
   void ProcessExpirationTimeout();
 
-  // Kills DHCP client process.
+  // Asks ProcessManager to terminate the DHCP client process without
+  // waiting for it to exit.
   void KillClient();
 
   ControlInterface* control_interface_;
@@ -194,6 +205,9 @@ class DHCPConfig : public IPConfig {
   // Whether a lease has been acquired from the DHCP server or gateway ARP.
   bool is_lease_active_;
 
+  // Whether Start() is waiting for a previous client to exit.
+  bool start_deferred_;
+
   // The proxy for communicating with the DHCP client.
   std::unique_ptr<DHCPProxyInterface> proxy_;
 
@@ -48,9 +48,11 @@ using std::vector;
 using testing::_;
 using testing::AnyNumber;
 using testing::ContainsRegex;
+using testing::DoAll;
 using testing::InvokeWithoutArgs;
 using testing::Mock;
 using testing::Return;
+using testing::SaveArg;
 using testing::SetArgumentPointee;
 using testing::Test;
 
@@ -373,7 +375,9 @@ TEST_F(DHCPConfigTest, Restart) {
   const int kPID2 = 987;
   config_->pid_ = kPID1;
   EXPECT_CALL(provider_, UnbindPID(kPID1));
-  EXPECT_CALL(process_manager_, StopProcessAndBlock(kPID1)).WillOnce(Return(true));
+  EXPECT_CALL(provider_, ClientStopping(_));
+  EXPECT_CALL(process_manager_, StopProcessAsync(kPID1, _))
+      .WillOnce(Return(true));
   EXPECT_CALL(process_manager_, StartProcessInMinijail(_, _, _, _, _, _, _))
       .WillOnce(Return(kPID2));
   EXPECT_CALL(provider_, BindPID(kPID2, IsRefPtrTo(config_)));
@@ -384,7 +388,7 @@ TEST_F(DHCPConfigTest, Restart) {
 
 TEST_F(DHCPConfigTest, RestartNoClient) {
   const int kPID = 777;
-  EXPECT_CALL(process_manager_, StopProcessAndBlock(_)).Times(0);
+  EXPECT_CALL(process_manager_, StopProcessAsync(_, _)).Times(0);
   EXPECT_CALL(process_manager_, StartProcessInMinijail(_, _, _, _, _, _, _))
       .WillOnce(Return(kPID));
   EXPECT_CALL(provider_, BindPID(kPID, IsRefPtrTo(config_)));
@@ -393,6 +397,46 @@ TEST_F(DHCPConfigTest, RestartNoClient) {
   config_->pid_ = 0;
 }
 
+TEST_F(DHCPConfigTest, StartDeferredUntilClientStopped) {
+  const int kPID1 = 1 << 17;  // Ensure unknown positive PID.
+  const int kPID2 = 987;
+  config_->pid_ = kPID1;
+  const string client_key = config_->GetClientKey();
+
+  // Restarting doesn't wait for the old client to exit, but holds the new
+  // one back until it has.
+  base::Closure stopped_callback;
+  base::Closure deferred_start;
+  EXPECT_CALL(provider_, UnbindPID(kPID1));
+  EXPECT_CALL(provider_, ClientStopping(client_key));
+  EXPECT_CALL(process_manager_, StopProcessAsync(kPID1, _))
+      .WillOnce(DoAll(SaveArg<1>(&stopped_callback), Return(true)));
+  EXPECT_CALL(provider_, DeferStartUntilStopped(client_key, _))
+      .WillOnce(DoAll(SaveArg<1>(&deferred_start), Return(true)));
+  EXPECT_CALL(process_manager_, StartProcessInMinijail(_, _, _, _, _, _, _))
+      .Times(0);
+  EXPECT_TRUE(config_->Restart());
+  EXPECT_FALSE(config_->pid_);
+  Mock::VerifyAndClearExpectations(&process_manager_);
+
+  // Requesting an IP again keeps waiting.
+  EXPECT_CALL(provider_, DeferStartUntilStopped(_, _)).Times(0);
+  EXPECT_TRUE(config_->RequestIP());
+  Mock::VerifyAndClearExpectations(&provider_);
+
+  // The old client is gone.
+  EXPECT_CALL(provider_, ClientStopped(client_key));
+  stopped_callback.Run();
+  EXPECT_CALL(provider_, DeferStartUntilStopped(client_key, _))
+      .WillOnce(Return(false));
+  EXPECT_CALL(process_manager_, StartProcessInMinijail(_, _, _, _, _, _, _))
+      .WillOnce(Return(kPID2));
+  EXPECT_CALL(provider_, BindPID(kPID2, IsRefPtrTo(config_)));
+  deferred_start.Run();
+  EXPECT_EQ(kPID2, config_->pid_);
+  config_->pid_ = 0;
+}
+
 TEST_F(DHCPConfigCallbackTest, StartTimeout) {
   EXPECT_CALL(*config_.get(), ShouldFailOnAcquisitionTimeout())
       .WillOnce(Return(true));
@@ -424,6 +468,24 @@ TEST_F(DHCPConfigTest, Stop) {
   EXPECT_FALSE(config_->pid_);
 }
 
+TEST_F(DHCPConfigTest, DestructorBlocksUntilClientStopped) {
+  const int kPID = 1 << 17;  // Ensure unknown positive PID.
+  TestDHCPConfigRefPtr config(new TestDHCPConfig(&control_,
+                                                 dispatcher(),
+                                                 &provider_,
+                                                 kDeviceName,
+                                                 kDhcpMethod,
+                                                 kLeaseFileSuffix));
+  config->process_manager_ = &process_manager_;
+  config->pid_ = kPID;
+  EXPECT_CALL(provider_, ClientStopping(_)).Times(0);
+  EXPECT_CALL(process_manager_, StopProcessAsync(_, _)).Times(0);
+  EXPECT_CALL(process_manager_, StopProcessAndBlock(kPID))
+      .WillOnce(Return(true));
+  EXPECT_CALL(provider_, UnbindPID(kPID));
+  config = nullptr;
+}
+
 TEST_F(DHCPConfigTest, StopDuringRequestIP) {
   config_->pid_ = 567;
   EXPECT_CALL(*proxy_, Rebind(kDeviceName)).Times(1);
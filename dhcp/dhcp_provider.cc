@@ -158,6 +158,35 @@ bool DHCPProvider::IsRecentlyUnbound(int pid) {
   return ContainsValue(recently_unbound_pids_, pid);
 }
 
+void DHCPProvider::ClientStopping(const string& client_key) {
+  SLOG(this, 2) << __func__ << " client: " << client_key;
+  stopping_clients_[client_key];
+}
+
+void DHCPProvider::ClientStopped(const string& client_key) {
+  SLOG(this, 2) << __func__ << " client: " << client_key;
+  auto stopping_client = stopping_clients_.find(client_key);
+  if (stopping_client == stopping_clients_.end()) {
+    return;
+  }
+  std::vector<base::Closure> starts;
+  starts.swap(stopping_client->second);
+  stopping_clients_.erase(stopping_client);
+  for (const auto& start : starts) {
+    start.Run();
+  }
+}
+
+bool DHCPProvider::DeferStartUntilStopped(const string& client_key,
+                                          const base::Closure& start) {
+  auto stopping_client = stopping_clients_.find(client_key);
+  if (stopping_client == stopping_clients_.end()) {
+    return false;
+  }
+  stopping_client->second.push_back(start);
+  return true;
+}
+
 void DHCPProvider::DestroyLease(const string& name) {
   SLOG(this, 2) << __func__ << " name: " << name;
   base::DeleteFile(root_.Append(
@@ -21,7 +21,9 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
+#include <base/callback.h>
 #include <base/files/file_path.h>
 #include <base/lazy_instance.h>
 #include <gtest/gtest_prod.h>  // for FRIEND_TEST
@@ -109,6 +111,18 @@ class DHCPProvider {
   // Returns true if |pid| was recently unbound from the provider.
   bool IsRecentlyUnbound(int pid);
 
+  // Called by a DHCP config when it starts stopping its client, and again
+  // once that client has exited.  |client_key| identifies the interface and
+  // address family, since dhcpcd refuses to start while a previous instance
+  // for them is still running.
+  virtual void ClientStopping(const std::string& client_key);
+  virtual void ClientStopped(const std::string& client_key);
+
+  // If a client for |client_key| is still being stopped, queues |start| to
+  // run once it has exited and returns true.  Otherwise returns false.
+  virtual bool DeferStartUntilStopped(const std::string& client_key,
+                                      const base::Closure& start);
+
  protected:
   DHCPProvider();
 
@@ -142,6 +156,10 @@ class DHCPProvider {
   // arrive addressed from them.
   std::set<int> recently_unbound_pids_;
 
+  // Clients being stopped, keyed by client key, with the starts waiting on
+  // each of them.
+  std::map<std::string, std::vector<base::Closure>> stopping_clients_;
+
   DISALLOW_COPY_AND_ASSIGN(DHCPProvider);
 };
 
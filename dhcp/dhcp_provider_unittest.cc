@@ -16,6 +16,7 @@
 
 #include "shill/dhcp/dhcp_provider.h"
 
+#include <base/bind.h>
 #include <base/files/file_util.h>
 #include <base/files/scoped_temp_dir.h>
 #include <base/strings/stringprintf.h>
@@ -56,6 +57,7 @@ class DHCPProviderTest : public Test {
     // tests.
     provider_->configs_.clear();
     provider_->recently_unbound_pids_.clear();
+    provider_->stopping_clients_.clear();
   }
 
  protected:
@@ -66,6 +68,14 @@ class DHCPProviderTest : public Test {
   StrictMock<MockEventDispatcher> dispatcher_;
 };
 
+namespace {
+
+void CountStart(int* count) {
+  ++(*count);
+}
+
+}  // namespace
+
 TEST_F(DHCPProviderTest, CreateIPv4Config) {
   DhcpProperties dhcp_props;
 
@@ -118,4 +128,28 @@ TEST_F(DHCPProviderTest, BindAndUnbind) {
   EXPECT_FALSE(provider_->IsRecentlyUnbound(kPid));
 }
 
+TEST_F(DHCPProviderTest, DeferStartUntilStopped) {
+  const char kClientKey[] = "dhcp:testdevicename";
+  const char kOtherClientKey[] = "dhcp6:testdevicename";
+  int starts = 0;
+  base::Closure start = base::Bind(&CountStart, &starts);
+
+  // Nothing is stopping, so starts go ahead right away.
+  EXPECT_FALSE(provider_->DeferStartUntilStopped(kClientKey, start));
+
+  provider_->ClientStopping(kClientKey);
+  EXPECT_TRUE(provider_->DeferStartUntilStopped(kClientKey, start));
+  EXPECT_TRUE(provider_->DeferStartUntilStopped(kClientKey, start));
+  EXPECT_FALSE(provider_->DeferStartUntilStopped(kOtherClientKey, start));
+  EXPECT_EQ(0, starts);
+
+  provider_->ClientStopped(kClientKey);
+  EXPECT_EQ(2, starts);
+  EXPECT_FALSE(provider_->DeferStartUntilStopped(kClientKey, start));
+
+  // Stray notifications are ignored.
+  provider_->ClientStopped(kClientKey);
+  EXPECT_EQ(2, starts);
+}
+
 }  // namespace shill
@@ -46,6 +46,11 @@ class MockDHCPProvider : public DHCPProvider {
                                 const std::string& storage_identifier));
   MOCK_METHOD2(BindPID, void(int pid, const DHCPConfigRefPtr& config));
   MOCK_METHOD1(UnbindPID, void(int pid));
+  MOCK_METHOD1(ClientStopping, void(const std::string& client_key));
+  MOCK_METHOD1(ClientStopped, void(const std::string& client_key));
+  MOCK_METHOD2(DeferStartUntilStopped,
+               bool(const std::string& client_key,
+                    const base::Closure& start));
 
  private:
   DISALLOW_COPY_AND_ASSIGN(MockDHCPProvider);
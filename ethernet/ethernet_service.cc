@@ -142,6 +142,7 @@ bool EthernetService::IsAutoConnectable(const char** reason) const {
 }
 
 void EthernetService::OnVisibilityChanged() {
+  InvalidatePropertyDependency(kDependencyVisibility);
   NotifyPropertyChanges();
 }
 
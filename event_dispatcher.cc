@@ -64,6 +64,15 @@ IOHandler* EventDispatcher::CreateInputHandler(
           fd, input_callback, error_callback);
 }
 
+IOHandler* EventDispatcher::CreateDrainingInputHandler(
+    int fd,
+    const IOHandler::ReadBudget& budget,
+    const IOHandler::InputCallback& input_callback,
+    const IOHandler::ErrorCallback& error_callback) {
+  return io_handler_factory_->CreateDrainingIOInputHandler(
+          fd, budget, input_callback, error_callback);
+}
+
 // TODO(zqiu): Remove all reference to this function and use the
 // IOHandlerFactory function directly. Delete this function once
 // all references are removed.
@@ -56,6 +56,14 @@ class EventDispatcher {
       const IOHandler::InputCallback& input_callback,
       const IOHandler::ErrorCallback& error_callback);
 
+  // Like CreateInputHandler(), but reads from |fd| according to |budget|,
+  // which lets high-rate descriptors be drained on each wakeup.
+  virtual IOHandler* CreateDrainingInputHandler(
+      int fd,
+      const IOHandler::ReadBudget& budget,
+      const IOHandler::InputCallback& input_callback,
+      const IOHandler::ErrorCallback& error_callback);
+
   virtual IOHandler* CreateReadyHandler(
       int fd,
       IOHandler::ReadyMode mode,
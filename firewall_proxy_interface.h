@@ -20,6 +20,8 @@
 #include <string>
 #include <vector>
 
+#include "shill/callbacks.h"
+
 namespace shill {
 
 class FirewallProxyInterface {
@@ -27,6 +29,11 @@ class FirewallProxyInterface {
   virtual ~FirewallProxyInterface() {}
   virtual bool RequestVpnSetup(const std::vector<std::string>& user_names,
                                const std::string& interface) = 0;
+  // Asynchronous version of RequestVpnSetup. |callback| is run once the
+  // firewall has replied, and is not run if the proxy is destroyed first.
+  virtual void RequestVpnSetupAsync(const std::vector<std::string>& user_names,
+                                    const std::string& interface,
+                                    const ResultCallback& callback) = 0;
   virtual bool RemoveVpnSetup() = 0;
 };
 
@@ -59,6 +59,37 @@ const char IPConfig::kType[] = "ip";
 // static
 uint IPConfig::global_serial_ = 0;
 
+bool IPConfig::Route::operator==(const Route& other) const {
+  return host == other.host &&
+      netmask == other.netmask &&
+      gateway == other.gateway;
+}
+
+bool IPConfig::Properties::operator==(const Properties& other) const {
+  return address_family == other.address_family &&
+      address == other.address &&
+      subnet_prefix == other.subnet_prefix &&
+      broadcast_address == other.broadcast_address &&
+      dns_servers == other.dns_servers &&
+      domain_name == other.domain_name &&
+      accepted_hostname == other.accepted_hostname &&
+      domain_search == other.domain_search &&
+      gateway == other.gateway &&
+      method == other.method &&
+      peer_address == other.peer_address &&
+      delegated_prefix == other.delegated_prefix &&
+      delegated_prefix_length == other.delegated_prefix_length &&
+      user_traffic_only == other.user_traffic_only &&
+      default_route == other.default_route &&
+      exclusion_list == other.exclusion_list &&
+      blackhole_ipv6 == other.blackhole_ipv6 &&
+      mtu == other.mtu &&
+      routes == other.routes &&
+      vendor_encapsulated_options == other.vendor_encapsulated_options &&
+      web_proxy_auto_discovery == other.web_proxy_auto_discovery &&
+      lease_duration_seconds == other.lease_duration_seconds;
+}
+
 IPConfig::IPConfig(ControlInterface* control_interface,
                    const std::string& device_name)
     : device_name_(device_name),
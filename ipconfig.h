@@ -43,6 +43,9 @@ class Time;
 class IPConfig : public base::RefCounted<IPConfig> {
  public:
   struct Route {
+    bool operator==(const Route& other) const;
+    bool operator!=(const Route& other) const { return !(*this == other); }
+
     std::string host;
     std::string netmask;
     std::string gateway;
@@ -58,6 +61,11 @@ class IPConfig : public base::RefCounted<IPConfig> {
                    mtu(kUndefinedMTU),
                    lease_duration_seconds(0) {}
 
+    bool operator==(const Properties& other) const;
+    bool operator!=(const Properties& other) const {
+      return !(*this == other);
+    }
+
     IPAddress::Family address_family;
     std::string address;
     int32_t subnet_prefix;
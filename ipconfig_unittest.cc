@@ -179,6 +179,34 @@ TEST_F(IPConfigTest, UpdateProperties) {
   ExpectPropertiesEqual(IPConfig::Properties());
 }
 
+TEST_F(IPConfigTest, PropertiesEqual) {
+  IPConfig::Properties properties;
+  properties.address = "1.2.3.4";
+  properties.subnet_prefix = 24;
+  properties.dns_servers.push_back("10.20.30.40");
+  IPConfig::Route route;
+  route.host = "10.0.0.0";
+  route.netmask = "255.0.0.0";
+  route.gateway = "1.2.3.1";
+  properties.routes.push_back(route);
+
+  IPConfig::Properties other = properties;
+  EXPECT_TRUE(properties == other);
+  EXPECT_FALSE(properties != other);
+
+  other.dns_servers.push_back("20.30.40.50");
+  EXPECT_FALSE(properties == other);
+  EXPECT_TRUE(properties != other);
+
+  other = properties;
+  other.routes[0].gateway = "1.2.3.2";
+  EXPECT_TRUE(properties != other);
+
+  other = properties;
+  other.mtu = 1400;
+  EXPECT_TRUE(properties != other);
+}
+
 TEST_F(IPConfigTest, Callbacks) {
   ipconfig_->RegisterUpdateCallback(
       Bind(&IPConfigTest::OnIPConfigUpdated, Unretained(this)));
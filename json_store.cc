@@ -395,6 +395,7 @@ bool JsonStore::Open() {
     LOG(INFO) << "Clearing existing settings on open.";
     group_name_to_settings_.clear();
   }
+  key_indexes_.clear();
 
   base::DictionaryValue::Iterator it(*settings_dictionary);
   while (!it.IsAtEnd()) {
@@ -484,26 +485,39 @@ set<string> JsonStore::GetGroups() const {
 // Returns a set so that caller can easily test whether a particular group
 // is contained within this collection.
 set<string> JsonStore::GetGroupsWithKey(const string& key) const {
-  set<string> matching_groups;
-  // iterate over groups, find ones with matching key
-  for (const auto& group_name_and_settings : group_name_to_settings_) {
-    const auto& group_name = group_name_and_settings.first;
-    const auto& group_settings = group_name_and_settings.second;
-    if (group_settings.find(key) != group_settings.end()) {
-      matching_groups.insert(group_name);
-    }
-  }
-  return matching_groups;
+  return GetKeyIndex(key).groups;
 }
 
 set<string> JsonStore::GetGroupsWithProperties(const KeyValueStore& properties)
     const {
-  set<string> matching_groups;
   const brillo::VariantDictionary& properties_dict(properties.properties());
-  for (const auto& group_name_and_settings : group_name_to_settings_) {
-    const auto& group_name = group_name_and_settings.first;
-    const auto& group_settings = group_name_and_settings.second;
-    if (DoesGroupContainProperties(group_settings, properties_dict)) {
+  if (properties_dict.empty()) {
+    return GetGroups();
+  }
+  // Start from the smallest candidate set offered by the indexes of the
+  // queried keys, and check the remaining properties on those groups only.
+  const set<string>* candidate_groups = nullptr;
+  for (const auto& property_name_and_value : properties_dict) {
+    const KeyIndex& index = GetKeyIndex(property_name_and_value.first);
+    const set<string>* groups = &index.groups;
+    if (property_name_and_value.second.IsTypeCompatible<string>()) {
+      const auto it = index.groups_by_string_value.find(
+          property_name_and_value.second.Get<string>());
+      if (it == index.groups_by_string_value.end()) {
+        return set<string>();
+      }
+      groups = &it->second;
+    }
+    if (!candidate_groups || groups->size() < candidate_groups->size()) {
+      candidate_groups = groups;
+    }
+  }
+
+  set<string> matching_groups;
+  for (const auto& group_name : *candidate_groups) {
+    const auto& group_settings = group_name_to_settings_.find(group_name);
+    if (group_settings != group_name_to_settings_.end() &&
+        DoesGroupContainProperties(group_settings->second, properties_dict)) {
       matching_groups.insert(group_name);
     }
   }
@@ -526,6 +540,7 @@ bool JsonStore::DeleteKey(const string& group, const string& key) {
   auto property_it = group_settings.find(key);
   if (property_it != group_settings.end()) {
     group_settings.erase(property_it);
+    key_indexes_.erase(key);
   }
 
   return true;
@@ -535,6 +550,7 @@ bool JsonStore::DeleteGroup(const string& group) {
   auto group_name_and_settings = group_name_to_settings_.find(group);
   if (group_name_and_settings != group_name_to_settings_.end()) {
     group_name_to_settings_.erase(group_name_and_settings);
+    key_indexes_.clear();
   }
   return true;
 }
@@ -669,6 +685,7 @@ bool JsonStore::ReadSetting(
 template<typename T>
 bool JsonStore::WriteSetting(
     const string& group, const string& key, const T& new_value) {
+  key_indexes_.erase(key);
   auto group_name_and_settings = group_name_to_settings_.find(group);
   if (group_name_and_settings == group_name_to_settings_.end()) {
     group_name_to_settings_[group][key] = new_value;
@@ -694,4 +711,27 @@ bool JsonStore::WriteSetting(
   }
 }
 
+const JsonStore::KeyIndex& JsonStore::GetKeyIndex(const string& key) const {
+  const auto& it = key_indexes_.find(key);
+  if (it != key_indexes_.end()) {
+    return it->second;
+  }
+  SLOG(this, 10) << "Building index for key |" << key << "|.";
+  KeyIndex& index = key_indexes_[key];
+  for (const auto& group_name_and_settings : group_name_to_settings_) {
+    const auto& group_name = group_name_and_settings.first;
+    const auto& group_settings = group_name_and_settings.second;
+    const auto& property_name_and_value = group_settings.find(key);
+    if (property_name_and_value == group_settings.end()) {
+      continue;
+    }
+    index.groups.insert(group_name);
+    if (property_name_and_value->second.IsTypeCompatible<string>()) {
+      index.groups_by_string_value[
+          property_name_and_value->second.Get<string>()].insert(group_name);
+    }
+  }
+  return index;
+}
+
 }  // namespace shill
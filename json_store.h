@@ -103,14 +103,23 @@ class JsonStore : public StoreInterface {
   // Tests which modify |path_|.
   FRIEND_TEST(JsonStoreTest, FlushFailsWhenPathComponentDoesNotExist);
 
+  // Inverted index over the groups containing a given key. Built lazily
+  // on the first query for the key, and dropped when the key is written.
+  struct KeyIndex {
+    std::set<std::string> groups;
+    std::map<std::string, std::set<std::string>> groups_by_string_value;
+  };
+
   template<typename T> bool ReadSetting(
       const std::string& group, const std::string& key, T* out) const;
   template<typename T> bool WriteSetting(
       const std::string& group, const std::string& key, const T& new_value);
+  const KeyIndex& GetKeyIndex(const std::string& key) const;
 
   const base::FilePath path_;
   std::string file_description_;
   std::map<std::string, brillo::VariantDictionary> group_name_to_settings_;
+  mutable std::map<std::string, KeyIndex> key_indexes_;
 
   DISALLOW_COPY_AND_ASSIGN(JsonStore);
 };
@@ -443,6 +443,31 @@ TEST_F(JsonStoreTest, GetGroupsWithPropertiesCanMatchOnMultipleProperties) {
             store_->GetGroupsWithProperties(required_properties));
 }
 
+TEST_F(JsonStoreTest, GetGroupsWithPropertiesReflectsWrites) {
+  store_->SetString("group_a", "knob_1", "value_1");
+
+  KeyValueStore required_properties;
+  required_properties.SetString("knob_1", "value_1");
+  EXPECT_EQ(set<string>({"group_a"}),
+            store_->GetGroupsWithProperties(required_properties));
+
+  store_->SetString("group_b", "knob_1", "value_1");
+  EXPECT_EQ(set<string>({"group_a", "group_b"}),
+            store_->GetGroupsWithProperties(required_properties));
+
+  store_->SetString("group_a", "knob_1", "value_2");
+  EXPECT_EQ(set<string>({"group_b"}),
+            store_->GetGroupsWithProperties(required_properties));
+
+  store_->DeleteKey("group_b", "knob_1");
+  EXPECT_EQ(set<string>(),
+            store_->GetGroupsWithProperties(required_properties));
+  EXPECT_EQ(set<string>({"group_a"}), store_->GetGroupsWithKey("knob_1"));
+
+  store_->DeleteGroup("group_a");
+  EXPECT_EQ(set<string>(), store_->GetGroupsWithKey("knob_1"));
+}
+
 TEST_F(JsonStoreTest, GetGroupsWithPropertiesChecksValuesForBoolIntAndString) {
   // Documentation in StoreInterface says GetGroupsWithProperties
   // checks only Bool, Int, and String properties. For now, we interpret
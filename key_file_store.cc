@@ -69,6 +69,7 @@ KeyFileStore::~KeyFileStore() {
 }
 
 void KeyFileStore::ReleaseKeyFile() {
+  key_indexes_.clear();
   if (key_file_) {
     g_key_file_free(key_file_);
     key_file_ = nullptr;
@@ -159,21 +160,34 @@ set<string> KeyFileStore::GetGroups() const {
 // Returns a set so that caller can easily test whether a particular group
 // is contained within this collection.
 set<string> KeyFileStore::GetGroupsWithKey(const string& key) const {
-  set<string> groups = GetGroups();
-  set<string> groups_with_key;
-  for (const auto& group : groups) {
-    if (g_key_file_has_key(key_file_, group.c_str(), key.c_str(), nullptr)) {
-      groups_with_key.insert(group);
-    }
-  }
-  return groups_with_key;
+  return GetKeyIndex(key).groups;
 }
 
 set<string> KeyFileStore::GetGroupsWithProperties(
      const KeyValueStore& properties) const {
-  set<string> groups = GetGroups();
+  if (properties.properties().empty()) {
+    return GetGroups();
+  }
+  // Narrow the search down to the smallest candidate set offered by the
+  // indexes of the queried keys, then check the remaining properties.
+  const set<string>* candidates = nullptr;
+  for (const auto& property : properties.properties()) {
+    const KeyIndex& index = GetKeyIndex(property.first);
+    const set<string>* groups = &index.groups;
+    if (property.second.IsTypeCompatible<string>()) {
+      const auto it =
+          index.groups_by_string_value.find(property.second.Get<string>());
+      if (it == index.groups_by_string_value.end()) {
+        return set<string>();
+      }
+      groups = &it->second;
+    }
+    if (!candidates || groups->size() < candidates->size()) {
+      candidates = groups;
+    }
+  }
   set<string> groups_with_properties;
-  for (const auto& group : groups) {
+  for (const auto& group : *candidates) {
     if (DoesGroupMatchProperties(group, properties)) {
       groups_with_properties.insert(group);
     }
@@ -188,6 +202,7 @@ bool KeyFileStore::ContainsGroup(const string& group) const {
 
 bool KeyFileStore::DeleteKey(const string& group, const string& key) {
   CHECK(key_file_);
+  key_indexes_.erase(key);
   GError* error = nullptr;
   g_key_file_remove_key(key_file_, group.c_str(), key.c_str(), &error);
   if (error && error->code != G_KEY_FILE_ERROR_KEY_NOT_FOUND) {
@@ -200,6 +215,7 @@ bool KeyFileStore::DeleteKey(const string& group, const string& key) {
 
 bool KeyFileStore::DeleteGroup(const string& group) {
   CHECK(key_file_);
+  key_indexes_.clear();
   GError* error = nullptr;
   g_key_file_remove_group(key_file_, group.c_str(), &error);
   if (error && error->code != G_KEY_FILE_ERROR_GROUP_NOT_FOUND) {
@@ -244,6 +260,7 @@ bool KeyFileStore::SetString(const string& group,
                              const string& key,
                              const string& value) {
   CHECK(key_file_);
+  key_indexes_.erase(key);
   g_key_file_set_string(key_file_, group.c_str(), key.c_str(), value.c_str());
   return true;
 }
@@ -268,6 +285,7 @@ bool KeyFileStore::GetBool(const string& group,
 
 bool KeyFileStore::SetBool(const string& group, const string& key, bool value) {
   CHECK(key_file_);
+  key_indexes_.erase(key);
   g_key_file_set_boolean(key_file_,
                          group.c_str(),
                          key.c_str(),
@@ -294,6 +312,7 @@ bool KeyFileStore::GetInt(
 
 bool KeyFileStore::SetInt(const string& group, const string& key, int value) {
   CHECK(key_file_);
+  key_indexes_.erase(key);
   g_key_file_set_integer(key_file_, group.c_str(), key.c_str(), value);
   return true;
 }
@@ -357,6 +376,7 @@ bool KeyFileStore::SetStringList(const string& group,
                                  const string& key,
                                  const vector<string>& value) {
   CHECK(key_file_);
+  key_indexes_.erase(key);
   vector<const char*> list;
   for (const auto& string_entry : value) {
     list.push_back(string_entry.c_str());
@@ -413,4 +433,25 @@ bool KeyFileStore::DoesGroupMatchProperties(
   return true;
 }
 
+const KeyFileStore::KeyIndex& KeyFileStore::GetKeyIndex(
+    const string& key) const {
+  auto it = key_indexes_.find(key);
+  if (it != key_indexes_.end()) {
+    return it->second;
+  }
+  SLOG(this, 10) << "Building index for key " << key;
+  KeyIndex& index = key_indexes_[key];
+  for (const auto& group : GetGroups()) {
+    if (!g_key_file_has_key(key_file_, group.c_str(), key.c_str(), nullptr)) {
+      continue;
+    }
+    index.groups.insert(group);
+    string value;
+    if (GetString(group, key, &value)) {
+      index.groups_by_string_value[value].insert(group);
+    }
+  }
+  return index;
+}
+
 }  // namespace shill
@@ -17,6 +17,7 @@
 #ifndef SHILL_KEY_FILE_STORE_H_
 #define SHILL_KEY_FILE_STORE_H_
 
+#include <map>
 #include <set>
 #include <string>
 #include <vector>
@@ -95,13 +96,22 @@ class KeyFileStore : public StoreInterface {
 
   static const char kCorruptSuffix[];
 
+  // Inverted index over the groups containing a given key, built the first
+  // time the key is queried and dropped whenever the key is written.
+  struct KeyIndex {
+    std::set<std::string> groups;
+    std::map<std::string, std::set<std::string>> groups_by_string_value;
+  };
+
   void ReleaseKeyFile();
   bool DoesGroupMatchProperties(const std::string& group,
                                 const KeyValueStore& properties) const;
+  const KeyIndex& GetKeyIndex(const std::string& key) const;
 
   CryptoProvider crypto_;
   GKeyFile* key_file_;
   const base::FilePath path_;
+  mutable std::map<std::string, KeyIndex> key_indexes_;
 
   DISALLOW_COPY_AND_ASSIGN(KeyFileStore);
 };
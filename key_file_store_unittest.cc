@@ -282,6 +282,40 @@ TEST_F(KeyFileStoreTest, GetGroupsWithProperties) {
   ASSERT_TRUE(store_->Close());
 }
 
+TEST_F(KeyFileStoreTest, GetGroupsWithPropertiesAfterWrites) {
+  static const char kGroupA[] = "group-a";
+  static const char kGroupB[] = "group-b";
+  static const char kKey[] = "key";
+  static const char kValue0[] = "value0";
+  static const char kValue1[] = "value1";
+  WriteKeyFile(base::StringPrintf("[%s]\n%s=%s\n",
+                                  kGroupA, kKey, kValue0));
+  ASSERT_TRUE(store_->Open());
+  KeyValueStore args0;
+  args0.SetString(kKey, kValue0);
+  KeyValueStore args1;
+  args1.SetString(kKey, kValue1);
+  EXPECT_EQ(set<string>{kGroupA}, store_->GetGroupsWithProperties(args0));
+  EXPECT_EQ(set<string>{kGroupA}, store_->GetGroupsWithKey(kKey));
+
+  // Writes to a queried key are reflected in subsequent queries.
+  ASSERT_TRUE(store_->SetString(kGroupB, kKey, kValue0));
+  EXPECT_EQ((set<string>{kGroupA, kGroupB}),
+            store_->GetGroupsWithProperties(args0));
+  ASSERT_TRUE(store_->SetString(kGroupA, kKey, kValue1));
+  EXPECT_EQ(set<string>{kGroupB}, store_->GetGroupsWithProperties(args0));
+  EXPECT_EQ(set<string>{kGroupA}, store_->GetGroupsWithProperties(args1));
+
+  ASSERT_TRUE(store_->DeleteKey(kGroupA, kKey));
+  EXPECT_TRUE(store_->GetGroupsWithProperties(args1).empty());
+  EXPECT_EQ(set<string>{kGroupB}, store_->GetGroupsWithKey(kKey));
+
+  ASSERT_TRUE(store_->DeleteGroup(kGroupB));
+  EXPECT_TRUE(store_->GetGroupsWithProperties(args0).empty());
+  EXPECT_TRUE(store_->GetGroupsWithKey(kKey).empty());
+  ASSERT_TRUE(store_->Close());
+}
+
 TEST_F(KeyFileStoreTest, DeleteKey) {
   static const char kGroup[] = "the-group";
   static const char kKeyDead[] = "dead";
@@ -93,6 +93,7 @@ void LinkMonitor::Stop() {
   active_link_monitor_->Stop();
   passive_link_monitor_->Stop();
   gateway_mac_address_.Clear();
+  gateway_verify_callback_.Reset();
 }
 
 void LinkMonitor::OnAfterResume() {
@@ -109,6 +110,15 @@ void LinkMonitor::OnAfterResume() {
   active_link_monitor_->Start(ActiveLinkMonitor::kFastTestPeriodMilliseconds);
 }
 
+bool LinkMonitor::VerifyGateway(const GatewayVerifyCallback& callback) {
+  if (!IsGatewayFound()) {
+    return false;
+  }
+  OnAfterResume();
+  gateway_verify_callback_ = callback;
+  return true;
+}
+
 int LinkMonitor::GetResponseTimeMilliseconds() const {
   return active_link_monitor_->GetResponseTimeMilliseconds();
 }
@@ -121,6 +131,7 @@ void LinkMonitor::OnActiveLinkMonitorFailure(
     Metrics::LinkMonitorFailure failure,
     int broadcast_failure_count,
     int unicast_failure_count) {
+  GatewayVerifyCallback gateway_verify_callback = gateway_verify_callback_;
   failure_callback_.Run();
 
   struct timeval now, elapsed_time;
@@ -135,11 +146,19 @@ void LinkMonitor::OnActiveLinkMonitorFailure(
       unicast_failure_count);
 
   Stop();
+
+  if (!gateway_verify_callback.is_null()) {
+    gateway_verify_callback.Run(false);
+  }
 }
 
 void LinkMonitor::OnActiveLinkMonitorSuccess() {
-  if (!gateway_mac_address_.Equals(
-      active_link_monitor_->gateway_mac_address())) {
+  GatewayVerifyCallback gateway_verify_callback = gateway_verify_callback_;
+  gateway_verify_callback_.Reset();
+  bool gateway_unchanged = gateway_mac_address_.Equals(
+      active_link_monitor_->gateway_mac_address());
+
+  if (!gateway_unchanged) {
     gateway_mac_address_ = active_link_monitor_->gateway_mac_address();
     // Notify device of the new gateway mac address.
     gateway_change_callback_.Run();
@@ -147,6 +166,10 @@ void LinkMonitor::OnActiveLinkMonitorSuccess() {
 
   // Start passive link monitoring.
   passive_link_monitor_->Start(PassiveLinkMonitor::kDefaultMonitorCycles);
+
+  if (!gateway_verify_callback.is_null()) {
+    gateway_verify_callback.Run(gateway_unchanged);
+  }
 }
 
 void LinkMonitor::OnPassiveLinkMonitorResultCallback(bool status) {
@@ -41,6 +41,7 @@ class LinkMonitor {
  public:
   typedef base::Closure FailureCallback;
   typedef base::Closure GatewayChangeCallback;
+  typedef base::Callback<void(bool)> GatewayVerifyCallback;
 
   // The default number of milliseconds between ARP requests used by
   // ActiveLinkMonitor. Needed by Metrics.
@@ -73,6 +74,16 @@ class LinkMonitor {
   // timeout than normal.
   virtual void OnAfterResume();
 
+  // Checks that the gateway is still reachable at the MAC address found for
+  // it earlier, e.g. after the link has roamed to a new access point.  Like
+  // OnAfterResume(), this restarts the ActiveLinkMonitor using a lower
+  // timeout than normal.  |callback| is invoked once with true if the gateway
+  // replies from the same MAC address, or false if it replies from a
+  // different one or stops responding.  If it stops responding, the failure
+  // callback is run first, as for any other link monitor failure.  Returns
+  // false, without invoking |callback|, if no gateway has been found yet.
+  virtual bool VerifyGateway(const GatewayVerifyCallback& callback);
+
   // Return modified cumulative average of the gateway ARP response
   // time.  Returns zero if no samples are available.  For each
   // missed ARP response, the sample is assumed to be the full
@@ -106,6 +117,8 @@ class LinkMonitor {
   FailureCallback failure_callback_;
   // Callback method to call if gateway mac address changes.
   GatewayChangeCallback gateway_change_callback_;
+  // Pending callback for VerifyGateway(), if any.
+  GatewayVerifyCallback gateway_verify_callback_;
   std::unique_ptr<ActiveLinkMonitor> active_link_monitor_;
   std::unique_ptr<PassiveLinkMonitor> passive_link_monitor_;
   // The MAC address of the default gateway.
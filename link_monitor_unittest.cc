@@ -39,6 +39,7 @@ using std::string;
 using testing::_;
 using testing::AnyNumber;
 using testing::HasSubstr;
+using testing::InSequence;
 using testing::Invoke;
 using testing::Mock;
 using testing::NiceMock;
@@ -66,6 +67,7 @@ class LinkMonitorObserver {
 
   MOCK_METHOD0(OnFailureCallback, void());
   MOCK_METHOD0(OnGatewayChangeCallback, void());
+  MOCK_METHOD1(OnGatewayVerifyCallback, void(bool gateway_unchanged));
 
   const LinkMonitor::FailureCallback failure_callback() {
     return failure_callback_;
@@ -75,6 +77,11 @@ class LinkMonitorObserver {
     return gateway_change_callback_;
   }
 
+  const LinkMonitor::GatewayVerifyCallback gateway_verify_callback() {
+    return Bind(&LinkMonitorObserver::OnGatewayVerifyCallback,
+                Unretained(this));
+  }
+
  private:
   LinkMonitor::FailureCallback failure_callback_;
   LinkMonitor::GatewayChangeCallback gateway_change_callback_;
@@ -256,6 +263,79 @@ TEST_F(LinkMonitorTest, OnActiveLinkMonitorSuccess) {
   Mock::VerifyAndClearExpectations(passive_link_monitor_);
 }
 
+TEST_F(LinkMonitorTest, VerifyGatewayNoGateway) {
+  EXPECT_CALL(*active_link_monitor_, Start(_)).Times(0);
+  EXPECT_CALL(observer_, OnGatewayVerifyCallback(_)).Times(0);
+  EXPECT_FALSE(monitor_.VerifyGateway(observer_.gateway_verify_callback()));
+}
+
+TEST_F(LinkMonitorTest, VerifyGatewaySuccess) {
+  ByteString gateway_mac(kGatewayMACAddress, arraysize(kGatewayMACAddress));
+  SetGatewayMacAddress(gateway_mac);
+  EXPECT_CALL(*active_link_monitor_,
+              Start(ActiveLinkMonitor::kFastTestPeriodMilliseconds))
+      .WillOnce(Return(true));
+  EXPECT_TRUE(monitor_.VerifyGateway(observer_.gateway_verify_callback()));
+  Mock::VerifyAndClearExpectations(active_link_monitor_);
+
+  // Gateway responds from the same MAC address.
+  EXPECT_CALL(*active_link_monitor_, gateway_mac_address())
+      .WillRepeatedly(ReturnRef(gateway_mac));
+  EXPECT_CALL(observer_, OnGatewayChangeCallback()).Times(0);
+  EXPECT_CALL(*passive_link_monitor_, Start(
+      PassiveLinkMonitor::kDefaultMonitorCycles));
+  EXPECT_CALL(observer_, OnGatewayVerifyCallback(true));
+  TriggerActiveLinkMonitorSuccess();
+  Mock::VerifyAndClearExpectations(&observer_);
+
+  // The callback is only invoked once.
+  EXPECT_CALL(*passive_link_monitor_, Start(
+      PassiveLinkMonitor::kDefaultMonitorCycles));
+  EXPECT_CALL(observer_, OnGatewayVerifyCallback(_)).Times(0);
+  TriggerActiveLinkMonitorSuccess();
+}
+
+TEST_F(LinkMonitorTest, VerifyGatewayChanged) {
+  ByteString gateway_mac(kGatewayMACAddress, arraysize(kGatewayMACAddress));
+  ByteString new_gateway_mac(gateway_mac);
+  new_gateway_mac.GetData()[0] ^= 0xff;
+  SetGatewayMacAddress(gateway_mac);
+  EXPECT_CALL(*active_link_monitor_,
+              Start(ActiveLinkMonitor::kFastTestPeriodMilliseconds))
+      .WillOnce(Return(true));
+  EXPECT_TRUE(monitor_.VerifyGateway(observer_.gateway_verify_callback()));
+
+  EXPECT_CALL(*active_link_monitor_, gateway_mac_address())
+      .WillRepeatedly(ReturnRef(new_gateway_mac));
+  EXPECT_CALL(observer_, OnGatewayChangeCallback());
+  EXPECT_CALL(*passive_link_monitor_, Start(
+      PassiveLinkMonitor::kDefaultMonitorCycles));
+  EXPECT_CALL(observer_, OnGatewayVerifyCallback(false));
+  TriggerActiveLinkMonitorSuccess();
+  VerifyGatewayMacAddress(new_gateway_mac);
+}
+
+TEST_F(LinkMonitorTest, VerifyGatewayFailure) {
+  ByteString gateway_mac(kGatewayMACAddress, arraysize(kGatewayMACAddress));
+  SetGatewayMacAddress(gateway_mac);
+  EXPECT_CALL(*active_link_monitor_,
+              Start(ActiveLinkMonitor::kFastTestPeriodMilliseconds))
+      .WillOnce(Return(true));
+  EXPECT_TRUE(monitor_.VerifyGateway(observer_.gateway_verify_callback()));
+
+  // The failure is still reported to the device before the verification
+  // callback runs.
+  {
+    InSequence seq;
+    EXPECT_CALL(observer_, OnFailureCallback());
+    EXPECT_CALL(observer_, OnGatewayVerifyCallback(false));
+  }
+  EXPECT_CALL(metrics_, SendEnumToUMA(HasSubstr("LinkMonitorFailure"), _, _));
+  EXPECT_CALL(metrics_, SendToUMA(_, _, _, _, _)).Times(AnyNumber());
+  TriggerActiveLinkMonitorFailure(Metrics::kLinkMonitorFailureThresholdReached,
+                                  5, 3);
+}
+
 TEST_F(LinkMonitorTest, OnPassiveLinkMonitorResultCallback) {
   // Active link monitor should start regardless of the result of the passive
   // link monitor.
@@ -22,6 +22,7 @@
 #include <algorithm>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <base/bind.h>
@@ -54,6 +55,7 @@
 #include "shill/hook_table.h"
 #include "shill/ip_address_store.h"
 #include "shill/logging.h"
+#include "shill/net/shill_time.h"
 #include "shill/profile.h"
 #include "shill/property_accessor.h"
 #include "shill/resolver.h"
@@ -110,6 +112,11 @@ const int Manager::kTerminationActionsTimeoutMilliseconds = 19500;
 // Device status check interval (every 3 minutes).
 const int Manager::kDeviceStatusCheckIntervalMilliseconds = 180000;
 
+// The warm start snapshot is refreshed every minute, and only trusted for a
+// few minutes so that it covers a crash respawn but not an extended outage.
+const int Manager::kWarmStartStateSaveIntervalMilliseconds = 60000;
+const int Manager::kWarmStartStateMaxAgeSeconds = 300;
+
 // static
 const char* Manager::kProbeTechnologies[] = {
     kTypeEthernet,
@@ -165,6 +172,9 @@ Manager::Manager(ControlInterface* control_interface,
       use_startup_portal_list_(false),
       device_status_check_task_(Bind(&Manager::DeviceStatusCheckTask,
                                      base::Unretained(this))),
+      warm_start_state_save_task_(Bind(&Manager::WarmStartStateSaveTask,
+                                       base::Unretained(this))),
+      time_(Time::GetInstance()),
       termination_actions_(dispatcher),
       suspend_delay_registered_(false),
       is_wake_on_lan_enabled_(true),
@@ -206,10 +216,12 @@ Manager::Manager(ControlInterface* control_interface,
                             &Manager::GetIgnoredDNSSearchPaths,
                             &Manager::SetIgnoredDNSSearchPaths);
   store_.RegisterString(kHostNameProperty, &props_.host_name);
-  store_.RegisterString(kLinkMonitorTechnologiesProperty,
-                        &props_.link_monitor_technologies);
-  store_.RegisterString(kNoAutoConnectTechnologiesProperty,
-                        &props_.no_auto_connect_technologies);
+  HelpRegisterDerivedString(kLinkMonitorTechnologiesProperty,
+                            &Manager::GetLinkMonitorTechnologies,
+                            &Manager::SetLinkMonitorTechnologies);
+  HelpRegisterDerivedString(kNoAutoConnectTechnologiesProperty,
+                            &Manager::GetNoAutoConnectTechnologies,
+                            &Manager::SetNoAutoConnectTechnologies);
   store_.RegisterBool(kOfflineModeProperty, &props_.offline_mode);
   store_.RegisterString(kPortalURLProperty, &props_.portal_url);
   store_.RegisterInt32(kPortalCheckIntervalProperty,
@@ -259,7 +271,7 @@ void Manager::Start() {
   LOG(INFO) << "Manager started.";
 
   power_manager_.reset(
-      new PowerManager(dispatcher_, control_interface_));
+      new PowerManager(dispatcher_, control_interface_, metrics_));
   power_manager_->Start(base::TimeDelta::FromMilliseconds(
                             kTerminationActionsTimeoutMilliseconds),
                         Bind(&Manager::OnSuspendImminent, AsWeakPtr()),
@@ -270,6 +282,10 @@ void Manager::Start() {
   CHECK(base::CreateDirectory(run_path_)) << run_path_.value();
   resolver_->set_path(run_path_.Append("resolv.conf"));
 
+  time_t now = 0;
+  time_->GetSecondsBoottime(&now);
+  warm_start_state_.Load(run_path_, now, kWarmStartStateMaxAgeSeconds);
+
   InitializeProfiles();
   running_ = true;
   device_info_.Start();
@@ -283,10 +299,16 @@ void Manager::Start() {
   // Start task for checking connection status.
   dispatcher_->PostDelayedTask(device_status_check_task_.callback(),
                                kDeviceStatusCheckIntervalMilliseconds);
+  dispatcher_->PostDelayedTask(warm_start_state_save_task_.callback(),
+                               kWarmStartStateSaveIntervalMilliseconds);
 }
 
 void Manager::Stop() {
   running_ = false;
+  // Snapshot runtime state before services are torn down below.
+  SaveWarmStartState();
+  warm_start_state_save_task_.Cancel();
+
   // Persist device information to disk;
   for (const auto& device : devices_) {
     UpdateDevice(device);
@@ -948,27 +970,45 @@ RpcIdentifier Manager::GetDefaultServiceRpcIdentifier(Error* /*error*/) {
       control_interface_->NullRPCIdentifier();
 }
 
-bool Manager::IsTechnologyInList(const string& technology_list,
-                                 Technology::Identifier tech) const {
+// static
+Manager::TechnologySet Manager::GetTechnologySetFromString(
+    const string& technology_list) {
+  TechnologySet technology_set;
   if (technology_list.empty())
-    return false;
+    return technology_set;
 
   Error error;
   vector<Technology::Identifier> technologies;
-  return Technology::GetTechnologyVectorFromString(technology_list,
-                                                   &technologies,
-                                                   &error) &&
-      std::find(technologies.begin(), technologies.end(), tech) !=
-          technologies.end();
+  if (!Technology::GetTechnologyVectorFromString(technology_list,
+                                                 &technologies,
+                                                 &error)) {
+    return technology_set;
+  }
+  for (const auto& technology : technologies) {
+    technology_set.set(technology);
+  }
+  return technology_set;
+}
+
+void Manager::UpdateTechnologyPolicy() {
+  TechnologyPolicy policy;
+  policy.portal_check = GetTechnologySetFromString(GetCheckPortalList(nullptr));
+  policy.link_monitor =
+      GetTechnologySetFromString(props_.link_monitor_technologies);
+  policy.no_auto_connect =
+      GetTechnologySetFromString(props_.no_auto_connect_technologies);
+  policy.prohibited = GetTechnologySetFromString(props_.prohibited_technologies);
+  technology_policy_ = policy;
 }
 
 bool Manager::IsPortalDetectionEnabled(Technology::Identifier tech) {
-  return IsTechnologyInList(GetCheckPortalList(nullptr), tech);
+  return technology_policy_.portal_check.test(tech);
 }
 
 void Manager::SetStartupPortalList(const string& portal_list) {
   startup_portal_list_ = portal_list;
   use_startup_portal_list_ = true;
+  UpdateTechnologyPolicy();
 }
 
 bool Manager::IsProfileBefore(const ProfileRefPtr& a,
@@ -992,17 +1032,17 @@ bool Manager::IsServiceEphemeral(const ServiceConstRefPtr& service) const {
 
 bool Manager::IsTechnologyLinkMonitorEnabled(
     Technology::Identifier technology) const {
-  return IsTechnologyInList(props_.link_monitor_technologies, technology);
+  return technology_policy_.link_monitor.test(technology);
 }
 
 bool Manager::IsTechnologyAutoConnectDisabled(
     Technology::Identifier technology) const {
-  return IsTechnologyInList(props_.no_auto_connect_technologies, technology);
+  return technology_policy_.no_auto_connect.test(technology);
 }
 
 bool Manager::IsTechnologyProhibited(
     Technology::Identifier technology) const {
-  return IsTechnologyInList(props_.prohibited_technologies, technology);
+  return technology_policy_.prohibited.test(technology);
 }
 
 void Manager::OnProfileStorageInitialized(Profile* profile) {
@@ -1358,6 +1398,7 @@ bool Manager::SetProhibitedTechnologies(const string& prohibited_technologies,
                                  result_callback);
   }
   props_.prohibited_technologies = prohibited_technologies;
+  UpdateTechnologyPolicy();
 
   return true;
 }
@@ -1495,6 +1536,7 @@ void Manager::SaveServiceToProfile(const ServiceRefPtr& to_update) {
 void Manager::LoadProperties(const scoped_refptr<DefaultProfile>& profile) {
   profile->LoadManagerProperties(&props_, dhcp_properties_.get());
   SetIgnoredDNSSearchPaths(props_.ignored_dns_search_paths, nullptr);
+  UpdateTechnologyPolicy();
 }
 
 void Manager::AddTerminationAction(const string& name,
@@ -1880,6 +1922,57 @@ void Manager::ConnectionStatusCheck() {
   metrics_->NotifyDeviceConnectionStatus(status);
 }
 
+void Manager::WarmStartStateSaveTask() {
+  SLOG(this, 4) << "In " << __func__;
+  // Hints that were loaded at startup and have not been used by now are
+  // superseded by the live state being saved.
+  warm_start_state_.Clear();
+  SaveWarmStartState();
+
+  dispatcher_->PostDelayedTask(warm_start_state_save_task_.callback(),
+                               kWarmStartStateSaveIntervalMilliseconds);
+}
+
+void Manager::SaveWarmStartState() {
+  WarmStartState state;
+  for (const auto& service : services_) {
+    const ConnectionRefPtr& connection = service->connection();
+    if (service->state() != Service::kStateOnline || !connection) {
+      continue;
+    }
+    WarmStartState::ServiceState service_state;
+    service_state.storage_identifier = service->GetStorageIdentifier();
+    service_state.interface_name = connection->interface_name();
+    service_state.gateway = connection->gateway().ToString();
+    state.mutable_services()->push_back(service_state);
+  }
+
+  time_t now = 0;
+  time_->GetSecondsBoottime(&now);
+  state.Save(run_path_, now);
+}
+
+bool Manager::ConsumeWarmStartOnlineHint(const ServiceRefPtr& service) {
+  const string storage_identifier = service->GetStorageIdentifier();
+  const WarmStartState::ServiceState* hint =
+      warm_start_state_.FindService(storage_identifier);
+  if (!hint) {
+    return false;
+  }
+  WarmStartState::ServiceState service_state = *hint;
+  warm_start_state_.RemoveService(storage_identifier);
+
+  const ConnectionRefPtr& connection = service->connection();
+  if (!connection ||
+      service_state.interface_name != connection->interface_name() ||
+      service_state.gateway != connection->gateway().ToString()) {
+    return false;
+  }
+  LOG(INFO) << "Service " << service->unique_name()
+            << " was online before restart; assuming it still is.";
+  return true;
+}
+
 void Manager::DevicePresenceStatusCheck() {
   Error error;
   vector<string> available_technologies = AvailableTechnologies(&error);
@@ -2208,6 +2301,16 @@ RpcIdentifiers Manager::EnumerateCompleteServices(Error* /*error*/) {
   return service_rpc_ids;
 }
 
+vector<ServiceRefPtr> Manager::GetOrderedServices(bool include_hidden) const {
+  vector<ServiceRefPtr> services;
+  for (const auto& service : services_) {
+    if (include_hidden || service->IsVisible()) {
+      services.push_back(service);
+    }
+  }
+  return services;
+}
+
 RpcIdentifiers Manager::EnumerateWatchedServices(Error* /*error*/) {
   RpcIdentifiers service_rpc_ids;
   watched_service_states_.clear();
@@ -2232,9 +2335,12 @@ string Manager::GetCheckPortalList(Error* /*error*/) {
 bool Manager::SetCheckPortalList(const string& portal_list, Error* error) {
   use_startup_portal_list_ = false;
   if (props_.check_portal_list == portal_list) {
+    // The effective list may still have changed if a startup list was in use.
+    UpdateTechnologyPolicy();
     return false;
   }
   props_.check_portal_list = portal_list;
+  UpdateTechnologyPolicy();
   return true;
 }
 
@@ -2242,6 +2348,14 @@ string Manager::GetIgnoredDNSSearchPaths(Error* /*error*/) {
   return props_.ignored_dns_search_paths;
 }
 
+string Manager::GetLinkMonitorTechnologies(Error* /*error*/) {
+  return props_.link_monitor_technologies;
+}
+
+string Manager::GetNoAutoConnectTechnologies(Error* /*error*/) {
+  return props_.no_auto_connect_technologies;
+}
+
 bool Manager::SetIgnoredDNSSearchPaths(const string& ignored_paths,
                                        Error* /*error*/) {
   if (props_.ignored_dns_search_paths == ignored_paths) {
@@ -2257,6 +2371,26 @@ bool Manager::SetIgnoredDNSSearchPaths(const string& ignored_paths,
   return true;
 }
 
+bool Manager::SetLinkMonitorTechnologies(const string& technologies,
+                                         Error* /*error*/) {
+  if (props_.link_monitor_technologies == technologies) {
+    return false;
+  }
+  props_.link_monitor_technologies = technologies;
+  UpdateTechnologyPolicy();
+  return true;
+}
+
+bool Manager::SetNoAutoConnectTechnologies(const string& technologies,
+                                           Error* /*error*/) {
+  if (props_.no_auto_connect_technologies == technologies) {
+    return false;
+  }
+  props_.no_auto_connect_technologies = technologies;
+  UpdateTechnologyPolicy();
+  return true;
+}
+
 // called via RPC (e.g., from ManagerDBusAdaptor)
 ServiceRefPtr Manager::GetService(const KeyValueStore& args, Error* error) {
   if (args.ContainsString(kTypeProperty) &&
@@ -2375,6 +2509,54 @@ ServiceRefPtr Manager::ConfigureService(const KeyValueStore& args,
   return service;
 }
 
+// called via RPC (e.g., from ManagerDBusAdaptor)
+void Manager::ConfigureServices(const vector<KeyValueStore>& args,
+                                vector<ServiceRefPtr>* services,
+                                vector<std::unique_ptr<Error>>* errors) {
+  services->clear();
+  errors->clear();
+
+  // Hold our own references, so that the set of profiles whose batch is
+  // ended below matches the set whose batch is begun here.
+  vector<ProfileRefPtr> profiles(profiles_.begin(), profiles_.end());
+  for (const auto& profile : profiles) {
+    profile->BeginBatchUpdate();
+  }
+
+  vector<ProfileRefPtr> target_profiles;
+  for (const auto& service_args : args) {
+    std::unique_ptr<Error> error(new Error());
+    ServiceRefPtr service = ConfigureService(service_args, error.get());
+    if (!service && error->IsSuccess()) {
+      error->Populate(Error::kInternalError);
+    }
+    services->push_back(error->IsSuccess() ? service : nullptr);
+    errors->push_back(std::move(error));
+    // Remember the profile this entry was saved to, in case flushing it
+    // fails below.
+    target_profiles.push_back(
+        service_args.ContainsString(kProfileProperty) ?
+        LookupProfileByRpcIdentifier(
+            service_args.GetString(kProfileProperty)) :
+        ActiveProfile());
+  }
+
+  for (const auto& profile : profiles) {
+    if (profile->EndBatchUpdate()) {
+      continue;
+    }
+    for (size_t i = 0; i < args.size(); ++i) {
+      if (target_profiles[i] != profile || !(*services)[i]) {
+        continue;
+      }
+      Error::PopulateAndLog(FROM_HERE, (*errors)[i].get(),
+                            Error::kInternalError,
+                            "Unable to save service to profile");
+      (*services)[i] = nullptr;
+    }
+  }
+}
+
 // called via RPC (e.g., from ManagerDBusAdaptor)
 ServiceRefPtr Manager::ConfigureServiceForProfile(
     const string& profile_rpcid, const KeyValueStore& args, Error* error) {
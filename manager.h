@@ -17,6 +17,7 @@
 #ifndef SHILL_MANAGER_H_
 #define SHILL_MANAGER_H_
 
+#include <bitset>
 #include <map>
 #include <memory>
 #include <string>
@@ -49,6 +50,7 @@
 #include "shill/property_store.h"
 #include "shill/service.h"
 #include "shill/upstart/upstart.h"
+#include "shill/warm_start_state.h"
 #include "shill/wimax/wimax_provider.h"
 
 namespace shill {
@@ -62,6 +64,7 @@ class IPAddressStore;
 class ManagerAdaptorInterface;
 class Resolver;
 class StoreInterface;
+class Time;
 class VPNProvider;
 
 #if !defined(DISABLE_WIFI)
@@ -176,11 +179,25 @@ class Manager : public base::SupportsWeakPtr<Manager> {
   // Return the complete list of services, including those that are not visible.
   RpcIdentifiers EnumerateCompleteServices(Error* error);
 
+  // Return the services in the same order as EnumerateAvailableServices()
+  // or, if |include_hidden| is true, EnumerateCompleteServices().
+  virtual std::vector<ServiceRefPtr> GetOrderedServices(
+      bool include_hidden) const;
+
   // called via RPC (e.g., from ManagerDBusAdaptor)
   std::map<std::string, std::string> GetLoadableProfileEntriesForService(
       const ServiceConstRefPtr& service);
   ServiceRefPtr GetService(const KeyValueStore& args, Error* error);
   ServiceRefPtr ConfigureService(const KeyValueStore& args, Error* error);
+  // Configure a service for each entry of |args|, as ConfigureService()
+  // would, but flush each affected profile to disk only once at the end.
+  // On return, |services| and |errors| each hold one element per entry of
+  // |args|; the service is null when its error is a failure.  If a profile
+  // cannot be flushed, every entry saved to that profile is failed.
+  virtual void ConfigureServices(
+      const std::vector<KeyValueStore>& args,
+      std::vector<ServiceRefPtr>* services,
+      std::vector<std::unique_ptr<Error>>* errors);
   ServiceRefPtr ConfigureServiceForProfile(
       const std::string& profile_rpcid,
       const KeyValueStore& args,
@@ -313,6 +330,11 @@ class Manager : public base::SupportsWeakPtr<Manager> {
                                     const ResultCallback& callback);
   // Return whether a technology is marked as enabled for portal detection.
   virtual bool IsPortalDetectionEnabled(Technology::Identifier tech);
+  // Returns true if the snapshot loaded at startup recorded |service| as
+  // online over the same interface and gateway it is connected through now,
+  // so that the caller can mark it online while portal detection confirms.
+  // The hint for |service| is used up by the first call.
+  virtual bool ConsumeWarmStartOnlineHint(const ServiceRefPtr& service);
   // Set the start-up value for the portal detection list.  This list will
   // be used until a value set explicitly over the control API.  Until
   // then, we ignore but do not overwrite whatever value is stored in the
@@ -585,6 +607,7 @@ class Manager : public base::SupportsWeakPtr<Manager> {
   FRIEND_TEST(ManagerTest, ConnectedTechnologies);
   FRIEND_TEST(ManagerTest, ConnectionStatusCheck);
   FRIEND_TEST(ManagerTest, ConnectToBestServices);
+  FRIEND_TEST(ManagerTest, ConsumeWarmStartOnlineHint);
   FRIEND_TEST(ManagerTest, CreateConnectivityReport);
   FRIEND_TEST(ManagerTest, DefaultTechnology);
   FRIEND_TEST(ManagerTest, DetectMultiHomedDevices);
@@ -613,6 +636,7 @@ class Manager : public base::SupportsWeakPtr<Manager> {
   FRIEND_TEST(ManagerTest, ReleaseBlacklistedDevice);
   FRIEND_TEST(ManagerTest, ReleaseDevice);
   FRIEND_TEST(ManagerTest, RunTerminationActions);
+  FRIEND_TEST(ManagerTest, SaveWarmStartState);
   FRIEND_TEST(ManagerTest, ServiceRegistration);
   FRIEND_TEST(ManagerTest, SetupApModeInterface);
   FRIEND_TEST(ManagerTest, SetupStationModeInterface);
@@ -620,6 +644,8 @@ class Manager : public base::SupportsWeakPtr<Manager> {
   FRIEND_TEST(ManagerTest, StartupPortalList);
   FRIEND_TEST(ServiceTest, IsAutoConnectable);
 
+  typedef std::bitset<Technology::kUnknown + 1> TechnologySet;
+
   struct DeviceClaim {
     DeviceClaim() {}
     DeviceClaim(const std::string& in_device_name,
@@ -645,6 +671,10 @@ class Manager : public base::SupportsWeakPtr<Manager> {
   static const int kDeviceStatusCheckIntervalMilliseconds;
   // Time to wait for termination actions to complete.
   static const int kTerminationActionsTimeoutMilliseconds;
+  // Interval between periodic saves of the warm start snapshot, and the age
+  // beyond which a snapshot is not trusted at startup.
+  static const int kWarmStartStateSaveIntervalMilliseconds;
+  static const int kWarmStartStateMaxAgeSeconds;
 
   void AutoConnect();
   std::vector<std::string> AvailableTechnologies(Error* error);
@@ -660,11 +690,22 @@ class Manager : public base::SupportsWeakPtr<Manager> {
   RpcIdentifier GetDefaultServiceRpcIdentifier(Error* error);
   std::string GetIgnoredDNSSearchPaths(Error* error);
   ServiceRefPtr GetServiceInner(const KeyValueStore& args, Error* error);
+  std::string GetLinkMonitorTechnologies(Error* error);
+  std::string GetNoAutoConnectTechnologies(Error* error);
   bool SetCheckPortalList(const std::string& portal_list, Error* error);
   bool SetIgnoredDNSSearchPaths(const std::string& ignored_paths, Error* error);
+  bool SetLinkMonitorTechnologies(const std::string& technologies,
+                                  Error* error);
+  bool SetNoAutoConnectTechnologies(const std::string& technologies,
+                                    Error* error);
   void EmitDefaultService();
-  bool IsTechnologyInList(const std::string& technology_list,
-                          Technology::Identifier tech) const;
+  // Returns the technologies named in the comma-separated |technology_list|.
+  // A list that fails to parse names no technologies.
+  static TechnologySet GetTechnologySetFromString(
+      const std::string& technology_list);
+  // Re-parses the technology lists in |props_| into |technology_policy_|.
+  // Must be called whenever one of those lists changes.
+  void UpdateTechnologyPolicy();
   void EmitDeviceProperties();
 #if !defined(DISABLE_WIFI)
   bool SetDisableWiFiVHT(const bool& disable_wifi_vht, Error* error);
@@ -721,6 +762,8 @@ class Manager : public base::SupportsWeakPtr<Manager> {
   void SortServicesTask();
   void DeviceStatusCheckTask();
   void ConnectionStatusCheck();
+  void WarmStartStateSaveTask();
+  void SaveWarmStartState();
   void DevicePresenceStatusCheck();
 
   bool MatchProfileWithService(const ServiceRefPtr& service);
@@ -838,6 +881,17 @@ class Manager : public base::SupportsWeakPtr<Manager> {
   // The priority order of technologies
   std::vector<Technology::Identifier> technology_order_;
 
+  // The comma-separated technology lists in |props_|, parsed once when they
+  // change so that the policy checks made for every service on every
+  // auto-connect pass are a single bit test.
+  struct TechnologyPolicy {
+    TechnologySet portal_check;
+    TechnologySet link_monitor;
+    TechnologySet no_auto_connect;
+    TechnologySet prohibited;
+  };
+  TechnologyPolicy technology_policy_;
+
   // This is the last Service RPC Identifier for which we emitted a
   // "DefaultService" signal for.
   RpcIdentifier default_service_rpc_identifier_;
@@ -862,6 +916,13 @@ class Manager : public base::SupportsWeakPtr<Manager> {
   // Task for periodically checking various device status.
   base::CancelableClosure device_status_check_task_;
 
+  // Runtime state carried across a restart of the daemon.  Loaded from
+  // |run_path_| when the manager starts, and rewritten periodically and
+  // when it stops.
+  WarmStartState warm_start_state_;
+  base::CancelableClosure warm_start_state_save_task_;
+  Time* time_;
+
   // TODO(petkov): Currently this handles both terminate and suspend
   // actions. Rename all relevant identifiers to capture this.
   HookTable termination_actions_;
@@ -54,6 +54,7 @@
 #include "shill/mock_resolver.h"
 #include "shill/mock_service.h"
 #include "shill/mock_store.h"
+#include "shill/net/mock_time.h"
 #include "shill/portal_detector.h"
 #include "shill/property_store_unittest.h"
 #include "shill/resolver.h"
@@ -112,7 +113,8 @@ using ::testing::WithArg;
 class ManagerTest : public PropertyStoreTest {
  public:
   ManagerTest()
-      : power_manager_(new MockPowerManager(nullptr, control_interface())),
+      : power_manager_(new MockPowerManager(nullptr, control_interface(),
+                                            metrics())),
         device_info_(new NiceMock<MockDeviceInfo>(control_interface(),
                                                   nullptr,
                                                   nullptr,
@@ -1906,6 +1908,96 @@ TEST_F(ManagerTest, ConfigureRegisteredServiceWithProfile) {
   service->set_profile(nullptr);  // Breaks refcounting loop.
 }
 
+// Configuring several services at once should defer profile flushes to the
+// end of the batch, and fail only those entries whose profile failed to
+// flush.
+TEST_F(ManagerTest, ConfigureServices) {
+  scoped_refptr<MockProfile> profile0(
+      new NiceMock<MockProfile>(
+          control_interface(), metrics(), manager(), ""));
+  scoped_refptr<MockProfile> profile1(
+      new NiceMock<MockProfile>(
+          control_interface(), metrics(), manager(), ""));
+
+  const string kProfileName0 = "profile0";
+  const string kProfileName1 = "profile1";
+
+  EXPECT_CALL(*profile0, GetRpcIdentifier())
+      .WillRepeatedly(Return(kProfileName0));
+  EXPECT_CALL(*profile1, GetRpcIdentifier())
+      .WillRepeatedly(Return(kProfileName1));
+
+  AdoptProfile(manager(), profile0);
+  AdoptProfile(manager(), profile1);  // profile1 is now the ActiveProfile.
+
+  const vector<uint8_t> ssid;
+  scoped_refptr<MockWiFiService> service0(
+      new NiceMock<MockWiFiService>(control_interface(),
+                                    dispatcher(),
+                                    metrics(),
+                                    manager(),
+                                    wifi_provider_,
+                                    ssid,
+                                    "",
+                                    "",
+                                    false));
+  scoped_refptr<MockWiFiService> service1(
+      new NiceMock<MockWiFiService>(control_interface(),
+                                    dispatcher(),
+                                    metrics(),
+                                    manager(),
+                                    wifi_provider_,
+                                    ssid,
+                                    "",
+                                    "",
+                                    false));
+
+  EXPECT_CALL(*wifi_provider_, GetService(_, _))
+      .WillOnce(Return(service1))
+      .WillOnce(Return(service0));
+  EXPECT_CALL(*profile0, UpdateService(ServiceRefPtr(service0.get())))
+      .WillOnce(Return(true));
+  EXPECT_CALL(*profile1, UpdateService(ServiceRefPtr(service1.get())))
+      .WillOnce(Return(true));
+
+  {
+    InSequence seq;
+    EXPECT_CALL(*profile0, BeginBatchUpdate());
+    EXPECT_CALL(*profile0, EndBatchUpdate()).WillOnce(Return(false));
+  }
+  {
+    InSequence seq;
+    EXPECT_CALL(*profile1, BeginBatchUpdate());
+    EXPECT_CALL(*profile1, EndBatchUpdate()).WillOnce(Return(true));
+  }
+
+  vector<KeyValueStore> args(3);
+  // Saved to the active profile.
+  args[0].SetString(kTypeProperty, kTypeWifi);
+  // Refers to a profile that does not exist.
+  args[1].SetString(kTypeProperty, kTypeWifi);
+  args[1].SetString(kProfileProperty, "xxx");
+  // Saved to a profile that will fail to flush.
+  args[2].SetString(kTypeProperty, kTypeWifi);
+  args[2].SetString(kProfileProperty, kProfileName0);
+
+  vector<ServiceRefPtr> services;
+  vector<std::unique_ptr<Error>> errors;
+  manager()->ConfigureServices(args, &services, &errors);
+  ASSERT_EQ(3U, services.size());
+  ASSERT_EQ(3U, errors.size());
+
+  EXPECT_EQ(service1.get(), services[0].get());
+  EXPECT_TRUE(errors[0]->IsSuccess());
+
+  EXPECT_FALSE(services[1]);
+  EXPECT_EQ(Error::kInvalidArguments, errors[1]->type());
+
+  EXPECT_FALSE(services[2]);
+  EXPECT_EQ(Error::kInternalError, errors[2]->type());
+  EXPECT_EQ("Unable to save service to profile", errors[2]->message());
+}
+
 // If we configure a service that is already a member of the specified
 // profile, the Manager should not call LoadService or AdoptService again
 // on this service.
@@ -2513,6 +2605,103 @@ TEST_F(ManagerTest, ConnectionStatusCheck) {
   manager()->ConnectionStatusCheck();
 }
 
+TEST_F(ManagerTest, SaveWarmStartState) {
+  MockTime time;
+  manager()->time_ = &time;
+  const time_t kNow = 100;
+  EXPECT_CALL(time, GetSecondsBoottime(_))
+      .WillOnce(DoAll(SetArgumentPointee<0>(kNow), Return(true)));
+
+  scoped_refptr<MockConnection> mock_connection(
+      new NiceMock<MockConnection>(device_info_.get()));
+  const string kInterfaceName("null0");
+  IPAddress gateway(IPAddress::kFamilyIPv4);
+  ASSERT_TRUE(gateway.SetAddressFromString("192.168.1.1"));
+  ON_CALL(*mock_connection.get(), interface_name())
+      .WillByDefault(ReturnRef(kInterfaceName));
+  ON_CALL(*mock_connection.get(), gateway()).WillByDefault(ReturnRef(gateway));
+
+  scoped_refptr<MockService> online_service = new NiceMock<MockService>(
+      control_interface(), dispatcher(), metrics(), manager());
+  ON_CALL(*online_service.get(), state())
+      .WillByDefault(Return(Service::kStateOnline));
+  online_service->set_mock_connection(mock_connection);
+  manager()->RegisterService(online_service);
+
+  // Services that are connected but not online are left out.
+  scoped_refptr<MockService> portal_service = new NiceMock<MockService>(
+      control_interface(), dispatcher(), metrics(), manager());
+  ON_CALL(*portal_service.get(), state())
+      .WillByDefault(Return(Service::kStatePortal));
+  portal_service->set_mock_connection(mock_connection);
+  manager()->RegisterService(portal_service);
+
+  manager()->SaveWarmStartState();
+
+  WarmStartState state;
+  EXPECT_TRUE(state.Load(FilePath(run_path()), kNow, 0));
+  ASSERT_EQ(1U, state.services().size());
+  const WarmStartState::ServiceState* service_state =
+      state.FindService(online_service->GetStorageIdentifier());
+  ASSERT_NE(nullptr, service_state);
+  EXPECT_EQ(kInterfaceName, service_state->interface_name);
+  EXPECT_EQ("192.168.1.1", service_state->gateway);
+
+  // So DeregisterService works.
+  online_service->set_mock_connection(nullptr);
+  portal_service->set_mock_connection(nullptr);
+  manager()->DeregisterService(online_service);
+  manager()->DeregisterService(portal_service);
+  manager()->time_ = Time::GetInstance();
+}
+
+TEST_F(ManagerTest, ConsumeWarmStartOnlineHint) {
+  scoped_refptr<MockService> mock_service = new NiceMock<MockService>(
+      control_interface(), dispatcher(), metrics(), manager());
+  scoped_refptr<MockConnection> mock_connection(
+      new NiceMock<MockConnection>(device_info_.get()));
+  const string kInterfaceName("null0");
+  IPAddress gateway(IPAddress::kFamilyIPv4);
+  ASSERT_TRUE(gateway.SetAddressFromString("192.168.1.1"));
+  ON_CALL(*mock_connection.get(), interface_name())
+      .WillByDefault(ReturnRef(kInterfaceName));
+  ON_CALL(*mock_connection.get(), gateway()).WillByDefault(ReturnRef(gateway));
+  mock_service->set_mock_connection(mock_connection);
+
+  WarmStartState* state = &manager()->warm_start_state_;
+  WarmStartState::ServiceState service_state;
+  service_state.storage_identifier = mock_service->GetStorageIdentifier();
+  service_state.interface_name = kInterfaceName;
+  service_state.gateway = "192.168.1.1";
+
+  // No hint for this service.
+  EXPECT_FALSE(manager()->ConsumeWarmStartOnlineHint(mock_service));
+
+  // The service was online over the same interface and gateway.  The hint
+  // is only good once.
+  state->mutable_services()->push_back(service_state);
+  EXPECT_TRUE(manager()->ConsumeWarmStartOnlineHint(mock_service));
+  EXPECT_FALSE(manager()->ConsumeWarmStartOnlineHint(mock_service));
+
+  // The service is now reached through a different interface.
+  service_state.interface_name = "null1";
+  state->mutable_services()->push_back(service_state);
+  EXPECT_FALSE(manager()->ConsumeWarmStartOnlineHint(mock_service));
+  service_state.interface_name = kInterfaceName;
+
+  // The service is now reached through a different gateway.
+  service_state.gateway = "192.168.1.254";
+  state->mutable_services()->push_back(service_state);
+  EXPECT_FALSE(manager()->ConsumeWarmStartOnlineHint(mock_service));
+  service_state.gateway = "192.168.1.1";
+
+  // The service is no longer connected.
+  mock_service->set_mock_connection(nullptr);
+  state->mutable_services()->push_back(service_state);
+  EXPECT_FALSE(manager()->ConsumeWarmStartOnlineHint(mock_service));
+  EXPECT_TRUE(state->IsEmpty());
+}
+
 TEST_F(ManagerTest, DevicePresenceStatusCheck) {
   // Setup mock metrics and service.
   MockMetrics mock_metrics(dispatcher());
@@ -3547,6 +3736,7 @@ TEST_F(ManagerTest, StartupPortalList) {
   // Simulate loading value from the default profile.
   const string kProfileValue("wifi,vpn");
   manager()->props_.check_portal_list = kProfileValue;
+  manager()->UpdateTechnologyPolicy();
 
   EXPECT_EQ(kProfileValue, manager()->GetCheckPortalList(nullptr));
   EXPECT_TRUE(manager()->IsPortalDetectionEnabled(Technology::kWifi));
@@ -3581,19 +3771,36 @@ TEST_F(ManagerTest, StartupPortalList) {
 TEST_F(ManagerTest, LinkMonitorEnabled) {
   const string kEnabledTechnologies("wifi,vpn");
   manager()->props_.link_monitor_technologies = kEnabledTechnologies;
+  manager()->UpdateTechnologyPolicy();
   EXPECT_TRUE(manager()->IsTechnologyLinkMonitorEnabled(Technology::kWifi));
   EXPECT_FALSE(
       manager()->IsTechnologyLinkMonitorEnabled(Technology::kCellular));
+
+  // Setting the list over the control API takes effect immediately.
+  Error error;
+  manager()->mutable_store()->SetStringProperty(
+      kLinkMonitorTechnologiesProperty, "cellular", &error);
+  ASSERT_TRUE(error.IsSuccess());
+  EXPECT_EQ("cellular", manager()->props_.link_monitor_technologies);
+  EXPECT_FALSE(manager()->IsTechnologyLinkMonitorEnabled(Technology::kWifi));
+  EXPECT_TRUE(
+      manager()->IsTechnologyLinkMonitorEnabled(Technology::kCellular));
 }
 
 TEST_F(ManagerTest, IsTechnologyAutoConnectDisabled) {
   const string kNoAutoConnectTechnologies("wifi,cellular");
   manager()->props_.no_auto_connect_technologies = kNoAutoConnectTechnologies;
+  manager()->UpdateTechnologyPolicy();
   EXPECT_TRUE(manager()->IsTechnologyAutoConnectDisabled(Technology::kWifi));
   EXPECT_TRUE(
       manager()->IsTechnologyAutoConnectDisabled(Technology::kCellular));
   EXPECT_FALSE(
       manager()->IsTechnologyAutoConnectDisabled(Technology::kEthernet));
+
+  // A list that fails to parse disables auto-connect for nothing.
+  manager()->props_.no_auto_connect_technologies = "wifi,bogus";
+  manager()->UpdateTechnologyPolicy();
+  EXPECT_FALSE(manager()->IsTechnologyAutoConnectDisabled(Technology::kWifi));
 }
 
 TEST_F(ManagerTest, SetEnabledStateForTechnologyPersistentCheck) {
@@ -3835,6 +4042,35 @@ TEST_F(ManagerTest, EnumerateServices) {
   manager()->DeregisterService(mock_service);
 }
 
+TEST_F(ManagerTest, GetOrderedServices) {
+  scoped_refptr<MockService> visible_service(
+      new NiceMock<MockService>(control_interface(),
+                                dispatcher(),
+                                metrics(),
+                                manager()));
+  scoped_refptr<MockService> hidden_service(
+      new NiceMock<MockService>(control_interface(),
+                                dispatcher(),
+                                metrics(),
+                                manager()));
+  EXPECT_CALL(*hidden_service, IsVisible()).WillRepeatedly(Return(false));
+  manager()->RegisterService(visible_service);
+  manager()->RegisterService(hidden_service);
+
+  vector<ServiceRefPtr> services = manager()->GetOrderedServices(false);
+  ASSERT_EQ(1U, services.size());
+  EXPECT_EQ(visible_service.get(), services[0].get());
+
+  services = manager()->GetOrderedServices(true);
+  ASSERT_EQ(2U, services.size());
+  EXPECT_EQ(manager()->EnumerateCompleteServices(nullptr),
+            (vector<string>{services[0]->GetRpcIdentifier(),
+                            services[1]->GetRpcIdentifier()}));
+
+  manager()->DeregisterService(visible_service);
+  manager()->DeregisterService(hidden_service);
+}
+
 TEST_F(ManagerTest, ConnectToBestServices) {
   scoped_refptr<MockService> wifi_service0(
       new NiceMock<MockService>(control_interface(),
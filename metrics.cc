@@ -16,6 +16,8 @@
 
 #include "shill/metrics.h"
 
+#include <utility>
+
 #include <base/strings/string_util.h>
 #include <base/strings/stringprintf.h>
 #if defined(__ANDROID__)
@@ -32,7 +34,7 @@
 #include "shill/logging.h"
 
 using std::string;
-using std::shared_ptr;
+using std::unique_ptr;
 
 namespace shill {
 
@@ -146,6 +148,9 @@ const int Metrics::kTimerHistogramMillisecondsMax = 45 * 1000;
 const int Metrics::kTimerHistogramMillisecondsMin = 1;
 const int Metrics::kTimerHistogramNumBuckets = 50;
 
+constexpr int Metrics::kServiceConnectStateCount;
+const size_t Metrics::kMaxPooledServiceMetrics = 64;
+
 const char Metrics::kMetricPortalAttemptsSuffix[] = "PortalAttempts";
 const int Metrics::kMetricPortalAttemptsMax =
     PortalDetector::kMaxRequestAttempts;
@@ -186,6 +191,21 @@ const char Metrics::kMetricSuspendActionResult[] =
 const int Metrics::kMetricSuspendActionTimeTakenMillisecondsMax = 20000;
 const int Metrics::kMetricSuspendActionTimeTakenMillisecondsMin = 1;
 
+const char Metrics::kMetricRegisterSuspendDelayTime[] =
+    "Network.Shill.PowerManager.RegisterSuspendDelayTime";
+const char Metrics::kMetricRegisterDarkSuspendDelayTime[] =
+    "Network.Shill.PowerManager.RegisterDarkSuspendDelayTime";
+const char Metrics::kMetricReportSuspendReadinessTime[] =
+    "Network.Shill.PowerManager.ReportSuspendReadinessTime";
+const char Metrics::kMetricReportDarkSuspendReadinessTime[] =
+    "Network.Shill.PowerManager.ReportDarkSuspendReadinessTime";
+
+const char Metrics::kMetricVpnFirewallSetupTime[] =
+    "Network.Shill.Vpn.FirewallSetupTime";
+
+const int Metrics::kMetricDaemonCallTimeMillisecondsMax = 20000;
+const int Metrics::kMetricDaemonCallTimeMillisecondsMin = 1;
+
 const char Metrics::kMetricDarkResumeActionTimeTaken[] =
     "Network.Shill.DarkResumeActionTimeTaken";
 const char Metrics::kMetricDarkResumeActionResult[] =
@@ -410,6 +430,15 @@ const char Metrics::kMetricNetworkConnectionIPTypeSuffix[] =
 const char Metrics::kMetricIPv6ConnectivityStatusSuffix[] =
     "IPv6ConnectivityStatus";
 
+// static
+const char Metrics::kMetricTimeToIPv6AddressMillisecondsSuffix[] =
+    "TimeToIPv6Address";
+const char Metrics::kMetricTimeToIPv6DNSMillisecondsSuffix[] =
+    "TimeToIPv6DNS";
+const int Metrics::kMetricTimeToIPv6ReadyMillisecondsMax = 60 * 1000;
+const int Metrics::kMetricTimeToIPv6ReadyMillisecondsMin = 1;
+const int Metrics::kMetricTimeToIPv6ReadyMillisecondsNumBuckets = 60;
+
 // static
 const char Metrics::kMetricDevicePresenceStatusSuffix[] =
     "DevicePresenceStatus";
@@ -650,13 +679,26 @@ void Metrics::RegisterService(const Service& service) {
   SLOG(this, 2) << __func__;
   LOG_IF(WARNING, ContainsKey(services_metrics_, &service))
       << "Repeatedly registering " << service.unique_name();
-  shared_ptr<ServiceMetrics> service_metrics(new ServiceMetrics());
-  services_metrics_[&service] = service_metrics;
+  unique_ptr<ServiceMetrics> service_metrics;
+  if (service_metrics_pool_.empty()) {
+    service_metrics.reset(new ServiceMetrics());
+  } else {
+    service_metrics = std::move(service_metrics_pool_.back());
+    service_metrics_pool_.pop_back();
+  }
+  services_metrics_[&service] = std::move(service_metrics);
   InitializeCommonServiceMetrics(service);
 }
 
 void Metrics::DeregisterService(const Service& service) {
-  services_metrics_.erase(&service);
+  ServiceMetricsLookupMap::iterator it = services_metrics_.find(&service);
+  if (it == services_metrics_.end())
+    return;
+  if (service_metrics_pool_.size() < kMaxPooledServiceMetrics) {
+    it->second->Clear();
+    service_metrics_pool_.push_back(std::move(it->second));
+  }
+  services_metrics_.erase(it);
 }
 
 void Metrics::AddServiceStateTransitionTimer(
@@ -667,20 +709,20 @@ void Metrics::AddServiceStateTransitionTimer(
   SLOG(this, 2) << __func__ << ": adding " << histogram_name << " for "
                 << Service::ConnectStateToString(start_state) << " -> "
                 << Service::ConnectStateToString(stop_state);
-  ServiceMetricsLookupMap::iterator it = services_metrics_.find(&service);
-  if (it == services_metrics_.end()) {
-    SLOG(this, 1) << "service not found";
+  ServiceMetrics* service_metrics = GetServiceMetrics(service);
+  if (service_metrics == nullptr) {
     DCHECK(false);
     return;
   }
-  ServiceMetrics* service_metrics = it->second.get();
   CHECK(start_state < stop_state);
   chromeos_metrics::TimerReporter* timer =
       new chromeos_metrics::TimerReporter(histogram_name,
                                           kTimerHistogramMillisecondsMin,
                                           kTimerHistogramMillisecondsMax,
                                           kTimerHistogramNumBuckets);
-  service_metrics->timers.push_back(timer);  // passes ownership.
+  // Passes ownership.
+  service_metrics->timers.push_back(
+      unique_ptr<chromeos_metrics::TimerReporter>(timer));
   service_metrics->start_on_state[start_state].push_back(timer);
   service_metrics->stop_on_state[stop_state].push_back(timer);
 }
@@ -728,13 +770,11 @@ void Metrics::NotifyDefaultServiceChanged(const Service* service) {
 
 void Metrics::NotifyServiceStateChanged(const Service& service,
                                         Service::ConnectState new_state) {
-  ServiceMetricsLookupMap::iterator it = services_metrics_.find(&service);
-  if (it == services_metrics_.end()) {
-    SLOG(this, 1) << "service not found";
+  ServiceMetrics* service_metrics = GetServiceMetrics(service);
+  if (service_metrics == nullptr) {
     DCHECK(false);
     return;
   }
-  ServiceMetrics* service_metrics = it->second.get();
   UpdateServiceStateTransitionMetrics(service_metrics, new_state);
 
   if (new_state == Service::kStateFailure)
@@ -886,6 +926,32 @@ void Metrics::NotifyDarkResumeActionsStarted() {
   dark_resume_scan_retries_ = 0;
 }
 
+void Metrics::NotifySuspendDelayRegistered(bool is_dark, int milliseconds) {
+  SendToUMA(is_dark ? kMetricRegisterDarkSuspendDelayTime :
+                      kMetricRegisterSuspendDelayTime,
+            milliseconds,
+            kMetricDaemonCallTimeMillisecondsMin,
+            kMetricDaemonCallTimeMillisecondsMax,
+            kTimerHistogramNumBuckets);
+}
+
+void Metrics::NotifySuspendReadinessReported(bool is_dark, int milliseconds) {
+  SendToUMA(is_dark ? kMetricReportDarkSuspendReadinessTime :
+                      kMetricReportSuspendReadinessTime,
+            milliseconds,
+            kMetricDaemonCallTimeMillisecondsMin,
+            kMetricDaemonCallTimeMillisecondsMax,
+            kTimerHistogramNumBuckets);
+}
+
+void Metrics::NotifyVpnFirewallSetupCompleted(int milliseconds) {
+  SendToUMA(kMetricVpnFirewallSetupTime,
+            milliseconds,
+            kMetricDaemonCallTimeMillisecondsMin,
+            kMetricDaemonCallTimeMillisecondsMax,
+            kTimerHistogramNumBuckets);
+}
+
 void Metrics::NotifyDarkResumeActionsCompleted(bool success) {
   if (!time_dark_resume_actions_timer->HasStarted())
     return;
@@ -1021,8 +1087,8 @@ void Metrics::Notify80211Disconnect(WiFiDisconnectByWhom by_whom,
 void Metrics::RegisterDevice(int interface_index,
                              Technology::Identifier technology) {
   SLOG(this, 2) << __func__ << ": " << interface_index;
-  shared_ptr<DeviceMetrics> device_metrics(new DeviceMetrics);
-  devices_metrics_[interface_index] = device_metrics;
+  DeviceMetrics* device_metrics = new DeviceMetrics;
+  devices_metrics_[interface_index].reset(device_metrics);  // Passes ownership.
   device_metrics->technology = technology;
   string histogram = GetFullMetricName(
       kMetricTimeToInitializeMillisecondsSuffix, technology);
@@ -1431,6 +1497,28 @@ void Metrics::NotifyIPv6ConnectivityStatus(Technology::Identifier technology_id,
   SendEnumToUMA(histogram, ipv6_status, kIPv6ConnectivityStatusMax);
 }
 
+void Metrics::NotifyIPv6AddressReady(Technology::Identifier technology_id,
+                                     int milliseconds) {
+  string histogram = GetFullMetricName(
+      kMetricTimeToIPv6AddressMillisecondsSuffix, technology_id);
+  SendToUMA(histogram,
+            milliseconds,
+            kMetricTimeToIPv6ReadyMillisecondsMin,
+            kMetricTimeToIPv6ReadyMillisecondsMax,
+            kMetricTimeToIPv6ReadyMillisecondsNumBuckets);
+}
+
+void Metrics::NotifyIPv6DNSReady(Technology::Identifier technology_id,
+                                 int milliseconds) {
+  string histogram = GetFullMetricName(kMetricTimeToIPv6DNSMillisecondsSuffix,
+                                       technology_id);
+  SendToUMA(histogram,
+            milliseconds,
+            kMetricTimeToIPv6ReadyMillisecondsMin,
+            kMetricTimeToIPv6ReadyMillisecondsMax,
+            kMetricTimeToIPv6ReadyMillisecondsNumBuckets);
+}
+
 void Metrics::NotifyDevicePresenceStatus(Technology::Identifier technology_id,
                                          bool status) {
   string histogram = GetFullMetricName(kMetricDevicePresenceStatusSuffix,
@@ -1642,15 +1730,17 @@ void Metrics::UpdateServiceStateTransitionMetrics(
     Service::ConnectState new_state) {
   const char* state_string = Service::ConnectStateToString(new_state);
   SLOG(this, 5) << __func__ << ": new_state=" << state_string;
-  TimerReportersList& start_timers = service_metrics->start_on_state[new_state];
-  for (auto& start_timer : start_timers) {
+  const TimerReportersList& start_timers =
+      service_metrics->start_on_state[new_state];
+  for (auto start_timer : start_timers) {
     SLOG(this, 5) << "Starting timer for " << start_timer->histogram_name()
                   << " due to new state " << state_string << ".";
     start_timer->Start();
   }
 
-  TimerReportersList& stop_timers = service_metrics->stop_on_state[new_state];
-  for (auto& stop_timer : stop_timers) {
+  const TimerReportersList& stop_timers =
+      service_metrics->stop_on_state[new_state];
+  for (auto stop_timer : stop_timers) {
     SLOG(this, 5) << "Stopping timer for " << stop_timer->histogram_name()
                   << " due to new state " << state_string << ".";
     if (stop_timer->Stop())
@@ -1735,6 +1825,24 @@ void Metrics::SendServiceFailure(const Service& service) {
                           kNetworkServiceErrorMax);
 }
 
+void Metrics::ServiceMetrics::Clear() {
+  timers.clear();
+  for (int i = 0; i < kServiceConnectStateCount; ++i) {
+    start_on_state[i].clear();
+    stop_on_state[i].clear();
+  }
+}
+
+Metrics::ServiceMetrics* Metrics::GetServiceMetrics(
+    const Service& service) const {
+  ServiceMetricsLookupMap::const_iterator it = services_metrics_.find(&service);
+  if (it == services_metrics_.end()) {
+    SLOG(this, 1) << "service not found";
+    return nullptr;
+  }
+  return it->second.get();
+}
+
 Metrics::DeviceMetrics* Metrics::GetDeviceMetrics(int interface_index) const {
   DeviceMetricsLookupMap::const_iterator it =
       devices_metrics_.find(interface_index);
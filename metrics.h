@@ -17,12 +17,11 @@
 #ifndef SHILL_METRICS_H_
 #define SHILL_METRICS_H_
 
-#include <list>
-#include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
-#include <base/memory/scoped_vector.h>
 #include <metrics/metrics_library.h>
 #include <metrics/timer.h>
 
@@ -638,6 +637,20 @@ class Metrics {
   static const int kMetricSuspendActionTimeTakenMillisecondsMax;
   static const int kMetricSuspendActionTimeTakenMillisecondsMin;
 
+  // Time taken for powerd to answer suspend delay registrations and suspend
+  // readiness reports.
+  static const char kMetricRegisterSuspendDelayTime[];
+  static const char kMetricRegisterDarkSuspendDelayTime[];
+  static const char kMetricReportSuspendReadinessTime[];
+  static const char kMetricReportDarkSuspendReadinessTime[];
+
+  // Time taken by the firewall to install the rules for a VPN connection.
+  static const char kMetricVpnFirewallSetupTime[];
+
+  // Bounds for the time taken by calls to other system daemons.
+  static const int kMetricDaemonCallTimeMillisecondsMax;
+  static const int kMetricDaemonCallTimeMillisecondsMin;
+
   // Shill dark resume action statistics.
   static const char kMetricDarkResumeActionTimeTaken[];
   static const char kMetricDarkResumeActionResult[];
@@ -773,6 +786,14 @@ class Metrics {
   // IPv6 connectivity status.
   static const char kMetricIPv6ConnectivityStatusSuffix[];
 
+  // Time from enabling IPv6 on a link until a usable global address, and
+  // until DNS servers from a Router Advertisement, are available.
+  static const char kMetricTimeToIPv6AddressMillisecondsSuffix[];
+  static const char kMetricTimeToIPv6DNSMillisecondsSuffix[];
+  static const int kMetricTimeToIPv6ReadyMillisecondsMax;
+  static const int kMetricTimeToIPv6ReadyMillisecondsMin;
+  static const int kMetricTimeToIPv6ReadyMillisecondsNumBuckets;
+
   // Device presence.
   static const char kMetricDevicePresenceStatusSuffix[];
 
@@ -877,6 +898,18 @@ class Metrics {
   // |success| is true, if the suspend actions completed successfully.
   void NotifySuspendActionsCompleted(bool success);
 
+  // Notifies this object that powerd answered a request to register a
+  // (dark, if |is_dark|) suspend delay after |milliseconds|.
+  virtual void NotifySuspendDelayRegistered(bool is_dark, int milliseconds);
+
+  // Notifies this object that powerd answered a (dark, if |is_dark|) suspend
+  // readiness report after |milliseconds|.
+  virtual void NotifySuspendReadinessReported(bool is_dark, int milliseconds);
+
+  // Notifies this object that the firewall answered a request to set up the
+  // rules for a VPN connection after |milliseconds|.
+  virtual void NotifyVpnFirewallSetupCompleted(int milliseconds);
+
   // Notifies this object that dark resume actions started executing.
   void NotifyDarkResumeActionsStarted();
 
@@ -1033,6 +1066,16 @@ class Metrics {
   virtual void NotifyIPv6ConnectivityStatus(
       Technology::Identifier technology_id, bool status);
 
+  // Notifies this object that the first usable global IPv6 address appeared
+  // |milliseconds| after IPv6 was enabled on a link.
+  virtual void NotifyIPv6AddressReady(Technology::Identifier technology_id,
+                                      int milliseconds);
+
+  // Notifies this object that the first IPv6 DNS servers were received
+  // |milliseconds| after IPv6 was enabled on a link.
+  virtual void NotifyIPv6DNSReady(Technology::Identifier technology_id,
+                                  int milliseconds);
+
   // Notifies this object about the presence of given technology type device.
   virtual void NotifyDevicePresenceStatus(Technology::Identifier technology_id,
                                           bool status);
@@ -1099,6 +1142,7 @@ class Metrics {
   FRIEND_TEST(MetricsTest, CellularDropsPerHour);
   FRIEND_TEST(MetricsTest, FrequencyToChannel);
   FRIEND_TEST(MetricsTest, ResetConnectTimer);
+  FRIEND_TEST(MetricsTest, ReuseServiceMetrics);
   FRIEND_TEST(MetricsTest, ServiceFailure);
   FRIEND_TEST(MetricsTest, TimeOnlineTimeToDrop);
   FRIEND_TEST(MetricsTest, TimeToConfig);
@@ -1122,19 +1166,27 @@ class Metrics {
   FRIEND_TEST(MetricsTest, NotifyBeforeSuspendActions_NotInDarkResume);
   FRIEND_TEST(WiFiMainTest, GetGeolocationObjects);
 
-  typedef ScopedVector<chromeos_metrics::TimerReporter> TimerReporters;
-  typedef std::list<chromeos_metrics::TimerReporter*> TimerReportersList;
-  typedef std::map<Service::ConnectState, TimerReportersList>
-      TimerReportersByState;
+  // Number of slots in the per-service state transition tables, one for each
+  // Service::ConnectState.
+  static constexpr int kServiceConnectStateCount = Service::kStateOnline + 1;
+  // Maximum number of released ServiceMetrics kept for reuse.
+  static const size_t kMaxPooledServiceMetrics;
+
+  typedef std::vector<chromeos_metrics::TimerReporter*> TimerReportersList;
   struct ServiceMetrics {
+    // Releases all timers while retaining the capacity of the state tables,
+    // so that the object can be reused for another service.
+    void Clear();
+
     // All TimerReporter objects are stored in |timers| which owns the objects.
-    // |start_on_state| and |stop_on_state| contain pointers to the
-    // TimerReporter objects and control when to start and stop the timers.
-    TimerReporters timers;
-    TimerReportersByState start_on_state;
-    TimerReportersByState stop_on_state;
+    // |start_on_state| and |stop_on_state| are indexed by connect state and
+    // contain pointers to the TimerReporter objects to start and stop when
+    // the service enters that state.
+    std::vector<std::unique_ptr<chromeos_metrics::TimerReporter>> timers;
+    TimerReportersList start_on_state[kServiceConnectStateCount];
+    TimerReportersList stop_on_state[kServiceConnectStateCount];
   };
-  typedef std::map<const Service*, std::shared_ptr<ServiceMetrics>>
+  typedef std::unordered_map<const Service*, std::unique_ptr<ServiceMetrics>>
       ServiceMetricsLookupMap;
 
   struct DeviceMetrics {
@@ -1149,7 +1201,7 @@ class Metrics {
     std::unique_ptr<chromeos_metrics::TimerReporter> auto_connect_timer;
     int auto_connect_tries;
   };
-  typedef std::map<const int, std::shared_ptr<DeviceMetrics>>
+  typedef std::unordered_map<int, std::unique_ptr<DeviceMetrics>>
       DeviceMetricsLookupMap;
 
   static const uint16_t kWiFiBandwidth5MHz;
@@ -1168,6 +1220,7 @@ class Metrics {
   static const uint16_t kWiFiFrequency5825;
 
   void InitializeCommonServiceMetrics(const Service& service);
+  ServiceMetrics* GetServiceMetrics(const Service& service) const;
   void UpdateServiceStateTransitionMetrics(ServiceMetrics* service_metrics,
                                            Service::ConnectState new_state);
   void SendServiceFailure(const Service& service);
@@ -1225,6 +1278,10 @@ class Metrics {
   MetricsLibrary metrics_library_;
   MetricsLibraryInterface* library_;
   ServiceMetricsLookupMap services_metrics_;
+  // ServiceMetrics released by DeregisterService(), reused by
+  // RegisterService() to avoid reallocating the state tables when services
+  // come and go.
+  std::vector<std::unique_ptr<ServiceMetrics>> service_metrics_pool_;
   Technology::Identifier last_default_technology_;
   bool was_online_;
   std::unique_ptr<chromeos_metrics::Timer> time_online_timer_;
@@ -173,6 +173,25 @@ TEST_F(MetricsTest, TimeToOnline) {
   metrics_.NotifyServiceStateChanged(*service_, Service::kStateOnline);
 }
 
+TEST_F(MetricsTest, ReuseServiceMetrics) {
+  size_t pool_size = metrics_.service_metrics_pool_.size();
+  metrics_.DeregisterService(*service_);
+  EXPECT_EQ(pool_size + 1, metrics_.service_metrics_pool_.size());
+  metrics_.RegisterService(*service_);
+  EXPECT_EQ(pool_size, metrics_.service_metrics_pool_.size());
+
+  // The recycled state tables only contain the timers of the new
+  // registration.
+  EXPECT_CALL(library_, SendToUMA("Network.Shill.Unknown.TimeToConfig",
+                                  Ge(0),
+                                  Metrics::kTimerHistogramMillisecondsMin,
+                                  Metrics::kTimerHistogramMillisecondsMax,
+                                  Metrics::kTimerHistogramNumBuckets))
+      .Times(1);
+  metrics_.NotifyServiceStateChanged(*service_, Service::kStateConfiguring);
+  metrics_.NotifyServiceStateChanged(*service_, Service::kStateConnected);
+}
+
 TEST_F(MetricsTest, ServiceFailure) {
   EXPECT_CALL(*service_, failure())
       .WillRepeatedly(Return(Service::kFailureBadPassphrase));
@@ -1001,6 +1020,26 @@ TEST_F(MetricsTest, NotifyDarkResumeActionsCompleted_Failure) {
   EXPECT_FALSE(metrics_.wake_reason_received_);
 }
 
+TEST_F(MetricsTest, NotifySuspendReadinessReported) {
+  const int kMilliseconds = 30;
+  EXPECT_CALL(library_,
+              SendToUMA(Metrics::kMetricReportSuspendReadinessTime,
+                        kMilliseconds,
+                        Metrics::kMetricDaemonCallTimeMillisecondsMin,
+                        Metrics::kMetricDaemonCallTimeMillisecondsMax,
+                        Metrics::kTimerHistogramNumBuckets));
+  metrics_.NotifySuspendReadinessReported(false, kMilliseconds);
+  Mock::VerifyAndClearExpectations(&library_);
+
+  EXPECT_CALL(library_,
+              SendToUMA(Metrics::kMetricReportDarkSuspendReadinessTime,
+                        kMilliseconds,
+                        Metrics::kMetricDaemonCallTimeMillisecondsMin,
+                        Metrics::kMetricDaemonCallTimeMillisecondsMax,
+                        Metrics::kTimerHistogramNumBuckets));
+  metrics_.NotifySuspendReadinessReported(true, kMilliseconds);
+}
+
 TEST_F(MetricsTest, NotifySuspendActionsStarted) {
   metrics_.time_suspend_actions_timer->Stop();
   metrics_.wake_on_wifi_throttled_ = true;
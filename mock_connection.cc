@@ -22,7 +22,7 @@ namespace shill {
 
 MockConnection::MockConnection(const DeviceInfo* device_info)
     : Connection(0, std::string(), Technology::kUnknown, device_info,
-                 nullptr) {}
+                 nullptr, nullptr) {}
 
 MockConnection::~MockConnection() {}
 
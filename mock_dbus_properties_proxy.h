@@ -34,6 +34,11 @@ class MockDBusPropertiesProxy : public DBusPropertiesProxyInterface {
   MOCK_METHOD1(GetAll, KeyValueStore(const std::string& interface_name));
   MOCK_METHOD2(Get, brillo::Any(const std::string& interface_name,
                                 const std::string& property));
+  MOCK_METHOD2(GetAllAsync, void(const std::string& interface_name,
+                                 const KeyValueStoreCallback& callback));
+  MOCK_METHOD3(GetAsync, void(const std::string& interface_name,
+                              const std::string& property,
+                              const GetCallback& callback));
   MOCK_METHOD1(set_properties_changed_callback,
                void(const PropertiesChangedCallback& callback));
   MOCK_METHOD1(set_modem_manager_properties_changed_callback,
@@ -38,6 +38,11 @@ class MockEventDispatcher : public EventDispatcher {
       int fd,
       const IOHandler::InputCallback& input_callback,
       const IOHandler::ErrorCallback& error_callback));
+  MOCK_METHOD4(CreateDrainingInputHandler, IOHandler*(
+      int fd,
+      const IOHandler::ReadBudget& budget,
+      const IOHandler::InputCallback& input_callback,
+      const IOHandler::ErrorCallback& error_callback));
 
   MOCK_METHOD3(CreateReadyHandler,
                IOHandler*(int fd,
@@ -31,6 +31,10 @@ class MockFirewallProxy : public FirewallProxyInterface {
 
   MOCK_METHOD2(RequestVpnSetup, bool(const std::vector<std::string>& user_names,
                                      const std::string& interface));
+  MOCK_METHOD3(RequestVpnSetupAsync,
+               void(const std::vector<std::string>& user_names,
+                    const std::string& interface,
+                    const ResultCallback& callback));
   MOCK_METHOD0(RemoveVpnSetup, bool());
 
  private:
@@ -33,6 +33,7 @@ class MockLinkMonitor : public LinkMonitor {
   MOCK_METHOD0(OnAfterResume, void());
   MOCK_CONST_METHOD0(GetResponseTimeMilliseconds, int());
   MOCK_CONST_METHOD0(IsGatewayFound, bool());
+  MOCK_METHOD1(VerifyGateway, bool(const GatewayVerifyCallback& callback));
 
  private:
   DISALLOW_COPY_AND_ASSIGN(MockLinkMonitor);
@@ -77,6 +77,13 @@ class MockManager : public Manager {
   MOCK_CONST_METHOD0(IsConnected, bool());
   MOCK_METHOD0(UpdateEnabledTechnologies, void());
   MOCK_METHOD1(IsPortalDetectionEnabled, bool(Technology::Identifier tech));
+  MOCK_METHOD1(ConsumeWarmStartOnlineHint, bool(const ServiceRefPtr& service));
+  MOCK_CONST_METHOD1(GetOrderedServices,
+                     std::vector<ServiceRefPtr>(bool include_hidden));
+  MOCK_METHOD3(ConfigureServices,
+               void(const std::vector<KeyValueStore>& args,
+                    std::vector<ServiceRefPtr>* services,
+                    std::vector<std::unique_ptr<Error>>* errors));
   MOCK_CONST_METHOD1(IsServiceEphemeral,
                      bool(const ServiceConstRefPtr& service));
   MOCK_CONST_METHOD2(IsProfileBefore,
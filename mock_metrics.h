@@ -81,6 +81,15 @@ class MockMetrics : public Metrics {
                     Metrics::NetworkConnectionIPType type));
   MOCK_METHOD2(NotifyIPv6ConnectivityStatus,
                void(Technology::Identifier technology_id, bool status));
+  MOCK_METHOD2(NotifySuspendDelayRegistered,
+               void(bool is_dark, int milliseconds));
+  MOCK_METHOD2(NotifySuspendReadinessReported,
+               void(bool is_dark, int milliseconds));
+  MOCK_METHOD1(NotifyVpnFirewallSetupCompleted, void(int milliseconds));
+  MOCK_METHOD2(NotifyIPv6AddressReady,
+               void(Technology::Identifier technology_id, int milliseconds));
+  MOCK_METHOD2(NotifyIPv6DNSReady,
+               void(Technology::Identifier technology_id, int milliseconds));
   MOCK_METHOD2(NotifyDevicePresenceStatus,
                void(Technology::Identifier technology_id, bool status));
   MOCK_METHOD2(NotifyUnreliableLinkSignalStrength,
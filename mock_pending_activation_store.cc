@@ -18,7 +18,8 @@
 
 namespace shill {
 
-MockPendingActivationStore::MockPendingActivationStore() {}
+MockPendingActivationStore::MockPendingActivationStore()
+    : PendingActivationStore(nullptr) {}
 MockPendingActivationStore::~MockPendingActivationStore() {}
 
 }  // namespace shill
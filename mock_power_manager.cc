@@ -19,8 +19,9 @@
 namespace shill {
 
 MockPowerManager::MockPowerManager(EventDispatcher* dispatcher,
-                                   ControlInterface* control_interface)
-    : PowerManager(dispatcher, control_interface) {}
+                                   ControlInterface* control_interface,
+                                   Metrics* metrics)
+    : PowerManager(dispatcher, control_interface, metrics) {}
 
 MockPowerManager::~MockPowerManager() {}
 
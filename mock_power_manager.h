@@ -27,11 +27,13 @@
 namespace shill {
 
 class ControlInterface;
+class Metrics;
 
 class MockPowerManager : public PowerManager {
  public:
   MockPowerManager(EventDispatcher* dispatcher,
-                   ControlInterface* control_interface);
+                   ControlInterface* control_interface,
+                   Metrics* metrics);
   ~MockPowerManager() override;
 
   MOCK_METHOD0(ReportSuspendReadiness, bool());
@@ -45,6 +45,22 @@ class MockPowerManagerProxy : public PowerManagerProxyInterface {
   MOCK_METHOD2(ReportDarkSuspendReadiness, bool(int delay_id, int suspend_id));
   MOCK_METHOD1(RecordDarkResumeWakeReason,
                bool(const std::string& wake_reason));
+  MOCK_METHOD3(RegisterSuspendDelayAsync,
+               void(base::TimeDelta timeout,
+                    const std::string& description,
+                    const RegisterSuspendDelayCallback& callback));
+  MOCK_METHOD3(ReportSuspendReadinessAsync,
+               void(int delay_id,
+                    int suspend_id,
+                    const ResultCallback& callback));
+  MOCK_METHOD3(RegisterDarkSuspendDelayAsync,
+               void(base::TimeDelta timeout,
+                    const std::string& description,
+                    const RegisterSuspendDelayCallback& callback));
+  MOCK_METHOD3(ReportDarkSuspendReadinessAsync,
+               void(int delay_id,
+                    int suspend_id,
+                    const ResultCallback& callback));
 
  private:
   DISALLOW_COPY_AND_ASSIGN(MockPowerManagerProxy);
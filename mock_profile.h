@@ -46,6 +46,8 @@ class MockProfile : public Profile {
   MOCK_METHOD1(UpdateDevice, bool(const DeviceRefPtr& device));
   MOCK_METHOD1(UpdateWiFiProvider, bool(const WiFiProvider& wifi_provider));
   MOCK_METHOD0(Save, bool());
+  MOCK_METHOD0(BeginBatchUpdate, void());
+  MOCK_METHOD0(EndBatchUpdate, bool());
   MOCK_METHOD0(GetStorage, StoreInterface*());
   MOCK_CONST_METHOD0(GetConstStorage, const StoreInterface*());
   MOCK_CONST_METHOD0(IsDefault, bool());
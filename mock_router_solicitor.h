@@ -0,0 +1,41 @@
+//
+// Copyright (C) 2015 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SHILL_MOCK_ROUTER_SOLICITOR_H_
+#define SHILL_MOCK_ROUTER_SOLICITOR_H_
+
+#include "shill/router_solicitor.h"
+
+#include <gmock/gmock.h>
+
+namespace shill {
+
+class MockRouterSolicitor : public RouterSolicitor {
+ public:
+  MockRouterSolicitor();
+  ~MockRouterSolicitor() override;
+
+  MOCK_METHOD0(Start, void());
+  MOCK_METHOD0(Stop, void());
+  MOCK_CONST_METHOD0(IsStarted, bool());
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(MockRouterSolicitor);
+};
+
+}  // namespace shill
+
+#endif  // SHILL_MOCK_ROUTER_SOLICITOR_H_
@@ -17,6 +17,8 @@
 #ifndef SHILL_MOCK_ROUTING_TABLE_H_
 #define SHILL_MOCK_ROUTING_TABLE_H_
 
+#include <string>
+
 #include <base/macros.h>
 #include <gmock/gmock.h>
 
@@ -56,7 +58,10 @@ class MockRoutingTable : public RoutingTable {
   MOCK_METHOD1(FlushRoutesWithTag, void(int tag));
   MOCK_METHOD0(FlushCache, bool());
   MOCK_METHOD1(ResetTable, void(int interface_index));
-  MOCK_METHOD2(SetDefaultMetric, void(int interface_index, uint32_t metric));
+  MOCK_METHOD1(AllocInterfaceTable,
+               uint8_t(const std::string& interface_name));
+  MOCK_METHOD1(FreeInterfaceTable, void(uint8_t table_id));
+  MOCK_METHOD1(SetDefaultTable, bool(uint8_t table_id));
   MOCK_METHOD5(RequestRouteToHost, bool(const IPAddress& addresss,
                                         int interface_index,
                                         int tag,
@@ -75,6 +75,9 @@ bool AttributeList::InitAttributeFromValue(int id, const ByteString& value) {
 }
 
 void AttributeList::Print(int log_level, int indent) const {
+  if (!VLOG_IS_ON(log_level)) {
+    return;
+  }
   map<int, AttributePointer>::const_iterator i;
 
   for (i = attributes_.begin(); i != attributes_.end(); ++i) {
@@ -67,7 +67,8 @@ class SHILL_EXPORT AttributeList : public base::RefCounted<AttributeList> {
 
   // Prints the attribute list with each attribute using no less than 1 line.
   // |indent| indicates the amout of leading spaces to be printed (useful for
-  // nested attributes).
+  // nested attributes).  Does no formatting work unless |log_level| is
+  // enabled.
   void Print(int log_level, int indent) const;
 
   // Visit each attribute in |payload| starting at |offset|.  Call |method|
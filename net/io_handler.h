@@ -47,6 +47,26 @@ class SHILL_EXPORT IOHandler {
   // Data buffer size in bytes.
   static const int kDataBufferSize = 4096;
 
+  // Limits how much an input handler reads per readiness notification.  By
+  // default the handler does a single read into a kDataBufferSize buffer.
+  // Handlers for high-rate descriptors can instead drain the descriptor
+  // until it would block, stopping after |max_reads| reads or |max_bytes|
+  // bytes so that other descriptors still get serviced.  |buffer_size|
+  // should be large enough for the largest unit the consumer reads (e.g.
+  // one packet from a tun device).
+  struct ReadBudget {
+    ReadBudget()
+        : buffer_size(kDataBufferSize), max_reads(1),
+          max_bytes(kDataBufferSize) {}
+    ReadBudget(size_t in_buffer_size, int in_max_reads, size_t in_max_bytes)
+        : buffer_size(in_buffer_size), max_reads(in_max_reads),
+          max_bytes(in_max_bytes) {}
+
+    size_t buffer_size;
+    int max_reads;
+    size_t max_bytes;
+  };
+
   IOHandler() {}
   virtual ~IOHandler() {}
 
@@ -33,6 +33,17 @@ IOHandler* IOHandlerFactory::CreateIOInputHandler(
   return handler;
 }
 
+IOHandler* IOHandlerFactory::CreateDrainingIOInputHandler(
+    int fd,
+    const IOHandler::ReadBudget& budget,
+    const IOHandler::InputCallback& input_callback,
+    const IOHandler::ErrorCallback& error_callback) {
+  IOHandler* handler =
+      new IOInputHandler(fd, budget, input_callback, error_callback);
+  handler->Start();
+  return handler;
+}
+
 IOHandler* IOHandlerFactory::CreateIOReadyHandler(
     int fd,
     IOHandler::ReadyMode mode,
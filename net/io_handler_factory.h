@@ -32,6 +32,12 @@ class SHILL_EXPORT IOHandlerFactory {
       const IOHandler::InputCallback& input_callback,
       const IOHandler::ErrorCallback& error_callback);
 
+  virtual IOHandler* CreateDrainingIOInputHandler(
+      int fd,
+      const IOHandler::ReadBudget& budget,
+      const IOHandler::InputCallback& input_callback,
+      const IOHandler::ErrorCallback& error_callback);
+
   virtual IOHandler* CreateIOReadyHandler(
       int fd,
       IOHandler::ReadyMode mode,
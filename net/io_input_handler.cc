@@ -16,10 +16,14 @@
 
 #include "shill/net/io_input_handler.h"
 
-#include <string>
+#include <errno.h>
+#include <fcntl.h>
 #include <unistd.h>
 
+#include <string>
+
 #include <base/logging.h>
+#include <base/posix/eintr_wrapper.h>
 #include <base/strings/stringprintf.h>
 
 namespace shill {
@@ -27,40 +31,83 @@ namespace shill {
 IOInputHandler::IOInputHandler(int fd,
                                const InputCallback& input_callback,
                                const ErrorCallback& error_callback)
+    : IOInputHandler(fd, ReadBudget(), input_callback, error_callback) {}
+
+IOInputHandler::IOInputHandler(int fd,
+                               const ReadBudget& budget,
+                               const InputCallback& input_callback,
+                               const ErrorCallback& error_callback)
     : fd_(fd),
       input_callback_(input_callback),
-      error_callback_(error_callback) {}
+      error_callback_(error_callback),
+      budget_(budget),
+      buffer_(budget.buffer_size),
+      watching_(false),
+      weak_ptr_factory_(this) {
+  CHECK_GT(budget_.buffer_size, 0u);
+  CHECK_GT(budget_.max_reads, 0);
+}
 
 IOInputHandler::~IOInputHandler() {
   Stop();
 }
 
 void IOInputHandler::Start() {
+  if (IsDraining()) {
+    // Draining reads until the descriptor would block, so it must not.
+    int flags = fcntl(fd_, F_GETFL);
+    if (flags < 0 || fcntl(fd_, F_SETFL, flags | O_NONBLOCK) < 0) {
+      PLOG(ERROR) << "Failed to make fd non-blocking; reading once per event";
+      budget_.max_reads = 1;
+    }
+  }
   if (!base::MessageLoopForIO::current()->WatchFileDescriptor(
           fd_, true, base::MessageLoopForIO::WATCH_READ,
           &fd_watcher_, this)) {
     LOG(ERROR) << "WatchFileDescriptor failed on read";
+    return;
   }
+  watching_ = true;
 }
 
 void IOInputHandler::Stop() {
   fd_watcher_.StopWatchingFileDescriptor();
+  watching_ = false;
 }
 
 void IOInputHandler::OnFileCanReadWithoutBlocking(int fd) {
   CHECK_EQ(fd_, fd);
 
-  unsigned char buf[IOHandler::kDataBufferSize];
-  int len = read(fd, buf, sizeof(buf));
-  if (len < 0) {
-    std::string condition = base::StringPrintf(
-        "File read error: %d", errno);
-    LOG(ERROR) << condition;
-    error_callback_.Run(condition);
-  }
+  // |input_callback_| may stop or destroy this handler.
+  base::WeakPtr<IOInputHandler> weak_this = weak_ptr_factory_.GetWeakPtr();
+  size_t bytes_read = 0;
+  for (int reads = 0; reads < budget_.max_reads; ++reads) {
+    int len = HANDLE_EINTR(read(fd, buffer_.data(), buffer_.size()));
+    if (len < 0) {
+      if (IsDraining() && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return;
+      }
+      std::string condition = base::StringPrintf(
+          "File read error: %d", errno);
+      LOG(ERROR) << condition;
+      error_callback_.Run(condition);
+      return;
+    }
+
+    InputData input_data(buffer_.data(), len);
+    input_callback_.Run(&input_data);
+    if (!weak_this || !watching_) {
+      return;
+    }
 
-  InputData input_data(buf, len);
-  input_callback_.Run(&input_data);
+    // A zero-length read means end of file.  Otherwise keep reading until
+    // the descriptor would block or the budget is spent; don't treat a short
+    // read as drained since tun devices return one packet per read.
+    bytes_read += len;
+    if (len == 0 || bytes_read >= budget_.max_bytes) {
+      return;
+    }
+  }
 }
 
 void IOInputHandler::OnFileCanWriteWithoutBlocking(int fd) {
@@ -17,6 +17,9 @@
 #ifndef SHILL_NET_IO_INPUT_HANDLER_H_
 #define SHILL_NET_IO_INPUT_HANDLER_H_
 
+#include <vector>
+
+#include <base/memory/weak_ptr.h>
 #include <base/message_loop/message_loop.h>
 
 #include "shill/net/io_handler.h"
@@ -30,20 +33,36 @@ class IOInputHandler : public IOHandler,
   IOInputHandler(int fd,
                  const InputCallback& input_callback,
                  const ErrorCallback& error_callback);
+  // Creates a handler that reads according to |budget|.  If |budget| allows
+  // more than one read per notification, |fd| is put in non-blocking mode
+  // when the handler is started.
+  IOInputHandler(int fd,
+                 const ReadBudget& budget,
+                 const InputCallback& input_callback,
+                 const ErrorCallback& error_callback);
   ~IOInputHandler();
 
   void Start() override;
   void Stop() override;
 
  private:
+  friend class IOInputHandlerTest;
+
   // base::MessageLoopForIO::Watcher methods.
   void OnFileCanReadWithoutBlocking(int fd) override;
   void OnFileCanWriteWithoutBlocking(int fd) override;
 
+  bool IsDraining() const { return budget_.max_reads > 1; }
+
   int fd_;
   base::MessageLoopForIO::FileDescriptorWatcher fd_watcher_;
   InputCallback input_callback_;
   ErrorCallback error_callback_;
+  ReadBudget budget_;
+  // Reused across notifications so draining does not allocate per read.
+  std::vector<unsigned char> buffer_;
+  bool watching_;
+  base::WeakPtrFactory<IOInputHandler> weak_ptr_factory_;
 };
 
 }  // namespace shill
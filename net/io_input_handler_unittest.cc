@@ -0,0 +1,138 @@
+//
+// Copyright (C) 2015 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "shill/net/io_input_handler.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+
+#include <base/bind.h>
+#include <base/message_loop/message_loop.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using base::Bind;
+using base::Unretained;
+using std::string;
+using testing::_;
+using testing::Invoke;
+using testing::Test;
+
+namespace shill {
+
+class IOInputHandlerTest : public Test {
+ public:
+  IOInputHandlerTest() {}
+  ~IOInputHandlerTest() override {}
+
+  void SetUp() override {
+    ASSERT_EQ(0, pipe(pipe_fds_));
+  }
+
+  void TearDown() override {
+    handler_.reset();
+    close(pipe_fds_[0]);
+    close(pipe_fds_[1]);
+  }
+
+  MOCK_METHOD1(OnInput, void(size_t len));
+  MOCK_METHOD1(OnError, void(const string& condition));
+
+ protected:
+  void CreateHandler(const IOHandler::ReadBudget& budget) {
+    handler_.reset(new IOInputHandler(
+        pipe_fds_[0], budget,
+        Bind(&IOInputHandlerTest::HandleInput, Unretained(this)),
+        Bind(&IOInputHandlerTest::OnError, Unretained(this))));
+    handler_->Start();
+  }
+
+  void WriteBytes(size_t len) {
+    string data(len, 'x');
+    ASSERT_EQ(static_cast<ssize_t>(len),
+              write(pipe_fds_[1], data.data(), data.size()));
+  }
+
+  void TriggerRead() {
+    handler_->OnFileCanReadWithoutBlocking(pipe_fds_[0]);
+  }
+
+  bool IsNonBlocking() {
+    return fcntl(pipe_fds_[0], F_GETFL) & O_NONBLOCK;
+  }
+
+  base::MessageLoopForIO message_loop_;
+  int pipe_fds_[2];
+  std::unique_ptr<IOInputHandler> handler_;
+
+ private:
+  void HandleInput(InputData* data) {
+    OnInput(data->len);
+  }
+};
+
+TEST_F(IOInputHandlerTest, SingleReadByDefault) {
+  CreateHandler(IOHandler::ReadBudget());
+  EXPECT_FALSE(IsNonBlocking());
+  WriteBytes(IOHandler::kDataBufferSize + 10);
+  EXPECT_CALL(*this, OnInput(IOHandler::kDataBufferSize));
+  TriggerRead();
+}
+
+TEST_F(IOInputHandlerTest, DrainUntilWouldBlock) {
+  CreateHandler(IOHandler::ReadBudget(16, 10, 1024));
+  EXPECT_TRUE(IsNonBlocking());
+  WriteBytes(40);
+  EXPECT_CALL(*this, OnInput(16)).Times(2);
+  EXPECT_CALL(*this, OnInput(8));
+  EXPECT_CALL(*this, OnError(_)).Times(0);
+  TriggerRead();
+}
+
+TEST_F(IOInputHandlerTest, DrainStopsAtReadBudget) {
+  CreateHandler(IOHandler::ReadBudget(16, 2, 1024));
+  WriteBytes(64);
+  EXPECT_CALL(*this, OnInput(16)).Times(2);
+  TriggerRead();
+}
+
+TEST_F(IOInputHandlerTest, DrainStopsAtByteBudget) {
+  CreateHandler(IOHandler::ReadBudget(16, 10, 20));
+  WriteBytes(64);
+  EXPECT_CALL(*this, OnInput(16)).Times(2);
+  TriggerRead();
+}
+
+TEST_F(IOInputHandlerTest, DrainStopsWhenHandlerStopped) {
+  CreateHandler(IOHandler::ReadBudget(16, 10, 1024));
+  WriteBytes(64);
+  EXPECT_CALL(*this, OnInput(16))
+      .WillOnce(Invoke([this](size_t) { handler_->Stop(); }));
+  TriggerRead();
+}
+
+TEST_F(IOInputHandlerTest, DrainStopsWhenHandlerDestroyed) {
+  CreateHandler(IOHandler::ReadBudget(16, 10, 1024));
+  WriteBytes(64);
+  EXPECT_CALL(*this, OnInput(16))
+      .WillOnce(Invoke([this](size_t) { handler_.reset(); }));
+  TriggerRead();
+}
+
+}  // namespace shill
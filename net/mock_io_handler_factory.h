@@ -34,6 +34,13 @@ class MockIOHandlerFactory : public IOHandlerFactory {
                    const IOHandler::InputCallback& input_callback,
                    const IOHandler::ErrorCallback& error_callback));
 
+  MOCK_METHOD4(CreateDrainingIOInputHandler,
+               IOHandler* (
+                   int fd,
+                   const IOHandler::ReadBudget& budget,
+                   const IOHandler::InputCallback& input_callback,
+                   const IOHandler::ErrorCallback& error_callback));
+
   MOCK_METHOD3(CreateIOReadyHandler,
                IOHandler* (
                    int fd,
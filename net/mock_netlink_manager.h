@@ -55,6 +55,8 @@ class MockNetlinkManager : public NetlinkManager {
                     const NetlinkAuxilliaryMessageHandler& error_handler));
   MOCK_METHOD2(SubscribeToEvents,
                bool(const std::string& family, const std::string& group));
+  MOCK_METHOD1(SetPacketCaptureSize, void(size_t max_packets));
+  MOCK_CONST_METHOD1(DumpCapturedPackets, bool(const base::FilePath& path));
 
  private:
   DISALLOW_COPY_AND_ASSIGN(MockNetlinkManager);
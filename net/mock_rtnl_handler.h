@@ -17,6 +17,7 @@
 #ifndef SHILL_NET_MOCK_RTNL_HANDLER_H_
 #define SHILL_NET_MOCK_RTNL_HANDLER_H_
 
+#include <set>
 #include <string>
 
 #include <base/macros.h>
@@ -50,6 +51,10 @@ class MockRTNLHandler : public RTNLHandler {
   MOCK_METHOD2(SendMessageWithErrorMask, bool(RTNLMessage* message,
                                               const ErrorMask& error_mask));
   MOCK_METHOD1(SendMessage, bool(RTNLMessage* message));
+  MOCK_METHOD1(SendMessageSync, int(RTNLMessage* message));
+  MOCK_METHOD2(SetIgnoredInterfaces,
+               void(const std::set<int>& ignored_indices,
+                    const std::set<int>& link_only_indices));
 
  private:
   DISALLOW_COPY_AND_ASSIGN(MockRTNLHandler);
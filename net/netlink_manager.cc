@@ -24,6 +24,7 @@
 #include <map>
 #include <queue>
 
+#include <base/files/file_util.h>
 #include <base/location.h>
 #include <base/logging.h>
 #include <base/memory/weak_ptr.h>
@@ -45,6 +46,7 @@ using base::MessageLoop;
 using std::list;
 using std::map;
 using std::string;
+using std::vector;
 
 namespace shill {
 
@@ -189,7 +191,9 @@ NetlinkManager::NetlinkManager()
       time_(Time::GetInstance()),
       io_handler_factory_(
           IOHandlerFactoryContainer::GetInstance()->GetIOHandlerFactory()),
-          dump_pending_(false) {}
+          dump_pending_(false),
+          packet_capture_size_(0),
+          next_capture_index_(0) {}
 
 NetlinkManager::~NetlinkManager() {}
 
@@ -497,9 +501,14 @@ bool NetlinkManager::SendOrPostMessage(
   // NetlinkSocket::SendMessage in NetlinkManager::SendMessageInternal.
   VLOG(5) << "NL Message " << pending_message.sequence_number << " to send ("
           << pending_message.message_string.GetLength() << " bytes) ===>";
-  message->Print(6, 7);
-  NetlinkMessage::PrintBytes(8, pending_message.message_string.GetConstData(),
-                             pending_message.message_string.GetLength());
+  if (VLOG_IS_ON(6)) {
+    message->Print(6, 7);
+  }
+  if (VLOG_IS_ON(8)) {
+    NetlinkMessage::PrintBytes(8,
+                               pending_message.message_string.GetConstData(),
+                               pending_message.message_string.GetLength());
+  }
 
   if (is_dump_msg) {
     pending_messages_.push(pending_message);
@@ -560,6 +569,8 @@ bool NetlinkManager::SendMessageInternal(
     LOG(ERROR) << "Failed to send Netlink message.";
     return false;
   }
+  CapturePacket(pending_message.message_string.GetConstData(),
+                pending_message.message_string.GetLength());
   if (pending_message.is_dump_request) {
     VLOG(5) << "Waiting for replies to NL dump message "
             << pending_message.sequence_number;
@@ -638,6 +649,55 @@ uint32_t NetlinkManager::GetSequenceNumber() {
       sock_->GetSequenceNumber() : NetlinkMessage::kBroadcastSequenceNumber;
 }
 
+void NetlinkManager::SetPacketCaptureSize(size_t max_packets) {
+  packet_capture_size_ = max_packets;
+  captured_packets_.clear();
+  captured_packets_.reserve(max_packets);
+  next_capture_index_ = 0;
+}
+
+vector<ByteString> NetlinkManager::GetCapturedPackets() const {
+  vector<ByteString> packets;
+  packets.reserve(captured_packets_.size());
+  for (size_t i = 0; i < captured_packets_.size(); ++i) {
+    packets.push_back(captured_packets_[
+        (next_capture_index_ + i) % captured_packets_.size()]);
+  }
+  return packets;
+}
+
+bool NetlinkManager::DumpCapturedPackets(const base::FilePath& path) const {
+  string contents;
+  const vector<ByteString> packets = GetCapturedPackets();
+  for (const auto& packet : packets) {
+    contents += packet.HexEncode() + "\n";
+  }
+  if (base::WriteFile(path, contents.data(), contents.size()) !=
+      static_cast<int>(contents.size())) {
+    LOG(ERROR) << "Failed to write captured netlink packets to "
+               << path.value();
+    return false;
+  }
+  LOG(INFO) << "Wrote " << packets.size() << " captured netlink packets to "
+            << path.value();
+  return true;
+}
+
+void NetlinkManager::CapturePacket(const unsigned char* buf,
+                                   size_t num_bytes) {
+  if (packet_capture_size_ == 0) {
+    return;
+  }
+  ByteString packet(buf, num_bytes);
+  // While the ring is filling up, the oldest packet stays at index 0.
+  if (captured_packets_.size() < packet_capture_size_) {
+    captured_packets_.push_back(packet);
+    return;
+  }
+  captured_packets_[next_capture_index_] = packet;
+  next_capture_index_ = (next_capture_index_ + 1) % packet_capture_size_;
+}
+
 bool NetlinkManager::SubscribeToEvents(const string& family_id,
                                        const string& group_name) {
   if (!ContainsKey(message_types_, family_id)) {
@@ -670,6 +730,7 @@ void NetlinkManager::OnRawNlMessageReceived(InputData* data) {
     if (!packet.IsValid()) {
       break;
     }
+    CapturePacket(buf, packet.GetLength());
     buf += packet.GetLength();
     OnNlMessageReceived(&packet);
   }
@@ -691,8 +752,12 @@ void NetlinkManager::OnNlMessageReceived(NetlinkPacket* packet) {
   }
   VLOG(5) << "NL Message " << sequence_number << " Received ("
           << packet->GetLength() << " bytes) <===";
-  message->Print(6, 7);
-  NetlinkMessage::PrintPacket(8, *packet);
+  if (VLOG_IS_ON(6)) {
+    message->Print(6, 7);
+  }
+  if (VLOG_IS_ON(8)) {
+    NetlinkMessage::PrintPacket(8, *packet);
+  }
 
   bool is_error_ack_message = false;
   uint32_t error_code = 0;
@@ -73,9 +73,11 @@
 #include <queue>
 #include <set>
 #include <string>
+#include <vector>
 
 #include <base/bind.h>
 #include <base/cancelable_callback.h>
+#include <base/files/file_path.h>
 #include <base/lazy_instance.h>
 #include <base/macros.h>
 #include <gtest/gtest_prod.h>  // for FRIEND_TEST
@@ -269,6 +271,19 @@ class SHILL_EXPORT NetlinkManager {
   // NetlinkManager's netlink socket.
   uint32_t GetSequenceNumber();
 
+  // Keeps a copy of the raw bytes of the last |max_packets| netlink packets
+  // sent or received, so that they can be decoded after the fact without
+  // formatting every message as it goes by.  Setting a size discards any
+  // packets already captured; a size of 0 (the default) turns capture off.
+  virtual void SetPacketCaptureSize(size_t max_packets);
+
+  // Returns the captured packets, oldest first.
+  std::vector<ByteString> GetCapturedPackets() const;
+
+  // Writes the captured packets to |path|, oldest first, one hex-encoded
+  // packet per line.  Returns true on success.
+  virtual bool DumpCapturedPackets(const base::FilePath& path) const;
+
  protected:
   friend struct base::DefaultLazyInstanceTraits<NetlinkManager>;
 
@@ -370,6 +385,10 @@ class SHILL_EXPORT NetlinkManager {
   // from now.
   void ResendPendingDumpMessageAfterDelay();
 
+  // Adds a copy of |num_bytes| at |buf| to the capture ring, overwriting the
+  // oldest entry once the ring is full.  Does nothing if capture is off.
+  void CapturePacket(const unsigned char* buf, size_t num_bytes);
+
   // Just for tests, this method turns off WiFi and clears the subscribed
   // events list. If |full| is true, also clears state set by Init.
   void Reset(bool full);
@@ -446,6 +465,11 @@ class SHILL_EXPORT NetlinkManager {
   IOHandlerFactory* io_handler_factory_;
   bool dump_pending_;
 
+  // Fixed-size ring of raw packets; see SetPacketCaptureSize().
+  size_t packet_capture_size_;
+  std::vector<ByteString> captured_packets_;
+  size_t next_capture_index_;
+
   DISALLOW_COPY_AND_ASSIGN(NetlinkManager);
 };
 
@@ -28,6 +28,8 @@
 #include <string>
 #include <vector>
 
+#include <base/files/file_util.h>
+#include <base/files/scoped_temp_dir.h>
 #include <base/strings/stringprintf.h>
 #include <base/message_loop/message_loop.h>
 #include <gmock/gmock.h>
@@ -1121,4 +1123,51 @@ TEST_F(NetlinkManagerTest, OnInvalidRawNlMessageReceived) {
   netlink_manager_->OnRawNlMessageReceived(nullptr);
 }
 
+TEST_F(NetlinkManagerTest, PacketCapture) {
+  vector<unsigned char> message{
+    0x14, 0x00, 0x00, 0x00,  // length
+    0x00, 0x00,  // type
+    0x00, 0x00,  // flags
+    0x00, 0x00, 0x00, 0x00,  // sequence number
+    0x00, 0x00, 0x00, 0x00,  // sender port
+    0x00, 0x00, 0x00, 0x00,  // body
+  };
+  const size_t kSequenceOffset = 8;
+
+  // Capture is off by default.
+  InputData uncaptured_data(message.data(), message.size());
+  netlink_manager_->OnRawNlMessageReceived(&uncaptured_data);
+  EXPECT_TRUE(netlink_manager_->GetCapturedPackets().empty());
+
+  // Once the ring is full, the oldest packets are overwritten.
+  const size_t kCaptureSize = 2;
+  netlink_manager_->SetPacketCaptureSize(kCaptureSize);
+  for (unsigned char sequence = 1; sequence <= 3; ++sequence) {
+    message[kSequenceOffset] = sequence;
+    InputData data(message.data(), message.size());
+    netlink_manager_->OnRawNlMessageReceived(&data);
+  }
+  vector<ByteString> packets = netlink_manager_->GetCapturedPackets();
+  ASSERT_EQ(kCaptureSize, packets.size());
+  for (const auto& packet : packets) {
+    EXPECT_EQ(message.size(), packet.GetLength());
+  }
+  EXPECT_EQ(2, packets[0].GetConstData()[kSequenceOffset]);
+  EXPECT_EQ(3, packets[1].GetConstData()[kSequenceOffset]);
+
+  // The captured packets are written out oldest first.
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath dump_path = temp_dir.path().Append("netlink_capture");
+  EXPECT_TRUE(netlink_manager_->DumpCapturedPackets(dump_path));
+  string dump;
+  ASSERT_TRUE(base::ReadFileToString(dump_path, &dump));
+  EXPECT_EQ(packets[0].HexEncode() + "\n" + packets[1].HexEncode() + "\n",
+            dump);
+
+  // Turning capture off discards what was captured.
+  netlink_manager_->SetPacketCaptureSize(0);
+  EXPECT_TRUE(netlink_manager_->GetCapturedPackets().empty());
+}
+
 }  // namespace shill
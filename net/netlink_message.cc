@@ -95,6 +95,9 @@ bool NetlinkMessage::InitFromPacket(NetlinkPacket* packet,
 // static
 void NetlinkMessage::PrintBytes(int log_level, const unsigned char* buf,
                                 size_t num_bytes) {
+  if (!VLOG_IS_ON(log_level)) {
+    return;
+  }
   VLOG(log_level) << "Netlink Message -- Examining Bytes";
   if (!buf) {
     VLOG(log_level) << "<NULL Buffer>";
@@ -116,6 +119,9 @@ void NetlinkMessage::PrintBytes(int log_level, const unsigned char* buf,
 
 // static
 void NetlinkMessage::PrintPacket(int log_level, const NetlinkPacket& packet) {
+  if (!VLOG_IS_ON(log_level)) {
+    return;
+  }
   VLOG(log_level) << "Netlink Message -- Examining Packet";
   if (!packet.IsValid()) {
     VLOG(log_level) << "<Invalid Buffer>";
@@ -154,6 +160,11 @@ void NetlinkMessage::PrintHeader(int log_level, const nlmsghdr* header) {
 // static
 void NetlinkMessage::PrintPayload(int log_level, const unsigned char* buf,
                                   size_t num_bytes) {
+  // Building the hex dump is the expensive part, so skip it entirely unless
+  // it is going to be logged.
+  if (!VLOG_IS_ON(log_level)) {
+    return;
+  }
   while (num_bytes) {
     string output;
     size_t bytes_this_row = min(num_bytes, static_cast<size_t>(32));
@@ -252,6 +263,9 @@ ByteString UnknownMessage::Encode(uint32_t sequence_number) {
 
 void UnknownMessage::Print(int header_log_level,
                            int /*detail_log_level*/) const {
+  if (!VLOG_IS_ON(header_log_level)) {
+    return;
+  }
   int total_bytes = message_body_.GetLength();
   const uint8_t* const_data = message_body_.GetConstData();
 
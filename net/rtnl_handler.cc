@@ -24,6 +24,7 @@
 #include <net/if.h>
 #include <net/if_arp.h>
 #include <netinet/ether.h>
+#include <stddef.h>
 #include <string.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
@@ -43,7 +44,9 @@
 
 using base::Bind;
 using base::Unretained;
+using std::set;
 using std::string;
+using std::vector;
 
 namespace shill {
 
@@ -51,9 +54,50 @@ namespace shill {
 const int RTNLHandler::kReceiveBufferSize = 512 * 1024;
 const int RTNLHandler::kInvalidSocket = -1;
 const int RTNLHandler::kErrorWindowSize = 16;
+const size_t RTNLHandler::kMaxFilteredInterfaces = 1024;
 
 namespace {
 base::LazyInstance<RTNLHandler> g_rtnl_handler = LAZY_INSTANCE_INITIALIZER;
+
+// Socket filter return values that deliver a whole message or drop it.
+const uint32_t kFilterAccept = 0xffffffff;
+const uint32_t kFilterDrop = 0;
+
+// Link, address, neighbor and ND user option messages all carry the
+// interface index at the same offset within their fixed header.
+const uint32_t kInterfaceIndexOffset =
+    NLMSG_HDRLEN + offsetof(struct ifinfomsg, ifi_index);
+static_assert(offsetof(struct ifaddrmsg, ifa_index) ==
+              offsetof(struct ifinfomsg, ifi_index),
+              "ifaddrmsg interface index is misplaced");
+static_assert(offsetof(struct ndmsg, ndm_ifindex) ==
+              offsetof(struct ifinfomsg, ifi_index),
+              "ndmsg interface index is misplaced");
+static_assert(offsetof(struct nduseroptmsg, nduseropt_ifindex) ==
+              offsetof(struct ifinfomsg, ifi_index),
+              "nduseroptmsg interface index is misplaced");
+
+// Message types, other than RTM_NEWLINK, that the socket filter inspects.
+const uint16_t kFilteredMessageTypes[] = {
+  RTM_NEWADDR, RTM_DELADDR, RTM_NEWNEIGH, RTM_DELNEIGH, RTM_NEWNDUSEROPT
+};
+
+// Appends instructions that drop the message if the interface index in
+// the accumulator is in |indices|, consuming up to |*remaining| entries.
+void AppendInterfaceIndexChecks(const set<int>& indices,
+                                size_t* remaining,
+                                vector<sock_filter>* filter) {
+  for (int index : indices) {
+    if (*remaining == 0) {
+      return;
+    }
+    --*remaining;
+    filter->push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K,
+                               htonl(static_cast<uint32_t>(index)), 0, 1));
+    filter->push_back(BPF_STMT(BPF_RET | BPF_K, kFilterDrop));
+  }
+}
+
 }  // namespace
 
 RTNLHandler::RTNLHandler()
@@ -109,6 +153,10 @@ void RTNLHandler::Start(uint32_t netlink_groups_mask) {
     return;
   }
 
+  if (!ignored_interfaces_.empty() || !link_only_interfaces_.empty()) {
+    InstallInterfaceFilter();
+  }
+
   rtnl_handler_.reset(io_handler_factory_->CreateIOInputHandler(
       rtnl_socket_,
       rtnl_callback_,
@@ -472,6 +520,55 @@ bool RTNLHandler::SendMessageWithErrorMask(RTNLMessage* message,
   return true;
 }
 
+int RTNLHandler::SendMessageSync(RTNLMessage* message) {
+  VLOG(5) << __func__ << " message type " << message->type()
+          << " mode " << message->mode();
+
+  message->set_flags(message->flags() | NLM_F_REQUEST | NLM_F_ACK);
+  message->set_seq(0);
+  ByteString msgdata = message->Encode();
+  if (msgdata.GetLength() == 0) {
+    return EINVAL;
+  }
+
+  int socket = sockets_->Socket(PF_NETLINK, SOCK_DGRAM, NETLINK_ROUTE);
+  if (socket < 0) {
+    int error = sockets_->Error();
+    PLOG(ERROR) << "Unable to open synchronous RTNL socket";
+    return error;
+  }
+  ScopedSocketCloser socket_closer(sockets_.get(), socket);
+
+  if (sockets_->Send(socket,
+                     msgdata.GetConstData(),
+                     msgdata.GetLength(),
+                     0) < 0) {
+    int error = sockets_->Error();
+    PLOG(ERROR) << "Synchronous RTNL send failed";
+    return error;
+  }
+
+  // The acknowledgement echoes the request after the error code, so leave
+  // room for it; anything beyond the error code may be truncated.
+  unsigned char reply[NLMSG_SPACE(sizeof(struct nlmsgerr)) + 1024];
+  ssize_t length = sockets_->RecvFrom(socket, reply, sizeof(reply), 0,
+                                      nullptr, nullptr);
+  if (length < 0) {
+    int error = sockets_->Error();
+    PLOG(ERROR) << "Synchronous RTNL receive failed";
+    return error;
+  }
+  const struct nlmsghdr* hdr = reinterpret_cast<struct nlmsghdr*>(reply);
+  if (static_cast<size_t>(length) < NLMSG_LENGTH(sizeof(struct nlmsgerr)) ||
+      hdr->nlmsg_type != NLMSG_ERROR) {
+    LOG(ERROR) << "Unexpected reply to synchronous RTNL request";
+    return EPROTO;
+  }
+  const struct nlmsgerr* err =
+      reinterpret_cast<const struct nlmsgerr*>(NLMSG_DATA(hdr));
+  return -err->error;
+}
+
 bool RTNLHandler::SendMessage(RTNLMessage* message) {
   ErrorMask error_mask;
   if (message->mode() == RTNLMessage::kModeAdd) {
@@ -485,6 +582,82 @@ bool RTNLHandler::SendMessage(RTNLMessage* message) {
   return SendMessageWithErrorMask(message, error_mask);
 }
 
+void RTNLHandler::SetIgnoredInterfaces(const set<int>& ignored_indices,
+                                       const set<int>& link_only_indices) {
+  if (ignored_indices == ignored_interfaces_ &&
+      link_only_indices == link_only_interfaces_) {
+    return;
+  }
+  ignored_interfaces_ = ignored_indices;
+  link_only_interfaces_ = link_only_indices;
+  if (ignored_interfaces_.size() + link_only_interfaces_.size() >
+      kMaxFilteredInterfaces) {
+    LOG(WARNING) << "Filtering RTNL messages for only "
+                 << kMaxFilteredInterfaces << " interfaces";
+  }
+  if (rtnl_socket_ != kInvalidSocket) {
+    InstallInterfaceFilter();
+  }
+}
+
+// static
+vector<sock_filter> RTNLHandler::BuildInterfaceFilter(
+    const set<int>& ignored_indices, const set<int>& link_only_indices) {
+  // BPF loads are big-endian, while netlink fields are in host byte order,
+  // so every constant below is byte-swapped with htons()/htonl().
+  vector<sock_filter> filter = {
+    // Deliver anything too short to carry an interface index.
+    BPF_STMT(BPF_LD | BPF_W | BPF_LEN, 0),
+    BPF_JUMP(BPF_JMP | BPF_JGE | BPF_K,
+             kInterfaceIndexOffset + sizeof(uint32_t), 1, 0),
+    BPF_STMT(BPF_RET | BPF_K, kFilterAccept),
+    // Deliver multipart (dump) replies, since a filter only sees the first
+    // message in each datagram.
+    BPF_STMT(BPF_LD | BPF_H | BPF_ABS, offsetof(struct nlmsghdr, nlmsg_flags)),
+    BPF_JUMP(BPF_JMP | BPF_JSET | BPF_K, htons(NLM_F_MULTI), 0, 1),
+    BPF_STMT(BPF_RET | BPF_K, kFilterAccept),
+    BPF_STMT(BPF_LD | BPF_H | BPF_ABS, offsetof(struct nlmsghdr, nlmsg_type)),
+  };
+
+  // Send filtered non-link messages to the link-only checks, followed by
+  // the ignored checks.  Send RTM_NEWLINK to the ignored checks alone, and
+  // deliver every other message type, including RTM_DELLINK, so that
+  // interfaces can always be classified and removed.
+  const size_t num_types = arraysize(kFilteredMessageTypes);
+  for (size_t i = 0; i < num_types; ++i) {
+    filter.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K,
+                              htons(kFilteredMessageTypes[i]),
+                              static_cast<uint8_t>(num_types + 2 - i), 0));
+  }
+  filter.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, htons(RTM_NEWLINK),
+                            0, 1));
+  // The offset of this jump depends on the number of link-only checks, and
+  // is filled in below.
+  size_t link_jump = filter.size();
+  filter.push_back(BPF_STMT(BPF_JMP | BPF_JA, 0));
+  filter.push_back(BPF_STMT(BPF_RET | BPF_K, kFilterAccept));
+
+  size_t remaining = kMaxFilteredInterfaces;
+  filter.push_back(BPF_STMT(BPF_LD | BPF_W | BPF_ABS, kInterfaceIndexOffset));
+  AppendInterfaceIndexChecks(link_only_indices, &remaining, &filter);
+  filter[link_jump].k = static_cast<uint32_t>(filter.size() - link_jump - 1);
+  filter.push_back(BPF_STMT(BPF_LD | BPF_W | BPF_ABS, kInterfaceIndexOffset));
+  AppendInterfaceIndexChecks(ignored_indices, &remaining, &filter);
+  filter.push_back(BPF_STMT(BPF_RET | BPF_K, kFilterAccept));
+  return filter;
+}
+
+void RTNLHandler::InstallInterfaceFilter() {
+  vector<sock_filter> filter =
+      BuildInterfaceFilter(ignored_interfaces_, link_only_interfaces_);
+  sock_fprog pf;
+  pf.filter = filter.data();
+  pf.len = filter.size();
+  if (sockets_->AttachFilter(rtnl_socket_, &pf) != 0) {
+    PLOG(ERROR) << "Failed to attach RTNL socket filter";
+  }
+}
+
 bool RTNLHandler::IsSequenceInErrorMaskWindow(uint32_t sequence) {
   return (request_sequence_ - sequence) < kErrorWindowSize;
 }
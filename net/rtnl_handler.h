@@ -17,6 +17,8 @@
 #ifndef SHILL_NET_RTNL_HANDLER_H_
 #define SHILL_NET_RTNL_HANDLER_H_
 
+#include <linux/filter.h>
+
 #include <memory>
 #include <set>
 #include <string>
@@ -122,6 +124,24 @@ class SHILL_EXPORT RTNLHandler {
   // using an error mask inferred from the mode and type of |message|.
   virtual bool SendMessage(RTNLMessage* message);
 
+  // Sends |message| on a separate RTNL socket and waits for the kernel to
+  // acknowledge it.  Returns 0 on success, or the errno reported by the
+  // kernel (or encountered while talking to it).  Only suitable for
+  // requests the kernel completes immediately, such as rule changes, since
+  // this blocks until the acknowledgement arrives.
+  virtual int SendMessageSync(RTNLMessage* message);
+
+  // Installs a socket filter so that the kernel discards notifications
+  // about uninteresting interfaces before they are queued on the RTNL
+  // socket.  Link, address, neighbor and RDNSS notifications about
+  // interfaces in |ignored_indices| are dropped.  Interfaces in
+  // |link_only_indices| still deliver link notifications, but their other
+  // notifications are dropped.  Link deletions, dump replies and all other
+  // message types are always delivered.  Replaces any earlier filter, and
+  // is re-applied if the RTNL socket is re-opened.
+  virtual void SetIgnoredInterfaces(const std::set<int>& ignored_indices,
+                                    const std::set<int>& link_only_indices);
+
  protected:
   RTNLHandler();
 
@@ -134,6 +154,7 @@ class SHILL_EXPORT RTNLHandler {
   friend class RTNLListenerTest;
   friend class RoutingTableTest;
 
+  FRIEND_TEST(RTNLHandlerTest, SetIgnoredInterfacesLimit);
   FRIEND_TEST(RTNLListenerTest, NoRun);
   FRIEND_TEST(RTNLListenerTest, Run);
   FRIEND_TEST(RoutingTableTest, RouteDeleteForeign);
@@ -144,6 +165,19 @@ class SHILL_EXPORT RTNLHandler {
   // Size of the window for receiving error sequences out-of-order.
   static const int kErrorWindowSize;
 
+  // Upper bound on the number of interfaces named in the socket filter,
+  // which keeps the program well below the kernel's instruction limit.
+  static const size_t kMaxFilteredInterfaces;
+
+  // Returns a socket filter program implementing SetIgnoredInterfaces().
+  static std::vector<sock_filter> BuildInterfaceFilter(
+      const std::set<int>& ignored_indices,
+      const std::set<int>& link_only_indices);
+
+  // Attaches the filter for |ignored_interfaces_| and
+  // |link_only_interfaces_| to |rtnl_socket_|.
+  void InstallInterfaceFilter();
+
   // This stops the event-monitoring function of the RTNL handler -- it is
   // private since it will never happen in normal running, but is useful for
   // tests.
@@ -190,6 +224,8 @@ class SHILL_EXPORT RTNLHandler {
   std::unique_ptr<IOHandler> rtnl_handler_;
   IOHandlerFactory* io_handler_factory_;
   std::vector<ErrorMask> error_mask_window_;
+  std::set<int> ignored_interfaces_;
+  std::set<int> link_only_interfaces_;
 
   DISALLOW_COPY_AND_ASSIGN(RTNLHandler);
 };
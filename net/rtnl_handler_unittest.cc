@@ -16,10 +16,16 @@
 
 #include "shill/net/rtnl_handler.h"
 
+#include <set>
 #include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <linux/filter.h>
 #include <net/if.h>
+#include <string.h>
 #include <sys/socket.h>
 #include <linux/netlink.h>  // Needs typedefs from sys/socket.h.
 #include <linux/rtnetlink.h>
@@ -35,16 +41,21 @@
 using base::Bind;
 using base::Callback;
 using base::Unretained;
+using std::set;
 using std::string;
+using std::vector;
 using testing::_;
 using testing::A;
 using testing::DoAll;
 using testing::ElementsAre;
 using testing::HasSubstr;
+using testing::Invoke;
+using testing::Mock;
 using testing::Return;
 using testing::ReturnArg;
 using testing::StrictMock;
 using testing::Test;
+using testing::WithArg;
 
 namespace shill {
 
@@ -62,6 +73,70 @@ MATCHER_P(MessageType, message_type, "") {
   return std::get<0>(arg).type() == message_type;
 }
 
+// Runs the socket filter |filter| over |packet| as the kernel would, and
+// returns whether the packet is delivered.  Only the instructions that
+// RTNLHandler generates are supported.
+bool FilterAccepts(const vector<sock_filter>& filter,
+                   const ByteString& packet) {
+  const unsigned char* data = packet.GetConstData();
+  const uint32_t length = packet.GetLength();
+  uint32_t accumulator = 0;
+  for (size_t pc = 0; pc < filter.size(); ++pc) {
+    const sock_filter& instruction = filter[pc];
+    switch (instruction.code) {
+      case BPF_LD | BPF_W | BPF_LEN:
+        accumulator = length;
+        break;
+      case BPF_LD | BPF_W | BPF_ABS: {
+        if (instruction.k + sizeof(uint32_t) > length) {
+          return false;
+        }
+        uint32_t word;
+        memcpy(&word, data + instruction.k, sizeof(word));
+        accumulator = ntohl(word);
+        break;
+      }
+      case BPF_LD | BPF_H | BPF_ABS: {
+        if (instruction.k + sizeof(uint16_t) > length) {
+          return false;
+        }
+        uint16_t half_word;
+        memcpy(&half_word, data + instruction.k, sizeof(half_word));
+        accumulator = ntohs(half_word);
+        break;
+      }
+      case BPF_JMP | BPF_JA:
+        pc += instruction.k;
+        break;
+      case BPF_JMP | BPF_JEQ | BPF_K:
+        pc += accumulator == instruction.k ? instruction.jt : instruction.jf;
+        break;
+      case BPF_JMP | BPF_JGE | BPF_K:
+        pc += accumulator >= instruction.k ? instruction.jt : instruction.jf;
+        break;
+      case BPF_JMP | BPF_JSET | BPF_K:
+        pc += (accumulator & instruction.k) ? instruction.jt : instruction.jf;
+        break;
+      case BPF_RET | BPF_K:
+        return instruction.k != 0;
+      default:
+        ADD_FAILURE() << "Unexpected filter instruction " << instruction.code;
+        return false;
+    }
+  }
+  ADD_FAILURE() << "Filter ran past its last instruction";
+  return false;
+}
+
+ByteString EncodeMessage(RTNLMessage::Type type,
+                         RTNLMessage::Mode mode,
+                         unsigned int flags,
+                         int interface_index) {
+  RTNLMessage message(type, mode, flags, 0, 0, interface_index,
+                      IPAddress::kFamilyIPv4);
+  return message.Encode();
+}
+
 }  // namespace
 
 class RTNLHandlerTest : public Test {
@@ -321,6 +396,123 @@ TEST_F(RTNLHandlerTest, SendMessageInferredErrorMasks) {
   }
 }
 
+TEST_F(RTNLHandlerTest, SendMessageSync) {
+  const int kSyncSocket = kTestSocket + 1;
+  int reply_error = 0;
+  auto write_ack = [&reply_error](int, void* buf, size_t len, int,
+                                  struct sockaddr*, socklen_t*) -> ssize_t {
+    struct {
+      struct nlmsghdr hdr;
+      struct nlmsgerr err;
+    } ack;
+    memset(&ack, 0, sizeof(ack));
+    ack.hdr.nlmsg_type = NLMSG_ERROR;
+    ack.hdr.nlmsg_len = NLMSG_LENGTH(sizeof(ack.err));
+    ack.err.error = -reply_error;
+    EXPECT_GE(len, sizeof(ack));
+    memcpy(buf, &ack, sizeof(ack));
+    return sizeof(ack);
+  };
+
+  // Each request uses a socket of its own, which is closed afterwards, and
+  // asks the kernel for an acknowledgement.
+  for (int error : {0, ENOENT}) {
+    reply_error = error;
+    RTNLMessage message(RTNLMessage::kTypeLink,
+                        RTNLMessage::kModeDelete,
+                        0,
+                        0,
+                        0,
+                        kTestDeviceIndex,
+                        IPAddress::kFamilyUnknown);
+    EXPECT_CALL(*sockets_, Socket(PF_NETLINK, SOCK_DGRAM, NETLINK_ROUTE))
+        .WillOnce(Return(kSyncSocket));
+    EXPECT_CALL(*sockets_, Send(kSyncSocket, _, _, 0)).WillOnce(ReturnArg<2>());
+    EXPECT_CALL(*sockets_, RecvFrom(kSyncSocket, _, _, 0, _, _))
+        .WillOnce(Invoke(write_ack));
+    EXPECT_CALL(*sockets_, Close(kSyncSocket)).WillOnce(Return(0));
+    EXPECT_EQ(error, RTNLHandler::GetInstance()->SendMessageSync(&message));
+    EXPECT_EQ(NLM_F_REQUEST | NLM_F_ACK, message.flags());
+    Mock::VerifyAndClearExpectations(sockets_);
+  }
+
+  // Local failures are reported with their errno.
+  RTNLMessage message(RTNLMessage::kTypeLink,
+                      RTNLMessage::kModeDelete,
+                      0,
+                      0,
+                      0,
+                      kTestDeviceIndex,
+                      IPAddress::kFamilyUnknown);
+  EXPECT_CALL(*sockets_, Socket(PF_NETLINK, SOCK_DGRAM, NETLINK_ROUTE))
+      .WillOnce(Return(-1));
+  EXPECT_CALL(*sockets_, Error()).WillOnce(Return(EMFILE));
+  EXPECT_EQ(EMFILE, RTNLHandler::GetInstance()->SendMessageSync(&message));
+}
+
+TEST_F(RTNLHandlerTest, SetIgnoredInterfaces) {
+  const int kIgnoredIndex = kTestDeviceIndex;
+  const int kLinkOnlyIndex = kTestDeviceIndex + 1;
+  const int kOtherIndex = kTestDeviceIndex + 2;
+  RTNLHandler* handler = RTNLHandler::GetInstance();
+
+  // The filter is attached once the socket is opened.
+  handler->SetIgnoredInterfaces({kIgnoredIndex}, {kLinkOnlyIndex});
+  vector<sock_filter> filter;
+  EXPECT_CALL(*sockets_, AttachFilter(kTestSocket, _))
+      .WillOnce(DoAll(WithArg<1>(Invoke([&filter](sock_fprog* program) {
+                        filter.assign(program->filter,
+                                      program->filter + program->len);
+                      })),
+                      Return(0)));
+  StartRTNLHandler();
+  Mock::VerifyAndClearExpectations(sockets_);
+
+  EXPECT_FALSE(FilterAccepts(filter, EncodeMessage(
+      RTNLMessage::kTypeLink, RTNLMessage::kModeAdd, 0, kIgnoredIndex)));
+  EXPECT_FALSE(FilterAccepts(filter, EncodeMessage(
+      RTNLMessage::kTypeNeighbor, RTNLMessage::kModeAdd, 0, kIgnoredIndex)));
+  EXPECT_TRUE(FilterAccepts(filter, EncodeMessage(
+      RTNLMessage::kTypeLink, RTNLMessage::kModeDelete, 0, kIgnoredIndex)));
+  EXPECT_TRUE(FilterAccepts(filter, EncodeMessage(
+      RTNLMessage::kTypeLink, RTNLMessage::kModeAdd, NLM_F_MULTI,
+      kIgnoredIndex)));
+
+  EXPECT_TRUE(FilterAccepts(filter, EncodeMessage(
+      RTNLMessage::kTypeLink, RTNLMessage::kModeAdd, 0, kLinkOnlyIndex)));
+  EXPECT_FALSE(FilterAccepts(filter, EncodeMessage(
+      RTNLMessage::kTypeNeighbor, RTNLMessage::kModeAdd, 0, kLinkOnlyIndex)));
+
+  EXPECT_TRUE(FilterAccepts(filter, EncodeMessage(
+      RTNLMessage::kTypeLink, RTNLMessage::kModeAdd, 0, kOtherIndex)));
+  EXPECT_TRUE(FilterAccepts(filter, EncodeMessage(
+      RTNLMessage::kTypeNeighbor, RTNLMessage::kModeAdd, 0, kOtherIndex)));
+
+  // An unchanged set of interfaces does not touch the socket, while a
+  // changed one replaces the filter right away.
+  handler->SetIgnoredInterfaces({kIgnoredIndex}, {kLinkOnlyIndex});
+  EXPECT_CALL(*sockets_, AttachFilter(kTestSocket, _)).WillOnce(Return(0));
+  handler->SetIgnoredInterfaces(set<int>(), set<int>());
+  Mock::VerifyAndClearExpectations(sockets_);
+
+  StopRTNLHandler();
+}
+
+TEST_F(RTNLHandlerTest, SetIgnoredInterfacesLimit) {
+  set<int> indices;
+  for (size_t i = 1; i <= RTNLHandler::kMaxFilteredInterfaces + 1; ++i) {
+    indices.insert(static_cast<int>(i));
+  }
+  vector<sock_filter> filter =
+      RTNLHandler::BuildInterfaceFilter(indices, set<int>());
+  EXPECT_LT(filter.size(), static_cast<size_t>(BPF_MAXINSNS));
+  EXPECT_FALSE(FilterAccepts(filter, EncodeMessage(
+      RTNLMessage::kTypeNeighbor, RTNLMessage::kModeAdd, 0, 1)));
+  EXPECT_TRUE(FilterAccepts(filter, EncodeMessage(
+      RTNLMessage::kTypeNeighbor, RTNLMessage::kModeAdd, 0,
+      static_cast<int>(RTNLHandler::kMaxFilteredInterfaces + 1))));
+}
+
 TEST_F(RTNLHandlerTest, MaskedError) {
   StartRTNLHandler();
   const uint32_t kSequenceNumber = 123;
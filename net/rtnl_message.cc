@@ -16,6 +16,7 @@
 
 #include "shill/net/rtnl_message.h"
 
+#include <linux/fib_rules.h>
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
 #include <netinet/in.h>
@@ -39,6 +40,7 @@ struct RTNLHeader {
     struct rtgenmsg gen;
     struct nduseroptmsg nd_user_opt;
     struct ndmsg ndm;
+    struct fib_rule_hdr frh;
   };
 };
 
@@ -89,6 +91,7 @@ bool RTNLMessage::DecodeInternal(const ByteString& msg) {
   case RTM_NEWROUTE:
   case RTM_NEWNDUSEROPT:
   case RTM_NEWNEIGH:
+  case RTM_NEWRULE:
     mode = kModeAdd;
     break;
 
@@ -96,6 +99,7 @@ bool RTNLMessage::DecodeInternal(const ByteString& msg) {
   case RTM_DELADDR:
   case RTM_DELROUTE:
   case RTM_DELNEIGH:
+  case RTM_DELRULE:
     mode = kModeDelete;
     break;
 
@@ -136,6 +140,12 @@ bool RTNLMessage::DecodeInternal(const ByteString& msg) {
       return false;
     break;
 
+  case RTM_NEWRULE:
+  case RTM_DELRULE:
+    if (!DecodeRule(hdr, mode, &attr_data, &attr_length))
+      return false;
+    break;
+
   default:
     NOTREACHED();
   }
@@ -323,11 +333,33 @@ bool RTNLMessage::DecodeNeighbor(const RTNLHeader* hdr,
   return true;
 }
 
+bool RTNLMessage::DecodeRule(const RTNLHeader* hdr,
+                             Mode mode,
+                             rtattr** attr_data,
+                             int* attr_length) {
+  if (hdr->hdr.nlmsg_len < NLMSG_LENGTH(sizeof(hdr->frh))) {
+    return false;
+  }
+
+  mode_ = mode;
+  family_ = hdr->frh.family;
+  type_ = kTypeRule;
+
+  *attr_data = RTM_RTA(NLMSG_DATA(&hdr->hdr));
+  *attr_length = RTM_PAYLOAD(&hdr->hdr);
+
+  set_rule_status(RuleStatus(hdr->frh.table,
+                             hdr->frh.action,
+                             hdr->frh.flags));
+  return true;
+}
+
 ByteString RTNLMessage::Encode() const {
   if (type_ != kTypeLink &&
       type_ != kTypeAddress &&
       type_ != kTypeRoute &&
-      type_ != kTypeNeighbor) {
+      type_ != kTypeNeighbor &&
+      type_ != kTypeRule) {
     return ByteString();
   }
 
@@ -345,6 +377,8 @@ ByteString RTNLMessage::Encode() const {
       hdr.hdr.nlmsg_type = RTM_GETROUTE;
     } else if (type_ == kTypeNeighbor) {
       hdr.hdr.nlmsg_type = RTM_GETNEIGH;
+    } else if (type_ == kTypeRule) {
+      hdr.hdr.nlmsg_type = RTM_GETRULE;
     } else {
       NOTIMPLEMENTED();
       return ByteString();
@@ -378,6 +412,12 @@ ByteString RTNLMessage::Encode() const {
       }
       break;
 
+    case kTypeRule:
+      if (!EncodeRule(&hdr)) {
+        return ByteString();
+      }
+      break;
+
     default:
       NOTREACHED();
     }
@@ -509,6 +549,26 @@ bool RTNLMessage::EncodeNeighbor(RTNLHeader* hdr) const {
   return true;
 }
 
+bool RTNLMessage::EncodeRule(RTNLHeader* hdr) const {
+  switch (mode_) {
+    case kModeAdd:
+      hdr->hdr.nlmsg_type = RTM_NEWRULE;
+      break;
+    case kModeDelete:
+      hdr->hdr.nlmsg_type = RTM_DELRULE;
+      break;
+    default:
+      NOTIMPLEMENTED();
+      return false;
+  }
+  hdr->hdr.nlmsg_len = NLMSG_LENGTH(sizeof(hdr->frh));
+  hdr->frh.family = family_;
+  hdr->frh.table = rule_status_.table;
+  hdr->frh.action = rule_status_.action;
+  hdr->frh.flags = rule_status_.flags;
+  return true;
+}
+
 void RTNLMessage::Reset() {
   mode_ = kModeUnknown;
   type_ = kTypeUnknown;
@@ -520,6 +580,7 @@ void RTNLMessage::Reset() {
   link_status_ = LinkStatus();
   address_status_ = AddressStatus();
   route_status_ = RouteStatus();
+  rule_status_ = RuleStatus();
   attributes_.clear();
 }
 
@@ -43,6 +43,7 @@ class SHILL_EXPORT RTNLMessage {
     kTypeRdnss,
     kTypeDnssl,
     kTypeNeighbor,
+    kTypeRule,
   };
 
   enum Mode {
@@ -117,6 +118,22 @@ class SHILL_EXPORT RTNLMessage {
     unsigned char flags;
   };
 
+  struct RuleStatus {
+    RuleStatus()
+        : table(0),
+          action(0),
+          flags(0) {}
+    RuleStatus(unsigned char table_in,
+               unsigned char action_in,
+               uint32_t flags_in)
+        : table(table_in),
+          action(action_in),
+          flags(flags_in) {}
+    unsigned char table;
+    unsigned char action;
+    uint32_t flags;
+  };
+
   struct NeighborStatus {
     NeighborStatus()
         : state(0),
@@ -166,6 +183,7 @@ class SHILL_EXPORT RTNLMessage {
   Type type() const { return type_; }
   Mode mode() const { return mode_; }
   uint16_t flags() const { return flags_; }
+  void set_flags(uint16_t flags) { flags_ = flags; }
   uint32_t seq() const { return seq_; }
   void set_seq(uint32_t seq) { seq_ = seq; }
   uint32_t pid() const { return pid_; }
@@ -184,6 +202,10 @@ class SHILL_EXPORT RTNLMessage {
   void set_route_status(const RouteStatus& route_status) {
     route_status_ = route_status;
   }
+  const RuleStatus& rule_status() const { return rule_status_; }
+  void set_rule_status(const RuleStatus& rule_status) {
+    rule_status_ = rule_status;
+  }
   const RdnssOption& rdnss_option() const { return rdnss_option_; }
   void set_rdnss_option(const RdnssOption& rdnss_option) {
     rdnss_option_ = rdnss_option;
@@ -234,7 +256,12 @@ class SHILL_EXPORT RTNLMessage {
   SHILL_PRIVATE bool EncodeLink(RTNLHeader* hdr) const;
   SHILL_PRIVATE bool EncodeAddress(RTNLHeader* hdr) const;
   SHILL_PRIVATE bool EncodeRoute(RTNLHeader* hdr) const;
+  SHILL_PRIVATE bool DecodeRule(const RTNLHeader* hdr,
+                                Mode mode,
+                                rtattr** attr_data,
+                                int* attr_length);
   SHILL_PRIVATE bool EncodeNeighbor(RTNLHeader* hdr) const;
+  SHILL_PRIVATE bool EncodeRule(RTNLHeader* hdr) const;
 
   Type type_;
   Mode mode_;
@@ -247,6 +274,7 @@ class SHILL_EXPORT RTNLMessage {
   AddressStatus address_status_;
   RouteStatus route_status_;
   NeighborStatus neighbor_status_;
+  RuleStatus rule_status_;
   RdnssOption rdnss_option_;
   std::unordered_map<uint16_t, ByteString> attributes_;
 
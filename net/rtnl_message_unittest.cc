@@ -17,6 +17,7 @@
 #include "shill/net/rtnl_message.h"
 
 #include <sys/socket.h>
+#include <linux/fib_rules.h>
 #include <linux/if.h>  // NOLINT(build/include_alpha) - needs sockaddr.
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
@@ -776,4 +777,41 @@ TEST_F(RTNLMessageTest, EncodeLinkDel) {
   EXPECT_FALSE(msg.HasAttribute(IFLA_OPERSTATE));
 }
 
+TEST_F(RTNLMessageTest, EncodeRuleAdd) {
+  const char kInterfaceName[] = "wlan0";
+  const uint32_t kPriority = 32765;
+  RTNLMessage msg(RTNLMessage::kTypeRule,
+                  RTNLMessage::kModeAdd,
+                  NLM_F_REQUEST | NLM_F_CREATE,
+                  1, 2, 0,
+                  IPAddress::kFamilyIPv6);
+  msg.set_rule_status(RTNLMessage::RuleStatus(10, FR_ACT_TO_TBL, 0));
+  msg.SetAttribute(FRA_PRIORITY, ByteString::CreateFromCPUUInt32(kPriority));
+  msg.SetAttribute(FRA_OIFNAME, ByteString(string(kInterfaceName), true));
+
+  RTNLMessage pmsg;
+  EXPECT_TRUE(pmsg.Decode(msg.Encode()));
+
+  EXPECT_EQ(RTNLMessage::kTypeRule, pmsg.type());
+  EXPECT_EQ(RTNLMessage::kModeAdd, pmsg.mode());
+  EXPECT_EQ(IPAddress::kFamilyIPv6, pmsg.family());
+  EXPECT_EQ(10, pmsg.rule_status().table);
+  EXPECT_EQ(FR_ACT_TO_TBL, pmsg.rule_status().action);
+
+  uint32_t priority = 0;
+  EXPECT_TRUE(pmsg.GetAttribute(FRA_PRIORITY).ConvertToCPUUInt32(&priority));
+  EXPECT_EQ(kPriority, priority);
+  EXPECT_TRUE(pmsg.GetAttribute(FRA_OIFNAME).Equals(
+      ByteString(string(kInterfaceName), true)));
+}
+
+TEST_F(RTNLMessageTest, EncodeRuleQuery) {
+  RTNLMessage msg(RTNLMessage::kTypeRule,
+                  RTNLMessage::kModeQuery,
+                  NLM_F_REQUEST,
+                  1, 2, 0,
+                  IPAddress::kFamilyIPv4);
+  EXPECT_TRUE(msg.Encode().IsEmpty());
+}
+
 }  // namespace shill
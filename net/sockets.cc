@@ -76,6 +76,11 @@ int Sockets::AddMulticastMembership(int sockfd, in_addr_t addr) const {
   return setsockopt(sockfd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq));
 }
 
+int Sockets::SetIPv6MulticastHops(int sockfd, int hops) const {
+  return setsockopt(sockfd, IPPROTO_IPV6, IPV6_MULTICAST_HOPS, &hops,
+                    sizeof(hops));
+}
+
 int Sockets::Close(int fd) const {
   return IGNORE_EINTR(close(fd));
 }
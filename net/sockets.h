@@ -61,6 +61,9 @@ class SHILL_EXPORT Sockets {
   // setsockopt(s, IPPROTO_IP, IP_ADD_MEMBERSHIP, ...)
   virtual int AddMulticastMembership(int sockfd, in_addr_t addr) const;
 
+  // setsockopt(s, IPPROTO_IPV6, IPV6_MULTICAST_HOPS, ...)
+  virtual int SetIPv6MulticastHops(int sockfd, int hops) const;
+
   // close
   virtual int Close(int fd) const;
 
@@ -16,10 +16,14 @@
 
 #include "shill/pending_activation_store.h"
 
+#include <base/bind.h>
+
+#include "shill/event_dispatcher.h"
 #include "shill/logging.h"
 #include "shill/store_factory.h"
 #include "shill/store_interface.h"
 
+using base::Bind;
 using base::FilePath;
 using std::string;
 
@@ -37,8 +41,11 @@ const char PendingActivationStore::kMeidGroupId[] = "meid_list";
 // We're keeping the old file name here for backwards compatibility.
 const char PendingActivationStore::kStorageFileName[] =
     "activating_iccid_store.profile";
+const int PendingActivationStore::kFlushDelayMilliseconds = 1000;
 
-PendingActivationStore::PendingActivationStore() {}
+PendingActivationStore::PendingActivationStore(EventDispatcher* dispatcher)
+    : dispatcher_(dispatcher),
+      weak_ptr_factory_(this) {}
 
 PendingActivationStore::~PendingActivationStore() {
   if (storage_.get())
@@ -93,6 +100,8 @@ string PendingActivationStore::IdentifierTypeToGroupId(IdentifierType type) {
 
 bool PendingActivationStore::InitStorage(const FilePath& storage_path) {
   // Close the current file.
+  flush_callback_.Cancel();
+  state_cache_.clear();
   if (storage_.get()) {
     storage_->Flush();
     storage_.reset();  // KeyFileStore closes the file in its destructor.
@@ -120,12 +129,24 @@ bool PendingActivationStore::InitStorage(const FilePath& storage_path) {
 PendingActivationStore::State PendingActivationStore::GetActivationState(
     IdentifierType type,
     const string& identifier) const {
-  string formatted_identifier = FormattedIdentifier(type, identifier);
-  SLOG(this, 2) << __func__ << ": " << formatted_identifier;
+  SLOG(this, 2) << __func__ << ": " << FormattedIdentifier(type, identifier);
   if (!storage_.get()) {
     LOG(ERROR) << "Underlying storage not initialized.";
     return kStateUnknown;
   }
+  CacheKey key(type, identifier);
+  StateCache::const_iterator it = state_cache_.find(key);
+  if (it != state_cache_.end())
+    return it->second;
+  State state = ReadActivationState(type, identifier);
+  state_cache_[key] = state;
+  return state;
+}
+
+PendingActivationStore::State PendingActivationStore::ReadActivationState(
+    IdentifierType type,
+    const string& identifier) const {
+  string formatted_identifier = FormattedIdentifier(type, identifier);
   int state = 0;
   if (!storage_->GetInt(IdentifierTypeToGroupId(type), identifier, &state)) {
     SLOG(this, 2) << "No entry exists for " << formatted_identifier;
@@ -164,7 +185,9 @@ bool PendingActivationStore::SetActivationState(
                   << "values.";
     return false;
   }
-  return storage_->Flush();
+  state_cache_[CacheKey(type, identifier)] = state;
+  ScheduleFlush();
+  return true;
 }
 
 bool PendingActivationStore::RemoveEntry(IdentifierType type,
@@ -179,7 +202,36 @@ bool PendingActivationStore::RemoveEntry(IdentifierType type,
     SLOG(this, 2) << "Failed to remove the given identifier.";
     return false;
   }
-  return storage_->Flush();
+  state_cache_[CacheKey(type, identifier)] = kStateUnknown;
+  ScheduleFlush();
+  return true;
+}
+
+void PendingActivationStore::ScheduleFlush() {
+  if (!dispatcher_) {
+    if (!storage_->Flush())
+      LOG(ERROR) << "Failed to flush pending activation store.";
+    return;
+  }
+  if (!flush_callback_.IsCancelled())
+    return;  // Coalesce with the flush that is already pending.
+  flush_callback_.Reset(Bind(&PendingActivationStore::OnFlushTimeout,
+                             weak_ptr_factory_.GetWeakPtr()));
+  dispatcher_->PostDelayedTask(flush_callback_.callback(),
+                               kFlushDelayMilliseconds);
+}
+
+void PendingActivationStore::FlushPending() {
+  if (flush_callback_.IsCancelled())
+    return;
+  flush_callback_.Cancel();
+  if (!storage_->Flush())
+    LOG(ERROR) << "Failed to flush pending activation store.";
+}
+
+void PendingActivationStore::OnFlushTimeout() {
+  SLOG(this, 2) << __func__;
+  FlushPending();
 }
 
 }  // namespace shill
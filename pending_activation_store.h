@@ -17,14 +17,19 @@
 #ifndef SHILL_PENDING_ACTIVATION_STORE_H_
 #define SHILL_PENDING_ACTIVATION_STORE_H_
 
+#include <map>
 #include <memory>
 #include <string>
+#include <utility>
 
+#include <base/cancelable_callback.h>
 #include <base/files/file_path.h>
+#include <base/memory/weak_ptr.h>
 #include <gtest/gtest_prod.h>  // for FRIEND_TEST
 
 namespace shill {
 
+class EventDispatcher;
 class StoreInterface;
 
 // PendingActivationStore stores the network activation status for a
@@ -33,6 +38,12 @@ class StoreInterface;
 // activation and stored in the persistent profile. Once shill knows that
 // the activation associated with a particular SIM is successful, it is removed
 // from the profile and the cellular service is marked as activated.
+//
+// Activation states are cached in memory once read, so repeated lookups
+// during activation and modem resets do not go back to the underlying store.
+// Modifications are applied to the store immediately, but flushing to disk is
+// deferred by kFlushDelayMilliseconds so that a burst of updates results in a
+// single write.
 class PendingActivationStore {
  public:
   enum State {
@@ -58,8 +69,10 @@ class PendingActivationStore {
     kIdentifierMEID,
   };
 
-  // Constructor performs no initialization.
-  PendingActivationStore();
+  // Constructor performs no initialization. Deferred flushes are posted on
+  // |dispatcher|. If |dispatcher| is NULL, every modification is flushed
+  // synchronously.
+  explicit PendingActivationStore(EventDispatcher* dispatcher);
   virtual ~PendingActivationStore();
 
   // Tries to open the underlying store interface from the given file path.
@@ -91,18 +104,41 @@ class PendingActivationStore {
  private:
   friend class PendingActivationStoreTest;
   friend class CellularCapabilityUniversalTest;
+  FRIEND_TEST(PendingActivationStoreTest, CachesActivationState);
+  FRIEND_TEST(PendingActivationStoreTest, CoalescesFlushes);
   FRIEND_TEST(PendingActivationStoreTest, FileInteractions);
   FRIEND_TEST(PendingActivationStoreTest, GetActivationState);
   FRIEND_TEST(PendingActivationStoreTest, RemoveEntry);
   FRIEND_TEST(PendingActivationStoreTest, SetActivationState);
 
+  typedef std::pair<IdentifierType, std::string> CacheKey;
+  typedef std::map<CacheKey, State> StateCache;
+
   static const char kIccidGroupId[];
   static const char kMeidGroupId[];
   static const char kStorageFileName[];
+  static const int kFlushDelayMilliseconds;
 
   static std::string IdentifierTypeToGroupId(IdentifierType type);
 
+  // Reads the activation state for |type|:|identifier| from |storage_|,
+  // bypassing the cache.
+  State ReadActivationState(IdentifierType type,
+                            const std::string& identifier) const;
+
+  // Schedules a deferred flush of |storage_|, unless one is already pending.
+  void ScheduleFlush();
+  // Flushes |storage_| to disk if a deferred flush is pending.
+  void FlushPending();
+  void OnFlushTimeout();
+
+  EventDispatcher* dispatcher_;
   std::unique_ptr<StoreInterface> storage_;
+  // Activation states already read from or written to |storage_|. Identifiers
+  // without an entry in |storage_| are cached as kStateUnknown.
+  mutable StateCache state_cache_;
+  base::CancelableClosure flush_callback_;
+  base::WeakPtrFactory<PendingActivationStore> weak_ptr_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(PendingActivationStore);
 };
@@ -20,20 +20,25 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include "shill/mock_event_dispatcher.h"
 #include "shill/mock_store.h"
 #include "shill/store_factory.h"
 
 using ::testing::_;
 using ::testing::DoAll;
 using ::testing::Mock;
+using ::testing::NiceMock;
 using ::testing::Return;
+using ::testing::SaveArg;
 using ::testing::SetArgumentPointee;
 
 namespace shill {
 
 class PendingActivationStoreTest : public ::testing::Test {
  public:
-  PendingActivationStoreTest() : mock_store_(new MockStore()) {
+  PendingActivationStoreTest()
+      : mock_store_(new MockStore()),
+        store_(&dispatcher_) {
   }
 
  protected:
@@ -41,6 +46,7 @@ class PendingActivationStoreTest : public ::testing::Test {
     store_.storage_.reset(mock_store_.release());
   }
 
+  NiceMock<MockEventDispatcher> dispatcher_;
   std::unique_ptr<MockStore> mock_store_;
   PendingActivationStore store_;
 };
@@ -179,51 +185,139 @@ TEST_F(PendingActivationStoreTest, GetActivationState) {
   MockStore* mock_store = mock_store_.get();
   SetMockStore();
 
-  const char kEntry[] = "12345689";
+  const char kEntry1[] = "12345689";
+  const char kEntry2[] = "12345690";
+  const char kEntry3[] = "12345691";
 
   // Value not found
   EXPECT_CALL(*mock_store, GetInt(PendingActivationStore::kIccidGroupId,
-                                  kEntry,
+                                  kEntry1,
                                   _))
       .WillOnce(Return(false));
   EXPECT_EQ(PendingActivationStore::kStateUnknown,
             store_.GetActivationState(PendingActivationStore::kIdentifierICCID,
-                                      kEntry));
+                                      kEntry1));
 
   // File contains invalid entry
   EXPECT_CALL(*mock_store,
-              GetInt(PendingActivationStore::kMeidGroupId, kEntry, _))
+              GetInt(PendingActivationStore::kMeidGroupId, kEntry1, _))
       .WillOnce(DoAll(
           SetArgumentPointee<2>(
               static_cast<int>(PendingActivationStore::kStateMax)),
           Return(true)));
   EXPECT_EQ(PendingActivationStore::kStateUnknown,
             store_.GetActivationState(PendingActivationStore::kIdentifierMEID,
-                                      kEntry));
+                                      kEntry1));
   EXPECT_CALL(*mock_store,
-              GetInt(PendingActivationStore::kMeidGroupId, kEntry, _))
+              GetInt(PendingActivationStore::kMeidGroupId, kEntry2, _))
       .WillOnce(DoAll(SetArgumentPointee<2>(0), Return(true)));
   EXPECT_EQ(PendingActivationStore::kStateUnknown,
             store_.GetActivationState(PendingActivationStore::kIdentifierMEID,
-                                      kEntry));
+                                      kEntry2));
   Mock::VerifyAndClearExpectations(mock_store);
 
   // All enum values
+  EXPECT_CALL(*mock_store,
+              GetInt(PendingActivationStore::kIccidGroupId, kEntry2, _))
+      .WillOnce(DoAll(SetArgumentPointee<2>(1), Return(true)));
+  EXPECT_EQ(PendingActivationStore::kStatePending,
+            store_.GetActivationState(PendingActivationStore::kIdentifierICCID,
+                                      kEntry2));
+  EXPECT_CALL(*mock_store,
+              GetInt(PendingActivationStore::kIccidGroupId, kEntry3, _))
+      .WillOnce(DoAll(SetArgumentPointee<2>(2), Return(true)));
+  EXPECT_EQ(PendingActivationStore::kStateActivated,
+            store_.GetActivationState(PendingActivationStore::kIdentifierICCID,
+                                      kEntry3));
+  Mock::VerifyAndClearExpectations(mock_store);
+}
+
+TEST_F(PendingActivationStoreTest, CachesActivationState) {
+  MockStore* mock_store = mock_store_.get();
+  SetMockStore();
+
+  const char kEntry[] = "12345689";
+
+  // The underlying store is consulted only on the first lookup.
   EXPECT_CALL(*mock_store,
               GetInt(PendingActivationStore::kIccidGroupId, kEntry, _))
       .WillOnce(DoAll(SetArgumentPointee<2>(1), Return(true)));
   EXPECT_EQ(PendingActivationStore::kStatePending,
             store_.GetActivationState(PendingActivationStore::kIdentifierICCID,
                                       kEntry));
+  EXPECT_EQ(PendingActivationStore::kStatePending,
+            store_.GetActivationState(PendingActivationStore::kIdentifierICCID,
+                                      kEntry));
+  Mock::VerifyAndClearExpectations(mock_store);
+
+  // Modifications are served from the cache as well.
+  EXPECT_CALL(*mock_store, GetInt(_, _, _)).Times(0);
   EXPECT_CALL(*mock_store,
-              GetInt(PendingActivationStore::kIccidGroupId, kEntry, _))
-      .WillOnce(DoAll(SetArgumentPointee<2>(2), Return(true)));
+              SetInt(PendingActivationStore::kIccidGroupId, kEntry, 2))
+      .WillOnce(Return(true));
+  EXPECT_TRUE(store_.SetActivationState(
+      PendingActivationStore::kIdentifierICCID,
+      kEntry,
+      PendingActivationStore::kStateActivated));
   EXPECT_EQ(PendingActivationStore::kStateActivated,
             store_.GetActivationState(PendingActivationStore::kIdentifierICCID,
                                       kEntry));
+  EXPECT_CALL(*mock_store,
+              DeleteKey(PendingActivationStore::kIccidGroupId, kEntry))
+      .WillOnce(Return(true));
+  EXPECT_TRUE(store_.RemoveEntry(PendingActivationStore::kIdentifierICCID,
+                                 kEntry));
+  EXPECT_EQ(PendingActivationStore::kStateUnknown,
+            store_.GetActivationState(PendingActivationStore::kIdentifierICCID,
+                                      kEntry));
   Mock::VerifyAndClearExpectations(mock_store);
 }
 
+TEST_F(PendingActivationStoreTest, CoalescesFlushes) {
+  MockStore* mock_store = mock_store_.get();
+  SetMockStore();
+
+  const char kEntry1[] = "12345689";
+  const char kEntry2[] = "12345690";
+
+  base::Closure flush_task;
+  EXPECT_CALL(*mock_store, SetInt(_, _, _)).WillRepeatedly(Return(true));
+  EXPECT_CALL(*mock_store, DeleteKey(_, _)).WillRepeatedly(Return(true));
+  EXPECT_CALL(*mock_store, Flush()).Times(0);
+  EXPECT_CALL(dispatcher_,
+              PostDelayedTask(
+                  _, PendingActivationStore::kFlushDelayMilliseconds))
+      .WillOnce(SaveArg<0>(&flush_task));
+  EXPECT_TRUE(store_.SetActivationState(
+      PendingActivationStore::kIdentifierICCID,
+      kEntry1,
+      PendingActivationStore::kStatePending));
+  EXPECT_TRUE(store_.SetActivationState(
+      PendingActivationStore::kIdentifierMEID,
+      kEntry2,
+      PendingActivationStore::kStateActivated));
+  EXPECT_TRUE(store_.RemoveEntry(PendingActivationStore::kIdentifierICCID,
+                                 kEntry1));
+  Mock::VerifyAndClearExpectations(mock_store);
+  Mock::VerifyAndClearExpectations(&dispatcher_);
+
+  // A single flush covers all of the modifications above.
+  EXPECT_CALL(*mock_store, Flush()).WillOnce(Return(true));
+  flush_task.Run();
+  Mock::VerifyAndClearExpectations(mock_store);
+
+  // A new modification schedules another flush.
+  EXPECT_CALL(*mock_store, SetInt(_, _, _)).WillOnce(Return(true));
+  EXPECT_CALL(dispatcher_, PostDelayedTask(_, _))
+      .WillOnce(SaveArg<0>(&flush_task));
+  EXPECT_TRUE(store_.SetActivationState(
+      PendingActivationStore::kIdentifierICCID,
+      kEntry1,
+      PendingActivationStore::kStateActivated));
+  Mock::VerifyAndClearExpectations(&dispatcher_);
+  EXPECT_CALL(*mock_store, Flush()).WillRepeatedly(Return(true));
+}
+
 TEST_F(PendingActivationStoreTest, SetActivationState) {
   MockStore* mock_store = mock_store_.get();
   SetMockStore();
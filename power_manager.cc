@@ -28,8 +28,11 @@
 #endif  // __ANDROID__
 
 #include "shill/control_interface.h"
+#include "shill/error.h"
 #include "shill/event_dispatcher.h"
 #include "shill/logging.h"
+#include "shill/metrics.h"
+#include "shill/net/shill_time.h"
 #include "shill/power_manager_proxy_interface.h"
 
 using base::Bind;
@@ -47,9 +50,12 @@ const char PowerManager::kDarkSuspendDelayDescription[] = "shill";
 const int PowerManager::kSuspendTimeoutMilliseconds = 15 * 1000;
 
 PowerManager::PowerManager(EventDispatcher* dispatcher,
-                           ControlInterface* control_interface)
+                           ControlInterface* control_interface,
+                           Metrics* metrics)
     : dispatcher_(dispatcher),
       control_interface_(control_interface),
+      metrics_(metrics),
+      time_(Time::GetInstance()),
       suspend_delay_registered_(false),
       suspend_delay_id_(0),
       dark_suspend_delay_registered_(false),
@@ -57,7 +63,8 @@ PowerManager::PowerManager(EventDispatcher* dispatcher,
       suspending_(false),
       in_dark_resume_(false),
       current_suspend_id_(0),
-      current_dark_suspend_id_(0) {}
+      current_dark_suspend_id_(0),
+      weak_ptr_factory_(this) {}
 
 PowerManager::~PowerManager() {}
 
@@ -88,6 +95,9 @@ void PowerManager::Stop() {
 
   suspend_delay_registered_ = false;
   dark_suspend_delay_registered_ = false;
+  // Replies still in flight would otherwise mark delays as registered with
+  // a powerd that we no longer talk to.
+  weak_ptr_factory_.InvalidateWeakPtrs();
   power_manager_proxy_.reset();
 }
 
@@ -97,14 +107,25 @@ bool PowerManager::ReportSuspendReadiness() {
               << current_suspend_id_ << ") not active. Ignoring signal.";
     return false;
   }
-  return power_manager_proxy_->ReportSuspendReadiness(suspend_delay_id_,
-                                                      current_suspend_id_);
+  struct timeval now;
+  time_->GetTimeMonotonic(&now);
+  power_manager_proxy_->ReportSuspendReadinessAsync(
+      suspend_delay_id_,
+      current_suspend_id_,
+      Bind(&PowerManager::OnSuspendReadinessReported,
+           weak_ptr_factory_.GetWeakPtr(), false, now));
+  return true;
 }
 
 bool PowerManager::ReportDarkSuspendReadiness() {
-  return power_manager_proxy_->ReportDarkSuspendReadiness(
+  struct timeval now;
+  time_->GetTimeMonotonic(&now);
+  power_manager_proxy_->ReportDarkSuspendReadinessAsync(
       dark_suspend_delay_id_,
-      current_dark_suspend_id_);
+      current_dark_suspend_id_,
+      Bind(&PowerManager::OnSuspendReadinessReported,
+           weak_ptr_factory_.GetWeakPtr(), true, now));
+  return true;
 }
 
 bool PowerManager::RecordDarkResumeWakeReason(const string& wake_reason) {
@@ -158,20 +179,25 @@ void PowerManager::OnDarkSuspendImminent(int suspend_id) {
 void PowerManager::OnPowerManagerAppeared() {
   LOG(INFO) << __func__;
   CHECK(!suspend_delay_registered_);
-  if (power_manager_proxy_->RegisterSuspendDelay(suspend_delay_,
-                                                 kSuspendDelayDescription,
-                                                 &suspend_delay_id_))
-    suspend_delay_registered_ = true;
-
-  if (power_manager_proxy_->RegisterDarkSuspendDelay(
+  // Both registrations are in flight at once; each delay counts as
+  // registered once powerd has replied to it.
+  struct timeval now;
+  time_->GetTimeMonotonic(&now);
+  power_manager_proxy_->RegisterSuspendDelayAsync(
+      suspend_delay_,
+      kSuspendDelayDescription,
+      Bind(&PowerManager::OnSuspendDelayRegistered,
+           weak_ptr_factory_.GetWeakPtr(), false, now));
+  power_manager_proxy_->RegisterDarkSuspendDelayAsync(
       suspend_delay_,
       kDarkSuspendDelayDescription,
-      &dark_suspend_delay_id_))
-    dark_suspend_delay_registered_ = true;
+      Bind(&PowerManager::OnSuspendDelayRegistered,
+           weak_ptr_factory_.GetWeakPtr(), true, now));
 }
 
 void PowerManager::OnPowerManagerVanished() {
   LOG(INFO) << __func__;
+  weak_ptr_factory_.InvalidateWeakPtrs();
   // If powerd vanished during a suspend, we need to wake ourselves up.
   if (suspending_)
     OnSuspendDone(kInvalidSuspendId);
@@ -179,4 +205,43 @@ void PowerManager::OnPowerManagerVanished() {
   dark_suspend_delay_registered_ = false;
 }
 
+void PowerManager::OnSuspendDelayRegistered(bool is_dark,
+                                            const struct timeval& start_time,
+                                            const Error& error,
+                                            int delay_id) {
+  metrics_->NotifySuspendDelayRegistered(is_dark,
+                                         GetMillisecondsSince(start_time));
+  if (error.IsFailure()) {
+    LOG(ERROR) << "Failed to register " << (is_dark ? "dark " : "")
+               << "suspend delay: " << error;
+    return;
+  }
+  if (is_dark) {
+    dark_suspend_delay_id_ = delay_id;
+    dark_suspend_delay_registered_ = true;
+  } else {
+    suspend_delay_id_ = delay_id;
+    suspend_delay_registered_ = true;
+  }
+}
+
+void PowerManager::OnSuspendReadinessReported(bool is_dark,
+                                              const struct timeval& start_time,
+                                              const Error& error) {
+  metrics_->NotifySuspendReadinessReported(is_dark,
+                                           GetMillisecondsSince(start_time));
+  if (error.IsFailure()) {
+    LOG(ERROR) << "Failed to report " << (is_dark ? "dark " : "")
+               << "suspend readiness: " << error;
+  }
+}
+
+int PowerManager::GetMillisecondsSince(const struct timeval& start_time) {
+  struct timeval now = { 0, 0 };
+  struct timeval elapsed_time;
+  time_->GetTimeMonotonic(&now);
+  timersub(&now, &start_time, &elapsed_time);
+  return elapsed_time.tv_sec * 1000 + elapsed_time.tv_usec / 1000;
+}
+
 }  // namespace shill
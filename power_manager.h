@@ -21,12 +21,15 @@
 // registered users.  It also provides a means for calling methods on the
 // PowerManagerProxy.
 
+#include <sys/time.h>
+
 #include <map>
 #include <memory>
 #include <string>
 
 #include <base/callback.h>
 #include <base/cancelable_callback.h>
+#include <base/memory/weak_ptr.h>
 
 #include "shill/power_manager_proxy_interface.h"
 
@@ -34,6 +37,9 @@ namespace shill {
 
 class EventDispatcher;
 class ControlInterface;
+class Error;
+class Metrics;
+class Time;
 
 class PowerManager : public PowerManagerProxyDelegate {
  public:
@@ -59,7 +65,8 @@ class PowerManager : public PowerManagerProxyDelegate {
   // |control_itnerface| creates the PowerManagerProxy. Use a fake for testing.
   // Note: |Start| should be called to initialize this object before using it.
   PowerManager(EventDispatcher* dispatcher,
-               ControlInterface* control_interface);
+               ControlInterface* control_interface,
+               Metrics* metrics);
   ~PowerManager() override;
 
   bool suspending() const { return suspending_; }
@@ -81,8 +88,8 @@ class PowerManager : public PowerManagerProxyDelegate {
   virtual void Stop();
 
   // Report suspend readiness. If called when there is no suspend attempt
-  // active, this function will fail. Returns true if sucessfully reported to
-  // powerd.
+  // active, this function will fail. Returns true if the report was sent to
+  // powerd; the call does not wait for powerd to acknowledge it.
   virtual bool ReportSuspendReadiness();
 
   // Report dark suspend readiness. See ReportSuspendReadiness for more details.
@@ -113,8 +120,22 @@ class PowerManager : public PowerManagerProxyDelegate {
   void OnPowerManagerAppeared();
   void OnPowerManagerVanished();
 
+  // Completion handlers for the asynchronous powerd calls. |start_time| is
+  // when the call was made, and is used to record its latency.
+  void OnSuspendDelayRegistered(bool is_dark,
+                                const struct timeval& start_time,
+                                const Error& error,
+                                int delay_id);
+  void OnSuspendReadinessReported(bool is_dark,
+                                  const struct timeval& start_time,
+                                  const Error& error);
+
+  int GetMillisecondsSince(const struct timeval& start_time);
+
   EventDispatcher* dispatcher_;
   ControlInterface* control_interface_;
+  Metrics* metrics_;
+  Time* time_;
 
   // The power manager proxy created by this class.  It dispatches the inherited
   // delegate methods of this object when changes in the power state occur.
@@ -146,6 +167,10 @@ class PowerManager : public PowerManagerProxyDelegate {
   int current_suspend_id_;
   int current_dark_suspend_id_;
 
+  // Invalidated when powerd vanishes, so that replies to calls made to the
+  // previous powerd instance are ignored.
+  base::WeakPtrFactory<PowerManager> weak_ptr_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(PowerManager);
 };
 
@@ -19,8 +19,11 @@
 
 #include <string>
 
+#include <base/callback.h>
 #include <base/time/time.h>
 
+#include "shill/callbacks.h"
+
 namespace shill {
 
 // This class provides events from the power manager.  To use this class, create
@@ -32,6 +35,12 @@ namespace shill {
 // is deleted before the delegate.
 class PowerManagerProxyInterface {
  public:
+  // Callback invoked with the ID assigned to a suspend delay once an
+  // asynchronous registration completes. |delay_id| is only meaningful if
+  // |error| is a success.
+  typedef base::Callback<void(const Error& error, int delay_id)>
+      RegisterSuspendDelayCallback;
+
   virtual ~PowerManagerProxyInterface() {}
 
   // Sends a request to the power manager to wait for this client for up to
@@ -70,6 +79,24 @@ class PowerManagerProxyInterface {
   // Calls the power manager's RecordDarkResumeWakeReason method to record the
   // wake reason for the current dark resume. Returns true on success.
   virtual bool RecordDarkResumeWakeReason(const std::string& wake_reason) = 0;
+
+  // Asynchronous versions of the suspend delay registration and readiness
+  // calls above. The call returns as soon as the request has been sent;
+  // |callback| is run when powerd replies. |callback| is not run if the proxy
+  // is destroyed first.
+  virtual void RegisterSuspendDelayAsync(
+      base::TimeDelta timeout,
+      const std::string& description,
+      const RegisterSuspendDelayCallback& callback) = 0;
+  virtual void ReportSuspendReadinessAsync(int delay_id,
+                                           int suspend_id,
+                                           const ResultCallback& callback) = 0;
+  virtual void RegisterDarkSuspendDelayAsync(
+      base::TimeDelta timeout,
+      const std::string& description,
+      const RegisterSuspendDelayCallback& callback) = 0;
+  virtual void ReportDarkSuspendReadinessAsync(
+      int delay_id, int suspend_id, const ResultCallback& callback) = 0;
 };
 
 // PowerManager signal delegate to be associated with the proxy.
@@ -16,6 +16,8 @@
 
 #include "shill/power_manager_proxy_stub.h"
 
+#include "shill/error.h"
+
 namespace shill {
 
 PowerManagerProxyStub::PowerManagerProxyStub() {}
@@ -64,4 +66,32 @@ bool PowerManagerProxyStub::RecordDarkResumeWakeReason(
   return false;
 }
 
+void PowerManagerProxyStub::RegisterSuspendDelayAsync(
+    base::TimeDelta /*timeout*/,
+    const std::string& /*description*/,
+    const RegisterSuspendDelayCallback& callback) {
+  // STUB IMPLEMENTATION.
+  callback.Run(Error(Error::kNotImplemented), 0);
+}
+
+void PowerManagerProxyStub::ReportSuspendReadinessAsync(
+    int /*delay_id*/, int /*suspend_id*/, const ResultCallback& callback) {
+  // STUB IMPLEMENTATION.
+  callback.Run(Error(Error::kNotImplemented));
+}
+
+void PowerManagerProxyStub::RegisterDarkSuspendDelayAsync(
+    base::TimeDelta /*timeout*/,
+    const std::string& /*description*/,
+    const RegisterSuspendDelayCallback& callback) {
+  // STUB IMPLEMENTATION.
+  callback.Run(Error(Error::kNotImplemented), 0);
+}
+
+void PowerManagerProxyStub::ReportDarkSuspendReadinessAsync(
+    int /*delay_id*/, int /*suspend_id*/, const ResultCallback& callback) {
+  // STUB IMPLEMENTATION.
+  callback.Run(Error(Error::kNotImplemented));
+}
+
 }  // namespace shill
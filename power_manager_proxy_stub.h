@@ -48,6 +48,24 @@ class PowerManagerProxyStub : public PowerManagerProxyInterface {
 
   bool RecordDarkResumeWakeReason(const std::string& wake_reason) override;
 
+  void RegisterSuspendDelayAsync(
+      base::TimeDelta timeout,
+      const std::string& description,
+      const RegisterSuspendDelayCallback& callback) override;
+
+  void ReportSuspendReadinessAsync(int delay_id,
+                                   int suspend_id,
+                                   const ResultCallback& callback) override;
+
+  void RegisterDarkSuspendDelayAsync(
+      base::TimeDelta timeout,
+      const std::string& description,
+      const RegisterSuspendDelayCallback& callback) override;
+
+  void ReportDarkSuspendReadinessAsync(int delay_id,
+                                       int suspend_id,
+                                       const ResultCallback& callback) override;
+
  private:
   DISALLOW_COPY_AND_ASSIGN(PowerManagerProxyStub);
 };
@@ -28,6 +28,7 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include "shill/error.h"
 #include "shill/mock_control.h"
 #include "shill/mock_event_dispatcher.h"
 #include "shill/mock_metrics.h"
@@ -39,12 +40,11 @@ using base::Unretained;
 using std::map;
 using std::string;
 using testing::_;
-using testing::DoAll;
 using testing::IgnoreResult;
 using testing::InvokeWithoutArgs;
 using testing::Mock;
 using testing::Return;
-using testing::SetArgumentPointee;
+using testing::SaveArg;
 using testing::Test;
 
 namespace shill {
@@ -94,7 +94,8 @@ class PowerManagerTest : public Test {
 
   PowerManagerTest()
       : kTimeout(base::TimeDelta::FromSeconds(3)),
-        power_manager_(&dispatcher_, &control_),
+        metrics_(&dispatcher_),
+        power_manager_(&dispatcher_, &control_, &metrics_),
         power_manager_proxy_(control_.power_manager_proxy()),
         delegate_(control_.delegate()) {
     suspend_imminent_callback_ =
@@ -120,11 +121,10 @@ class PowerManagerTest : public Test {
     power_manager_.Stop();
   }
 
-  void AddProxyExpectationForRegisterSuspendDelay(int delay_id,
-                                                  bool return_value) {
+  void AddProxyExpectationForRegisterSuspendDelay() {
     EXPECT_CALL(*power_manager_proxy_,
-                RegisterSuspendDelay(kTimeout, kDescription, _))
-        .WillOnce(DoAll(SetArgumentPointee<2>(delay_id), Return(return_value)));
+                RegisterSuspendDelayAsync(kTimeout, kDescription, _))
+        .WillOnce(SaveArg<2>(&register_suspend_delay_callback_));
   }
 
   void AddProxyExpectationForUnregisterSuspendDelay(int delay_id,
@@ -134,11 +134,10 @@ class PowerManagerTest : public Test {
   }
 
   void AddProxyExpectationForReportSuspendReadiness(int delay_id,
-                                                    int suspend_id,
-                                                    bool return_value) {
+                                                    int suspend_id) {
     EXPECT_CALL(*power_manager_proxy_,
-                ReportSuspendReadiness(delay_id, suspend_id))
-        .WillOnce(Return(return_value));
+                ReportSuspendReadinessAsync(delay_id, suspend_id, _))
+        .WillOnce(SaveArg<2>(&report_suspend_readiness_callback_));
   }
 
   void AddProxyExpectationForRecordDarkResumeWakeReason(
@@ -147,19 +146,17 @@ class PowerManagerTest : public Test {
         .WillOnce(Return(return_value));
   }
 
-  void AddProxyExpectationForRegisterDarkSuspendDelay(int delay_id,
-                                                      bool return_value) {
+  void AddProxyExpectationForRegisterDarkSuspendDelay() {
     EXPECT_CALL(*power_manager_proxy_,
-                RegisterDarkSuspendDelay(kTimeout, kDarkDescription, _))
-        .WillOnce(DoAll(SetArgumentPointee<2>(delay_id), Return(return_value)));
+                RegisterDarkSuspendDelayAsync(kTimeout, kDarkDescription, _))
+        .WillOnce(SaveArg<2>(&register_dark_suspend_delay_callback_));
   }
 
   void AddProxyExpectationForReportDarkSuspendReadiness(int delay_id,
-                                                        int suspend_id,
-                                                        bool return_value) {
+                                                        int suspend_id) {
     EXPECT_CALL(*power_manager_proxy_,
-                ReportDarkSuspendReadiness(delay_id, suspend_id))
-        .WillOnce(Return(return_value));
+                ReportDarkSuspendReadinessAsync(delay_id, suspend_id, _))
+        .WillOnce(SaveArg<2>(&report_dark_suspend_readiness_callback_));
   }
 
   void AddProxyExpectationForUnregisterDarkSuspendDelay(int delay_id,
@@ -168,11 +165,21 @@ class PowerManagerTest : public Test {
         .WillOnce(Return(return_value));
   }
 
+  // Has powerd accept both of the suspend delays that were registered when
+  // it appeared, with |delay_id|.
+  void ReplyToRegisterSuspendDelays(int delay_id) {
+    ASSERT_FALSE(register_suspend_delay_callback_.is_null());
+    ASSERT_FALSE(register_dark_suspend_delay_callback_.is_null());
+    register_suspend_delay_callback_.Run(Error(), delay_id);
+    register_dark_suspend_delay_callback_.Run(Error(), delay_id);
+  }
+
   void RegisterSuspendDelays() {
-    AddProxyExpectationForRegisterSuspendDelay(kDelayId, true);
-    AddProxyExpectationForRegisterDarkSuspendDelay(kDelayId, true);
+    AddProxyExpectationForRegisterSuspendDelay();
+    AddProxyExpectationForRegisterDarkSuspendDelay();
     OnPowerManagerAppeared();
     Mock::VerifyAndClearExpectations(power_manager_proxy_);
+    ReplyToRegisterSuspendDelays(kDelayId);
   }
 
   void OnSuspendImminent(int suspend_id) {
@@ -197,17 +204,32 @@ class PowerManagerTest : public Test {
     power_manager_.OnPowerManagerVanished();
   }
 
+  bool suspend_delay_registered() const {
+    return power_manager_.suspend_delay_registered_;
+  }
+
+  bool dark_suspend_delay_registered() const {
+    return power_manager_.dark_suspend_delay_registered_;
+  }
+
   // This is non-static since it's a non-POD type.
   const base::TimeDelta kTimeout;
 
   MockEventDispatcher dispatcher_;
   FakeControl control_;
+  MockMetrics metrics_;
   PowerManager power_manager_;
   MockPowerManagerProxy* const power_manager_proxy_;
   PowerManagerProxyDelegate* const delegate_;
   PowerManager::SuspendImminentCallback suspend_imminent_callback_;
   PowerManager::SuspendDoneCallback suspend_done_callback_;
   PowerManager::DarkSuspendImminentCallback dark_suspend_imminent_callback_;
+  PowerManagerProxyInterface::RegisterSuspendDelayCallback
+      register_suspend_delay_callback_;
+  PowerManagerProxyInterface::RegisterSuspendDelayCallback
+      register_dark_suspend_delay_callback_;
+  ResultCallback report_suspend_readiness_callback_;
+  ResultCallback report_dark_suspend_readiness_callback_;
 };
 
 const char PowerManagerTest::kDescription[] = "shill";
@@ -225,9 +247,13 @@ TEST_F(PowerManagerTest, SuspendingState) {
 }
 
 TEST_F(PowerManagerTest, RegisterSuspendDelayFailure) {
-  AddProxyExpectationForRegisterSuspendDelay(kDelayId, false);
+  AddProxyExpectationForRegisterSuspendDelay();
+  AddProxyExpectationForRegisterDarkSuspendDelay();
   OnPowerManagerAppeared();
   Mock::VerifyAndClearExpectations(power_manager_proxy_);
+  register_suspend_delay_callback_.Run(Error(Error::kOperationFailed),
+                                       kDelayId);
+  EXPECT_FALSE(suspend_delay_registered());
 
   // Outstanding shill callbacks should still be invoked.
   // - suspend_done_callback: If powerd died in the middle of a suspend
@@ -248,9 +274,13 @@ TEST_F(PowerManagerTest, RegisterSuspendDelayFailure) {
 }
 
 TEST_F(PowerManagerTest, RegisterDarkSuspendDelayFailure) {
-  AddProxyExpectationForRegisterDarkSuspendDelay(kDelayId, false);
+  AddProxyExpectationForRegisterSuspendDelay();
+  AddProxyExpectationForRegisterDarkSuspendDelay();
   OnPowerManagerAppeared();
   Mock::VerifyAndClearExpectations(power_manager_proxy_);
+  register_dark_suspend_delay_callback_.Run(Error(Error::kOperationFailed),
+                                            kDelayId);
+  EXPECT_FALSE(dark_suspend_delay_registered());
 
   // Outstanding dark suspend imminent signal should be ignored, since we
   // probably won't have time to cleanly do dark resume actions. Might as well
@@ -259,12 +289,78 @@ TEST_F(PowerManagerTest, RegisterDarkSuspendDelayFailure) {
   OnDarkSuspendImminent(kSuspendId1);
 }
 
+TEST_F(PowerManagerTest, RegisterSuspendDelaysAsync) {
+  PowerManagerProxyInterface::RegisterSuspendDelayCallback callback;
+  PowerManagerProxyInterface::RegisterSuspendDelayCallback dark_callback;
+  EXPECT_CALL(*power_manager_proxy_,
+              RegisterSuspendDelayAsync(kTimeout, kDescription, _))
+      .WillOnce(SaveArg<2>(&callback));
+  EXPECT_CALL(*power_manager_proxy_,
+              RegisterDarkSuspendDelayAsync(kTimeout, kDarkDescription, _))
+      .WillOnce(SaveArg<2>(&dark_callback));
+  OnPowerManagerAppeared();
+
+  // Both requests are outstanding; neither delay counts until powerd replies.
+  ASSERT_FALSE(callback.is_null());
+  ASSERT_FALSE(dark_callback.is_null());
+  EXPECT_FALSE(suspend_delay_registered());
+  EXPECT_FALSE(dark_suspend_delay_registered());
+
+  EXPECT_CALL(metrics_, NotifySuspendDelayRegistered(false, _));
+  callback.Run(Error(), kDelayId);
+  EXPECT_TRUE(suspend_delay_registered());
+  Mock::VerifyAndClearExpectations(&metrics_);
+
+  // A reply from a powerd instance that has since gone away is ignored.
+  OnPowerManagerVanished();
+  EXPECT_CALL(metrics_, NotifySuspendDelayRegistered(_, _)).Times(0);
+  dark_callback.Run(Error(), kDelayId);
+  EXPECT_FALSE(dark_suspend_delay_registered());
+}
+
+TEST_F(PowerManagerTest, RegisterSuspendDelaysReplyAfterStop) {
+  AddProxyExpectationForRegisterSuspendDelay();
+  AddProxyExpectationForRegisterDarkSuspendDelay();
+  OnPowerManagerAppeared();
+  power_manager_.Stop();
+
+  // Replies that arrive after shutdown must not mark either delay as
+  // registered, or the next Stop() would try to unregister it.
+  EXPECT_CALL(metrics_, NotifySuspendDelayRegistered(_, _)).Times(0);
+  ReplyToRegisterSuspendDelays(kDelayId);
+  EXPECT_FALSE(suspend_delay_registered());
+  EXPECT_FALSE(dark_suspend_delay_registered());
+}
+
 TEST_F(PowerManagerTest, ReportSuspendReadinessFailure) {
   RegisterSuspendDelays();
   EXPECT_CALL(*this, SuspendImminentAction());
   OnSuspendImminent(kSuspendId1);
-  AddProxyExpectationForReportSuspendReadiness(kDelayId, kSuspendId1, false);
-  EXPECT_FALSE(power_manager_.ReportSuspendReadiness());
+  AddProxyExpectationForReportSuspendReadiness(kDelayId, kSuspendId1);
+  EXPECT_TRUE(power_manager_.ReportSuspendReadiness());
+
+  // The report is sent without waiting for powerd, so a failed reply is only
+  // logged and recorded.
+  ASSERT_FALSE(report_suspend_readiness_callback_.is_null());
+  EXPECT_CALL(metrics_, NotifySuspendReadinessReported(false, _));
+  report_suspend_readiness_callback_.Run(Error(Error::kOperationFailed));
+  EXPECT_TRUE(power_manager_.suspending());
+}
+
+TEST_F(PowerManagerTest, ReportSuspendReadinessReplyAfterPowerManagerVanished) {
+  RegisterSuspendDelays();
+  EXPECT_CALL(*this, SuspendImminentAction());
+  OnSuspendImminent(kSuspendId1);
+  AddProxyExpectationForReportSuspendReadiness(kDelayId, kSuspendId1);
+  EXPECT_TRUE(power_manager_.ReportSuspendReadiness());
+
+  EXPECT_CALL(*this, SuspendDoneAction());
+  OnPowerManagerVanished();
+
+  // The reply comes from a powerd instance that has gone away.
+  ASSERT_FALSE(report_suspend_readiness_callback_.is_null());
+  EXPECT_CALL(metrics_, NotifySuspendReadinessReported(_, _)).Times(0);
+  report_suspend_readiness_callback_.Run(Error());
 }
 
 TEST_F(PowerManagerTest, RecordDarkResumeWakeReasonFailure) {
@@ -289,14 +385,18 @@ TEST_F(PowerManagerTest, ReportDarkSuspendReadinessFailure) {
   RegisterSuspendDelays();
   EXPECT_CALL(*this, DarkSuspendImminentAction());
   OnDarkSuspendImminent(kSuspendId1);
-  AddProxyExpectationForReportDarkSuspendReadiness(kDelayId, kSuspendId1,
-                                                   false);
-  EXPECT_FALSE(power_manager_.ReportDarkSuspendReadiness());
+  AddProxyExpectationForReportDarkSuspendReadiness(kDelayId, kSuspendId1);
+  EXPECT_TRUE(power_manager_.ReportDarkSuspendReadiness());
+
+  ASSERT_FALSE(report_dark_suspend_readiness_callback_.is_null());
+  EXPECT_CALL(metrics_, NotifySuspendReadinessReported(true, _));
+  report_dark_suspend_readiness_callback_.Run(Error(Error::kOperationFailed));
 }
 
 TEST_F(PowerManagerTest, ReportSuspendReadinessFailsOutsideSuspend) {
   RegisterSuspendDelays();
-  EXPECT_CALL(*power_manager_proxy_, ReportSuspendReadiness(_, _)).Times(0);
+  EXPECT_CALL(*power_manager_proxy_, ReportSuspendReadinessAsync(_, _, _))
+      .Times(0);
   EXPECT_FALSE(power_manager_.ReportSuspendReadiness());
 }
 
@@ -304,24 +404,30 @@ TEST_F(PowerManagerTest, ReportSuspendReadinessSynchronous) {
   // Verifies that a synchronous ReportSuspendReadiness call by shill on a
   // SuspendImminent callback is routed back to powerd.
   RegisterSuspendDelays();
-  EXPECT_CALL(*power_manager_proxy_, ReportSuspendReadiness(_, _))
-      .WillOnce(Return(true));
+  AddProxyExpectationForReportSuspendReadiness(kDelayId, kSuspendId1);
   EXPECT_CALL(*this, SuspendImminentAction())
       .WillOnce(IgnoreResult(InvokeWithoutArgs(
           &power_manager_, &PowerManager::ReportSuspendReadiness)));
   OnSuspendImminent(kSuspendId1);
+
+  ASSERT_FALSE(report_suspend_readiness_callback_.is_null());
+  EXPECT_CALL(metrics_, NotifySuspendReadinessReported(false, _));
+  report_suspend_readiness_callback_.Run(Error());
 }
 
 TEST_F(PowerManagerTest, ReportDarkSuspendReadinessSynchronous) {
   // Verifies that a synchronous ReportDarkSuspendReadiness call by shill on a
   // DarkSuspendImminent callback is routed back to powerd.
   RegisterSuspendDelays();
-  EXPECT_CALL(*power_manager_proxy_, ReportDarkSuspendReadiness(_, _))
-      .WillOnce(Return(true));
+  AddProxyExpectationForReportDarkSuspendReadiness(kDelayId, kSuspendId1);
   EXPECT_CALL(*this, DarkSuspendImminentAction())
       .WillOnce(IgnoreResult(InvokeWithoutArgs(
           &power_manager_, &PowerManager::ReportDarkSuspendReadiness)));
   OnDarkSuspendImminent(kSuspendId1);
+
+  ASSERT_FALSE(report_dark_suspend_readiness_callback_.is_null());
+  EXPECT_CALL(metrics_, NotifySuspendReadinessReported(true, _));
+  report_dark_suspend_readiness_callback_.Run(Error());
 }
 
 TEST_F(PowerManagerTest, Stop) {
@@ -349,17 +455,18 @@ TEST_F(PowerManagerTest, OnPowerManagerReappeared) {
   RegisterSuspendDelays();
 
   // Check that we re-register suspend delay on powerd restart.
-  AddProxyExpectationForRegisterSuspendDelay(kDelayId2, true);
-  AddProxyExpectationForRegisterDarkSuspendDelay(kDelayId2, true);
+  AddProxyExpectationForRegisterSuspendDelay();
+  AddProxyExpectationForRegisterDarkSuspendDelay();
   OnPowerManagerVanished();
   OnPowerManagerAppeared();
   Mock::VerifyAndClearExpectations(power_manager_proxy_);
+  ReplyToRegisterSuspendDelays(kDelayId2);
 
   // Check that a |ReportSuspendReadiness| message is sent with the new delay
   // id.
   EXPECT_CALL(*this, SuspendImminentAction());
   OnSuspendImminent(kSuspendId1);
-  AddProxyExpectationForReportSuspendReadiness(kDelayId2, kSuspendId1, true);
+  AddProxyExpectationForReportSuspendReadiness(kDelayId2, kSuspendId1);
   EXPECT_TRUE(power_manager_.ReportSuspendReadiness());
   Mock::VerifyAndClearExpectations(power_manager_proxy_);
 
@@ -367,8 +474,7 @@ TEST_F(PowerManagerTest, OnPowerManagerReappeared) {
   // delay id.
   EXPECT_CALL(*this, DarkSuspendImminentAction());
   OnDarkSuspendImminent(kSuspendId1);
-  AddProxyExpectationForReportDarkSuspendReadiness(kDelayId2, kSuspendId1,
-                                                   true);
+  AddProxyExpectationForReportDarkSuspendReadiness(kDelayId2, kSuspendId1);
   EXPECT_TRUE(power_manager_.ReportDarkSuspendReadiness());
 }
 
@@ -389,11 +495,12 @@ TEST_F(PowerManagerTest, PowerManagerReappearedInSuspend) {
   OnSuspendImminent(kSuspendId1);
   Mock::VerifyAndClearExpectations(this);
 
-  AddProxyExpectationForRegisterSuspendDelay(kDelayId2, true);
-  AddProxyExpectationForRegisterDarkSuspendDelay(kDelayId2, true);
+  AddProxyExpectationForRegisterSuspendDelay();
+  AddProxyExpectationForRegisterDarkSuspendDelay();
   EXPECT_CALL(*this, SuspendDoneAction());
   OnPowerManagerVanished();
   OnPowerManagerAppeared();
+  ReplyToRegisterSuspendDelays(kDelayId2);
   EXPECT_FALSE(power_manager_.suspending());
   Mock::VerifyAndClearExpectations(this);
 
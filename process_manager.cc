@@ -82,6 +82,17 @@ void ProcessManager::Init(EventDispatcher* dispatcher) {
 void ProcessManager::Stop() {
   SLOG(this, 2) << __func__;
   CHECK(async_signal_handler_);
+  // Finish stopping any process that StopProcessAsync() left running, since
+  // the timers that would escalate to SIGKILL won't fire any more.  Nobody is
+  // left to act on the completion callbacks.
+  vector<pid_t> stopping_pids;
+  for (const auto& termination_callback : termination_callbacks_) {
+    stopping_pids.push_back(termination_callback.first);
+  }
+  termination_callbacks_.clear();
+  for (pid_t pid : stopping_pids) {
+    StopProcessAndBlock(pid);
+  }
   process_reaper_.Unregister();
   async_signal_handler_.reset();
 }
@@ -198,6 +209,23 @@ bool ProcessManager::StopProcess(pid_t pid) {
   return TerminateProcess(pid, false);
 }
 
+bool ProcessManager::StopProcessAsync(pid_t pid,
+                                      const base::Closure& callback) {
+  SLOG(this, 2) << __func__ << "(" << pid << ")";
+
+  if (!StopProcess(pid)) {
+    return false;
+  }
+  if (pending_termination_processes_.find(pid) ==
+      pending_termination_processes_.end()) {
+    // The process was already gone.
+    dispatcher_->PostTask(callback);
+  } else {
+    termination_callbacks_[pid] = callback;
+  }
+  return true;
+}
+
 bool ProcessManager::StopProcessAndBlock(pid_t pid) {
   SLOG(this, 2) << __func__ << "(" << pid << ")";
 
@@ -224,15 +252,16 @@ bool ProcessManager::StopProcessAndBlock(pid_t pid) {
 
   // Try SIGTERM firstly.
   // Send SIGKILL signal if SIGTERM was not handled in a timely manner.
-  if (KillProcessWithTimeout(pid, false) ||
-      KillProcessWithTimeout(pid, true)) {
-    return true;
+  bool killed = KillProcessWithTimeout(pid, false) ||
+      KillProcessWithTimeout(pid, true);
+  if (!killed) {
+    // In case of killing failure.
+    LOG(ERROR) << "Timeout waiting for process " << pid << " to be killed.";
   }
 
-  // In case of killing failure.
-  LOG(ERROR) << "Timeout waiting for process " << pid << " to be killed.";
-
-  return false;
+  // Someone may have been waiting on an asynchronous stop of this process.
+  RunTerminationCallback(pid);
+  return killed;
 }
 
 bool ProcessManager::KillProcessWithTimeout(pid_t pid, bool kill_signal) {
@@ -321,6 +350,7 @@ void ProcessManager::OnProcessExited(pid_t pid, const siginfo_t& info) {
   if (terminated_process != pending_termination_processes_.end()) {
     terminated_process->second->Cancel();
     pending_termination_processes_.erase(terminated_process);
+    RunTerminationCallback(pid);
     return;
   }
 
@@ -337,11 +367,18 @@ void ProcessManager::ProcessTerminationTimeoutHandler(pid_t pid,
   // Process still not killed after SIGKILL signal.
   if (kill_signal) {
     LOG(ERROR) << "Timeout waiting for process " << pid << " to be killed.";
+    RunTerminationCallback(pid);
     return;
   }
 
   // Retry using SIGKILL signal.
-  TerminateProcess(pid, true);
+  if (!TerminateProcess(pid, true) ||
+      pending_termination_processes_.find(pid) ==
+          pending_termination_processes_.end()) {
+    // Either SIGKILL could not be sent or the process is already gone;
+    // there is nothing left to wait for.
+    RunTerminationCallback(pid);
+  }
 }
 
 bool ProcessManager::TerminateProcess(pid_t pid, bool kill_signal) {
@@ -369,4 +406,14 @@ bool ProcessManager::TerminateProcess(pid_t pid, bool kill_signal) {
   return true;
 }
 
+void ProcessManager::RunTerminationCallback(pid_t pid) {
+  auto termination_callback = termination_callbacks_.find(pid);
+  if (termination_callback == termination_callbacks_.end()) {
+    return;
+  }
+  base::Closure callback = termination_callback->second;
+  termination_callbacks_.erase(termination_callback);
+  callback.Run();
+}
+
 }  // namespace shill
@@ -48,7 +48,8 @@ class ProcessManager {
   // Register async signal handler and setup process reaper.
   virtual void Init(EventDispatcher* dispatcher);
 
-  // Call on shutdown to release async_signal_handler_.
+  // Call on shutdown to release async_signal_handler_.  Processes still being
+  // stopped by StopProcessAsync() are stopped synchronously first.
   virtual void Stop();
 
   // Create and start a process for |program| with |arguments|. |enivronment|
@@ -111,6 +112,12 @@ class ProcessManager {
   // time.
   virtual bool StopProcess(pid_t pid);
 
+  // Same as StopProcess(), but |callback| is invoked once |pid| has been
+  // reaped, or once ProcessManager gives up waiting for it after SIGKILL.
+  // Unlike StopProcessAndBlock(), this never blocks the event loop.  Returns
+  // false, without invoking |callback|, if |pid| could not be stopped.
+  virtual bool StopProcessAsync(pid_t pid, const base::Closure& callback);
+
   // Stop the given |pid| in a synchronous manner.
   virtual bool StopProcessAndBlock(pid_t pid);
 
@@ -143,6 +150,9 @@ class ProcessManager {
   // list, to make sure process |pid| does exit in timely manner.
   bool TerminateProcess(pid_t pid, bool kill_signal);
 
+  // Run and forget the StopProcessAsync() callback for |pid|, if any.
+  void RunTerminationCallback(pid_t pid);
+
   // Kill process |pid|. If |kill_signal| is true it will send SIGKILL,
   // otherwise it will send SIGTERM.
   // It returns true when the process was already dead or killed within
@@ -179,6 +189,8 @@ class ProcessManager {
   // does exit, log an error if it failed to exit within a specific timeout.
   std::map<pid_t, std::unique_ptr<TerminationTimeoutCallback>>
       pending_termination_processes_;
+  // Callbacks to run when processes stopped by StopProcessAsync() are gone.
+  std::map<pid_t, base::Closure> termination_callbacks_;
 
   base::WeakPtrFactory<ProcessManager> weak_factory_{this};
   DISALLOW_COPY_AND_ASSIGN(ProcessManager);
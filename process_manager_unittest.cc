@@ -53,6 +53,7 @@ class ProcessManagerTest : public testing::Test {
   virtual void TearDown() {
     process_manager_->watched_processes_.clear();
     process_manager_->pending_termination_processes_.clear();
+    process_manager_->termination_callbacks_.clear();
   }
 
   void AddWatchedProcess(pid_t pid, const Callback<void(int)>& callback) {
@@ -65,6 +66,14 @@ class ProcessManagerTest : public testing::Test {
         pid, std::move(timeout_handler));
   }
 
+  void AddTerminationCallback(pid_t pid, const Closure& callback) {
+    process_manager_->termination_callbacks_.emplace(pid, callback);
+  }
+
+  void AssertEmptyTerminationCallbacks() {
+    EXPECT_TRUE(process_manager_->termination_callbacks_.empty());
+  }
+
   void AssertEmptyWatchedProcesses() {
     EXPECT_TRUE(process_manager_->watched_processes_.empty());
   }
@@ -95,14 +104,18 @@ class ProcessManagerTest : public testing::Test {
               Bind(&CallbackObserver::OnProcessExited, Unretained(this))),
           termination_timeout_callback_(
               Bind(&CallbackObserver::OnTerminationTimeout,
-                   Unretained(this))) {}
+                   Unretained(this))),
+          terminated_callback_(
+              Bind(&CallbackObserver::OnTerminated, Unretained(this))) {}
     virtual ~CallbackObserver() {}
 
     MOCK_METHOD1(OnProcessExited, void(int exit_status));
     MOCK_METHOD0(OnTerminationTimeout, void());
+    MOCK_METHOD0(OnTerminated, void());
 
     Callback<void(int)> exited_callback_;
     Closure termination_timeout_callback_;
+    Closure terminated_callback_;
   };
 
   MockEventDispatcher dispatcher_;
@@ -146,6 +159,46 @@ TEST_F(ProcessManagerTest, TerminateProcessExited) {
   AssertEmptyTerminateProcesses();
 }
 
+TEST_F(ProcessManagerTest, TerminateProcessExitedRunsCallback) {
+  const pid_t kPid = 123;
+  CallbackObserver observer;
+  std::unique_ptr<CancelableClosure> timeout_handler(
+      new CancelableClosure(observer.termination_timeout_callback_));
+  AddTerminateProcess(kPid, std::move(timeout_handler));
+  AddTerminationCallback(kPid, observer.terminated_callback_);
+
+  EXPECT_CALL(observer, OnTerminationTimeout()).Times(0);
+  EXPECT_CALL(observer, OnTerminated()).Times(1);
+  OnProcessExited(kPid, 1);
+  AssertEmptyTerminateProcesses();
+  AssertEmptyTerminationCallbacks();
+}
+
+TEST_F(ProcessManagerTest, KillTimeoutRunsTerminationCallback) {
+  const pid_t kPid = 123;
+  CallbackObserver observer;
+  std::unique_ptr<CancelableClosure> timeout_handler(
+      new CancelableClosure(observer.termination_timeout_callback_));
+  AddTerminateProcess(kPid, std::move(timeout_handler));
+  AddTerminationCallback(kPid, observer.terminated_callback_);
+
+  // ProcessManager gives up after SIGKILL, and lets the caller move on.
+  EXPECT_CALL(observer, OnTerminated()).Times(1);
+  OnTerminationTimeout(kPid, true);
+  AssertEmptyTerminateProcesses();
+  AssertEmptyTerminationCallbacks();
+}
+
+TEST_F(ProcessManagerTest, StopProcessAsyncUnwatchedProcess) {
+  const pid_t kPid = 123;
+  CallbackObserver observer;
+  EXPECT_CALL(observer, OnTerminated()).Times(0);
+  EXPECT_CALL(dispatcher_, PostTask(_)).Times(0);
+  EXPECT_FALSE(process_manager_->StopProcessAsync(
+      kPid, observer.terminated_callback_));
+  AssertEmptyTerminationCallbacks();
+}
+
 TEST_F(ProcessManagerTest,
        StartProcessInMinijailWithPipesReturnsPidAndWatchesChild) {
   const string kProgram = "/usr/bin/dump";
@@ -67,7 +67,9 @@ Profile::Profile(ControlInterface* control_interface,
     : metrics_(metrics),
       manager_(manager),
       control_interface_(control_interface),
-      name_(name) {
+      name_(name),
+      batch_update_in_progress_(false),
+      batch_update_needs_flush_(false) {
   if (connect_to_rpc)
     adaptor_.reset(control_interface->CreateProfileAdaptor(this));
 
@@ -192,18 +194,18 @@ bool Profile::AdoptService(const ServiceRefPtr& service) {
     return false;
   }
   service->SetProfile(this);
-  return service->Save(storage_.get()) && storage_->Flush();
+  return service->Save(storage_.get()) && FlushStorage();
 }
 
 bool Profile::AbandonService(const ServiceRefPtr& service) {
   if (service->profile() == this)
     service->SetProfile(nullptr);
   return storage_->DeleteGroup(service->GetStorageIdentifier()) &&
-      storage_->Flush();
+      FlushStorage();
 }
 
 bool Profile::UpdateService(const ServiceRefPtr& service) {
-  return service->Save(storage_.get()) && storage_->Flush();
+  return service->Save(storage_.get()) && FlushStorage();
 }
 
 bool Profile::LoadService(const ServiceRefPtr& service) {
@@ -381,6 +383,27 @@ bool Profile::Save() {
   return storage_->Flush();
 }
 
+void Profile::BeginBatchUpdate() {
+  batch_update_in_progress_ = true;
+}
+
+bool Profile::EndBatchUpdate() {
+  batch_update_in_progress_ = false;
+  if (!batch_update_needs_flush_) {
+    return true;
+  }
+  batch_update_needs_flush_ = false;
+  return storage_->Flush();
+}
+
+bool Profile::FlushStorage() {
+  if (batch_update_in_progress_) {
+    batch_update_needs_flush_ = true;
+    return true;
+  }
+  return storage_->Flush();
+}
+
 vector<string> Profile::EnumerateAvailableServices(Error* error) {
   // We should return the Manager's service list if this is the active profile.
   if (manager_->IsActiveProfile(this)) {
@@ -166,6 +166,13 @@ class Profile : public base::RefCounted<Profile> {
   // Write all in-memory state to disk via |storage_|.
   virtual bool Save();
 
+  // Between BeginBatchUpdate() and EndBatchUpdate(), service changes made
+  // through this profile are written to |storage_| but not flushed to disk.
+  // EndBatchUpdate() flushes once if anything changed, and returns false if
+  // that flush failed.
+  virtual void BeginBatchUpdate();
+  virtual bool EndBatchUpdate();
+
   // Parses a profile identifier. There're two acceptable forms of the |raw|
   // identifier: "identifier" and "~user/identifier". Both "user" and
   // "identifier" must be suitable for use in a D-Bus object path. Returns true
@@ -240,6 +247,10 @@ class Profile : public base::RefCounted<Profile> {
 
   static bool IsValidIdentifierToken(const std::string& token);
 
+  // Flushes |storage_| to disk, or defers the flush if a batch update is in
+  // progress.
+  bool FlushStorage();
+
   void HelpRegisterConstDerivedStrings(
       const std::string& name,
       Strings(Profile::*get)(Error* error));
@@ -260,6 +271,9 @@ class Profile : public base::RefCounted<Profile> {
   // Allows this profile to be backed with on-disk storage.
   std::unique_ptr<StoreInterface> storage_;
 
+  bool batch_update_in_progress_;
+  bool batch_update_needs_flush_;
+
   std::unique_ptr<ProfileAdaptorInterface> adaptor_;
 
   DISALLOW_COPY_AND_ASSIGN(Profile);
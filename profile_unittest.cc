@@ -302,6 +302,42 @@ TEST_F(ProfileTest, Save) {
   profile_->Save();
 }
 
+TEST_F(ProfileTest, BatchUpdate) {
+  MockStore* storage(new StrictMock<MockStore>());
+  profile_->storage_.reset(storage);  // Passes ownership
+  scoped_refptr<MockService> service1(CreateMockService());
+  scoped_refptr<MockService> service2(CreateMockService());
+  EXPECT_CALL(*service1.get(), Save(storage)).WillRepeatedly(Return(true));
+  EXPECT_CALL(*service2.get(), Save(storage)).WillRepeatedly(Return(true));
+
+  // Nothing changed, so ending the batch does not touch the disk.
+  EXPECT_CALL(*storage, Flush()).Times(0);
+  profile_->BeginBatchUpdate();
+  EXPECT_TRUE(profile_->EndBatchUpdate());
+  Mock::VerifyAndClearExpectations(storage);
+
+  // Several changes within a batch are flushed exactly once.
+  profile_->BeginBatchUpdate();
+  EXPECT_TRUE(profile_->AdoptService(service1));
+  EXPECT_TRUE(profile_->AdoptService(service2));
+  EXPECT_TRUE(profile_->UpdateService(service1));
+  Mock::VerifyAndClearExpectations(storage);
+  EXPECT_CALL(*storage, Flush()).WillOnce(Return(true));
+  EXPECT_TRUE(profile_->EndBatchUpdate());
+  Mock::VerifyAndClearExpectations(storage);
+
+  // A failed flush is reported by EndBatchUpdate().
+  profile_->BeginBatchUpdate();
+  EXPECT_TRUE(profile_->UpdateService(service2));
+  EXPECT_CALL(*storage, Flush()).WillOnce(Return(false));
+  EXPECT_FALSE(profile_->EndBatchUpdate());
+  Mock::VerifyAndClearExpectations(storage);
+
+  // Outside of a batch, every change is flushed immediately.
+  EXPECT_CALL(*storage, Flush()).WillOnce(Return(true));
+  EXPECT_TRUE(profile_->UpdateService(service1));
+}
+
 TEST_F(ProfileTest, EntryEnumeration) {
   scoped_refptr<MockService> service1(CreateMockService());
   scoped_refptr<MockService> service2(CreateMockService());
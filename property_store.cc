@@ -235,6 +235,54 @@ bool PropertyStore::GetProperties(brillo::VariantDictionary* out,
   return true;
 }
 
+bool PropertyStore::GetSelectedProperties(const vector<string>& names,
+                                          brillo::VariantDictionary* out,
+                                          Error* /*error*/) const {
+  for (const auto& name : names) {
+    if (InsertReadableProperty(name, bool_properties_, out) ||
+        InsertReadableProperty(name, int16_properties_, out) ||
+        InsertReadableProperty(name, int32_properties_, out) ||
+        InsertReadableProperty(name, string_properties_, out) ||
+        InsertReadableProperty(name, stringmap_properties_, out) ||
+        InsertReadableProperty(name, stringmaps_properties_, out) ||
+        InsertReadableProperty(name, strings_properties_, out) ||
+        InsertReadableProperty(name, uint8_properties_, out) ||
+        InsertReadableProperty(name, bytearray_properties_, out) ||
+        InsertReadableProperty(name, uint16_properties_, out) ||
+        InsertReadableProperty(name, uint16s_properties_, out) ||
+        InsertReadableProperty(name, uint32_properties_, out) ||
+        InsertReadableProperty(name, uint64_properties_, out)) {
+      continue;
+    }
+
+    // The remaining types are converted the same way GetProperties() does.
+    RpcIdentifier rpc_identifier;
+    if (GetReadableProperty(name, rpc_identifier_properties_,
+                            &rpc_identifier)) {
+      (*out)[name] = brillo::Any(dbus::ObjectPath(rpc_identifier));
+      continue;
+    }
+    RpcIdentifiers rpc_identifiers;
+    if (GetReadableProperty(name, rpc_identifiers_properties_,
+                            &rpc_identifiers)) {
+      vector<dbus::ObjectPath> rpc_identifiers_as_paths;
+      for (const auto& path : rpc_identifiers) {
+        rpc_identifiers_as_paths.push_back(dbus::ObjectPath(path));
+      }
+      (*out)[name] = brillo::Any(rpc_identifiers_as_paths);
+      continue;
+    }
+    KeyValueStore key_value_store;
+    if (GetReadableProperty(name, key_value_store_properties_,
+                            &key_value_store)) {
+      brillo::VariantDictionary dict;
+      KeyValueStore::ConvertToVariantDictionary(key_value_store, &dict);
+      (*out)[name] = brillo::Any(dict);
+    }
+  }
+  return true;
+}
+
 bool PropertyStore::GetBoolProperty(const string& name,
                                     bool* value,
                                     Error* error) const {
@@ -921,6 +969,37 @@ bool PropertyStore::GetProperty(
   return error->IsSuccess();
 }
 
+template <class V>
+bool PropertyStore::GetReadableProperty(
+    const string& name,
+    const map<string, std::shared_ptr<AccessorInterface<V>>>& collection,
+    V* value) const {
+  auto it = collection.find(name);
+  if (it == collection.end()) {
+    return false;
+  }
+  Error error;
+  V val = it->second->Get(&error);
+  if (!error.IsSuccess()) {
+    return false;
+  }
+  *value = val;
+  return true;
+}
+
+template <class V>
+bool PropertyStore::InsertReadableProperty(
+    const string& name,
+    const map<string, std::shared_ptr<AccessorInterface<V>>>& collection,
+    brillo::VariantDictionary* out) const {
+  V value;
+  if (!GetReadableProperty(name, collection, &value)) {
+    return false;
+  }
+  (*out)[name] = brillo::Any(value);
+  return true;
+}
+
 template <class V>
 bool PropertyStore::SetProperty(
     const string& name,
@@ -52,6 +52,14 @@ class PropertyStore {
   // (std::map<std::string, brillo::Any>).
   bool GetProperties(brillo::VariantDictionary* out, Error* error) const;
 
+  // Like GetProperties(), but only retrieves the properties named in
+  // |names|.  Names that do not exist in this store, or are not readable,
+  // are skipped.  Accessors for properties that were not asked for are
+  // never invoked.
+  bool GetSelectedProperties(const std::vector<std::string>& names,
+                             brillo::VariantDictionary* out,
+                             Error* error) const;
+
   // Methods to allow the getting of properties stored in the referenced
   // |store_| by name. Upon success, these methods return true and return the
   // property value in |value|. Upon failure, they return false and
@@ -277,6 +285,23 @@ class PropertyStore {
                      std::shared_ptr<AccessorInterface<V>>>& collection,
       const std::string& value_type_english) const;
 
+  // Looks up |name| in |collection| alone, returning false without
+  // populating an error if it is not there or cannot be read.
+  template <class V>
+  bool GetReadableProperty(
+      const std::string& name,
+      const std::map<std::string,
+                     std::shared_ptr<AccessorInterface<V>>>& collection,
+      V* value) const;
+
+  // Adds the value of |name| from |collection| to |out|, if readable.
+  template <class V>
+  bool InsertReadableProperty(
+      const std::string& name,
+      const std::map<std::string,
+                     std::shared_ptr<AccessorInterface<V>>>& collection,
+      brillo::VariantDictionary* out) const;
+
   template <class V>
   bool SetProperty(
       const std::string& name,
@@ -44,6 +44,7 @@ using std::map;
 using std::string;
 using std::vector;
 using ::testing::_;
+using ::testing::Mock;
 using ::testing::Return;
 using ::testing::Values;
 
@@ -832,4 +833,45 @@ TEST_F(PropertyStoreTest, SetAndGetProperties) {
   EXPECT_EQ(new_uint32_value, result_dict[kUint32Key].Get<uint32_t>());
 }
 
+TEST_F(PropertyStoreTest, GetSelectedProperties) {
+  PropertyStore store;
+  const string kBoolKey = "boolp";
+  const string kKeyValueStoreKey = "keyvaluestorep";
+  const string kStringKey = "stringp";
+  const string kWriteOnlyKey = "writeonlyp";
+  bool bool_value = true;
+  string string_value = "string";
+  store.RegisterBool(kBoolKey, &bool_value);
+  store.RegisterString(kStringKey, &string_value);
+  store.RegisterWriteOnlyString(kWriteOnlyKey, &string_value);
+  store.RegisterDerivedKeyValueStore(
+      kKeyValueStoreKey,
+      KeyValueStoreAccessor(
+          new CustomAccessor<PropertyStoreTest, KeyValueStore>(
+              this, &PropertyStoreTest::GetKeyValueStoreCallback,
+              &PropertyStoreTest::SetKeyValueStoreCallback)));
+
+  // Properties that were not asked for are never read.
+  EXPECT_CALL(*this, GetKeyValueStoreCallback(_)).Times(0);
+  brillo::VariantDictionary result_dict;
+  Error error;
+  EXPECT_TRUE(store.GetSelectedProperties(
+      vector<string>{kStringKey, kWriteOnlyKey, "nonexistent"},
+      &result_dict, &error));
+  EXPECT_TRUE(error.IsSuccess());
+  ASSERT_EQ(1U, result_dict.size());
+  EXPECT_EQ(string_value, result_dict[kStringKey].Get<string>());
+  Mock::VerifyAndClearExpectations(this);
+
+  EXPECT_CALL(*this, GetKeyValueStoreCallback(_))
+      .WillOnce(Return(KeyValueStore()));
+  result_dict.clear();
+  EXPECT_TRUE(store.GetSelectedProperties(
+      vector<string>{kBoolKey, kKeyValueStoreKey}, &result_dict, &error));
+  ASSERT_EQ(2U, result_dict.size());
+  EXPECT_EQ(bool_value, result_dict[kBoolKey].Get<bool>());
+  EXPECT_TRUE(result_dict[kKeyValueStoreKey]
+                  .IsTypeCompatible<brillo::VariantDictionary>());
+}
+
 }  // namespace shill
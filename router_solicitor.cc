@@ -0,0 +1,149 @@
+//
+// Copyright (C) 2015 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "shill/router_solicitor.h"
+
+#include <arpa/inet.h>
+#include <netinet/icmp6.h>
+#include <netinet/in.h>
+#include <string.h>
+
+#include <base/bind.h>
+
+#include "shill/event_dispatcher.h"
+#include "shill/logging.h"
+#include "shill/net/sockets.h"
+
+namespace shill {
+
+namespace Logging {
+static auto kModuleLogScope = ScopeLogger::kInet;
+static std::string ObjectID(RouterSolicitor* r) { return "(router_solicitor)"; }
+}
+
+const int RouterSolicitor::kMaxSolicitations = 4;
+const int RouterSolicitor::kSolicitationIntervalMilliseconds = 500;
+
+namespace {
+
+// All-routers multicast address (RFC 4291).
+const char kAllRoutersAddress[] = "ff02::2";
+// Hop limit required on Neighbor Discovery messages (RFC 4861).
+const int kNeighborDiscoveryHopLimit = 255;
+
+}  // namespace
+
+RouterSolicitor::RouterSolicitor(EventDispatcher* dispatcher,
+                                 int interface_index)
+    : dispatcher_(dispatcher),
+      interface_index_(interface_index),
+      sockets_(new Sockets()),
+      socket_(Sockets::kInvalidFileDescriptor),
+      solicitations_sent_(0) {}
+
+RouterSolicitor::~RouterSolicitor() {
+  Stop();
+}
+
+void RouterSolicitor::Start() {
+  Stop();
+  if (!OpenSocket()) {
+    Stop();
+    return;
+  }
+  SendSolicitation();
+}
+
+void RouterSolicitor::Stop() {
+  solicitation_callback_.Cancel();
+  socket_closer_.reset();
+  socket_ = Sockets::kInvalidFileDescriptor;
+  solicitations_sent_ = 0;
+}
+
+bool RouterSolicitor::IsStarted() const {
+  return socket_closer_.get();
+}
+
+bool RouterSolicitor::OpenSocket() {
+  int socket = sockets_->Socket(AF_INET6, SOCK_RAW, IPPROTO_ICMPV6);
+  if (socket == Sockets::kInvalidFileDescriptor) {
+    PLOG(ERROR) << "Could not create ICMPv6 socket";
+    return false;
+  }
+  socket_ = socket;
+  socket_closer_.reset(new ScopedSocketCloser(sockets_.get(), socket_));
+
+  if (sockets_->SetNonBlocking(socket_) != 0) {
+    PLOG(ERROR) << "Could not set socket to be non-blocking";
+    return false;
+  }
+  if (sockets_->SetIPv6MulticastHops(socket_,
+                                     kNeighborDiscoveryHopLimit) != 0) {
+    PLOG(ERROR) << "Could not set multicast hop limit";
+    return false;
+  }
+  return true;
+}
+
+void RouterSolicitor::SendSolicitation() {
+  ++solicitations_sent_;
+  TransmitSolicitation();
+  if (solicitations_sent_ >= kMaxSolicitations) {
+    Stop();
+    return;
+  }
+  solicitation_callback_.Reset(
+      base::Bind(&RouterSolicitor::SendSolicitation, base::Unretained(this)));
+  dispatcher_->PostDelayedTask(solicitation_callback_.callback(),
+                               kSolicitationIntervalMilliseconds);
+}
+
+bool RouterSolicitor::TransmitSolicitation() {
+  // The kernel fills in the checksum of ICMPv6 raw sockets.  No source
+  // link-layer address option is included, since the source address may
+  // be optimistic (RFC 4429 section 3.2).
+  struct nd_router_solicit solicitation;
+  memset(&solicitation, 0, sizeof(solicitation));
+  solicitation.nd_rs_type = ND_ROUTER_SOLICIT;
+  solicitation.nd_rs_code = 0;
+
+  struct sockaddr_in6 destination;
+  memset(&destination, 0, sizeof(destination));
+  destination.sin6_family = AF_INET6;
+  destination.sin6_scope_id = interface_index_;
+  CHECK_EQ(1, inet_pton(AF_INET6, kAllRoutersAddress, &destination.sin6_addr));
+
+  ssize_t result = sockets_->SendTo(
+      socket_,
+      &solicitation,
+      sizeof(solicitation),
+      0,
+      reinterpret_cast<struct sockaddr*>(&destination),
+      sizeof(destination));
+  if (result != static_cast<ssize_t>(sizeof(solicitation))) {
+    // Expected until the link-local address is usable as a source address.
+    SLOG(this, 2) << "Router solicitation " << solicitations_sent_
+                  << " on interface " << interface_index_ << " failed: "
+                  << sockets_->ErrorString();
+    return false;
+  }
+  SLOG(this, 2) << "Sent router solicitation " << solicitations_sent_
+                << " on interface " << interface_index_;
+  return true;
+}
+
+}  // namespace shill
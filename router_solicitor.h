@@ -0,0 +1,76 @@
+//
+// Copyright (C) 2015 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SHILL_ROUTER_SOLICITOR_H_
+#define SHILL_ROUTER_SOLICITOR_H_
+
+#include <memory>
+
+#include <base/cancelable_callback.h>
+#include <base/macros.h>
+
+namespace shill {
+
+class EventDispatcher;
+class ScopedSocketCloser;
+class Sockets;
+
+// The RouterSolicitor class sends ICMPv6 Router Solicitations on an
+// interface as soon as IPv6 is enabled on it, instead of waiting for the
+// kernel's first solicitation, which is only sent once DAD of the link-local
+// address has completed and after a further random delay.  Solicitations are
+// repeated a few times in case the link-local address was not yet usable as
+// a source address.
+class RouterSolicitor {
+ public:
+  static const int kMaxSolicitations;
+  static const int kSolicitationIntervalMilliseconds;
+
+  RouterSolicitor(EventDispatcher* dispatcher, int interface_index);
+  virtual ~RouterSolicitor();
+
+  // Sends a Router Solicitation right away, and repeats it until Stop() is
+  // called or kMaxSolicitations have been attempted.
+  virtual void Start();
+
+  // Cancels pending solicitations and closes the transmit socket.
+  virtual void Stop();
+
+  virtual bool IsStarted() const;
+
+ private:
+  friend class RouterSolicitorTest;
+
+  // Opens the transmit socket.
+  bool OpenSocket();
+  // Sends one solicitation and schedules the next, if any.
+  void SendSolicitation();
+  bool TransmitSolicitation();
+
+  EventDispatcher* dispatcher_;
+  const int interface_index_;
+  std::unique_ptr<Sockets> sockets_;
+  std::unique_ptr<ScopedSocketCloser> socket_closer_;
+  int socket_;
+  int solicitations_sent_;
+  base::CancelableClosure solicitation_callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(RouterSolicitor);
+};
+
+}  // namespace shill
+
+#endif  // SHILL_ROUTER_SOLICITOR_H_
@@ -0,0 +1,172 @@
+//
+// Copyright (C) 2015 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "shill/router_solicitor.h"
+
+#include <arpa/inet.h>
+#include <netinet/icmp6.h>
+#include <netinet/in.h>
+
+#include <base/bind.h>
+#include <gtest/gtest.h>
+
+#include "shill/mock_event_dispatcher.h"
+#include "shill/net/mock_sockets.h"
+
+using base::Closure;
+using testing::_;
+using testing::Return;
+using testing::SaveArg;
+using testing::StrictMock;
+using testing::Test;
+
+namespace shill {
+
+namespace {
+
+const int kInterfaceIndex = 3;
+const int kSocketFD = 789;
+
+}  // namespace
+
+MATCHER_P(IsAllRoutersAddress, interface_index, "") {
+  const struct sockaddr_in6* socket_address =
+      reinterpret_cast<const struct sockaddr_in6*>(arg);
+  struct in6_addr all_routers;
+  inet_pton(AF_INET6, "ff02::2", &all_routers);
+  return socket_address->sin6_family == AF_INET6 &&
+      socket_address->sin6_scope_id == static_cast<uint32_t>(interface_index) &&
+      memcmp(&socket_address->sin6_addr, &all_routers,
+             sizeof(all_routers)) == 0;
+}
+
+MATCHER(IsRouterSolicitation, "") {
+  const struct nd_router_solicit* solicitation =
+      reinterpret_cast<const struct nd_router_solicit*>(arg);
+  return solicitation->nd_rs_type == ND_ROUTER_SOLICIT &&
+      solicitation->nd_rs_code == 0;
+}
+
+class RouterSolicitorTest : public Test {
+ public:
+  RouterSolicitorTest()
+      : sockets_(new StrictMock<MockSockets>()),
+        solicitor_(&dispatcher_, kInterfaceIndex) {
+    // Passes ownership.
+    solicitor_.sockets_.reset(sockets_);
+  }
+  virtual ~RouterSolicitorTest() {}
+
+  virtual void TearDown() {
+    if (solicitor_.IsStarted()) {
+      EXPECT_CALL(*sockets_, Close(kSocketFD));
+      solicitor_.Stop();
+    }
+  }
+
+ protected:
+  void ExpectOpenSocket() {
+    EXPECT_CALL(*sockets_, Socket(AF_INET6, SOCK_RAW, IPPROTO_ICMPV6))
+        .WillOnce(Return(kSocketFD));
+    EXPECT_CALL(*sockets_, SetNonBlocking(kSocketFD)).WillOnce(Return(0));
+    EXPECT_CALL(*sockets_, SetIPv6MulticastHops(kSocketFD, 255))
+        .WillOnce(Return(0));
+  }
+
+  void ExpectSolicitation(ssize_t result) {
+    EXPECT_CALL(*sockets_,
+                SendTo(kSocketFD, IsRouterSolicitation(),
+                       sizeof(struct nd_router_solicit), 0,
+                       IsAllRoutersAddress(kInterfaceIndex),
+                       sizeof(struct sockaddr_in6)))
+        .WillOnce(Return(result));
+  }
+
+  int solicitations_sent() const { return solicitor_.solicitations_sent_; }
+
+  StrictMock<MockEventDispatcher> dispatcher_;
+  MockSockets* sockets_;  // Owned by |solicitor_|.
+  RouterSolicitor solicitor_;
+};
+
+TEST_F(RouterSolicitorTest, Constructor) {
+  EXPECT_FALSE(solicitor_.IsStarted());
+}
+
+TEST_F(RouterSolicitorTest, SocketOpenFail) {
+  EXPECT_CALL(*sockets_, Socket(AF_INET6, SOCK_RAW, IPPROTO_ICMPV6))
+      .WillOnce(Return(-1));
+  EXPECT_CALL(dispatcher_, PostDelayedTask(_, _)).Times(0);
+  solicitor_.Start();
+  EXPECT_FALSE(solicitor_.IsStarted());
+}
+
+TEST_F(RouterSolicitorTest, SetHopLimitFail) {
+  EXPECT_CALL(*sockets_, Socket(AF_INET6, SOCK_RAW, IPPROTO_ICMPV6))
+      .WillOnce(Return(kSocketFD));
+  EXPECT_CALL(*sockets_, SetNonBlocking(kSocketFD)).WillOnce(Return(0));
+  EXPECT_CALL(*sockets_, SetIPv6MulticastHops(kSocketFD, 255))
+      .WillOnce(Return(-1));
+  EXPECT_CALL(*sockets_, Close(kSocketFD));
+  EXPECT_CALL(*sockets_, SendTo(_, _, _, _, _, _)).Times(0);
+  EXPECT_CALL(dispatcher_, PostDelayedTask(_, _)).Times(0);
+  solicitor_.Start();
+  EXPECT_FALSE(solicitor_.IsStarted());
+}
+
+TEST_F(RouterSolicitorTest, SolicitUntilLimit) {
+  ExpectOpenSocket();
+  // The first attempt may fail while the link-local address is tentative.
+  ExpectSolicitation(-1);
+  Closure solicitation_task;
+  EXPECT_CALL(dispatcher_,
+              PostDelayedTask(_,
+                  RouterSolicitor::kSolicitationIntervalMilliseconds))
+      .WillOnce(SaveArg<0>(&solicitation_task));
+  solicitor_.Start();
+  EXPECT_TRUE(solicitor_.IsStarted());
+  EXPECT_EQ(1, solicitations_sent());
+
+  for (int i = 1; i < RouterSolicitor::kMaxSolicitations - 1; ++i) {
+    ExpectSolicitation(sizeof(struct nd_router_solicit));
+    EXPECT_CALL(dispatcher_, PostDelayedTask(_, _))
+        .WillOnce(SaveArg<0>(&solicitation_task));
+    solicitation_task.Run();
+    EXPECT_TRUE(solicitor_.IsStarted());
+  }
+
+  // The last solicitation closes the socket.
+  ExpectSolicitation(sizeof(struct nd_router_solicit));
+  EXPECT_CALL(*sockets_, Close(kSocketFD));
+  EXPECT_CALL(dispatcher_, PostDelayedTask(_, _)).Times(0);
+  solicitation_task.Run();
+  EXPECT_FALSE(solicitor_.IsStarted());
+}
+
+TEST_F(RouterSolicitorTest, Stop) {
+  ExpectOpenSocket();
+  ExpectSolicitation(sizeof(struct nd_router_solicit));
+  EXPECT_CALL(dispatcher_, PostDelayedTask(_, _));
+  solicitor_.Start();
+  EXPECT_TRUE(solicitor_.IsStarted());
+
+  EXPECT_CALL(*sockets_, Close(kSocketFD));
+  solicitor_.Stop();
+  EXPECT_FALSE(solicitor_.IsStarted());
+  EXPECT_EQ(0, solicitations_sent());
+}
+
+}  // namespace shill
@@ -17,7 +17,9 @@
 #include "shill/routing_table.h"
 
 #include <arpa/inet.h>
+#include <errno.h>
 #include <fcntl.h>
+#include <linux/fib_rules.h>
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
 #include <netinet/ether.h>
@@ -67,9 +69,29 @@ base::LazyInstance<RoutingTable> g_routing_table = LAZY_INSTANCE_INITIALIZER;
 const char RoutingTable::kRouteFlushPath4[] = "/proc/sys/net/ipv4/route/flush";
 // static
 const char RoutingTable::kRouteFlushPath6[] = "/proc/sys/net/ipv6/route/flush";
+// The policy rules sit just ahead of the kernel's own "lookup main" rule at
+// 32766.  Rules added without an explicit priority (such as the fwmark rule
+// for user-traffic-only connections) land ahead of these.
+// static
+const uint32_t RoutingTable::kMainRulePriority = 32763;
+// static
+const uint32_t RoutingTable::kInterfaceRulePriority = 32764;
+// static
+const uint32_t RoutingTable::kDefaultRulePriority = 32765;
+// Table 1 is reserved for user-traffic-only connections, and tables from
+// RT_TABLE_COMPAT up belong to the kernel.
+// static
+const uint8_t RoutingTable::kInterfaceTableIdMin = 2;
+// static
+const uint8_t RoutingTable::kInterfaceTableIdMax = RT_TABLE_COMPAT - 1;
+// Bounds the rules removed per priority and family by FlushRules(), in case
+// the kernel never reports that none are left.
+// static
+const int RoutingTable::kMaxFlushedRules = 1024;
 
 RoutingTable::RoutingTable()
-    : route_callback_(Bind(&RoutingTable::RouteMsgHandler, Unretained(this))),
+    : default_table_id_(RT_TABLE_UNSPEC),
+      route_callback_(Bind(&RoutingTable::RouteMsgHandler, Unretained(this))),
       rtnl_handler_(RTNLHandler::GetInstance()) {
   SLOG(this, 2) << __func__;
 }
@@ -86,11 +108,23 @@ void RoutingTable::Start() {
   route_listener_.reset(
       new RTNLListener(RTNLHandler::kRequestRoute, route_callback_));
   rtnl_handler_->RequestDump(RTNLHandler::kRequestRoute);
+
+  // Rules from a previous instance would point at tables that are about to
+  // be handed out again, possibly to other interfaces.
+  FlushRules();
+
+  // Non-default routes, such as subnet and host routes, are still looked up
+  // in the main table ahead of any interface's default route.
+  ApplyRule(RTNLMessage::kModeAdd, kMainRulePriority, RT_TABLE_MAIN, "", true);
 }
 
 void RoutingTable::Stop() {
   SLOG(this, 2) << __func__;
 
+  if (route_listener_) {
+    ApplyRule(RTNLMessage::kModeDelete, kMainRulePriority, RT_TABLE_MAIN, "",
+              true);
+  }
   route_listener_.reset();
 }
 
@@ -269,22 +303,68 @@ void RoutingTable::ResetTable(int interface_index) {
   tables_.erase(interface_index);
 }
 
-void RoutingTable::SetDefaultMetric(int interface_index, uint32_t metric) {
-  SLOG(this, 2) << __func__ << " index " << interface_index
-                << " metric " << metric;
+uint8_t RoutingTable::AllocInterfaceTable(const string& interface_name) {
+  SLOG(this, 2) << __func__ << " interface " << interface_name;
+
+  for (int table_id = kInterfaceTableIdMin; table_id <= kInterfaceTableIdMax;
+       ++table_id) {
+    if (ContainsKey(interface_tables_, table_id)) {
+      continue;
+    }
+    if (!ApplyRule(RTNLMessage::kModeAdd, kInterfaceRulePriority, table_id,
+                   interface_name, false)) {
+      LOG(ERROR) << __func__ << ": Unable to add routing rule for "
+                 << interface_name;
+      // Remove the rule for whichever family did make it into the kernel.
+      ApplyRule(RTNLMessage::kModeDelete, kInterfaceRulePriority, table_id,
+                interface_name, false);
+      return RT_TABLE_UNSPEC;
+    }
+    interface_tables_[table_id] = interface_name;
+    return table_id;
+  }
+
+  LOG(ERROR) << __func__ << ": No routing table left for " << interface_name;
+  return RT_TABLE_UNSPEC;
+}
 
-  RoutingTableEntry* entry;
-  if (GetDefaultRouteInternal(
-          interface_index, IPAddress::kFamilyIPv4, &entry) &&
-      entry->metric != metric) {
-    ReplaceMetric(interface_index, entry, metric);
+void RoutingTable::FreeInterfaceTable(uint8_t table_id) {
+  SLOG(this, 2) << __func__ << " table " << static_cast<int>(table_id);
+
+  auto table = interface_tables_.find(table_id);
+  if (table == interface_tables_.end()) {
+    return;
   }
 
-  if (GetDefaultRouteInternal(
-          interface_index, IPAddress::kFamilyIPv6, &entry) &&
-      entry->metric != metric) {
-    ReplaceMetric(interface_index, entry, metric);
+  if (default_table_id_ == table_id) {
+    ApplyRule(RTNLMessage::kModeDelete, kDefaultRulePriority, table_id, "",
+              false);
+    default_table_id_ = RT_TABLE_UNSPEC;
   }
+  ApplyRule(RTNLMessage::kModeDelete, kInterfaceRulePriority, table_id,
+            table->second, false);
+  interface_tables_.erase(table);
+}
+
+bool RoutingTable::SetDefaultTable(uint8_t table_id) {
+  SLOG(this, 2) << __func__ << " table " << static_cast<int>(table_id);
+
+  if (table_id == default_table_id_) {
+    return true;
+  }
+
+  // Rules of equal priority are consulted in the order they were added, so
+  // the old rule keeps matching until it is removed below.
+  if (!ApplyRule(RTNLMessage::kModeAdd, kDefaultRulePriority, table_id, "",
+                 false)) {
+    return false;
+  }
+  if (default_table_id_ != RT_TABLE_UNSPEC) {
+    ApplyRule(RTNLMessage::kModeDelete, kDefaultRulePriority,
+              default_table_id_, "", false);
+  }
+  default_table_id_ = table_id;
+  return true;
 }
 
 // static
@@ -467,6 +547,93 @@ bool RoutingTable::ApplyRoute(uint32_t interface_index,
   return rtnl_handler_->SendMessage(&message);
 }
 
+bool RoutingTable::ApplyRule(RTNLMessage::Mode mode,
+                             uint32_t priority,
+                             uint8_t table_id,
+                             const string& interface_name,
+                             bool suppress_default_route) {
+  SLOG(this, 2) << base::StringPrintf(
+      "%s: priority %u table %d interface '%s' mode %d",
+      __func__, priority, table_id, interface_name.c_str(), mode);
+
+  const IPAddress::Family kFamilies[] = {
+    IPAddress::kFamilyIPv4, IPAddress::kFamilyIPv6
+  };
+  bool ret = true;
+  for (const auto family : kFamilies) {
+    RTNLMessage message(
+        RTNLMessage::kTypeRule,
+        mode,
+        NLM_F_REQUEST |
+            (mode == RTNLMessage::kModeAdd ? NLM_F_CREATE : 0),
+        0,
+        0,
+        0,
+        family);
+
+    message.set_rule_status(
+        RTNLMessage::RuleStatus(table_id, FR_ACT_TO_TBL, 0));
+    message.SetAttribute(FRA_PRIORITY,
+                         ByteString::CreateFromCPUUInt32(priority));
+    if (!interface_name.empty()) {
+      message.SetAttribute(FRA_OIFNAME, ByteString(interface_name, true));
+    }
+    if (suppress_default_route) {
+      message.SetAttribute(FRA_SUPPRESS_PREFIXLEN,
+                           ByteString::CreateFromCPUUInt32(0));
+    }
+
+    if (!rtnl_handler_->SendMessage(&message)) {
+      ret = false;
+    }
+  }
+  return ret;
+}
+
+void RoutingTable::FlushRules() {
+  const IPAddress::Family kFamilies[] = {
+    IPAddress::kFamilyIPv4, IPAddress::kFamilyIPv6
+  };
+  const uint32_t kPriorities[] = {
+    kMainRulePriority, kInterfaceRulePriority, kDefaultRulePriority
+  };
+  for (const auto family : kFamilies) {
+    for (const auto priority : kPriorities) {
+      // A deletion that names only a priority removes the first rule found
+      // at that priority, whatever table or interface it refers to.  Repeat
+      // until the kernel reports that none are left.
+      int count = 0;
+      for (; count < kMaxFlushedRules; ++count) {
+        RTNLMessage message(
+            RTNLMessage::kTypeRule,
+            RTNLMessage::kModeDelete,
+            NLM_F_REQUEST,
+            0,
+            0,
+            0,
+            family);
+        message.set_rule_status(
+            RTNLMessage::RuleStatus(RT_TABLE_UNSPEC, FR_ACT_UNSPEC, 0));
+        message.SetAttribute(FRA_PRIORITY,
+                             ByteString::CreateFromCPUUInt32(priority));
+        int error = rtnl_handler_->SendMessageSync(&message);
+        if (error == ENOENT) {
+          break;
+        }
+        if (error != 0) {
+          LOG(ERROR) << __func__ << ": Unable to remove rules at priority "
+                     << priority << ": " << strerror(error);
+          break;
+        }
+      }
+      if (count > 0) {
+        LOG(INFO) << __func__ << ": Removed " << count
+                  << " stale rules at priority " << priority;
+      }
+    }
+  }
+}
+
 // Somewhat surprisingly, the kernel allows you to create multiple routes
 // to the same destination through the same interface with different metrics.
 // Therefore, to change the metric on a route, we can't just use the
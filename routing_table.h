@@ -18,6 +18,7 @@
 #define SHILL_ROUTING_TABLE_H_
 
 #include <deque>
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -40,7 +41,9 @@ struct RoutingTableEntry;
 // This singleton maintains an in-process copy of the routing table on
 // a per-interface basis.  It offers the ability for other modules to
 // make modifications to the routing table, centered around setting the
-// default route for an interface or modifying its metric (priority).
+// default route for an interface.  Each interface's default route lives in
+// a routing table of its own, and a single policy rule selects the table
+// of the default network, so that switching networks never rewrites routes.
 class RoutingTable {
  public:
   typedef std::vector<RoutingTableEntry> TableEntryVector;
@@ -126,8 +129,19 @@ class RoutingTable {
   // Reset local state for this interface.
   virtual void ResetTable(int interface_index);
 
-  // Set the metric (priority) on existing default routes for an interface.
-  virtual void SetDefaultMetric(int interface_index, uint32_t metric);
+  // Allocate a routing table to hold the default route of |interface_name|,
+  // and install a policy rule that directs traffic bound to that interface
+  // to it.  Returns RT_TABLE_UNSPEC if no table is available.
+  virtual uint8_t AllocInterfaceTable(const std::string& interface_name);
+
+  // Release a table returned by AllocInterfaceTable(), removing the policy
+  // rules that refer to it.
+  virtual void FreeInterfaceTable(uint8_t table_id);
+
+  // Point the default-network policy rule at |table_id|.  The new rule is
+  // installed before the previous one is removed, so there is no window
+  // without a default route.  Returns true if the rule was installed.
+  virtual bool SetDefaultTable(uint8_t table_id);
 
   // Get the default route to |destination| through |interface_index| and create
   // a host route to that destination.  When creating the route, tag our local
@@ -167,11 +181,37 @@ class RoutingTable {
                      RoutingTableEntry* entry,
                      uint32_t metric);
 
+  // Add or remove the IPv4 and IPv6 policy rules at |priority| that look up
+  // |table_id|, optionally only for traffic bound to |interface_name|.  If
+  // |suppress_default_route| is set, default routes found in |table_id| are
+  // ignored.
+  bool ApplyRule(RTNLMessage::Mode mode,
+                 uint32_t priority,
+                 uint8_t table_id,
+                 const std::string& interface_name,
+                 bool suppress_default_route);
+
+  // Remove every IPv4 and IPv6 policy rule at the priorities used by
+  // ApplyRule(), such as those left behind by an earlier shill process.
+  void FlushRules();
+
   static const char kRouteFlushPath4[];
   static const char kRouteFlushPath6[];
+  static const uint32_t kMainRulePriority;
+  static const uint32_t kInterfaceRulePriority;
+  static const uint32_t kDefaultRulePriority;
+  static const uint8_t kInterfaceTableIdMin;
+  static const uint8_t kInterfaceTableIdMax;
+  static const int kMaxFlushedRules;
 
   Tables tables_;
 
+  // Tables handed out by AllocInterfaceTable(), mapped to the name of the
+  // interface they serve.
+  std::map<uint8_t, std::string> interface_tables_;
+  // Table currently selected by the default-network rule, or RT_TABLE_UNSPEC.
+  uint8_t default_table_id_;
+
   base::Callback<void(const RTNLMessage&)> route_callback_;
   std::unique_ptr<RTNLListener> route_listener_;
   std::deque<Query> route_queries_;
@@ -16,10 +16,13 @@
 
 #include "shill/routing_table.h"
 
+#include <errno.h>
+#include <linux/fib_rules.h>
 #include <linux/rtnetlink.h>
 #include <sys/socket.h>
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <base/bind.h>
@@ -42,10 +45,13 @@ using base::Bind;
 using base::Callback;
 using base::Unretained;
 using std::deque;
+using std::string;
 using std::vector;
 using testing::_;
 using testing::Field;
+using testing::InSequence;
 using testing::Invoke;
+using testing::Mock;
 using testing::Return;
 using testing::StrictMock;
 using testing::Test;
@@ -232,6 +238,37 @@ MATCHER_P4(IsRoutingPacket, mode, index, entry, flags, "") {
       priority == entry.metric;
 }
 
+MATCHER_P4(IsRulePacket, mode, priority, table, interface_name, "") {
+  uint32_t rule_priority;
+
+  return
+      arg->type() == RTNLMessage::kTypeRule &&
+      arg->mode() == mode &&
+      arg->rule_status().table == table &&
+      arg->rule_status().action == FR_ACT_TO_TBL &&
+      arg->GetAttribute(FRA_PRIORITY).ConvertToCPUUInt32(&rule_priority) &&
+      rule_priority == static_cast<uint32_t>(priority) &&
+      (string(interface_name).empty() ?
+          !arg->HasAttribute(FRA_OIFNAME) :
+          arg->GetAttribute(FRA_OIFNAME).Equals(
+              ByteString(string(interface_name), true))) &&
+      arg->HasAttribute(FRA_SUPPRESS_PREFIXLEN) == (table == RT_TABLE_MAIN);
+}
+
+MATCHER_P2(IsRuleFlushPacket, family, priority, "") {
+  uint32_t rule_priority;
+
+  return
+      arg->type() == RTNLMessage::kTypeRule &&
+      arg->mode() == RTNLMessage::kModeDelete &&
+      arg->family() == family &&
+      arg->rule_status().table == RT_TABLE_UNSPEC &&
+      arg->rule_status().action == FR_ACT_UNSPEC &&
+      arg->GetAttribute(FRA_PRIORITY).ConvertToCPUUInt32(&rule_priority) &&
+      rule_priority == static_cast<uint32_t>(priority) &&
+      !arg->HasAttribute(FRA_OIFNAME);
+}
+
 }  // namespace
 
 void RoutingTableTest::SendRouteEntry(RTNLMessage::Mode mode,
@@ -283,7 +320,53 @@ void RoutingTableTest::SendRouteMessage(const RTNLMessage& msg) {
 
 TEST_F(RoutingTableTest, Start) {
   EXPECT_CALL(rtnl_handler_, RequestDump(RTNLHandler::kRequestRoute));
+  // Rules left over from an earlier instance are removed one at a time
+  // until the kernel reports that there are none left.
+  EXPECT_CALL(rtnl_handler_,
+              SendMessageSync(IsRuleFlushPacket(IPAddress::kFamilyIPv4,
+                                                32763)))
+      .WillOnce(Return(0))
+      .WillOnce(Return(0))
+      .WillOnce(Return(ENOENT));
+  EXPECT_CALL(rtnl_handler_,
+              SendMessageSync(IsRuleFlushPacket(IPAddress::kFamilyIPv4,
+                                                32764)))
+      .WillOnce(Return(ENOENT));
+  EXPECT_CALL(rtnl_handler_,
+              SendMessageSync(IsRuleFlushPacket(IPAddress::kFamilyIPv4,
+                                                32765)))
+      .WillOnce(Return(0))
+      .WillOnce(Return(ENOENT));
+  // Other errors stop the flush of that priority.
+  EXPECT_CALL(rtnl_handler_,
+              SendMessageSync(IsRuleFlushPacket(IPAddress::kFamilyIPv6,
+                                                32763)))
+      .WillOnce(Return(EPERM));
+  EXPECT_CALL(rtnl_handler_,
+              SendMessageSync(IsRuleFlushPacket(IPAddress::kFamilyIPv6,
+                                                32764)))
+      .WillOnce(Return(ENOENT));
+  EXPECT_CALL(rtnl_handler_,
+              SendMessageSync(IsRuleFlushPacket(IPAddress::kFamilyIPv6,
+                                                32765)))
+      .WillOnce(Return(ENOENT));
+  // One rule per address family.
+  EXPECT_CALL(rtnl_handler_,
+              SendMessage(IsRulePacket(RTNLMessage::kModeAdd,
+                                       32763,
+                                       RT_TABLE_MAIN,
+                                       "")))
+      .Times(2);
   routing_table_->Start();
+
+  // One rule per address family.
+  EXPECT_CALL(rtnl_handler_,
+              SendMessage(IsRulePacket(RTNLMessage::kModeDelete,
+                                       32763,
+                                       RT_TABLE_MAIN,
+                                       "")))
+      .Times(2);
+  routing_table_->Stop();
 }
 
 TEST_F(RoutingTableTest, RouteAddDelete) {
@@ -470,7 +553,10 @@ TEST_F(RoutingTableTest, RouteAddDelete) {
                                           kTestDeviceIndex0,
                                           entry0,
                                           0)));
-  routing_table_->SetDefaultMetric(kTestDeviceIndex0, entry5.metric);
+  EXPECT_TRUE(routing_table_->SetDefaultRoute(kTestDeviceIndex0,
+                                              gateway_address,
+                                              entry5.metric,
+                                              kTestTableId));
   // Furthermore, the routing table should reflect the change in the metric
   // for the default route for the interface.
   RoutingTableEntry default_route;
@@ -888,4 +974,93 @@ TEST_F(RoutingTableTest, CreateLinkRoute) {
                                                kTestTableId));
 }
 
+TEST_F(RoutingTableTest, InterfaceTables) {
+  const char kTestDeviceName1[] = "test-device1";
+
+  // Each interface gets a table of its own, selected for traffic bound to
+  // that interface.
+  EXPECT_CALL(rtnl_handler_,
+              SendMessage(IsRulePacket(RTNLMessage::kModeAdd, 32764, 2,
+                                       kTestDeviceName0)))
+      .Times(2);
+  EXPECT_EQ(2, routing_table_->AllocInterfaceTable(kTestDeviceName0));
+  EXPECT_CALL(rtnl_handler_,
+              SendMessage(IsRulePacket(RTNLMessage::kModeAdd, 32764, 3,
+                                       kTestDeviceName1)))
+      .Times(2);
+  EXPECT_EQ(3, routing_table_->AllocInterfaceTable(kTestDeviceName1));
+
+  // Selecting the default table takes a single rule per family.
+  EXPECT_CALL(rtnl_handler_,
+              SendMessage(IsRulePacket(RTNLMessage::kModeAdd, 32765, 2,
+                                       "")))
+      .Times(2);
+  EXPECT_TRUE(routing_table_->SetDefaultTable(2));
+  EXPECT_TRUE(routing_table_->SetDefaultTable(2));
+
+  // Switching to another table adds the new rule before removing the old.
+  {
+    InSequence seq;
+    EXPECT_CALL(rtnl_handler_,
+                SendMessage(IsRulePacket(RTNLMessage::kModeAdd, 32765, 3,
+                                         "")))
+        .Times(2);
+    EXPECT_CALL(rtnl_handler_,
+                SendMessage(IsRulePacket(RTNLMessage::kModeDelete, 32765, 2,
+                                         "")))
+        .Times(2);
+  }
+  EXPECT_TRUE(routing_table_->SetDefaultTable(3));
+
+  // Freeing a table that is not the default only removes its interface rule,
+  // and makes the table available again.
+  EXPECT_CALL(rtnl_handler_,
+              SendMessage(IsRulePacket(RTNLMessage::kModeDelete, 32764, 2,
+                                       kTestDeviceName0)))
+      .Times(2);
+  routing_table_->FreeInterfaceTable(2);
+  EXPECT_CALL(rtnl_handler_,
+              SendMessage(IsRulePacket(RTNLMessage::kModeAdd, 32764, 2,
+                                       kTestDeviceName0)))
+      .Times(2);
+  EXPECT_EQ(2, routing_table_->AllocInterfaceTable(kTestDeviceName0));
+
+  // Freeing the default table also removes the default rule.
+  EXPECT_CALL(rtnl_handler_,
+              SendMessage(IsRulePacket(RTNLMessage::kModeDelete, 32765, 3,
+                                       "")))
+      .Times(2);
+  EXPECT_CALL(rtnl_handler_,
+              SendMessage(IsRulePacket(RTNLMessage::kModeDelete, 32764, 3,
+                                       kTestDeviceName1)))
+      .Times(2);
+  routing_table_->FreeInterfaceTable(3);
+  routing_table_->FreeInterfaceTable(3);
+}
+
+TEST_F(RoutingTableTest, AllocInterfaceTableRuleFailure) {
+  // If the rule cannot be installed, no table is handed out, and the rule
+  // is removed in case it made it into the kernel for one family.
+  EXPECT_CALL(rtnl_handler_,
+              SendMessage(IsRulePacket(RTNLMessage::kModeAdd, 32764, 2,
+                                       kTestDeviceName0)))
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+  EXPECT_CALL(rtnl_handler_,
+              SendMessage(IsRulePacket(RTNLMessage::kModeDelete, 32764, 2,
+                                       kTestDeviceName0)))
+      .Times(2);
+  EXPECT_EQ(RT_TABLE_UNSPEC,
+            routing_table_->AllocInterfaceTable(kTestDeviceName0));
+  Mock::VerifyAndClearExpectations(&rtnl_handler_);
+
+  // The table remains available.
+  EXPECT_CALL(rtnl_handler_,
+              SendMessage(IsRulePacket(RTNLMessage::kModeAdd, 32764, 2,
+                                       kTestDeviceName0)))
+      .Times(2)
+      .WillRepeatedly(Return(true));
+  EXPECT_EQ(2, routing_table_->AllocInterfaceTable(kTestDeviceName0));
+}
+
 }  // namespace shill
@@ -85,6 +85,9 @@ const char Service::kCheckPortalTrue[] = "true";
 
 const char Service::kErrorDetailsNone[] = "";
 
+const char Service::kDependencyState[] = "State";
+const char Service::kDependencyVisibility[] = "Visibility";
+
 const int Service::kPriorityNone = 0;
 
 const char Service::kServiceSortAutoConnect[] = "AutoConnect";
@@ -284,7 +287,8 @@ Service::Service(ControlInterface* control_interface,
   HelpRegisterObservedDerivedBool(kVisibleProperty,
                                   &Service::GetVisibleProperty,
                                   nullptr,
-                                  nullptr);
+                                  nullptr,
+                                  {kDependencyState, kDependencyVisibility});
 
   store_.RegisterConstString(kPortalDetectionFailedPhaseProperty,
                              &portal_detection_failure_phase_);
@@ -425,6 +429,7 @@ void Service::SetState(ConnectState state) {
 
   previous_state_ = state_;
   state_ = state;
+  InvalidatePropertyDependency(kDependencyState);
   if (state != kStateFailure) {
     failure_ = kFailureUnknown;
     SetErrorDetails(kErrorDetailsNone);
@@ -1404,11 +1409,15 @@ void Service::HelpRegisterObservedDerivedBool(
     const string& name,
     bool(Service::*get)(Error* error),
     bool(Service::*set)(const bool&, Error*),
-    void(Service::*clear)(Error*)) {
+    void(Service::*clear)(Error*),
+    const Strings& dependencies) {
   BoolAccessor accessor(
       new CustomAccessor<Service, bool>(this, get, set, clear));
   store_.RegisterDerivedBool(name, accessor);
   property_change_notifier_->AddBoolPropertyObserver(name, accessor);
+  for (const auto& dependency : dependencies) {
+    property_change_notifier_->AddPropertyDependency(name, dependency);
+  }
 }
 
 // static
@@ -1638,6 +1647,10 @@ string Service::GetTethering(Error* error) const {
 }
 
 
+void Service::InvalidatePropertyDependency(const string& dependency) {
+  property_change_notifier_->InvalidateDependency(dependency);
+}
+
 void Service::NotifyPropertyChanges() {
   property_change_notifier_->UpdatePropertyObservers();
 }
@@ -82,6 +82,12 @@ class Service : public base::RefCounted<Service> {
 
   static const char kErrorDetailsNone[];
 
+  // Fields that observed derived properties depend on.  See
+  // InvalidatePropertyDependency().
+  static const char kDependencyState[];
+  // Technology-specific inputs to IsVisible(), e.g. endpoints or carrier.
+  static const char kDependencyVisibility[];
+
   // TODO(pstew): Storage constants shouldn't need to be public
   // crbug.com/208736
   static const char kStorageAutoConnect[];
@@ -599,11 +605,15 @@ class Service : public base::RefCounted<Service> {
   // HelpRegisterObservedDerived*: Expose an property over RPC, with the
   // name |name|, for which property changes are automatically generated.
   //
+  // |dependencies| lists the fields the property is derived from; the
+  // property is only re-read by NotifyPropertyChanges() after one of them
+  // has been invalidated.
   void HelpRegisterObservedDerivedBool(
       const std::string& name,
       bool(Service::*get)(Error* error),
       bool(Service::*set)(const bool& value, Error* error),
-      void(Service::*clear)(Error* error));
+      void(Service::*clear)(Error* error),
+      const Strings& dependencies);
   ServiceAdaptorInterface* adaptor() const { return adaptor_.get(); }
 
 #if !defined(DISABLE_WIFI) || !defined(DISABLE_WIRED_8021X)
@@ -652,6 +662,10 @@ class Service : public base::RefCounted<Service> {
   // metered backhaul for internet connectivity.
   virtual std::string GetTethering(Error* error) const;
 
+  // Reports that |dependency| has changed, so that observed properties
+  // derived from it are re-read by the next NotifyPropertyChanges().
+  void InvalidatePropertyDependency(const std::string& dependency);
+
   // Emit property change notifications for all observed properties.
   void NotifyPropertyChanges();
 
@@ -19,6 +19,7 @@
 #include <string>
 
 #include <base/bind.h>
+#include <base/logging.h>
 
 #include "shill/adaptor_interfaces.h"
 #include "shill/property_observer.h"
@@ -35,7 +36,8 @@ ServicePropertyChangeNotifier::~ServicePropertyChangeNotifier() {}
 
 void ServicePropertyChangeNotifier::AddBoolPropertyObserver(
     const string& name, BoolAccessor accessor) {
-  property_observers_.emplace_back(
+  AddPropertyObserver(
+      name,
       new PropertyObserver<bool>(
           accessor,
           Bind(&ServicePropertyChangeNotifier::BoolPropertyUpdater,
@@ -45,7 +47,8 @@ void ServicePropertyChangeNotifier::AddBoolPropertyObserver(
 
 void ServicePropertyChangeNotifier::AddUint8PropertyObserver(
     const string& name, Uint8Accessor accessor) {
-  property_observers_.emplace_back(
+  AddPropertyObserver(
+      name,
       new PropertyObserver<uint8_t>(
           accessor,
           Bind(&ServicePropertyChangeNotifier::Uint8PropertyUpdater,
@@ -55,7 +58,8 @@ void ServicePropertyChangeNotifier::AddUint8PropertyObserver(
 
 void ServicePropertyChangeNotifier::AddUint16PropertyObserver(
     const string& name, Uint16Accessor accessor) {
-  property_observers_.emplace_back(
+  AddPropertyObserver(
+      name,
       new PropertyObserver<uint16_t>(
           accessor,
           Bind(&ServicePropertyChangeNotifier::Uint16PropertyUpdater,
@@ -65,7 +69,8 @@ void ServicePropertyChangeNotifier::AddUint16PropertyObserver(
 
 void ServicePropertyChangeNotifier::AddUint16sPropertyObserver(
     const string& name, Uint16sAccessor accessor) {
-  property_observers_.emplace_back(
+  AddPropertyObserver(
+      name,
       new PropertyObserver<Uint16s>(
           accessor,
           Bind(&ServiceAdaptorInterface::EmitUint16sChanged,
@@ -75,7 +80,8 @@ void ServicePropertyChangeNotifier::AddUint16sPropertyObserver(
 
 void ServicePropertyChangeNotifier::AddUintPropertyObserver(
     const string& name, Uint32Accessor accessor) {
-  property_observers_.emplace_back(
+  AddPropertyObserver(
+      name,
       new PropertyObserver<uint32_t>(
           accessor,
           Bind(&ServicePropertyChangeNotifier::Uint32PropertyUpdater,
@@ -85,7 +91,8 @@ void ServicePropertyChangeNotifier::AddUintPropertyObserver(
 
 void ServicePropertyChangeNotifier::AddIntPropertyObserver(
     const string& name, Int32Accessor accessor) {
-  property_observers_.emplace_back(
+  AddPropertyObserver(
+      name,
       new PropertyObserver<int32_t>(
           accessor,
           Bind(&ServicePropertyChangeNotifier::Int32PropertyUpdater,
@@ -95,7 +102,8 @@ void ServicePropertyChangeNotifier::AddIntPropertyObserver(
 
 void ServicePropertyChangeNotifier::AddRpcIdentifierPropertyObserver(
     const string& name, RpcIdentifierAccessor accessor) {
-  property_observers_.emplace_back(
+  AddPropertyObserver(
+      name,
       new PropertyObserver<string>(
           accessor,
           Bind(&ServiceAdaptorInterface::EmitRpcIdentifierChanged,
@@ -105,7 +113,8 @@ void ServicePropertyChangeNotifier::AddRpcIdentifierPropertyObserver(
 
 void ServicePropertyChangeNotifier::AddStringPropertyObserver(
     const string& name, StringAccessor accessor) {
-  property_observers_.emplace_back(
+  AddPropertyObserver(
+      name,
       new PropertyObserver<string>(
           accessor,
           Bind(&ServiceAdaptorInterface::EmitStringChanged,
@@ -115,7 +124,8 @@ void ServicePropertyChangeNotifier::AddStringPropertyObserver(
 
 void ServicePropertyChangeNotifier::AddStringmapPropertyObserver(
     const string& name, StringmapAccessor accessor) {
-  property_observers_.emplace_back(
+  AddPropertyObserver(
+      name,
       new PropertyObserver<Stringmap>(
           accessor,
           Bind(&ServiceAdaptorInterface::EmitStringmapChanged,
@@ -123,12 +133,42 @@ void ServicePropertyChangeNotifier::AddStringmapPropertyObserver(
                name)));
 }
 
+void ServicePropertyChangeNotifier::AddPropertyDependency(
+    const string& name, const string& dependency) {
+  auto entry = property_observers_.find(name);
+  CHECK(entry != property_observers_.end())
+      << "No observer for property " << name;
+  entry->second.has_dependencies = true;
+  dependents_[dependency].push_back(name);
+}
+
+void ServicePropertyChangeNotifier::InvalidateDependency(
+    const string& dependency) {
+  auto dependents = dependents_.find(dependency);
+  if (dependents == dependents_.end()) {
+    return;
+  }
+  for (const auto& name : dependents->second) {
+    property_observers_[name].dirty = true;
+  }
+}
+
 void ServicePropertyChangeNotifier::UpdatePropertyObservers() {
-  for (const auto& observer : property_observers_) {
-    observer->Update();
+  for (auto& name_and_entry : property_observers_) {
+    ObserverEntry& entry = name_and_entry.second;
+    if (entry.has_dependencies && !entry.dirty) {
+      continue;
+    }
+    entry.dirty = false;
+    entry.observer->Update();
   }
 }
 
+void ServicePropertyChangeNotifier::AddPropertyObserver(
+    const string& name, PropertyObserverInterface* observer) {
+  property_observers_[name].observer.reset(observer);
+}
+
 void ServicePropertyChangeNotifier::BoolPropertyUpdater(const string& name,
                                                         const bool& value) {
   rpc_adaptor_->EmitBoolChanged(name, value);
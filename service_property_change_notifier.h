@@ -17,6 +17,7 @@
 #ifndef SHILL_SERVICE_PROPERTY_CHANGE_NOTIFIER_H_
 #define SHILL_SERVICE_PROPERTY_CHANGE_NOTIFIER_H_
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -36,6 +37,11 @@ class ServiceAdaptorInterface;
 // pointer to the ServiceAdaptor to which notifications should be
 // posted.  This pointer must be valid for the lifetime of this
 // property change notifier.
+//
+// An observed property may declare the fields it is derived from with
+// AddPropertyDependency().  Such a property is then only re-read by
+// UpdatePropertyObservers() after one of those fields has been reported
+// changed with InvalidateDependency(), rather than on every update.
 class ServicePropertyChangeNotifier {
  public:
   explicit ServicePropertyChangeNotifier(ServiceAdaptorInterface* adaptor);
@@ -59,9 +65,31 @@ class ServicePropertyChangeNotifier {
                                          StringAccessor accessor);
   virtual void AddStringmapPropertyObserver(const std::string& name,
                                             StringmapAccessor accessor);
+  // Declares that the observed property |name| only changes when
+  // |dependency| does.
+  virtual void AddPropertyDependency(const std::string& name,
+                                     const std::string& dependency);
+  // Marks the observed properties that depend on |dependency| as needing
+  // to be re-read by the next UpdatePropertyObservers().
+  virtual void InvalidateDependency(const std::string& dependency);
+  // Re-reads observed properties that have no declared dependencies or
+  // have been invalidated, and emits changes for those whose values differ.
   virtual void UpdatePropertyObservers();
 
  private:
+  struct ObserverEntry {
+    ObserverEntry() : has_dependencies(false), dirty(true) {}
+
+    std::unique_ptr<PropertyObserverInterface> observer;
+    bool has_dependencies;
+    // Newly added observers start dirty so that the first update
+    // synchronizes them with the fully constructed service.
+    bool dirty;
+  };
+
+  void AddPropertyObserver(const std::string& name,
+                           PropertyObserverInterface* observer);
+
   // Redirects templated calls to a value reference to a by-copy version.
   void BoolPropertyUpdater(const std::string& name, const bool& value);
   void Uint8PropertyUpdater(const std::string& name, const uint8_t& value);
@@ -70,7 +98,9 @@ class ServicePropertyChangeNotifier {
   void Int32PropertyUpdater(const std::string& name, const int32_t& value);
 
   ServiceAdaptorInterface* rpc_adaptor_;
-  std::vector<std::unique_ptr<PropertyObserverInterface>> property_observers_;
+  std::map<std::string, ObserverEntry> property_observers_;
+  // Names of the observed properties depending on each field.
+  std::map<std::string, std::vector<std::string>> dependents_;
 
   DISALLOW_COPY_AND_ASSIGN(ServicePropertyChangeNotifier);
 };
@@ -0,0 +1,106 @@
+//
+// Copyright (C) 2015 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "shill/service_property_change_notifier.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "shill/accessor_interface.h"
+#include "shill/error.h"
+#include "shill/mock_adaptors.h"
+
+using testing::_;
+using testing::Mock;
+using testing::Return;
+using testing::StrictMock;
+
+namespace shill {
+
+namespace {
+const char kProperty[] = "Property";
+const char kDependency[] = "Dependency";
+const char kOtherDependency[] = "OtherDependency";
+}  // namespace
+
+class TestBoolAccessor : public AccessorInterface<bool> {
+ public:
+  MOCK_METHOD1(Clear, void(Error* error));
+  MOCK_METHOD1(Get, bool(Error* error));
+  MOCK_METHOD2(Set, bool(const bool& value, Error* error));
+};
+
+class ServicePropertyChangeNotifierTest : public testing::Test {
+ public:
+  ServicePropertyChangeNotifierTest()
+      : accessor_(new StrictMock<TestBoolAccessor>()),
+        bool_accessor_(accessor_),
+        notifier_(&adaptor_) {}
+  ~ServicePropertyChangeNotifierTest() override {}
+
+ protected:
+  void AddObserver() {
+    EXPECT_CALL(*accessor_, Get(_)).WillOnce(Return(false));
+    notifier_.AddBoolPropertyObserver(kProperty, bool_accessor_);
+    Mock::VerifyAndClearExpectations(accessor_);
+  }
+
+  StrictMock<ServiceMockAdaptor> adaptor_;
+  StrictMock<TestBoolAccessor>* accessor_;
+  BoolAccessor bool_accessor_;  // Owns reference to |accessor_|.
+  ServicePropertyChangeNotifier notifier_;
+};
+
+TEST_F(ServicePropertyChangeNotifierTest, NoDependencies) {
+  AddObserver();
+
+  // Without declared dependencies the property is re-read on every update.
+  EXPECT_CALL(*accessor_, Get(_)).WillOnce(Return(false));
+  notifier_.UpdatePropertyObservers();
+  Mock::VerifyAndClearExpectations(accessor_);
+
+  EXPECT_CALL(*accessor_, Get(_)).WillOnce(Return(true));
+  EXPECT_CALL(adaptor_, EmitBoolChanged(kProperty, true));
+  notifier_.UpdatePropertyObservers();
+}
+
+TEST_F(ServicePropertyChangeNotifierTest, Dependencies) {
+  AddObserver();
+  notifier_.AddPropertyDependency(kProperty, kDependency);
+
+  // The first update synchronizes the observer.
+  EXPECT_CALL(*accessor_, Get(_)).WillOnce(Return(true));
+  EXPECT_CALL(adaptor_, EmitBoolChanged(kProperty, true));
+  notifier_.UpdatePropertyObservers();
+  Mock::VerifyAndClearExpectations(accessor_);
+  Mock::VerifyAndClearExpectations(&adaptor_);
+
+  // Nothing has been invalidated, so the property is not re-read.
+  EXPECT_CALL(*accessor_, Get(_)).Times(0);
+  notifier_.UpdatePropertyObservers();
+  notifier_.InvalidateDependency(kOtherDependency);
+  notifier_.UpdatePropertyObservers();
+  Mock::VerifyAndClearExpectations(accessor_);
+
+  // Invalidating a dependency re-reads the property once.
+  notifier_.InvalidateDependency(kDependency);
+  EXPECT_CALL(*accessor_, Get(_)).WillOnce(Return(false));
+  EXPECT_CALL(adaptor_, EmitBoolChanged(kProperty, false));
+  notifier_.UpdatePropertyObservers();
+  notifier_.UpdatePropertyObservers();
+}
+
+}  // namespace shill
@@ -518,6 +518,7 @@
         'property_store.cc',
         'resolver.cc',
         'result_aggregator.cc',
+        'router_solicitor.cc',
         'routing_table.cc',
         'rpc_task.cc',
         'scope_logger.cc',
@@ -540,6 +541,7 @@
         'vpn/vpn_driver.cc',
         'vpn/vpn_provider.cc',
         'vpn/vpn_service.cc',
+        'warm_start_state.cc',
       ],
       'actions': [
         {
@@ -768,6 +770,7 @@
             'mock_profile.cc',
             'mock_property_store.cc',
             'mock_resolver.cc',
+            'mock_router_solicitor.cc',
             'mock_routing_table.cc',
             'mock_service.cc',
             'mock_socket_info_reader.cc',
@@ -778,6 +781,7 @@
             'net/byte_string_unittest.cc',
             'net/event_history_unittest.cc',
             'net/ip_address_unittest.cc',
+            'net/io_input_handler_unittest.cc',
             'net/netlink_attribute_unittest.cc',
             'net/rtnl_handler_unittest.cc',
             'net/rtnl_listener_unittest.cc',
@@ -798,9 +802,11 @@
             'property_store_unittest.cc',
             'resolver_unittest.cc',
             'result_aggregator_unittest.cc',
+            'router_solicitor_unittest.cc',
             'routing_table_unittest.cc',
             'rpc_task_unittest.cc',
             'scope_logger_unittest.cc',
+            'service_property_change_notifier_unittest.cc',
             'service_property_change_test.cc',
             'service_under_test.cc',
             'service_unittest.cc',
@@ -817,6 +823,7 @@
             'upstart/upstart_unittest.cc',
             'virtual_device_unittest.cc',
             'vpn/mock_vpn_provider.cc',
+            'warm_start_state_unittest.cc',
           ],
           'conditions': [
             ['USE_cellular == 1', {
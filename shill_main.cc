@@ -70,6 +70,10 @@ static const char kAcceptHostnameFrom[] = "accept-hostname-from";
 // List of devices to enable DHCPv6.
 static const char kDhcpv6EnabledDevices[] = "dhcpv6-enabled-devices";
 #endif  // DISABLE_DHCPV6
+#ifndef DISABLE_WIFI
+// Number of raw netlink packets to keep for decoding after shill stops.
+static const char kNetlinkCapturePackets[] = "netlink-capture-packets";
+#endif  // DISABLE_WIFI
 // Flag that causes shill to show the help message and exit.
 static const char kHelp[] = "help";
 
@@ -104,6 +108,11 @@ static const char kHelpMessage[] = "\n"
     "  --dhcpv6-enabled-devices=device1,device2\n"
     "    Enable DHCPv6 for devices named device1 and device2\n"
 #endif  // DISABLE_DHCPV6
+#ifndef DISABLE_WIFI
+    "  --netlink-capture-packets=N\n"
+    "    Keep the last N raw netlink packets and write them to the run\n"
+    "    directory when shill stops.\n"
+#endif  // DISABLE_WIFI
     "  --minimum-mtu=mtu\n"
     "    Set the minimum value to respect as the MTU from DHCP responses.\n";
 }  // namespace switches
@@ -246,6 +255,19 @@ int main(int argc, char** argv) {
   }
 #endif  // DISABLE_DHCPV6
 
+#ifndef DISABLE_WIFI
+  if (cl->HasSwitch(switches::kNetlinkCapturePackets)) {
+    int packets;
+    std::string value =
+        cl->GetSwitchValueASCII(switches::kNetlinkCapturePackets);
+    if (!base::StringToInt(value, &packets) || packets < 0) {
+      LOG(FATAL) << "Could not convert '" << value
+                 << "' to a packet count.";
+    }
+    settings.netlink_capture_packets = packets;
+  }
+#endif  // DISABLE_WIFI
+
   shill::Config config;
 
   shill::ShillDaemon daemon(base::Bind(&OnStartup, argv[0], cl), settings,
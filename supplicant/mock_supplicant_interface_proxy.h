@@ -23,6 +23,7 @@
 #include <base/macros.h>
 #include <gmock/gmock.h>
 
+#include "shill/callbacks.h"
 #include "shill/refptr_types.h"
 #include "shill/supplicant/supplicant_interface_proxy_interface.h"
 
@@ -61,6 +62,19 @@ class MockSupplicantInterfaceProxy : public SupplicantInterfaceProxyInterface {
   MOCK_METHOD2(TDLSStatus, bool(const std::string& peer, std::string* status));
   MOCK_METHOD1(TDLSTeardown, bool(const std::string& peer));
   MOCK_METHOD2(SetHT40Enable, bool(const std::string& network, bool enable));
+  MOCK_METHOD2(AddNetworkAsync, void(const KeyValueStore& args,
+                                     const RpcIdentifierCallback& callback));
+  MOCK_METHOD2(FlushBSSAsync, void(uint32_t age,
+                                   const ResultCallback& callback));
+  MOCK_METHOD2(ScanAsync, void(const KeyValueStore& args,
+                               const ResultCallback& callback));
+  MOCK_METHOD2(SelectNetworkAsync, void(const std::string& network,
+                                        const ResultCallback& callback));
+  MOCK_METHOD3(SetHT40EnableAsync, void(const std::string& network,
+                                        bool enable,
+                                        const ResultCallback& callback));
+  MOCK_METHOD2(SetRoamThresholdAsync, void(uint16_t threshold,
+                                           const ResultCallback& callback));
 
  private:
   DISALLOW_COPY_AND_ASSIGN(MockSupplicantInterfaceProxy);
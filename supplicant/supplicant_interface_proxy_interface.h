@@ -20,6 +20,7 @@
 #include <map>
 #include <string>
 
+#include "shill/callbacks.h"
 #include "shill/key_value_store.h"
 
 namespace shill {
@@ -59,6 +60,24 @@ class SupplicantInterfaceProxyInterface {
                                       std::string* status) = 0;
   virtual bool TDLSTeardown(const std::string& peer) = 0;
   virtual bool SetHT40Enable(const std::string& network, bool enable) = 0;
+
+  // Asynchronous variants of the calls above.  Each returns immediately and
+  // runs |callback| once wpa_supplicant has replied.  Calls issued without
+  // waiting for earlier replies are pipelined on the bus, and wpa_supplicant
+  // handles them in the order they were issued.
+  virtual void AddNetworkAsync(const KeyValueStore& args,
+                               const RpcIdentifierCallback& callback) = 0;
+  virtual void FlushBSSAsync(uint32_t age,
+                             const ResultCallback& callback) = 0;
+  virtual void ScanAsync(const KeyValueStore& args,
+                         const ResultCallback& callback) = 0;
+  virtual void SelectNetworkAsync(const std::string& network,
+                                  const ResultCallback& callback) = 0;
+  virtual void SetHT40EnableAsync(const std::string& network,
+                                  bool enable,
+                                  const ResultCallback& callback) = 0;
+  virtual void SetRoamThresholdAsync(uint16_t threshold,
+                                     const ResultCallback& callback) = 0;
 };
 
 }  // namespace shill
@@ -99,6 +99,9 @@ const char OpenVPNDriver::kOpenVPNPath[] = "/usr/sbin/openvpn";
 // static
 const char OpenVPNDriver::kOpenVPNScript[] = SHIMDIR "/openvpn-script";
 // static
+const char OpenVPNDriver::kOpenVPNPreserveTunnelProperty[] =
+    "OpenVPN.PreserveTunnel";
+// static
 const VPNDriver::Property OpenVPNDriver::kProperties[] = {
   { kOpenVPNAuthNoCacheProperty, 0 },
   { kOpenVPNAuthProperty, 0 },
@@ -118,6 +121,7 @@ const VPNDriver::Property OpenVPNDriver::kProperties[] = {
   { kOpenVPNPasswordProperty, Property::kCredential | Property::kWriteOnly },
   { kOpenVPNPinProperty, Property::kCredential },
   { kOpenVPNPortProperty, 0 },
+  { kOpenVPNPreserveTunnelProperty, 0 },
   { kOpenVPNProtoProperty, 0 },
   { kOpenVPNProviderProperty, 0 },
   { kOpenVPNPushPeerInfoProperty, 0 },
@@ -176,6 +180,7 @@ OpenVPNDriver::OpenVPNDriver(ControlInterface* control,
       extra_certificates_file_(new CertificateFile()),
       lsb_release_file_(kLSBReleaseFile),
       openvpn_config_directory_(kDefaultOpenVPNConfigurationDirectory),
+      tunnel_preserved_(false),
       pid_(0),
       default_service_callback_tag_(0) {}
 
@@ -255,6 +260,7 @@ void OpenVPNDriver::Cleanup(Service::ConnectState state,
     service_ = nullptr;
   }
   ip_properties_ = IPConfig::Properties();
+  tunnel_preserved_ = false;
 }
 
 // static
@@ -392,11 +398,25 @@ void OpenVPNDriver::Notify(const string& reason,
                            const map<string, string>& dict) {
   LOG(INFO) << "IP configuration received: " << reason;
   if (reason != "up") {
+    tunnel_preserved_ = false;
     device_->DropConnection();
     return;
   }
   // On restart/reconnect, update the existing IP configuration.
-  ParseIPConfiguration(dict, &ip_properties_);
+  IPConfig::Properties properties = ip_properties_;
+  ParseIPConfiguration(dict, &properties);
+  if (tunnel_preserved_) {
+    tunnel_preserved_ = false;
+    if (properties == ip_properties_) {
+      // The tunnel device still carries this configuration, so there is
+      // nothing to re-apply.
+      LOG(INFO) << "Tunnel re-established with an unchanged configuration.";
+      StopConnectTimeout();
+      return;
+    }
+    LOG(INFO) << "Tunnel re-established with a new configuration.";
+  }
+  ip_properties_ = properties;
   device_->SelectService(service_);
   device_->UpdateIPConfig(ip_properties_);
   ReportConnectionMetrics();
@@ -978,6 +998,22 @@ void OpenVPNDriver::OnReconnecting(ReconnectReason reason) {
     StopConnectTimeout();
   }
   StartConnectTimeout(timeout_seconds);
+  if (tunnel_preserved_) {
+    return;
+  }
+  if (device_ && !ip_properties_.address.empty() &&
+      IsPreserveTunnelEnabled()) {
+    // Keep the tunnel device, its addresses, routes and DNS configuration in
+    // place, and leave the service connected so that it remains the default.
+    // Traffic routed into the tunnel is dropped by openvpn (persist-tun)
+    // until the tunnel is re-established instead of leaking onto the
+    // underlying network. The changes pushed by the server, if any, are
+    // applied by Notify.
+    LOG(INFO) << "Preserving tunnel state while reconnecting.";
+    tunnel_preserved_ = true;
+    management_server_->ReleaseHold();
+    return;
+  }
   // On restart/reconnect, drop the VPN connection, if any. The openvpn client
   // might be in hold state if the VPN connection was previously established
   // successfully. The hold will be released by OnDefaultServiceChanged when a
@@ -1053,14 +1089,20 @@ void OpenVPNDriver::OnDefaultServiceChanged(const ServiceRefPtr& service) {
   // the openvpn client until an underlying connection is established. If the
   // default service is our VPN service, hold the openvpn client on reconnect so
   // that the VPN connection can be torn down fully before a new connection
-  // attempt is made over the underlying service.
-  if (service && service != service_ && service->IsConnected()) {
+  // attempt is made over the underlying service, unless the tunnel is being
+  // preserved across the reconnect.
+  if (service && (service != service_ || tunnel_preserved_) &&
+      service->IsConnected()) {
     management_server_->ReleaseHold();
   } else {
     management_server_->Hold();
   }
 }
 
+bool OpenVPNDriver::IsPreserveTunnelEnabled() const {
+  return const_args()->ContainsString(kOpenVPNPreserveTunnelProperty);
+}
+
 void OpenVPNDriver::ReportConnectionMetrics() {
   metrics_->SendEnumToUMA(
       Metrics::kMetricVpnDriver,
@@ -152,12 +152,14 @@ class OpenVPNDriver : public VPNDriver,
   FRIEND_TEST(OpenVPNDriverTest, Notify);
   FRIEND_TEST(OpenVPNDriverTest, NotifyUMA);
   FRIEND_TEST(OpenVPNDriverTest, NotifyFail);
+  FRIEND_TEST(OpenVPNDriverTest, NotifyPreservedTunnel);
   FRIEND_TEST(OpenVPNDriverTest, OnDefaultServiceChanged);
   FRIEND_TEST(OpenVPNDriverTest, OnOpenVPNDied);
   FRIEND_TEST(OpenVPNDriverTest, OnOpenVPNExited);
   FRIEND_TEST(OpenVPNDriverTest, ParseForeignOption);
   FRIEND_TEST(OpenVPNDriverTest, ParseForeignOptions);
   FRIEND_TEST(OpenVPNDriverTest, ParseIPConfiguration);
+  FRIEND_TEST(OpenVPNDriverTest, OnReconnectingPreserveTunnel);
   FRIEND_TEST(OpenVPNDriverTest, ParseRouteOption);
   FRIEND_TEST(OpenVPNDriverTest, SetRoutes);
   FRIEND_TEST(OpenVPNDriverTest, SpawnOpenVPN);
@@ -173,6 +175,7 @@ class OpenVPNDriver : public VPNDriver,
 
   static const char kOpenVPNPath[];
   static const char kOpenVPNScript[];
+  static const char kOpenVPNPreserveTunnelProperty[];
   static const Property kProperties[];
 
   static const char kLSBReleaseFile[];
@@ -263,6 +266,11 @@ class OpenVPNDriver : public VPNDriver,
 
   void OnDefaultServiceChanged(const ServiceRefPtr& service);
 
+  // Returns true if the tunnel device and its IP configuration should be kept
+  // in place while openvpn reconnects, rather than being torn down and
+  // rebuilt once the tunnel is re-established.
+  bool IsPreserveTunnelEnabled() const;
+
   void ReportConnectionMetrics();
 
   ControlInterface* control_;
@@ -284,6 +292,10 @@ class OpenVPNDriver : public VPNDriver,
   base::FilePath openvpn_config_file_;
   IPConfig::Properties ip_properties_;
 
+  // True while openvpn renegotiates a tunnel whose device, addresses and
+  // routes were kept in place by OnReconnecting.
+  bool tunnel_preserved_;
+
   // The PID of the spawned openvpn process. May be 0 if no process has been
   // spawned yet or the process has died.
   int pid_;
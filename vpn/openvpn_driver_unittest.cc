@@ -486,6 +486,34 @@ INSTANTIATE_TEST_CASE_P(
               Metrics::kVpnUserAuthenticationTypeOpenVpnUsernamePasswordOtp,
               Metrics::kVpnUserAuthenticationTypeOpenVpnUsernameToken })));
 
+TEST_F(OpenVPNDriverTest, NotifyPreservedTunnel) {
+  map<string, string> config;
+  config["ifconfig_local"] = "1.2.3.4";
+  driver_->service_ = service_;
+  driver_->device_ = device_;
+  EXPECT_CALL(*device_, UpdateIPConfig(_));
+  driver_->Notify("up", config);
+  Mock::VerifyAndClearExpectations(device_.get());
+
+  // Unchanged configuration for a preserved tunnel is not re-applied.
+  driver_->tunnel_preserved_ = true;
+  StartConnectTimeout(0);
+  EXPECT_CALL(*device_, UpdateIPConfig(_)).Times(0);
+  driver_->Notify("up", config);
+  EXPECT_FALSE(driver_->tunnel_preserved_);
+  EXPECT_FALSE(driver_->IsConnectTimeoutStarted());
+  Mock::VerifyAndClearExpectations(device_.get());
+
+  // A changed configuration is applied.
+  driver_->tunnel_preserved_ = true;
+  config["ifconfig_local"] = "1.2.3.5";
+  EXPECT_CALL(*device_,
+              UpdateIPConfig(Field(&IPConfig::Properties::address, "1.2.3.5")));
+  driver_->Notify("up", config);
+  EXPECT_FALSE(driver_->tunnel_preserved_);
+  EXPECT_EQ("1.2.3.5", driver_->ip_properties_.address);
+}
+
 TEST_F(OpenVPNDriverTest, NotifyFail) {
   map<string, string> dict;
   driver_->device_ = device_;
@@ -1304,6 +1332,34 @@ TEST_F(OpenVPNDriverTest, OnReconnectingUnknown) {
   EXPECT_TRUE(IsConnectTimeoutStarted());
 }
 
+TEST_F(OpenVPNDriverTest, OnReconnectingPreserveTunnel) {
+  SetArg(OpenVPNDriver::kOpenVPNPreserveTunnelProperty, "true");
+  SetDevice(device_);
+  SetService(service_);
+
+  // Without an established tunnel, there is nothing to preserve.
+  EXPECT_CALL(*device_, DropConnection());
+  EXPECT_CALL(*service_, SetState(Service::kStateAssociating));
+  driver_->OnReconnecting(OpenVPNDriver::kReconnectReasonOffline);
+  EXPECT_FALSE(driver_->tunnel_preserved_);
+  Mock::VerifyAndClearExpectations(device_.get());
+  Mock::VerifyAndClearExpectations(service_.get());
+
+  // An established tunnel keeps its device state and the service stays
+  // connected.
+  driver_->ip_properties_.address = "1.2.3.4";
+  EXPECT_CALL(*device_, DropConnection()).Times(0);
+  EXPECT_CALL(*service_, SetState(_)).Times(0);
+  EXPECT_CALL(*management_server_, ReleaseHold());
+  driver_->OnReconnecting(OpenVPNDriver::kReconnectReasonOffline);
+  EXPECT_TRUE(driver_->tunnel_preserved_);
+  EXPECT_TRUE(IsConnectTimeoutStarted());
+
+  // A subsequent RECONNECTING notification is a no-op.
+  driver_->OnReconnecting(OpenVPNDriver::kReconnectReasonUnknown);
+  EXPECT_TRUE(driver_->tunnel_preserved_);
+}
+
 TEST_F(OpenVPNDriverTest, OnReconnectingTLSError) {
   EXPECT_CALL(dispatcher_,
               PostDelayedTask(_, GetReconnectOfflineTimeoutSeconds() * 1000));
@@ -1404,6 +1460,13 @@ TEST_F(OpenVPNDriverTest, OnDefaultServiceChanged) {
   EXPECT_CALL(*mock_service, IsConnected()).WillOnce(Return(true));
   EXPECT_CALL(*management_server_, ReleaseHold());
   driver_->OnDefaultServiceChanged(mock_service);
+
+  // The openvpn client is not held behind our own service while the tunnel
+  // is being preserved.
+  driver_->tunnel_preserved_ = true;
+  EXPECT_CALL(*service_, IsConnected()).WillOnce(Return(true));
+  EXPECT_CALL(*management_server_, ReleaseHold());
+  driver_->OnDefaultServiceChanged(service_);
 }
 
 TEST_F(OpenVPNDriverTest, GetReconnectTimeoutSeconds) {
@@ -56,6 +56,9 @@ static string ObjectID(OpenVPNManagementServer* o) {
 
 namespace {
 const char kPasswordTagAuth[] = "Auth";
+// openvpn can emit bursts of state and log lines; read them in one wakeup.
+const int kMaxReadsPerWakeup = 4;
+const size_t kMaxBytesPerWakeup = 4 * IOHandler::kDataBufferSize;
 }  // namespace
 
 const char OpenVPNManagementServer::kStateReconnecting[] = "RECONNECTING";
@@ -182,8 +185,10 @@ void OpenVPNManagementServer::OnReady(int fd) {
     return;
   }
   ready_handler_.reset();
-  input_handler_.reset(dispatcher_->CreateInputHandler(
+  input_handler_.reset(dispatcher_->CreateDrainingInputHandler(
       connected_socket_,
+      IOHandler::ReadBudget(IOHandler::kDataBufferSize, kMaxReadsPerWakeup,
+                            kMaxBytesPerWakeup),
       Bind(&OpenVPNManagementServer::OnInput, Unretained(this)),
       Bind(&OpenVPNManagementServer::OnInputError, Unretained(this))));
   SendState("on");
@@ -263,7 +263,8 @@ TEST_F(OpenVPNManagementServerTest, OnReady) {
   EXPECT_CALL(sockets_, Accept(kSocket, nullptr, nullptr))
       .WillOnce(Return(kConnectedSocket));
   server_.ready_handler_.reset(new IOHandler());
-  EXPECT_CALL(dispatcher_, CreateInputHandler(kConnectedSocket, _, _))
+  EXPECT_CALL(dispatcher_,
+              CreateDrainingInputHandler(kConnectedSocket, _, _, _))
       .WillOnce(ReturnNew<IOHandler>());
   ExpectSend("state on\n");
   server_.OnReady(kSocket);
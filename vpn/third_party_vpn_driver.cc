@@ -58,6 +58,10 @@ namespace {
 
 const int32_t kConstantMaxMtu = (1 << 16) - 1;
 const int32_t kConnectTimeoutSeconds = 60*5;
+// Each read from the tun device returns one packet, so under load draining
+// many packets per wakeup saves a message loop iteration per packet.
+const int kTunMaxReadsPerWakeup = 64;
+const size_t kTunMaxBytesPerWakeup = 256 * 1024;
 
 std::string IPAddressFingerprint(const IPAddress& address) {
   static const std::string hex_to_bin[] = {
@@ -484,8 +488,10 @@ bool ThirdPartyVpnDriver::ClaimInterface(const std::string& link_name,
     Cleanup(Service::kStateFailure, Service::kFailureInternal,
             "Unable to open tun interface");
   } else {
-    io_handler_.reset(dispatcher_->CreateInputHandler(
+    io_handler_.reset(dispatcher_->CreateDrainingInputHandler(
         tun_fd_,
+        IOHandler::ReadBudget(kConstantMaxMtu, kTunMaxReadsPerWakeup,
+                              kTunMaxBytesPerWakeup),
         base::Bind(&ThirdPartyVpnDriver::OnInput, base::Unretained(this)),
         base::Bind(&ThirdPartyVpnDriver::OnInputError,
                    base::Unretained(this))));
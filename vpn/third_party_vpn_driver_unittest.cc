@@ -103,7 +103,7 @@ TEST_F(ThirdPartyVpnDriverTest, ConnectAndDisconnect) {
 
   EXPECT_CALL(device_info_, OpenTunnelInterface(interface))
       .WillOnce(Return(fd));
-  EXPECT_CALL(dispatcher_, CreateInputHandler(fd, _, _))
+  EXPECT_CALL(dispatcher_, CreateDrainingInputHandler(fd, _, _, _))
       .WillOnce(Return(io_handler));
   EXPECT_CALL(*adaptor_interface_, EmitPlatformMessage(static_cast<uint32_t>(
                                        ThirdPartyVpnDriver::kConnected)));
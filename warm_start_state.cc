@@ -0,0 +1,177 @@
+//
+// Copyright (C) 2015 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "shill/warm_start_state.h"
+
+#include <memory>
+
+#include <base/files/file_util.h>
+#include <base/strings/string_number_conversions.h>
+#include <base/strings/string_util.h>
+
+#include "shill/logging.h"
+#include "shill/store_factory.h"
+#include "shill/store_interface.h"
+
+using base::FilePath;
+using std::string;
+
+namespace shill {
+
+namespace Logging {
+static auto kModuleLogScope = ScopeLogger::kManager;
+static string ObjectID(const WarmStartState* w) { return "(warm_start)"; }
+}
+
+// Bump this whenever the layout below changes incompatibly.
+const int WarmStartState::kVersion = 2;
+const char WarmStartState::kStorageFileName[] = "warm_start_state";
+
+const char WarmStartState::kServiceGroupPrefix[] = "service_";
+const char WarmStartState::kHeaderGroup[] = "warm_start";
+const char WarmStartState::kTemporaryFileSuffix[] = "new";
+const char WarmStartState::kGatewayKey[] = "Gateway";
+const char WarmStartState::kInterfaceNameKey[] = "InterfaceName";
+const char WarmStartState::kStorageIdentifierKey[] = "StorageIdentifier";
+const char WarmStartState::kTimestampKey[] = "Timestamp";
+const char WarmStartState::kVersionKey[] = "Version";
+
+WarmStartState::WarmStartState() {}
+
+WarmStartState::~WarmStartState() {}
+
+bool WarmStartState::Save(const FilePath& run_path, time_t now) const {
+  FilePath path = run_path.Append(kStorageFileName);
+  FilePath temporary_path = path.AddExtension(kTemporaryFileSuffix);
+  // The snapshot is built from scratch so that entries for services that
+  // have since gone away do not linger, and only replaces the earlier one
+  // once it is complete.
+  base::DeleteFile(temporary_path, false);
+  std::unique_ptr<StoreInterface> storage(
+      StoreFactory::GetInstance()->CreateStore(temporary_path));
+  if (!storage->Open()) {
+    LOG(ERROR) << "Failed to open warm start state at '"
+               << temporary_path.AsUTF8Unsafe() << "'";
+    return false;
+  }
+
+  storage->SetInt(kHeaderGroup, kVersionKey, kVersion);
+  storage->SetUint64(kHeaderGroup, kTimestampKey, now);
+
+  for (size_t i = 0; i < services_.size(); ++i) {
+    const string group = kServiceGroupPrefix + base::SizeTToString(i);
+    storage->SetString(group, kStorageIdentifierKey,
+                       services_[i].storage_identifier);
+    storage->SetString(group, kInterfaceNameKey, services_[i].interface_name);
+    storage->SetString(group, kGatewayKey, services_[i].gateway);
+  }
+
+  if (!storage->Flush()) {
+    LOG(ERROR) << "Failed to write warm start state.";
+    base::DeleteFile(temporary_path, false);
+    return false;
+  }
+  storage.reset();
+  if (!base::ReplaceFile(temporary_path, path, nullptr)) {
+    PLOG(ERROR) << "Failed to replace warm start state";
+    base::DeleteFile(temporary_path, false);
+    return false;
+  }
+  SLOG(this, 2) << "Saved warm start state with " << services_.size()
+                << " online services.";
+  return true;
+}
+
+bool WarmStartState::Load(const FilePath& run_path,
+                          time_t now,
+                          time_t max_age_seconds) {
+  Clear();
+  FilePath path = run_path.Append(kStorageFileName);
+  std::unique_ptr<StoreInterface> storage(
+      StoreFactory::GetInstance()->CreateStore(path));
+  if (!storage->IsNonEmpty()) {
+    SLOG(this, 2) << "No warm start state.";
+    return false;
+  }
+  if (!storage->Open()) {
+    LOG(WARNING) << "Failed to open warm start state; starting cold.";
+    return false;
+  }
+
+  int version = 0;
+  uint64_t timestamp = 0;
+  if (!storage->GetInt(kHeaderGroup, kVersionKey, &version) ||
+      version != kVersion ||
+      !storage->GetUint64(kHeaderGroup, kTimestampKey, &timestamp)) {
+    LOG(INFO) << "Ignoring warm start state from version " << version;
+    return false;
+  }
+  if (static_cast<uint64_t>(now) < timestamp ||
+      static_cast<uint64_t>(now) - timestamp >
+          static_cast<uint64_t>(max_age_seconds)) {
+    LOG(INFO) << "Ignoring stale warm start state.";
+    return false;
+  }
+
+  for (const auto& group : storage->GetGroups()) {
+    if (!base::StartsWith(group, kServiceGroupPrefix,
+                          base::CompareCase::SENSITIVE)) {
+      continue;
+    }
+    ServiceState service;
+    if (!storage->GetString(group, kStorageIdentifierKey,
+                            &service.storage_identifier) ||
+        !storage->GetString(group, kInterfaceNameKey,
+                            &service.interface_name) ||
+        !storage->GetString(group, kGatewayKey, &service.gateway)) {
+      continue;
+    }
+    services_.push_back(service);
+  }
+
+  LOG(INFO) << "Loaded warm start state with " << services_.size()
+            << " online services.";
+  return true;
+}
+
+void WarmStartState::Clear() {
+  services_.clear();
+}
+
+bool WarmStartState::IsEmpty() const {
+  return services_.empty();
+}
+
+const WarmStartState::ServiceState* WarmStartState::FindService(
+    const string& storage_identifier) const {
+  for (const auto& service : services_) {
+    if (service.storage_identifier == storage_identifier) {
+      return &service;
+    }
+  }
+  return nullptr;
+}
+
+void WarmStartState::RemoveService(const string& storage_identifier) {
+  for (auto it = services_.begin(); it != services_.end(); ++it) {
+    if (it->storage_identifier == storage_identifier) {
+      services_.erase(it);
+      return;
+    }
+  }
+}
+
+}  // namespace shill
@@ -0,0 +1,103 @@
+//
+// Copyright (C) 2015 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef SHILL_WARM_START_STATE_H_
+#define SHILL_WARM_START_STATE_H_
+
+#include <time.h>
+
+#include <string>
+#include <vector>
+
+#include <base/files/file_path.h>
+#include <base/macros.h>
+
+namespace shill {
+
+// WarmStartState is a compact snapshot of runtime state that the Manager
+// writes to its run directory periodically and when it stops.  The run
+// directory does not survive a reboot, but does survive a restart of the
+// daemon (crash respawn, upgrade, reload), which is when the snapshot is
+// useful: it is loaded at startup as a set of hints about what the daemon
+// was doing before.  It only records which services were online, and over
+// which interface and gateway, so that a service reconnecting the same way
+// can be reported online while portal detection confirms it.  Nothing in the
+// snapshot is ever treated as authoritative.
+//
+// The snapshot is versioned; a snapshot written by a different version, or
+// one older than the caller is willing to trust, is discarded on load.
+class WarmStartState {
+ public:
+  // A service that was online, and the connection it was online over.
+  struct ServiceState {
+    std::string storage_identifier;
+    std::string interface_name;
+    std::string gateway;
+  };
+
+  static const int kVersion;
+  static const char kStorageFileName[];
+
+  WarmStartState();
+  ~WarmStartState();
+
+  // Writes the snapshot, stamped with |now| (in seconds on the boottime
+  // clock), to kStorageFileName in |run_path|, replacing any earlier
+  // snapshot.  The snapshot is written to a temporary file first, so a
+  // crash while saving leaves the earlier snapshot intact.  Returns true on
+  // success.
+  bool Save(const base::FilePath& run_path, time_t now) const;
+
+  // Replaces the contents of this snapshot with the one in |run_path|.
+  // Returns false, leaving the snapshot empty, if there is no snapshot, if
+  // it was written by a different version, or if it is more than
+  // |max_age_seconds| older than |now|.
+  bool Load(const base::FilePath& run_path, time_t now, time_t max_age_seconds);
+
+  // Empties the snapshot.
+  void Clear();
+
+  bool IsEmpty() const;
+
+  // Returns the entry for the service with |storage_identifier|, or nullptr
+  // if there is none.
+  const ServiceState* FindService(const std::string& storage_identifier) const;
+
+  // Removes the entry for the service with |storage_identifier|, once its
+  // hints have been used.
+  void RemoveService(const std::string& storage_identifier);
+
+  std::vector<ServiceState>* mutable_services() { return &services_; }
+  const std::vector<ServiceState>& services() const { return services_; }
+
+ private:
+  static const char kServiceGroupPrefix[];
+  static const char kHeaderGroup[];
+  static const char kTemporaryFileSuffix[];
+  static const char kGatewayKey[];
+  static const char kInterfaceNameKey[];
+  static const char kStorageIdentifierKey[];
+  static const char kTimestampKey[];
+  static const char kVersionKey[];
+
+  std::vector<ServiceState> services_;
+
+  DISALLOW_COPY_AND_ASSIGN(WarmStartState);
+};
+
+}  // namespace shill
+
+#endif  // SHILL_WARM_START_STATE_H_
@@ -0,0 +1,161 @@
+//
+// Copyright (C) 2015 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "shill/warm_start_state.h"
+
+#include <memory>
+
+#include <base/files/file_enumerator.h>
+#include <base/files/file_util.h>
+#include <base/files/scoped_temp_dir.h>
+#include <gtest/gtest.h>
+
+#include "shill/store_factory.h"
+#include "shill/store_interface.h"
+
+using std::string;
+
+namespace shill {
+
+namespace {
+const time_t kNow = 1000;
+const time_t kMaxAge = 300;
+const char kInterfaceName[] = "wlan0";
+const char kServiceId[] = "wifi_0123456789ab_73736964_managed_none";
+const char kGateway[] = "192.168.1.1";
+}  // namespace
+
+class WarmStartStateTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+  }
+
+ protected:
+  void PopulateState(WarmStartState* state) {
+    WarmStartState::ServiceState service;
+    service.storage_identifier = kServiceId;
+    service.interface_name = kInterfaceName;
+    service.gateway = kGateway;
+    state->mutable_services()->push_back(service);
+  }
+
+  base::FilePath StatePath() const {
+    return temp_dir_.path().Append(WarmStartState::kStorageFileName);
+  }
+
+  base::ScopedTempDir temp_dir_;
+};
+
+TEST_F(WarmStartStateTest, RoundTrip) {
+  WarmStartState saved;
+  PopulateState(&saved);
+  EXPECT_TRUE(saved.Save(temp_dir_.path(), kNow));
+
+  WarmStartState loaded;
+  EXPECT_TRUE(loaded.Load(temp_dir_.path(), kNow + kMaxAge, kMaxAge));
+  EXPECT_FALSE(loaded.IsEmpty());
+
+  const WarmStartState::ServiceState* service = loaded.FindService(kServiceId);
+  ASSERT_NE(nullptr, service);
+  EXPECT_EQ(kInterfaceName, service->interface_name);
+  EXPECT_EQ(kGateway, service->gateway);
+
+  loaded.RemoveService(kServiceId);
+  EXPECT_EQ(nullptr, loaded.FindService(kServiceId));
+  EXPECT_TRUE(loaded.IsEmpty());
+}
+
+TEST_F(WarmStartStateTest, SaveReplacesEarlierSnapshot) {
+  WarmStartState state;
+  PopulateState(&state);
+  EXPECT_TRUE(state.Save(temp_dir_.path(), kNow));
+
+  state.Clear();
+  EXPECT_TRUE(state.IsEmpty());
+  EXPECT_TRUE(state.Save(temp_dir_.path(), kNow));
+
+  WarmStartState loaded;
+  EXPECT_TRUE(loaded.Load(temp_dir_.path(), kNow, kMaxAge));
+  EXPECT_TRUE(loaded.IsEmpty());
+
+  // Only the snapshot itself is left behind.
+  base::FileEnumerator files(temp_dir_.path(), false,
+                             base::FileEnumerator::FILES);
+  EXPECT_EQ(StatePath(), files.Next());
+  EXPECT_TRUE(files.Next().empty());
+}
+
+TEST_F(WarmStartStateTest, SaveFailureKeepsEarlierSnapshot) {
+  WarmStartState saved;
+  PopulateState(&saved);
+  EXPECT_TRUE(saved.Save(temp_dir_.path(), kNow));
+
+  // A non-empty directory in the way of the temporary file makes the save
+  // fail.
+  base::FilePath temporary_path = StatePath().AddExtension("new");
+  ASSERT_TRUE(base::CreateDirectory(temporary_path));
+  ASSERT_EQ(0, base::WriteFile(temporary_path.Append("file"), "", 0));
+  WarmStartState empty;
+  EXPECT_FALSE(empty.Save(temp_dir_.path(), kNow));
+
+  WarmStartState loaded;
+  EXPECT_TRUE(loaded.Load(temp_dir_.path(), kNow, kMaxAge));
+  EXPECT_NE(nullptr, loaded.FindService(kServiceId));
+}
+
+TEST_F(WarmStartStateTest, LoadMissing) {
+  WarmStartState state;
+  PopulateState(&state);
+  EXPECT_FALSE(state.Load(temp_dir_.path(), kNow, kMaxAge));
+  EXPECT_TRUE(state.IsEmpty());
+}
+
+TEST_F(WarmStartStateTest, LoadStale) {
+  WarmStartState saved;
+  PopulateState(&saved);
+  EXPECT_TRUE(saved.Save(temp_dir_.path(), kNow));
+
+  WarmStartState loaded;
+  EXPECT_FALSE(loaded.Load(temp_dir_.path(), kNow + kMaxAge + 1, kMaxAge));
+  EXPECT_TRUE(loaded.IsEmpty());
+
+  // A timestamp in the future means the clock has gone backwards, i.e. the
+  // snapshot predates a reboot and cannot be trusted either.
+  EXPECT_FALSE(loaded.Load(temp_dir_.path(), kNow - 1, kMaxAge));
+  EXPECT_TRUE(loaded.IsEmpty());
+}
+
+TEST_F(WarmStartStateTest, LoadVersionMismatch) {
+  WarmStartState saved;
+  PopulateState(&saved);
+  EXPECT_TRUE(saved.Save(temp_dir_.path(), kNow));
+
+  {
+    std::unique_ptr<StoreInterface> storage(
+        StoreFactory::GetInstance()->CreateStore(StatePath()));
+    ASSERT_TRUE(storage->Open());
+    ASSERT_TRUE(storage->SetInt("warm_start", "Version",
+                                WarmStartState::kVersion + 1));
+    ASSERT_TRUE(storage->Flush());
+  }
+
+  WarmStartState loaded;
+  EXPECT_FALSE(loaded.Load(temp_dir_.path(), kNow, kMaxAge));
+  EXPECT_TRUE(loaded.IsEmpty());
+}
+
+}  // namespace shill
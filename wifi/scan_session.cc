@@ -49,7 +49,8 @@ static string ObjectID(ScanSession* s) { return "(scan_session)"; }
 
 const float ScanSession::kAllFrequencies = 1.1;
 const uint64_t ScanSession::kScanRetryDelayMilliseconds = 200;  // Arbitrary.
-const size_t ScanSession::kScanRetryCount = 50;
+const uint64_t ScanSession::kScanRetryMaxDelayMilliseconds = 1000;
+const size_t ScanSession::kScanRetryCount = 15;
 
 ScanSession::ScanSession(
     NetlinkManager* netlink_manager,
@@ -77,7 +78,11 @@ ScanSession::ScanSession(
       on_scan_failed_(on_scan_failed),
       scan_tries_left_(kScanRetryCount),
       found_error_(false),
+      scan_event_handler_registered_(false),
+      scan_retry_delay_milliseconds_(kScanRetryDelayMilliseconds),
       metrics_(metrics) {
+  scan_event_handler_ = Bind(&ScanSession::OnScanEvent,
+                             weak_ptr_factory_.GetWeakPtr());
   sort(frequency_list_.begin(), frequency_list_.end(),
        &ScanSession::CompareFrequencyCount);
   // Add to |frequency_list_| all the frequencies from |available_frequencies|
@@ -104,6 +109,7 @@ ScanSession::ScanSession(
 }
 
 ScanSession::~ScanSession() {
+  StopEbusyRetry();
   const int kLogLevel = 6;
   ReportResults(kLogLevel);
 }
@@ -150,10 +156,12 @@ void ScanSession::InitiateScan() {
   current_scan_frequencies_ = GetScanFrequencies(fraction_wanted,
                                                  min_frequencies_,
                                                  max_frequencies_);
+  scan_retry_delay_milliseconds_ = kScanRetryDelayMilliseconds;
   DoScan(current_scan_frequencies_);
 }
 
 void ScanSession::ReInitiateScan() {
+  StopEbusyRetry();
   ebusy_timer_.Pause();
   DoScan(current_scan_frequencies_);
 }
@@ -257,15 +265,14 @@ void ScanSession::OnTriggerScanErrorResponse(
               found_error_ = true;
               on_scan_failed_.Run();
               scan_tries_left_ = kScanRetryCount;
+              scan_retry_delay_milliseconds_ = kScanRetryDelayMilliseconds;
               return;
             }
             --scan_tries_left_;
             SLOG(this, 3) << __func__ << " - trying again (" << scan_tries_left_
                           << " remaining after this)";
             ebusy_timer_.Resume();
-            dispatcher_->PostDelayedTask(Bind(&ScanSession::ReInitiateScan,
-                                              weak_ptr_factory_.GetWeakPtr()),
-                                         kScanRetryDelayMilliseconds);
+            ScheduleEbusyRetry();
             break;
           }
           found_error_ = true;
@@ -298,6 +305,56 @@ void ScanSession::OnTriggerScanErrorResponse(
   }
 }
 
+void ScanSession::ScheduleEbusyRetry() {
+  if (!scan_event_handler_registered_) {
+    scan_event_handler_registered_ =
+        netlink_manager_->AddBroadcastHandler(scan_event_handler_);
+  }
+  ebusy_retry_callback_.Reset(Bind(&ScanSession::ReInitiateScan,
+                                   weak_ptr_factory_.GetWeakPtr()));
+  dispatcher_->PostDelayedTask(ebusy_retry_callback_.callback(),
+                               scan_retry_delay_milliseconds_);
+  scan_retry_delay_milliseconds_ = std::min(2 * scan_retry_delay_milliseconds_,
+                                            kScanRetryMaxDelayMilliseconds);
+}
+
+void ScanSession::StopEbusyRetry() {
+  ebusy_retry_callback_.Cancel();
+  if (scan_event_handler_registered_) {
+    netlink_manager_->RemoveBroadcastHandler(scan_event_handler_);
+    scan_event_handler_registered_ = false;
+  }
+}
+
+void ScanSession::OnScanEvent(const NetlinkMessage& netlink_message) {
+  if (ebusy_retry_callback_.IsCancelled()) {
+    return;  // Not waiting to retry a scan.
+  }
+  if (netlink_message.message_type() != Nl80211Message::GetMessageType()) {
+    return;
+  }
+  const Nl80211Message& nl80211_message =
+      *reinterpret_cast<const Nl80211Message*>(&netlink_message);
+  if (nl80211_message.command() != NewScanResultsMessage::kCommand &&
+      nl80211_message.command() != ScanAbortedMessage::kCommand) {
+    return;
+  }
+  uint32_t ifindex;
+  if (!nl80211_message.const_attributes()->GetU32AttributeValue(
+          NL80211_ATTR_IFINDEX, &ifindex) ||
+      ifindex != wifi_interface_index_) {
+    return;
+  }
+  SLOG(this, 3) << __func__ << ": radio is free ("
+                << nl80211_message.command_string() << "), retrying scan";
+  // The broadcast handler cannot be removed while NetlinkManager is
+  // dispatching to it, so the handler is removed when the posted retry runs.
+  ebusy_retry_callback_.Reset(Bind(&ScanSession::ReInitiateScan,
+                                   weak_ptr_factory_.GetWeakPtr()));
+  dispatcher_->PostTask(ebusy_retry_callback_.callback());
+  scan_retry_delay_milliseconds_ = kScanRetryDelayMilliseconds;
+}
+
 void ScanSession::ReportResults(int log_level) {
   SLOG(this, log_level) << "------ ScanSession finished ------";
   SLOG(this, log_level) << "Scanned "
@@ -22,6 +22,7 @@
 #include <vector>
 
 #include <base/callback.h>
+#include <base/cancelable_callback.h>
 #include <base/macros.h>
 #include <base/memory/weak_ptr.h>
 #include <gtest/gtest_prod.h>  // for FRIEND_TEST
@@ -91,8 +92,10 @@ class ScanSession {
   static const float kAllFrequencies;
 
   // Sets up a new progressive scan session.  Uses |netlink_manager| to send
-  // NL80211_CMD_TRIGGER_SCAN messages to the kernel (uses |dispatcher| to
-  // reissue those commands if a send request returns EBUSY).  Multiple scans
+  // NL80211_CMD_TRIGGER_SCAN messages to the kernel.  If a send request
+  // returns EBUSY, the command is reissued as soon as the kernel broadcasts
+  // the end of the scan that kept the radio busy, or after a backoff delay
+  // (posted on |dispatcher|) if no such broadcast arrives.  Multiple scans
   // for APs on wifi device |ifindex| are issued (one for each call to
   // |InitiateScan|) on wifi frequencies taken from the union of unique
   // frequencies in |previous_frequencies| and |available_frequencies| (most
@@ -144,11 +147,16 @@ class ScanSession {
   friend class ScanSessionTest;
   friend class WiFiObjectTest;  // OnTriggerScanResponse.
   FRIEND_TEST(ScanSessionTest, EBusy);
+  FRIEND_TEST(ScanSessionTest, EBusyBackoff);
+  FRIEND_TEST(ScanSessionTest, EBusyRetryOnScanEvent);
   FRIEND_TEST(ScanSessionTest, OnError);
   FRIEND_TEST(ScanSessionTest, OnTriggerScanResponse);
 
-  // Milliseconds to wait before retrying a failed scan.
+  // Milliseconds to wait before retrying a scan that failed with EBUSY if the
+  // kernel does not report the end of the busy scan first.  The delay doubles
+  // with each retry, up to |kScanRetryMaxDelayMilliseconds|.
   static const uint64_t kScanRetryDelayMilliseconds;
+  static const uint64_t kScanRetryMaxDelayMilliseconds;
   // Number of times to retry a failed scan before giving up and calling
   // |on_scan_failed_|.
   static const size_t kScanRetryCount;
@@ -194,6 +202,16 @@ class ScanSession {
   void OnTriggerScanResponse(const Nl80211Message& message);
   void OnTriggerScanErrorResponse(NetlinkManager::AuxilliaryMessageType type,
                                   const NetlinkMessage* netlink_message);
+
+  // Arranges for the current scan to be re-issued after an EBUSY failure,
+  // either when |OnScanEvent| sees the busy radio become free or when the
+  // backoff delay expires, whichever comes first.
+  void ScheduleEbusyRetry();
+  // Stops listening for scan events and cancels any pending backoff retry.
+  void StopEbusyRetry();
+  // Handles NL80211_CMD_NEW_SCAN_RESULTS and NL80211_CMD_SCAN_ABORTED
+  // broadcasts for this interface while waiting to retry a scan.
+  void OnScanEvent(const NetlinkMessage& netlink_message);
   void ReportEbusyTime(int log_level);
 
   // Logs the results of the scan.
@@ -220,6 +238,12 @@ class ScanSession {
   size_t scan_tries_left_;
   bool found_error_;
 
+  // EBUSY retry state.
+  NetlinkManager::NetlinkMessageHandler scan_event_handler_;
+  bool scan_event_handler_registered_;
+  base::CancelableClosure ebusy_retry_callback_;
+  uint64_t scan_retry_delay_milliseconds_;
+
   // Statistics gathering.
   size_t original_frequency_count_;
   chromeos_metrics::Timer ebusy_timer_;
@@ -18,6 +18,7 @@
 
 #include <errno.h>
 
+#include <algorithm>
 #include <limits>
 #include <memory>
 #include <set>
@@ -37,6 +38,9 @@ using std::set;
 using std::vector;
 using testing::_;
 using testing::ContainerEq;
+using testing::Mock;
+using testing::Return;
+using testing::SaveArg;
 using testing::Test;
 
 namespace shill {
@@ -522,6 +526,80 @@ TEST_F(ScanSessionTest, EBusy) {
                                              &error_message);
 }
 
+TEST_F(ScanSessionTest, EBusyRetryOnScanEvent) {
+  Nl80211Message::SetMessageType(kNl80211FamilyId);
+  EXPECT_CALL(*netlink_manager(), SendNl80211Message(
+      IsNl80211Command(kNl80211FamilyId, NL80211_CMD_TRIGGER_SCAN), _, _, _));
+  scan_session()->InitiateScan();
+
+  // An EBUSY failure starts listening for scan events and schedules a
+  // fallback retry.
+  ErrorAckMessage error_message(-EBUSY);
+  EXPECT_CALL(*netlink_manager(), AddBroadcastHandler(_))
+      .WillOnce(Return(true));
+  EXPECT_CALL(*dispatcher(),
+              PostDelayedTask(_, static_cast<int64_t>(
+                  ScanSession::kScanRetryDelayMilliseconds)));
+  scan_session()->OnTriggerScanErrorResponse(NetlinkManager::kErrorFromKernel,
+                                             &error_message);
+  Mock::VerifyAndClearExpectations(netlink_manager());
+  Mock::VerifyAndClearExpectations(dispatcher());
+
+  // Scan events for other interfaces are ignored.
+  const uint32_t kOtherInterfaceIndex = 1;
+  NewScanResultsMessage other_results;
+  other_results.attributes()->CreateNl80211Attribute(
+      NL80211_ATTR_IFINDEX, NetlinkMessage::MessageContext());
+  other_results.attributes()->SetU32AttributeValue(NL80211_ATTR_IFINDEX,
+                                                   kOtherInterfaceIndex);
+  EXPECT_CALL(*dispatcher(), PostTask(_)).Times(0);
+  scan_session()->OnScanEvent(other_results);
+  Mock::VerifyAndClearExpectations(dispatcher());
+
+  // The end of the busy scan on this interface triggers an immediate retry.
+  ScanAbortedMessage scan_aborted;
+  scan_aborted.attributes()->CreateNl80211Attribute(
+      NL80211_ATTR_IFINDEX, NetlinkMessage::MessageContext());
+  scan_aborted.attributes()->SetU32AttributeValue(
+      NL80211_ATTR_IFINDEX, scan_session()->wifi_interface_index_);
+  base::Closure retry_task;
+  EXPECT_CALL(*dispatcher(), PostTask(_)).WillOnce(SaveArg<0>(&retry_task));
+  scan_session()->OnScanEvent(scan_aborted);
+  Mock::VerifyAndClearExpectations(dispatcher());
+
+  EXPECT_CALL(*netlink_manager(), RemoveBroadcastHandler(_))
+      .WillOnce(Return(true));
+  EXPECT_CALL(*netlink_manager(), SendNl80211Message(
+      IsNl80211Command(kNl80211FamilyId, NL80211_CMD_TRIGGER_SCAN), _, _, _));
+  retry_task.Run();
+  Mock::VerifyAndClearExpectations(netlink_manager());
+
+  // Once the retry has been issued, further scan events are ignored.
+  EXPECT_CALL(*dispatcher(), PostTask(_)).Times(0);
+  scan_session()->OnScanEvent(scan_aborted);
+}
+
+TEST_F(ScanSessionTest, EBusyBackoff) {
+  Nl80211Message::SetMessageType(kNl80211FamilyId);
+  EXPECT_CALL(*netlink_manager(), SendNl80211Message(
+      IsNl80211Command(kNl80211FamilyId, NL80211_CMD_TRIGGER_SCAN), _, _, _));
+  scan_session()->InitiateScan();
+
+  // Without scan events, retries back off up to the maximum delay.
+  ErrorAckMessage error_message(-EBUSY);
+  uint64_t expected_delay = ScanSession::kScanRetryDelayMilliseconds;
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_CALL(*dispatcher(),
+                PostDelayedTask(_, static_cast<int64_t>(expected_delay)));
+    scan_session()->OnTriggerScanErrorResponse(
+        NetlinkManager::kErrorFromKernel, &error_message);
+    Mock::VerifyAndClearExpectations(dispatcher());
+    expected_delay = std::min(2 * expected_delay,
+                              ScanSession::kScanRetryMaxDelayMilliseconds);
+  }
+  EXPECT_EQ(ScanSession::kScanRetryMaxDelayMilliseconds, expected_delay);
+}
+
 TEST_F(ScanSessionTest, ScanHidden) {
   scan_session_->AddSsid(ByteString("a", 1));
   EXPECT_CALL(netlink_manager_,
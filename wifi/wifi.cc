@@ -291,6 +291,7 @@ void WiFi::Stop(Error* error, const EnabledStateChangedCallback& /*callback*/) {
   tdls_manager_.reset();
   current_service_ = nullptr;            // breaks a reference cycle
   pending_service_ = nullptr;            // breaks a reference cycle
+  adding_network_service_ = nullptr;     // breaks a reference cycle
   is_debugging_connection_ = false;
   SetScanState(kScanIdle, kScanMethodNone, __func__);
   StopPendingTimer();
@@ -458,7 +459,8 @@ void WiFi::ConnectTo(WiFiService* service) {
   }
 
   // TODO(quiche): Handle cases where already connected.
-  if (pending_service_ && pending_service_ == service) {
+  if ((pending_service_ && pending_service_ == service) ||
+      (adding_network_service_ && adding_network_service_ == service)) {
     // TODO(quiche): Return an error to the caller. crbug.com/206812
     LOG(INFO) << "WiFi " << link_name() << " ignoring ConnectTo service "
               << service->unique_name()
@@ -466,6 +468,15 @@ void WiFi::ConnectTo(WiFiService* service) {
     return;
   }
 
+  // An attempt still waiting for its network to be added is superseded by
+  // this one, whether or not this one needs to add a network of its own.
+  if (adding_network_service_ && adding_network_service_ != service) {
+    SLOG(this, 2) << "Abandoning connection attempt to "
+                  << adding_network_service_->unique_name()
+                  << ", which is still adding its network.";
+    adding_network_service_ = nullptr;
+  }
+
   if (pending_service_ && pending_service_ != service) {
     LOG(INFO) << "Connecting to service. "
               << LogSSID(service->unique_name()) << ", "
@@ -496,25 +507,62 @@ void WiFi::ConnectTo(WiFiService* service) {
     AppendBgscan(service, &service_params);
     service_params.SetUint(WPASupplicant::kNetworkPropertyDisableVHT,
                            provider_->disable_vht());
-    if (!supplicant_interface_proxy_->AddNetwork(service_params,
-                                                 &network_path)) {
-      LOG(ERROR) << "Failed to add network";
+    // The connection attempt resumes in OnNetworkAdded once wpa_supplicant
+    // has created the network.  A later ConnectTo supersedes this one.
+    adding_network_service_ = service;
+    supplicant_interface_proxy_->AddNetworkAsync(
+        service_params,
+        Bind(&WiFi::OnNetworkAdded, weak_ptr_factory_.GetWeakPtr(),
+             WiFiServiceRefPtr(service)));
+    return;
+  }
+
+  SelectNetwork(service, network_path);
+}
+
+void WiFi::OnNetworkAdded(const WiFiServiceRefPtr& service,
+                          const string& network_path,
+                          const Error& error) {
+  const bool is_current_attempt = (service == adding_network_service_);
+  if (is_current_attempt) {
+    adding_network_service_ = nullptr;
+  }
+  if (error.IsFailure()) {
+    LOG(ERROR) << "Failed to add network";
+    if (is_current_attempt) {
       SetScanState(kScanIdle, scan_method_, __func__);
-      return;
     }
-    CHECK(!network_path.empty());  // No DBus path should be empty.
-    rpcid_by_service_[service] = network_path;
+    return;
+  }
+  CHECK(!network_path.empty());  // No DBus path should be empty.
+  // Remember the network even if the attempt was superseded, so that it is
+  // reused or removed later.
+  rpcid_by_service_[service.get()] = network_path;
+  if (!is_current_attempt) {
+    SLOG(this, 2) << "Connection attempt to " << service->unique_name()
+                  << " was superseded while adding its network.";
+    return;
   }
+  SelectNetwork(service.get(), network_path);
+}
 
+void WiFi::SelectNetwork(WiFiService* service, const string& network_path) {
   if (service->HasRecentConnectionIssues()) {
     SetConnectionDebugging(true);
   }
 
   // Enable HT40 for this network in case if it was disabled previously due to
-  // unreliable link.
-  supplicant_interface_proxy_->SetHT40Enable(network_path, true);
-
-  supplicant_interface_proxy_->SelectNetwork(network_path);
+  // unreliable link.  This and the selection below are issued back-to-back
+  // without waiting for replies.
+  supplicant_interface_proxy_->SetHT40EnableAsync(
+      network_path, true,
+      Bind(&WiFi::OnSupplicantOperationResult, weak_ptr_factory_.GetWeakPtr(),
+           "SetHT40Enable"));
+
+  supplicant_interface_proxy_->SelectNetworkAsync(
+      network_path,
+      Bind(&WiFi::OnSupplicantOperationResult, weak_ptr_factory_.GetWeakPtr(),
+           "SelectNetwork"));
   SetPendingService(service);
   CHECK(current_service_.get() != pending_service_.get());
 
@@ -545,6 +593,12 @@ void WiFi::DisconnectFromIfActive(WiFiService* service) {
 void WiFi::DisconnectFrom(WiFiService* service) {
   SLOG(this, 2) << __func__ << " service " << service->unique_name();
 
+  if (service == adding_network_service_) {
+    // The network is still being added; abandon the connection attempt.
+    adding_network_service_ = nullptr;
+    return;
+  }
+
   if (service != current_service_ &&  service != pending_service_) {
     // TODO(quiche): Once we have asynchronous reply support, we should
     // generate a D-Bus error here. (crbug.com/206812)
@@ -660,7 +714,9 @@ void WiFi::SetHT40EnableForService(const WiFiService* service, bool enable) {
 }
 
 bool WiFi::IsIdle() const {
-  return !current_service_ && !pending_service_;
+  // A connection attempt that is still adding its network is not idle, even
+  // though it has no pending service yet.
+  return !current_service_ && !pending_service_ && !adding_network_service_;
 }
 
 void WiFi::ClearCachedCredentials(const WiFiService* service) {
@@ -765,7 +821,7 @@ bool WiFi::SetBgscanSignalThreshold(const int32_t& dbm, Error* /*error*/) {
 bool WiFi::SetRoamThreshold(const uint16_t& threshold, Error* /*error*/) {
   roam_threshold_db_ = threshold;
   if (!current_service_ || !current_service_->roam_threshold_db_set()) {
-    supplicant_interface_proxy_->SetRoamThreshold(threshold);
+    SetSupplicantRoamThreshold(threshold);
   }
   return true;
 }
@@ -1053,10 +1109,9 @@ void WiFi::HandleRoam(const string& new_bss) {
     // Use WiFi service-specific roam threshold if it is set, otherwise use WiFi
     // device-wide roam threshold.
     if (current_service_->roam_threshold_db_set()) {
-      supplicant_interface_proxy_->SetRoamThreshold(
-          current_service_->roam_threshold_db());
+      SetSupplicantRoamThreshold(current_service_->roam_threshold_db());
     } else {
-      supplicant_interface_proxy_->SetRoamThreshold(roam_threshold_db_);
+      SetSupplicantRoamThreshold(roam_threshold_db_);
     }
     return;
   }
@@ -1419,7 +1474,10 @@ void WiFi::ScanDoneTask() {
     uint32_t max_age;
     time_->GetTimeMonotonic(&now);
     max_age = kMaxBSSResumeAgeSeconds + (now.tv_sec - resumed_at_.tv_sec);
-    supplicant_interface_proxy_->FlushBSS(max_age);
+    supplicant_interface_proxy_->FlushBSSAsync(
+        max_age,
+        Bind(&WiFi::OnSupplicantOperationResult,
+             weak_ptr_factory_.GetWeakPtr(), "FlushBSS"));
     need_bss_flush_ = false;
   }
   StartScanTimer();
@@ -1487,7 +1545,13 @@ void WiFi::ScanTask() {
     scan_args.SetByteArrays(WPASupplicant::kPropertyScanSSIDs, hidden_ssids);
   }
 
-  if (!supplicant_interface_proxy_->Scan(scan_args)) {
+  supplicant_interface_proxy_->ScanAsync(
+      scan_args,
+      Bind(&WiFi::OnScanRequested, weak_ptr_factory_.GetWeakPtr()));
+}
+
+void WiFi::OnScanRequested(const Error& error) {
+  if (error.IsFailure()) {
     // A scan may fail if, for example, the wpa_supplicant vanishing
     // notification is posted after this task has already started running.
     LOG(WARNING) << "Scan failed";
@@ -1614,14 +1678,10 @@ void WiFi::StateChanged(const string& new_state) {
       EnableHighBitrates();
       if (is_roaming_in_progress_) {
         // This means wpa_supplicant completed a roam without an intervening
-        // disconnect.  We should renew our DHCP lease just in case the new
-        // AP is on a different subnet than where we started.
+        // disconnect.  Make sure the new AP is not on a different subnet
+        // than where we started.
         is_roaming_in_progress_ = false;
-        const IPConfigRefPtr& ip_config = ipconfig();
-        if (ip_config) {
-          LOG(INFO) << link_name() << " renewing L3 configuration after roam.";
-          ip_config->RenewIP();
-        }
+        CheckL3AfterRoam();
       }
     } else if (has_already_completed_) {
       LOG(INFO) << link_name() << " L3 configuration already started.";
@@ -1677,6 +1737,37 @@ void WiFi::StateChanged(const string& new_state) {
   }
 }
 
+void WiFi::CheckL3AfterRoam() {
+  // If the gateway still answers ARP from the MAC address we knew it by,
+  // we are on the same subnet and the current lease remains valid; this
+  // avoids a DHCP round-trip on every roam.
+  if (link_monitor() &&
+      link_monitor()->VerifyGateway(
+          Bind(&WiFi::OnPostRoamGatewayVerified,
+               weak_ptr_factory_.GetWeakPtr()))) {
+    LOG(INFO) << link_name() << " verifying gateway after roam.";
+    return;
+  }
+  RenewIPAfterRoam();
+}
+
+void WiFi::OnPostRoamGatewayVerified(bool gateway_unchanged) {
+  if (gateway_unchanged) {
+    LOG(INFO) << link_name()
+              << " gateway unchanged after roam; keeping L3 configuration.";
+    return;
+  }
+  RenewIPAfterRoam();
+}
+
+void WiFi::RenewIPAfterRoam() {
+  const IPConfigRefPtr& ip_config = ipconfig();
+  if (ip_config) {
+    LOG(INFO) << link_name() << " renewing L3 configuration after roam.";
+    ip_config->RenewIP();
+  }
+}
+
 bool WiFi::SuspectCredentials(
     WiFiServiceRefPtr service, Service::ConnectFailure* failure) const {
   if (service->IsSecurityMatch(kSecurityPsk)) {
@@ -2274,6 +2365,8 @@ void WiFi::SetConnectionDebugging(bool enabled) {
 
 void WiFi::SetSupplicantInterfaceProxy(
     SupplicantInterfaceProxyInterface* supplicant_interface_proxy) {
+  // Replies to calls made on the previous proxy will never arrive.
+  adding_network_service_ = nullptr;
   if (supplicant_interface_proxy) {
     supplicant_interface_proxy_.reset(supplicant_interface_proxy);
     tdls_manager_.reset(new TDLSManager(dispatcher(),
@@ -2960,11 +3053,29 @@ void WiFi::ReportConnectedToServiceAfterWake() {
 }
 
 bool WiFi::RequestRoam(const std::string& addr, Error* error) {
+  // This backs an RPC whose caller expects to learn whether wpa_supplicant
+  // accepted the request, so wait for its reply.
   if (!supplicant_interface_proxy_->Roam(addr)) {
-    LOG(WARNING) << "Request roam to " << addr << " failed.";
+    Error::PopulateAndLog(FROM_HERE, error, Error::kOperationFailed,
+                          "Request roam to " + addr + " failed.");
     return false;
   }
   return true;
 }
 
+void WiFi::SetSupplicantRoamThreshold(uint16_t threshold) {
+  supplicant_interface_proxy_->SetRoamThresholdAsync(
+      threshold,
+      Bind(&WiFi::OnSupplicantOperationResult, weak_ptr_factory_.GetWeakPtr(),
+           "SetRoamThreshold"));
+}
+
+void WiFi::OnSupplicantOperationResult(const string& operation,
+                                       const Error& error) {
+  if (error.IsFailure()) {
+    LOG(ERROR) << link_name() << ": supplicant " << operation << " failed: "
+               << error;
+  }
+}
+
 }  // namespace shill
@@ -422,6 +422,12 @@ class WiFi : public Device, public SupplicantEventDelegateInterface {
   // to idle, so it can be used for future connections.
   void ServiceDisconnected(WiFiServiceRefPtr service);
   void HandleRoam(const std::string& new_bssid);
+  // Called once wpa_supplicant completes a roam without an intervening
+  // disconnect.  Keeps the current lease if the gateway is still reachable
+  // at the same MAC address, and renews it otherwise.
+  void CheckL3AfterRoam();
+  void OnPostRoamGatewayVerified(bool gateway_unchanged);
+  void RenewIPAfterRoam();
   void BSSAddedTask(const std::string& BSS,
                     const KeyValueStore& properties);
   void BSSRemovedTask(const std::string& BSS);
@@ -444,6 +450,8 @@ class WiFi : public Device, public SupplicantEventDelegateInterface {
   // [ScanDone]-->[ScanDoneTask]-->[UpdateScanStateAfterScanDone]
   void UpdateScanStateAfterScanDone();
   void ScanTask();
+  // Completes ScanTask once wpa_supplicant has accepted or rejected the scan.
+  void OnScanRequested(const Error& error);
   void StateChanged(const std::string& new_state);
   // Heuristic check if a connection failure was due to bad credentials.
   // Returns true and puts type of failure in |failure| if a credential
@@ -538,6 +546,18 @@ class WiFi : public Device, public SupplicantEventDelegateInterface {
   // the Pending timer is started and the associated service is set
   // to "Associating", otherwise it is stopped.
   void SetPendingService(const WiFiServiceRefPtr& service);
+  // Called when wpa_supplicant has created the network for |service| in
+  // response to ConnectTo.
+  void OnNetworkAdded(const WiFiServiceRefPtr& service,
+                      const std::string& network_path,
+                      const Error& error);
+  // Selects |network_path| in wpa_supplicant and makes |service| pending.
+  void SelectNetwork(WiFiService* service, const std::string& network_path);
+  void SetSupplicantRoamThreshold(uint16_t threshold);
+  // Logs the failure of an asynchronous supplicant call whose result needs
+  // no further handling.
+  void OnSupplicantOperationResult(const std::string& operation,
+                                   const Error& error);
 
   void OnSupplicantAppear();
   void OnSupplicantVanish();
@@ -638,6 +658,9 @@ class WiFi : public Device, public SupplicantEventDelegateInterface {
   // be distinct from |current_service_|. (A service should not
   // simultaneously be both pending, and current.)
   WiFiServiceRefPtr pending_service_;
+  // The Service whose wpa_supplicant Network is being added, before it
+  // becomes |pending_service_|.
+  WiFiServiceRefPtr adding_network_service_;
   std::string supplicant_state_;
   std::string supplicant_bss_;
   int32_t supplicant_disconnect_reason_;
@@ -859,6 +859,7 @@ void WiFiService::UpdateFromEndpoints() {
   adaptor()->EmitUint16sChanged(kWifiFrequencyListProperty, frequency_list_);
   SetStrength(SignalToStrength(signal));
   UpdateSecurity();
+  InvalidatePropertyDependency(kDependencyVisibility);
   NotifyPropertyChanges();
 }
 
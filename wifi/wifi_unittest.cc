@@ -605,15 +605,14 @@ class WiFiObjectTest : public ::testing::TestWithParam<string> {
     ON_CALL(*supplicant_process_proxy_, GetInterface(_, _))
         .WillByDefault(DoAll(SetArgumentPointee<1>(string("/default/path")),
                              Return(true)));
-    ON_CALL(*supplicant_interface_proxy_.get(), AddNetwork(_, _))
-        .WillByDefault(DoAll(SetArgumentPointee<1>(string("/default/path")),
-                             Return(true)));
+    ON_CALL(*supplicant_interface_proxy_.get(), AddNetworkAsync(_, _))
+        .WillByDefault(SaveArg<1>(&add_network_callback_));
     ON_CALL(*supplicant_interface_proxy_.get(), Disconnect())
         .WillByDefault(Return(true));
     ON_CALL(*supplicant_interface_proxy_.get(), RemoveNetwork(_))
         .WillByDefault(Return(true));
-    ON_CALL(*supplicant_interface_proxy_.get(), Scan(_))
-        .WillByDefault(Return(true));
+    ON_CALL(*supplicant_interface_proxy_.get(), ScanAsync(_, _))
+        .WillByDefault(SaveArg<1>(&scan_callback_));
     ON_CALL(*supplicant_network_proxy_.get(), SetEnabled(_))
         .WillByDefault(Return(true));
 
@@ -886,6 +885,21 @@ class WiFiObjectTest : public ::testing::TestWithParam<string> {
   void InitiateConnect(WiFiServiceRefPtr service) {
     wifi_->ConnectTo(service.get());
   }
+  void ReplyToAddNetwork(const string& network_path, const Error& error) {
+    ASSERT_FALSE(add_network_callback_.is_null());
+    RpcIdentifierCallback callback = add_network_callback_;
+    add_network_callback_.Reset();
+    callback.Run(network_path, error);
+  }
+  void ReplyToAddNetwork(const string& network_path) {
+    ReplyToAddNetwork(network_path, Error());
+  }
+  void ReplyToScan(const Error& error) {
+    ASSERT_FALSE(scan_callback_.is_null());
+    ResultCallback callback = scan_callback_;
+    scan_callback_.Reset();
+    callback.Run(error);
+  }
   void InitiateDisconnect(WiFiServiceRefPtr service) {
     wifi_->DisconnectFrom(service.get());
   }
@@ -902,14 +916,15 @@ class WiFiObjectTest : public ::testing::TestWithParam<string> {
         0, 0, kNetworkModeAdHoc, &endpoint, &service));
     if (!network_path.empty()) {
       EXPECT_CALL(*service, GetSupplicantConfigurationParameters());
-      EXPECT_CALL(*GetSupplicantInterfaceProxy(), AddNetwork(_, _))
-          .WillOnce(DoAll(SetArgumentPointee<1>(network_path), Return(true)));
+      EXPECT_CALL(*GetSupplicantInterfaceProxy(), AddNetworkAsync(_, _));
       EXPECT_CALL(*GetSupplicantInterfaceProxy(),
-                  SetHT40Enable(network_path, true));
-      EXPECT_CALL(*GetSupplicantInterfaceProxy(), SelectNetwork(network_path));
+                  SetHT40EnableAsync(network_path, true, _));
+      EXPECT_CALL(*GetSupplicantInterfaceProxy(),
+                  SelectNetworkAsync(network_path, _));
     }
     EXPECT_CALL(*service, SetState(Service::kStateAssociating));
     InitiateConnect(service);
+    ReplyToAddNetwork(network_path.empty() ? "/default/path" : network_path);
     Mock::VerifyAndClearExpectations(service.get());
     EXPECT_FALSE(GetPendingTimeout().IsCancelled());
     if (endpoint_ptr) {
@@ -1380,6 +1395,11 @@ class WiFiObjectTest : public ::testing::TestWithParam<string> {
   MockSupplicantEAPStateHandler* eap_state_handler_;
   MockNetlinkManager netlink_manager_;
 
+  // The most recent AddNetworkAsync and ScanAsync callbacks, which tests
+  // run through ReplyToAddNetwork and ReplyToScan.
+  RpcIdentifierCallback add_network_callback_;
+  ResultCallback scan_callback_;
+
  private:
   unique_ptr<MockSupplicantInterfaceProxy> supplicant_interface_proxy_;
   unique_ptr<MockSupplicantNetworkProxy> supplicant_network_proxy_;
@@ -1455,6 +1475,9 @@ class WiFiMainTest : public WiFiObjectTest {
     ExpectScanStart(method, false);
     StartWiFi();
     dispatcher_.DispatchPendingEvents();
+    if (method == WiFi::kScanMethodFull) {
+      ReplyToScan(Error());
+    }
     VerifyScanState(WiFi::kScanScanning, method);
   }
 
@@ -1488,7 +1511,7 @@ class WiFiMainTest : public WiFiObjectTest {
       EXPECT_CALL(*scan_session_, HasMoreFrequencies());
       EXPECT_CALL(*scan_session_, InitiateScan());
     } else {
-      EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(_));
+      EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _));
     }
     if (!is_continued) {
       EXPECT_CALL(*adaptor_, EmitBoolChanged(kScanningProperty,
@@ -1545,13 +1568,13 @@ TEST_F(WiFiMainTest, RoamThresholdProperty) {
   OnSupplicantAppear();
 
   EXPECT_CALL(*GetSupplicantInterfaceProxy(),
-              SetRoamThreshold(kRoamThreshold16));
+              SetRoamThresholdAsync(kRoamThreshold16, _));
   EXPECT_TRUE(SetRoamThreshold(kRoamThreshold16));
   EXPECT_EQ(GetRoamThreshold(), kRoamThreshold16);
 
   // Try a different number
   EXPECT_CALL(*GetSupplicantInterfaceProxy(),
-              SetRoamThreshold(kRoamThreshold32));
+              SetRoamThresholdAsync(kRoamThreshold32, _));
   EXPECT_TRUE(SetRoamThreshold(kRoamThreshold32));
   EXPECT_EQ(GetRoamThreshold(), kRoamThreshold32);
 
@@ -1560,11 +1583,47 @@ TEST_F(WiFiMainTest, RoamThresholdProperty) {
   MockWiFiServiceRefPtr service = MakeMockService(kSecurityNone);
   service->roam_threshold_db_set_ = true;
   SetCurrentService(service);
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), SetRoamThreshold(_)).Times(0);
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(),
+              SetRoamThresholdAsync(_, _)).Times(0);
   EXPECT_TRUE(SetRoamThreshold(kRoamThreshold16));
   EXPECT_EQ(kRoamThreshold16, GetRoamThreshold());
 }
 
+TEST_F(WiFiMainTest, RoamThresholdPropertyFailure) {
+  static const uint16_t kRoamThreshold16 = 16;
+
+  StartWiFi(false);  // No supplicant present.
+  OnSupplicantAppear();
+
+  ResultCallback set_roam_threshold_callback;
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(),
+              SetRoamThresholdAsync(kRoamThreshold16, _))
+      .WillOnce(SaveArg<1>(&set_roam_threshold_callback));
+  EXPECT_TRUE(SetRoamThreshold(kRoamThreshold16));
+
+  // A rejected update is only logged; the property keeps the new value.
+  ScopedMockLog log;
+  EXPECT_CALL(log, Log(_, _, _)).Times(AnyNumber());
+  EXPECT_CALL(log, Log(logging::LOG_ERROR, _,
+                       HasSubstr("supplicant SetRoamThreshold failed")));
+  set_roam_threshold_callback.Run(Error(Error::kOperationFailed));
+  EXPECT_EQ(kRoamThreshold16, GetRoamThreshold());
+}
+
+TEST_F(WiFiMainTest, RequestRoam) {
+  const string kBSSID("00:01:02:03:04:05");
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Roam(kBSSID))
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+  Error error;
+  EXPECT_TRUE(wifi()->RequestRoam(kBSSID, &error));
+  EXPECT_TRUE(error.IsSuccess());
+
+  // A rejected request is reported to the caller.
+  EXPECT_FALSE(wifi()->RequestRoam(kBSSID, &error));
+  EXPECT_EQ(Error::kOperationFailed, error.type());
+}
+
 TEST_F(WiFiMainTest, OnSupplicantAppearStarted) {
   EXPECT_EQ(nullptr, GetSupplicantInterfaceProxyFromWiFi());;
 
@@ -1650,7 +1709,7 @@ TEST_F(WiFiMainTest, CleanStart_FullScan) {
       .WillRepeatedly(Return(false));
   EXPECT_TRUE(GetScanTimer().IsCancelled());
   StartWiFi();
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(_));
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _));
   dispatcher_.DispatchPendingEvents();
   EXPECT_FALSE(GetScanTimer().IsCancelled());
 }
@@ -1701,6 +1760,7 @@ TEST_F(WiFiMainTest, UseArpGateway) {
 
   MockWiFiServiceRefPtr service = MakeMockService(kSecurityNone);
   InitiateConnect(service);
+  ReplyToAddNetwork("/default/path");
 
   // Selected service that does not have a static IP address.
   EXPECT_CALL(*service, HasStaticIPAddress()).WillRepeatedly(Return(false));
@@ -1732,7 +1792,7 @@ TEST_F(WiFiMainTest, Restart_FullScan) {
       .Times(AnyNumber())
       .WillRepeatedly(Return(false));
   EXPECT_CALL(*supplicant_process_proxy_, GetInterface(_, _));
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(_));
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _));
   StartWiFi();
   dispatcher_.DispatchPendingEvents();
 }
@@ -1761,10 +1821,11 @@ TEST_F(WiFiMainTest, NoScansWhileConnecting_FullScan) {
   ExpectConnecting();
   MockWiFiServiceRefPtr service = MakeMockService(kSecurityNone);
   InitiateConnect(service);
+  ReplyToAddNetwork("/default/path");
   VerifyScanState(WiFi::kScanConnecting, WiFi::kScanMethodFull);
 
   // If we're connecting, we ignore scan requests and stay on channel.
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(_)).Times(0);
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _)).Times(0);
   TriggerScan(WiFi::kScanMethodFull);
   dispatcher_.DispatchPendingEvents();
   Mock::VerifyAndClearExpectations(GetSupplicantInterfaceProxy());
@@ -1779,6 +1840,7 @@ TEST_F(WiFiMainTest, NoScansWhileConnecting_FullScan) {
   ExpectScanStart(WiFi::kScanMethodFull, false);
   TriggerScan(WiFi::kScanMethodFull);
   dispatcher_.DispatchPendingEvents();
+  ReplyToScan(Error());
   Mock::VerifyAndClearExpectations(GetSupplicantInterfaceProxy());
   Mock::VerifyAndClearExpectations(service.get());
 
@@ -1788,7 +1850,7 @@ TEST_F(WiFiMainTest, NoScansWhileConnecting_FullScan) {
   SetPendingService(nullptr);
   SetCurrentService(service);
   EXPECT_CALL(*service, IsConnecting()).WillOnce(Return(true));
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(_)).Times(0);
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _)).Times(0);
   TriggerScan(WiFi::kScanMethodFull);
   dispatcher_.DispatchPendingEvents();
   Mock::VerifyAndClearExpectations(GetSupplicantInterfaceProxy());
@@ -1800,6 +1862,7 @@ TEST_F(WiFiMainTest, NoScansWhileConnecting_FullScan) {
   ExpectScanStart(WiFi::kScanMethodFull, false);
   TriggerScan(WiFi::kScanMethodFull);
   dispatcher_.DispatchPendingEvents();
+  ReplyToScan(Error());
   Mock::VerifyAndClearExpectations(GetSupplicantInterfaceProxy());
   Mock::VerifyAndClearExpectations(service.get());
 
@@ -1815,6 +1878,7 @@ TEST_F(WiFiMainTest, NoScansWhileConnecting) {
   ExpectConnecting();
   MockWiFiServiceRefPtr service = MakeMockService(kSecurityNone);
   InitiateConnect(service);
+  ReplyToAddNetwork("/default/path");
   VerifyScanState(WiFi::kScanConnecting, WiFi::kScanMethodProgressive);
 
   // If we're connecting, we ignore scan requests and stay on channel.
@@ -1870,13 +1934,14 @@ TEST_F(WiFiMainTest, ResetScanStateWhenScanFailed) {
 
 TEST_F(WiFiMainTest, ResumeStartsScanWhenIdle_FullScan) {
   EnableFullScan();
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(_));
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _));
   StartWiFi();
   dispatcher_.DispatchPendingEvents();
+  ReplyToScan(Error());
   Mock::VerifyAndClearExpectations(GetSupplicantInterfaceProxy());
   ReportScanDone();
   ASSERT_TRUE(wifi()->IsIdle());
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(_));
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _));
   OnAfterResume();
   dispatcher_.DispatchPendingEvents();
 }
@@ -1915,12 +1980,13 @@ TEST_F(WiFiMainTest, ResumeDoesNotScanIfConnected) {
 
 TEST_F(WiFiMainTest, SuspendDoesNotStartScan_FullScan) {
   EnableFullScan();
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(_));
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _));
   StartWiFi();
   dispatcher_.DispatchPendingEvents();
+  ReplyToScan(Error());
   Mock::VerifyAndClearExpectations(GetSupplicantInterfaceProxy());
   ASSERT_TRUE(wifi()->IsIdle());
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(_)).Times(0);
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _)).Times(0);
   OnBeforeSuspend();
   dispatcher_.DispatchPendingEvents();
 }
@@ -1931,7 +1997,7 @@ TEST_F(WiFiMainTest, SuspendDoesNotStartScan) {
   dispatcher_.DispatchPendingEvents();
   Mock::VerifyAndClearExpectations(GetSupplicantInterfaceProxy());
   ASSERT_TRUE(wifi()->IsIdle());
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(_)).Times(0);
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _)).Times(0);
   EXPECT_CALL(*scan_session_, InitiateScan()).Times(0);
   OnBeforeSuspend();
   dispatcher_.DispatchPendingEvents();
@@ -1939,9 +2005,10 @@ TEST_F(WiFiMainTest, SuspendDoesNotStartScan) {
 
 TEST_F(WiFiMainTest, ResumeDoesNotStartScanWhenNotIdle_FullScan) {
   EnableFullScan();
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(_));
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _));
   StartWiFi();
   dispatcher_.DispatchPendingEvents();
+  ReplyToScan(Error());
   Mock::VerifyAndClearExpectations(GetSupplicantInterfaceProxy());
   WiFiServiceRefPtr service(
       SetupConnectedService("", nullptr, nullptr));
@@ -1949,7 +2016,7 @@ TEST_F(WiFiMainTest, ResumeDoesNotStartScanWhenNotIdle_FullScan) {
   ScopedMockLog log;
   EXPECT_CALL(log, Log(_, _, _)).Times(AnyNumber());
   EXPECT_CALL(log, Log(_, _, EndsWith("already connecting or connected.")));
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(_)).Times(0);
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _)).Times(0);
   OnAfterResume();
   dispatcher_.DispatchPendingEvents();
 }
@@ -1965,7 +2032,7 @@ TEST_F(WiFiMainTest, ResumeDoesNotStartScanWhenNotIdle) {
   ScopedMockLog log;
   EXPECT_CALL(log, Log(_, _, _)).Times(AnyNumber());
   EXPECT_CALL(log, Log(_, _, EndsWith("already connecting or connected.")));
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(_)).Times(0);
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _)).Times(0);
   EXPECT_TRUE(IsScanSessionNull());
   OnAfterResume();
   dispatcher_.DispatchPendingEvents();
@@ -2083,8 +2150,8 @@ TEST_F(WiFiMainTest, ReconnectPreservesDBusPath) {
   // A second connection attempt should remember the DBus path associated
   // with this service, and should not request new configuration parameters.
   EXPECT_CALL(*service, GetSupplicantConfigurationParameters()).Times(0);
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), AddNetwork(_, _)).Times(0);
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), SelectNetwork(kPath));
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), AddNetworkAsync(_, _)).Times(0);
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), SelectNetworkAsync(kPath, _));
   InitiateConnect(service);
 }
 
@@ -2489,7 +2556,7 @@ TEST_F(WiFiMainTest, ScanHidden_FullScan) {
   StartWiFi();
   EXPECT_CALL(*wifi_provider(), GetHiddenSSIDList()).WillOnce(Return(ssids));
   EXPECT_CALL(*GetSupplicantInterfaceProxy(),
-              Scan(HasHiddenSSID_FullScan(kSSID)));
+              ScanAsync(HasHiddenSSID_FullScan(kSSID), _));
   dispatcher_.DispatchPendingEvents();
 }
 
@@ -2516,7 +2583,8 @@ TEST_F(WiFiMainTest, ScanNoHidden_FullScan) {
   StartWiFi();
   EXPECT_CALL(*wifi_provider(), GetHiddenSSIDList())
       .WillOnce(Return(ByteArrays()));
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(HasNoHiddenSSID_FullScan()));
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(),
+              ScanAsync(HasNoHiddenSSID_FullScan(), _));
   dispatcher_.DispatchPendingEvents();
 }
 
@@ -2540,7 +2608,7 @@ TEST_F(WiFiMainTest, ScanWiFiDisabledAfterResume) {
   EXPECT_CALL(log, Log(_, _, _)).Times(AnyNumber());
   EXPECT_CALL(log, Log(_, _, EndsWith(
       "Ignoring scan request while device is not enabled."))).Times(1);
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(_)).Times(0);
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _)).Times(0);
   EXPECT_CALL(*scan_session_, InitiateScan()).Times(0);
   StartWiFi();
   StopWiFi();
@@ -2554,10 +2622,36 @@ TEST_F(WiFiMainTest, ScanRejected) {
   ReportScanDone();
   VerifyScanState(WiFi::kScanIdle, WiFi::kScanMethodNone);
 
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(_))
-      .WillOnce(Return(false));
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _));
+  TriggerScan(WiFi::kScanMethodFull);
+  dispatcher_.DispatchPendingEvents();
+  ReplyToScan(Error(Error::kOperationFailed));
+  VerifyScanState(WiFi::kScanIdle, WiFi::kScanMethodNone);
+}
+
+TEST_F(WiFiMainTest, ScanAccepted) {
+  StartWiFi();
+  ReportScanDone();
+
+  // The scan state only changes once wpa_supplicant accepts the request.
+  ExpectScanStart(WiFi::kScanMethodFull, false);
+  TriggerScan(WiFi::kScanMethodFull);
+  dispatcher_.DispatchPendingEvents();
+  VerifyScanState(WiFi::kScanIdle, WiFi::kScanMethodNone);
+  ReplyToScan(Error());
+  VerifyScanState(WiFi::kScanScanning, WiFi::kScanMethodFull);
+}
+
+TEST_F(WiFiMainTest, ScanReplyAfterStop) {
+  StartWiFi();
+  ReportScanDone();
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _));
   TriggerScan(WiFi::kScanMethodFull);
   dispatcher_.DispatchPendingEvents();
+  StopWiFi();
+
+  // A reply that arrives after the device stopped is dropped.
+  ReplyToScan(Error());
   VerifyScanState(WiFi::kScanIdle, WiFi::kScanMethodNone);
 }
 
@@ -2581,7 +2675,7 @@ TEST_F(WiFiMainTest, ProgressiveScanFound) {
   MockWiFiServiceRefPtr service = MakeMockService(kSecurityNone);
   EXPECT_CALL(*metrics(), NotifyDeviceScanFinished(_));
   EXPECT_CALL(*scan_session_, InitiateScan()).Times(0);
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(_)).Times(0);
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _)).Times(0);
   EXPECT_CALL(*adaptor_, EmitBoolChanged(kScanningProperty, false));
   SetPendingService(service);
 
@@ -2619,8 +2713,9 @@ TEST_F(WiFiMainTest, ProgressiveScanNotFound) {
   // scan.
   EXPECT_CALL(*scan_session_, HasMoreFrequencies()).WillOnce(Return(false));
   EXPECT_CALL(*scan_session_, InitiateScan()).Times(0);
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(_));
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _));
   dispatcher_.DispatchPendingEvents();
+  ReplyToScan(Error());
   VerifyScanState(WiFi::kScanScanning,
                   WiFi::kScanMethodProgressiveFinishedToFull);
 
@@ -2643,9 +2738,10 @@ TEST_F(WiFiMainTest, ProgressiveScanError) {
   dispatcher_.DispatchPendingEvents();  // Executes |ProgressiveScanTask|.
 
   // Calls |WiFi::OnFailedProgressiveScan| which calls |ScanTask|
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(_)).Times(1);
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _)).Times(1);
   NewScanResultsMessage not_supposed_to_get_this_message;
   OnTriggerScanResponse(not_supposed_to_get_this_message);
+  ReplyToScan(Error());
   VerifyScanState(WiFi::kScanScanning, WiFi::kScanMethodProgressiveErrorToFull);
 
   EXPECT_TRUE(IsScanSessionNull());
@@ -2672,6 +2768,7 @@ TEST_F(WiFiMainTest, StateChangeWithService) {
   dispatcher_.DispatchPendingEvents();
   MockWiFiServiceRefPtr service = MakeMockService(kSecurityNone);
   InitiateConnect(service);
+  ReplyToAddNetwork("/default/path");
   EXPECT_CALL(*service.get(), SetState(Service::kStateAssociating));
   ReportStateChanged(WPASupplicant::kInterfaceStateAssociated);
   // Verify expectations now, because WiFi may report other state changes
@@ -2693,6 +2790,7 @@ TEST_F(WiFiMainTest, StateChangeBackwardsWithService) {
   EXPECT_CALL(*service, SetState(Service::kStateConfiguring));
   EXPECT_CALL(*service, ResetSuspectedCredentialFailures());
   InitiateConnect(service);
+  ReplyToAddNetwork("/default/path");
   ReportStateChanged(WPASupplicant::kInterfaceStateCompleted);
   ReportStateChanged(WPASupplicant::kInterfaceStateAuthenticating);
   EXPECT_EQ(WPASupplicant::kInterfaceStateAuthenticating,
@@ -2713,6 +2811,7 @@ TEST_F(WiFiMainTest, ConnectToServiceWithoutRecentIssues) {
   EXPECT_CALL(*service.get(), HasRecentConnectionIssues())
       .WillOnce(Return(false));
   InitiateConnect(service);
+  ReplyToAddNetwork("/default/path");
 }
 
 TEST_F(WiFiMainTest, ConnectToServiceWithRecentIssues) {
@@ -2733,6 +2832,7 @@ TEST_F(WiFiMainTest, ConnectToServiceWithRecentIssues) {
   EXPECT_CALL(*service.get(), HasRecentConnectionIssues())
       .WillOnce(Return(true));
   InitiateConnect(service);
+  ReplyToAddNetwork("/default/path");
   Mock::VerifyAndClearExpectations(process_proxy);
 
   SetPendingService(nullptr);
@@ -2814,6 +2914,68 @@ TEST_F(WiFiMainTest, CurrentBSSChangedUpdateServiceEndpoint) {
   EXPECT_FALSE(GetIsRoamingInProgress());
 }
 
+TEST_F(WiFiMainTest, CurrentBSSChangedVerifyGateway) {
+  StartWiFi();
+  dispatcher_.DispatchPendingEvents();
+  MockWiFiServiceRefPtr service =
+      SetupConnectedService("", nullptr, nullptr);
+  auto link_monitor = new StrictMock<MockLinkMonitor>();
+  SetLinkMonitor(link_monitor);
+  WiFiEndpointRefPtr endpoint;
+  string bss_path =
+      AddEndpointToService(service, 0, 0, kNetworkModeAdHoc, &endpoint);
+  EXPECT_CALL(*service, NotifyCurrentEndpoint(EndpointMatch(endpoint)));
+  ReportCurrentBSSChanged(bss_path);
+  EXPECT_TRUE(GetIsRoamingInProgress());
+
+  // With a link monitor that knows the gateway, a completed roam checks the
+  // gateway instead of renewing the IPConfig right away.
+  scoped_refptr<MockIPConfig> ipconfig(
+      new MockIPConfig(control_interface(), kDeviceName));
+  SetIPConfig(ipconfig);
+  LinkMonitor::GatewayVerifyCallback verify_callback;
+  EXPECT_CALL(*service, IsConnected()).WillOnce(Return(true));
+  EXPECT_CALL(*link_monitor, VerifyGateway(_))
+      .WillOnce(DoAll(SaveArg<0>(&verify_callback), Return(true)));
+  EXPECT_CALL(*ipconfig, RenewIP()).Times(0);
+  ReportStateChanged(WPASupplicant::kInterfaceStateCompleted);
+  EXPECT_FALSE(GetIsRoamingInProgress());
+  ASSERT_FALSE(verify_callback.is_null());
+
+  // Gateway answered from the same MAC address: keep the lease.
+  verify_callback.Run(true);
+  Mock::VerifyAndClearExpectations(ipconfig.get());
+
+  // Gateway changed or stopped responding: renew.
+  EXPECT_CALL(*ipconfig, RenewIP());
+  verify_callback.Run(false);
+  Mock::VerifyAndClearExpectations(ipconfig.get());
+}
+
+TEST_F(WiFiMainTest, CurrentBSSChangedGatewayNotFound) {
+  StartWiFi();
+  dispatcher_.DispatchPendingEvents();
+  MockWiFiServiceRefPtr service =
+      SetupConnectedService("", nullptr, nullptr);
+  auto link_monitor = new StrictMock<MockLinkMonitor>();
+  SetLinkMonitor(link_monitor);
+  WiFiEndpointRefPtr endpoint;
+  string bss_path =
+      AddEndpointToService(service, 0, 0, kNetworkModeAdHoc, &endpoint);
+  EXPECT_CALL(*service, NotifyCurrentEndpoint(EndpointMatch(endpoint)));
+  ReportCurrentBSSChanged(bss_path);
+
+  // The link monitor can't verify the gateway, so renew as before.
+  scoped_refptr<MockIPConfig> ipconfig(
+      new MockIPConfig(control_interface(), kDeviceName));
+  SetIPConfig(ipconfig);
+  EXPECT_CALL(*service, IsConnected()).WillOnce(Return(true));
+  EXPECT_CALL(*link_monitor, VerifyGateway(_)).WillOnce(Return(false));
+  EXPECT_CALL(*ipconfig, RenewIP());
+  ReportStateChanged(WPASupplicant::kInterfaceStateCompleted);
+  Mock::VerifyAndClearExpectations(ipconfig.get());
+}
+
 TEST_F(WiFiMainTest, DisconnectReasonUpdated) {
   ScopedMockLog log;
   int test_reason = 4;
@@ -2898,7 +3060,7 @@ TEST_F(WiFiMainTest, AddNetworkArgs) {
   MakeNewEndpointAndService(0, 0, kNetworkModeAdHoc, nullptr, &service);
   EXPECT_CALL(*service, GetSupplicantConfigurationParameters());
   EXPECT_CALL(*GetSupplicantInterfaceProxy(),
-              AddNetwork(WiFiAddedArgs(true), _));
+              AddNetworkAsync(WiFiAddedArgs(true), _));
   EXPECT_TRUE(SetBgscanMethod(WPASupplicant::kNetworkBgscanMethodSimple));
   InitiateConnect(service);
 }
@@ -2909,10 +3071,129 @@ TEST_F(WiFiMainTest, AddNetworkArgsNoBgscan) {
   MakeNewEndpointAndService(0, 0, kNetworkModeAdHoc, nullptr, &service);
   EXPECT_CALL(*service, GetSupplicantConfigurationParameters());
   EXPECT_CALL(*GetSupplicantInterfaceProxy(),
-              AddNetwork(WiFiAddedArgs(false), _));
+              AddNetworkAsync(WiFiAddedArgs(false), _));
   InitiateConnect(service);
 }
 
+TEST_F(WiFiMainTest, ConnectToWaitsForAddNetwork) {
+  StartWiFi();
+  MockWiFiServiceRefPtr service;
+  MakeNewEndpointAndService(0, 0, kNetworkModeAdHoc, nullptr, &service);
+  RpcIdentifierCallback add_network_callback;
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), AddNetworkAsync(_, _))
+      .WillOnce(SaveArg<1>(&add_network_callback));
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), SelectNetworkAsync(_, _))
+      .Times(0);
+  InitiateConnect(service);
+  EXPECT_EQ(nullptr, GetPendingService().get());
+
+  // A repeated request while the network is being added is ignored.
+  InitiateConnect(service);
+  Mock::VerifyAndClearExpectations(GetSupplicantInterfaceProxy());
+
+  const char kPath[] = "/new/path";
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(),
+              SetHT40EnableAsync(kPath, true, _));
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), SelectNetworkAsync(kPath, _));
+  EXPECT_CALL(*service, SetState(Service::kStateAssociating));
+  add_network_callback.Run(kPath, Error());
+  EXPECT_EQ(service, GetPendingService());
+}
+
+TEST_F(WiFiMainTest, ConnectToSupersedesAddNetwork) {
+  StartWiFi();
+  MockWiFiServiceRefPtr service0;
+  MakeNewEndpointAndService(0, 0, kNetworkModeAdHoc, nullptr, &service0);
+  MockWiFiServiceRefPtr service1;
+  MakeNewEndpointAndService(0, 1, kNetworkModeAdHoc, nullptr, &service1);
+  RpcIdentifierCallback add_network_callback0;
+  RpcIdentifierCallback add_network_callback1;
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), AddNetworkAsync(_, _))
+      .WillOnce(SaveArg<1>(&add_network_callback0))
+      .WillOnce(SaveArg<1>(&add_network_callback1));
+  InitiateConnect(service0);
+  InitiateConnect(service1);
+
+  // The superseded attempt only records the new network.
+  const char kPath0[] = "/new/path0";
+  const char kPath1[] = "/new/path1";
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), SelectNetworkAsync(kPath0, _))
+      .Times(0);
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), SelectNetworkAsync(kPath1, _));
+  add_network_callback0.Run(kPath0, Error());
+  EXPECT_EQ(nullptr, GetPendingService().get());
+  add_network_callback1.Run(kPath1, Error());
+  EXPECT_EQ(service1, GetPendingService());
+
+  // Connecting to the first service again reuses its network.
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), AddNetworkAsync(_, _)).Times(0);
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), SelectNetworkAsync(kPath0, _));
+  InitiateConnect(service0);
+}
+
+TEST_F(WiFiMainTest, ConnectToKnownNetworkSupersedesAddNetwork) {
+  StartWiFi();
+  MockWiFiServiceRefPtr service0;
+  MakeNewEndpointAndService(0, 0, kNetworkModeAdHoc, nullptr, &service0);
+  MockWiFiServiceRefPtr service1;
+  MakeNewEndpointAndService(0, 1, kNetworkModeAdHoc, nullptr, &service1);
+  RpcIdentifierCallback add_network_callback0;
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), AddNetworkAsync(_, _))
+      .WillOnce(SaveArg<1>(&add_network_callback0));
+  InitiateConnect(service0);
+  // Waiting for the network to be added is not idle.
+  EXPECT_FALSE(wifi()->IsIdle());
+
+  // The second service already has a network, so it is selected right away.
+  const char kPath0[] = "/new/path0";
+  const char kPath1[] = "/known/path1";
+  SetServiceNetworkRpcId(service1, kPath1);
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), SelectNetworkAsync(kPath1, _));
+  InitiateConnect(service1);
+  EXPECT_EQ(service1, GetPendingService());
+  Mock::VerifyAndClearExpectations(GetSupplicantInterfaceProxy());
+
+  // The late reply for the first service must not take over the attempt.
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), SelectNetworkAsync(_, _))
+      .Times(0);
+  add_network_callback0.Run(kPath0, Error());
+  EXPECT_EQ(service1, GetPendingService());
+}
+
+TEST_F(WiFiMainTest, ConnectToAddNetworkFailure) {
+  StartWiFi();
+  MockWiFiServiceRefPtr service;
+  MakeNewEndpointAndService(0, 0, kNetworkModeAdHoc, nullptr, &service);
+  RpcIdentifierCallback add_network_callback;
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), AddNetworkAsync(_, _))
+      .WillOnce(SaveArg<1>(&add_network_callback));
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), SelectNetworkAsync(_, _))
+      .Times(0);
+  InitiateConnect(service);
+  add_network_callback.Run("", Error(Error::kOperationFailed));
+  EXPECT_EQ(nullptr, GetPendingService().get());
+
+  // A later attempt adds the network again.
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), AddNetworkAsync(_, _));
+  InitiateConnect(service);
+}
+
+TEST_F(WiFiMainTest, ConnectToAddNetworkReplyAfterStop) {
+  StartWiFi();
+  MockWiFiServiceRefPtr service;
+  MakeNewEndpointAndService(0, 0, kNetworkModeAdHoc, nullptr, &service);
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), AddNetworkAsync(_, _));
+  InitiateConnect(service);
+  StopWiFi();
+
+  // A reply that arrives after the device stopped is dropped, so the
+  // network is neither selected nor remembered.
+  EXPECT_CALL(*service, SetState(Service::kStateAssociating)).Times(0);
+  ReplyToAddNetwork("/new/path");
+  EXPECT_EQ(nullptr, GetPendingService().get());
+  EXPECT_TRUE(wifi()->IsIdle());
+}
+
 TEST_F(WiFiMainTest, AppendBgscan) {
   StartWiFi();
   MockWiFiServiceRefPtr service = MakeMockService(kSecurityNone);
@@ -3040,9 +3321,52 @@ TEST_F(WiFiMainTest, FlushBSSOnResume) {
       .WillOnce(DoAll(SetArgumentPointee<0>(resume_time), Return(0)))
       .WillOnce(DoAll(SetArgumentPointee<0>(scan_done_time), Return(0)));
   EXPECT_CALL(*GetSupplicantInterfaceProxy(),
-              FlushBSS(WiFi::kMaxBSSResumeAgeSeconds + 5));
+              FlushBSSAsync(WiFi::kMaxBSSResumeAgeSeconds + 5, _));
+  OnAfterResume();
+  ReportScanDone();
+}
+
+TEST_F(WiFiMainTest, FlushBSSOnResumeFailure) {
+  const struct timeval now = {1, 0};
+
+  StartWiFi();
+
+  EXPECT_CALL(time_, GetTimeMonotonic(_))
+      .WillRepeatedly(DoAll(SetArgumentPointee<0>(now), Return(0)));
+  ResultCallback flush_bss_callback;
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), FlushBSSAsync(_, _))
+      .WillOnce(SaveArg<1>(&flush_bss_callback));
+  OnAfterResume();
+  ReportScanDone();
+
+  // The failure is only logged.
+  ScopedMockLog log;
+  EXPECT_CALL(log, Log(_, _, _)).Times(AnyNumber());
+  EXPECT_CALL(log, Log(logging::LOG_ERROR, _,
+                       HasSubstr("supplicant FlushBSS failed")));
+  flush_bss_callback.Run(Error(Error::kOperationFailed));
+}
+
+TEST_F(WiFiMainTest, FlushBSSOnResumeReplyAfterStop) {
+  const struct timeval now = {1, 0};
+
+  StartWiFi();
+
+  EXPECT_CALL(time_, GetTimeMonotonic(_))
+      .WillRepeatedly(DoAll(SetArgumentPointee<0>(now), Return(0)));
+  ResultCallback flush_bss_callback;
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), FlushBSSAsync(_, _))
+      .WillOnce(SaveArg<1>(&flush_bss_callback));
   OnAfterResume();
   ReportScanDone();
+  StopWiFi();
+
+  // A reply that arrives after the device stopped is dropped.
+  ScopedMockLog log;
+  EXPECT_CALL(log, Log(_, _, _)).Times(AnyNumber());
+  EXPECT_CALL(log, Log(logging::LOG_ERROR, _,
+                       HasSubstr("supplicant FlushBSS failed"))).Times(0);
+  flush_bss_callback.Run(Error(Error::kOperationFailed));
 }
 
 TEST_F(WiFiMainTest, CallWakeOnWiFi_OnScanDone) {
@@ -3080,13 +3404,14 @@ TEST_F(WiFiMainTest, ScanTimerIdle_FullScan) {
   EnableFullScan();
   StartWiFi();
   dispatcher_.DispatchPendingEvents();
+  ReplyToScan(Error());
   ReportScanDone();
   CancelScanTimer();
   EXPECT_TRUE(GetScanTimer().IsCancelled());
 
   EXPECT_CALL(*manager(), OnDeviceGeolocationInfoUpdated(_));
   dispatcher_.DispatchPendingEvents();
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(_));
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _));
   FireScanTimer();
   dispatcher_.DispatchPendingEvents();
   EXPECT_FALSE(GetScanTimer().IsCancelled());  // Automatically re-armed.
@@ -3114,7 +3439,7 @@ TEST_F(WiFiMainTest, ScanTimerScanning) {
 
   // Should not call Scan, since we're already scanning.
   // (Scanning is triggered by StartWiFi.)
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(_)).Times(0);
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _)).Times(0);
   EXPECT_CALL(*scan_session_, InitiateScan()).Times(0);
   FireScanTimer();
   dispatcher_.DispatchPendingEvents();
@@ -3129,7 +3454,7 @@ TEST_F(WiFiMainTest, ScanTimerConnecting) {
   CancelScanTimer();
   EXPECT_TRUE(GetScanTimer().IsCancelled());
 
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(_)).Times(0);
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _)).Times(0);
   EXPECT_CALL(*scan_session_, InitiateScan()).Times(0);
   FireScanTimer();
   dispatcher_.DispatchPendingEvents();
@@ -3140,6 +3465,7 @@ TEST_F(WiFiMainTest, ScanTimerSuspending) {
   EnableFullScan();
   StartWiFi();
   dispatcher_.DispatchPendingEvents();
+  ReplyToScan(Error());
   ReportScanDone();
   CancelScanTimer();
   EXPECT_TRUE(GetScanTimer().IsCancelled());
@@ -3147,7 +3473,7 @@ TEST_F(WiFiMainTest, ScanTimerSuspending) {
   EXPECT_CALL(*manager(), OnDeviceGeolocationInfoUpdated(_));
   dispatcher_.DispatchPendingEvents();
   EXPECT_CALL(*manager(), IsSuspending()).WillOnce(Return(true));
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(_)).Times(0);
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _)).Times(0);
   FireScanTimer();
   dispatcher_.DispatchPendingEvents();
   EXPECT_TRUE(GetScanTimer().IsCancelled());  // Do not re-arm.
@@ -3183,6 +3509,7 @@ TEST_F(WiFiMainTest, ScanOnDisconnectWithHidden_FullScan) {
   EnableFullScan();
   StartWiFi();
   dispatcher_.DispatchPendingEvents();
+  ReplyToScan(Error());
   SetupConnectedService("", nullptr, nullptr);
   vector<uint8_t>kSSID(1, 'a');
   ByteArrays ssids;
@@ -3191,7 +3518,7 @@ TEST_F(WiFiMainTest, ScanOnDisconnectWithHidden_FullScan) {
   EXPECT_CALL(*wifi_provider(), GetHiddenSSIDList())
       .WillRepeatedly(Return(ssids));
   EXPECT_CALL(*GetSupplicantInterfaceProxy(),
-              Scan(HasHiddenSSID_FullScan(kSSID)));
+              ScanAsync(HasHiddenSSID_FullScan(kSSID), _));
   ReportCurrentBSSChanged(WPASupplicant::kCurrentBSSNull);
   dispatcher_.DispatchPendingEvents();
 }
@@ -3217,7 +3544,7 @@ TEST_F(WiFiMainTest, NoScanOnDisconnectWithoutHidden) {
   StartWiFi();
   dispatcher_.DispatchPendingEvents();
   SetupConnectedService("", nullptr, nullptr);
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(_)).Times(0);
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _)).Times(0);
   EXPECT_TRUE(IsScanSessionNull());
   EXPECT_CALL(*wifi_provider(), GetHiddenSSIDList())
       .WillRepeatedly(Return(ByteArrays()));
@@ -3304,6 +3631,7 @@ TEST_F(WiFiMainTest, SuspectCredentialsWEP) {
   MockWiFiServiceRefPtr service = MakeMockService(kSecurityWep);
   ExpectConnecting();
   InitiateConnect(service);
+  ReplyToAddNetwork("/default/path");
   SetCurrentService(service);
 
   // These expectations are very much like SetupConnectedService except
@@ -4202,8 +4530,7 @@ TEST_F(WiFiMainTest, ConnectToWithError) {
   StartScan(WiFi::kScanMethodProgressive);
 
   ExpectScanIdle();
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), AddNetwork(_, _)).
-      WillOnce(Return(false));
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), AddNetworkAsync(_, _));
   EXPECT_CALL(*metrics(), NotifyDeviceScanFinished(_)).Times(0);
   EXPECT_CALL(*metrics(), SendEnumToUMA(Metrics::kMetricScanResult, _, _)).
       Times(0);
@@ -4211,6 +4538,7 @@ TEST_F(WiFiMainTest, ConnectToWithError) {
   MockWiFiServiceRefPtr service = MakeMockService(kSecurityNone);
   EXPECT_CALL(*service, GetSupplicantConfigurationParameters());
   InitiateConnect(service);
+  ReplyToAddNetwork("", Error(Error::kOperationFailed));
   VerifyScanState(WiFi::kScanIdle, WiFi::kScanMethodNone);
   EXPECT_TRUE(IsScanSessionNull());
 }
@@ -4283,9 +4611,10 @@ TEST_F(WiFiMainTest, BackgroundScan) {
   SetupConnectedService("", nullptr, nullptr);
   VerifyScanState(WiFi::kScanIdle, WiFi::kScanMethodNone);
 
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(_)).Times(1);
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _)).Times(1);
   TriggerScan(WiFi::kScanMethodFull);
   dispatcher_.DispatchPendingEvents();
+  ReplyToScan(Error());
   VerifyScanState(WiFi::kScanBackgroundScanning, WiFi::kScanMethodFull);
 
   ReportScanDone();
@@ -4299,7 +4628,7 @@ TEST_F(WiFiMainTest, ProgressiveScanDuringFull) {
 
   // Now, try to slam-in a progressive scan.
   EXPECT_CALL(*scan_session_, InitiateScan()).Times(0);
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(_)).Times(0);
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _)).Times(0);
   TriggerScan(WiFi::kScanMethodProgressive);
   dispatcher_.DispatchPendingEvents();
   VerifyScanState(WiFi::kScanScanning, WiFi::kScanMethodFull);
@@ -4314,7 +4643,7 @@ TEST_F(WiFiMainTest, FullScanDuringProgressive) {
 
   // Now, try to slam-in a full scan.
   EXPECT_CALL(*scan_session_, InitiateScan()).Times(0);
-  EXPECT_CALL(*GetSupplicantInterfaceProxy(), Scan(_)).Times(0);
+  EXPECT_CALL(*GetSupplicantInterfaceProxy(), ScanAsync(_, _)).Times(0);
   TriggerScan(WiFi::kScanMethodFull);
   dispatcher_.DispatchPendingEvents();
   VerifyScanState(WiFi::kScanScanning, WiFi::kScanMethodProgressive);
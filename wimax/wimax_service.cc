@@ -101,6 +101,7 @@ void WiMaxService::Stop() {
     SetDevice(nullptr);
   }
   UpdateConnectable();
+  InvalidatePropertyDependency(kDependencyVisibility);
   NotifyPropertyChanges();
 }
 
@@ -139,6 +140,7 @@ bool WiMaxService::Start(WiMaxNetworkProxyInterface* proxy) {
       Bind(&WiMaxService::OnSignalStrengthChanged, Unretained(this)));
   proxy_.reset(local_proxy.release());
   UpdateConnectable();
+  InvalidatePropertyDependency(kDependencyVisibility);
   NotifyPropertyChanges();
   LOG(INFO) << "WiMAX service started: " << GetStorageIdentifier();
   return true;